@@ -43,6 +43,7 @@ typedef struct AV_TimeshiftPlayer AV_TimeshiftPlayer_t;
 typedef struct {
 	pthread_t av_mon_thread;
 	AM_Bool_t av_thread_running;
+	int       wake_fd;	/**< 唤醒监控线程的eventfd*/
 } AV_Monitor_t;
 
 /**\brief TS播放参数*/
@@ -26,6 +26,7 @@
 #include <am_time.h>
 #include "am_dmx.h"
 #include <am_thread.h>
+#include <am_tindex.h>
 #include "../am_av_internal.h"
 #include "../../am_aout/am_aout_internal.h"
 #include <sys/types.h>
@@ -36,6 +37,7 @@
 #include <poll.h>
 #include <errno.h>
 #include <signal.h>
+#include <sys/eventfd.h>
 #include <amports/amstream.h>
 #ifdef ANDROID
 #include <cutils/properties.h>
@@ -113,6 +115,7 @@ void *adec_handle = NULL;
 #define SCRAMBLE_CHECK_TIME          1000
 #define TIMESHIFT_INJECT_DIFF_TIME	 (90000*4)
 #define TIMESHIFT_FFFB_ERROR_CNT	 5
+#define TIMESHIFT_CRYPT_PKTS		 128
 #define VIDEO_AVAILABLE_MIN_CNT     2
 #define TIME_UNIT90K                 90000
 #define AUDIO_NO_DATA_TIME          20
@@ -278,6 +281,7 @@ void *adec_handle = NULL;
 #define SHOW_FIRSTFRAME_NOSYNC_PROP "tv.dtv.showfirstframe_nosync"
 #define REPLAY_ENABLE_PROP	"tv.dtv.replay_enable"
 #define HEART_BEAT_INTERVAL_PROP "tv.dtv.heart_beat_time"
+#define AV_MON_PERIOD_PROP "tv.dtv.avmon."
 
 #define CANVAS_ALIGN(x)    (((x)+7)&~7)
 #define JPEG_WRTIE_UNIT    (32*1024)
@@ -433,6 +437,7 @@ typedef enum
 typedef struct {
 	AV_PlayCmd_t cmd;
 	int done;
+	struct timespec put_time;	/**< 命令放入队列的时间，用于统计命令延迟*/
 	union {
 		struct {
 			int seek_pos;
@@ -444,7 +449,10 @@ typedef struct {
 } AV_PlayCmdPara_t;
 
 #define TIMESHIFT_CMD_Q_SIZE (32)
-QUEUE_DECLARATION(timeshift_cmd_q, AV_PlayCmdPara_t, TIMESHIFT_CMD_Q_SIZE);
+SPSC_QUEUE_DECLARATION(timeshift_cmd_q, AV_PlayCmdPara_t, TIMESHIFT_CMD_Q_SIZE);
+
+/**\brief 命令延迟统计的区间数，区间0为<1ms，区间n为[2^(n-1), 2^n)ms，最后一个区间不设上限*/
+#define TIMESHIFT_CMD_LAT_BUCKETS (12)
 
 /**\brief Timeshift播放模式相关数据*/
 typedef struct
@@ -461,13 +469,15 @@ typedef struct
 	int					timeout;
 	loff_t				rtotal;
 	int					rtime;
-	struct timeshift_cmd_q  cmd_q;
+	struct timeshift_cmd_q  cmd_q;	/**< 命令队列，多个命令发送者需持有lock*/
 	AV_PlayCmdPara_t        last_cmd[2];
+	int                     cmd_lat[TIMESHIFT_CMD_LAT_BUCKETS];	/**< 命令从放入队列到执行的延迟分布*/
+	int                     cmd_lat_max;	/**< 最大的命令延迟(us)*/
 	pthread_t			thread;
 	pthread_mutex_t		lock;
-	pthread_cond_t		cond;
 	AV_TimeshiftState_t	state;
 	AM_TFile_t	file;
+	AM_TIndex_t	index;	/**< 录像回放时的关键帧索引*/
 	int offset;
 	#define TIMESHIFT_TFILE_AUTOCREATE 1
 	#define TIMESHIFT_TFILE_DETACHED 2
@@ -491,6 +501,9 @@ typedef struct
 	int                     fffb_start;
 	int                     fffb_current;
 	int                     eof;
+	uint8_t                 crypt_buf[TIMESHIFT_CRYPT_PKTS*CRYPT_PKT_SIZE]; /**< 待解密的数据*/
+	int                     crypt_have; /**< crypt_buf中留到下次读取的不完整包的字节数*/
+	loff_t                  crypt_pos; /**< 留下数据之后的文件位置，文件位置改变时丢弃留下的数据*/
 } AV_TimeshiftData_t;
 
 struct AM_AUDIO_Driver
@@ -712,7 +725,6 @@ int g_festatus = 0;
 
 /*监控AV buffer, PTS 操作*/
 static pthread_mutex_t gAVMonLock = PTHREAD_MUTEX_INITIALIZER;
-static pthread_cond_t gAVMonCond = PTHREAD_COND_INITIALIZER;
 
 static void* aml_av_monitor_thread(void *arg);
 
@@ -2421,7 +2433,7 @@ static char *cmd2string(int cmd)
 }
 
 
-QUEUE_DEFINITION(timeshift_cmd_q, AV_PlayCmdPara_t);
+SPSC_QUEUE_DEFINITION(timeshift_cmd_q, AV_PlayCmdPara_t);
 
 static void timeshift_cmd_init(AV_PlayCmdPara_t *cmd, int c)
 {
@@ -2438,37 +2450,61 @@ static int timeshift_cmd_diff(AV_PlayCmdPara_t *cmd1, AV_PlayCmdPara_t *cmd2)
 		return (cmd1->seek.seek_pos != cmd2->seek.seek_pos) ? 1 : 0;
 	return 0;
 }
+/*called with tshift->lock held, the lock makes the senders a single producer*/
 static int timeshift_cmd_put(AV_TimeshiftData_t *tshift, AV_PlayCmdPara_t *cmd)
 {
-	AV_PlayCmdPara_t last;
-	enum enqueue_result e_ret;
-	enum dequeue_result d_ret = timeshift_cmd_q_dequeue(&tshift->cmd_q, &last);
-
-	if (d_ret == DEQUEUE_RESULT_EMPTY)
-		e_ret = timeshift_cmd_q_enqueue(&tshift->cmd_q, cmd);
-	else if (last.cmd == cmd->cmd) {
-		e_ret = timeshift_cmd_q_enqueue(&tshift->cmd_q, cmd);
-	} else {
-		e_ret = timeshift_cmd_q_enqueue(&tshift->cmd_q, &last);
-		e_ret |= timeshift_cmd_q_enqueue(&tshift->cmd_q, cmd);
-	}
-	if (e_ret != ENQUEUE_RESULT_SUCCESS) {
+	AM_TIME_GetTimeSpec(&cmd->put_time);
+	if (timeshift_cmd_q_enqueue(&tshift->cmd_q, cmd) != ENQUEUE_RESULT_SUCCESS) {
 		AM_DEBUG(1, "[timeshift] warning: cmd lost, max:%d", TIMESHIFT_CMD_Q_SIZE);
 		return -1;
 	}
 	return 0;
 }
+/*called by the timeshift thread only, without lock*/
 static int timeshift_cmd_get(AV_TimeshiftData_t *tshift, AV_PlayCmdPara_t *cmd)
 {
-	if (timeshift_cmd_q_is_empty(&tshift->cmd_q))
-		return -1;
+	AV_PlayCmdPara_t next;
+
 	if (timeshift_cmd_q_dequeue(&tshift->cmd_q, cmd) != DEQUEUE_RESULT_SUCCESS)
 		return -1;
+	/*only the latest of the same cmds in a row is executed*/
+	while ((timeshift_cmd_q_peek(&tshift->cmd_q, &next) == DEQUEUE_RESULT_SUCCESS)
+		&& (next.cmd == cmd->cmd))
+		timeshift_cmd_q_dequeue(&tshift->cmd_q, cmd);
 	return 0;
 }
-static int timeshift_cmd_more(AV_TimeshiftData_t *tshift)
+/*add the time from put to now to the latency histogram*/
+static void timeshift_cmd_latency(AV_TimeshiftData_t *tshift, AV_PlayCmdPara_t *cmd)
+{
+	struct timespec now;
+	int us, ms, b;
+
+	AM_TIME_GetTimeSpec(&now);
+	us = (now.tv_sec - cmd->put_time.tv_sec) * 1000000 + (now.tv_nsec - cmd->put_time.tv_nsec) / 1000;
+	ms = us / 1000;
+	for (b = 0; ms && (b < TIMESHIFT_CMD_LAT_BUCKETS - 1); b++)
+		ms >>= 1;
+
+	tshift->cmd_lat[b]++;
+	if (us > tshift->cmd_lat_max)
+		tshift->cmd_lat_max = us;
+	AM_DEBUG(5, "[timeshift] cmd %s latency %dus", cmd2string(cmd->cmd), us);
+}
+static void timeshift_cmd_latency_dump(AV_TimeshiftData_t *tshift)
 {
-	return !timeshift_cmd_q_is_empty(&tshift->cmd_q);
+	char buf[256];
+	int b, pos = 0;
+
+	for (b = 0; b < TIMESHIFT_CMD_LAT_BUCKETS; b++) {
+		if (!tshift->cmd_lat[b])
+			continue;
+		if (b == TIMESHIFT_CMD_LAT_BUCKETS - 1)
+			pos += snprintf(buf + pos, sizeof(buf) - pos, " >=%d:%d", 1 << (b - 1), tshift->cmd_lat[b]);
+		else
+			pos += snprintf(buf + pos, sizeof(buf) - pos, " <%d:%d", 1 << b, tshift->cmd_lat[b]);
+	}
+	buf[pos] = 0;
+	AM_DEBUG(1, "[timeshift] cmd latency(ms):%s, max %dus", buf, tshift->cmd_lat_max);
 }
 
 /**\brief 创建Timeshift相关数据*/
@@ -2483,11 +2519,16 @@ static AV_TimeshiftData_t* aml_create_timeshift_data(void)
 	memset(tshift, 0, sizeof(AV_TimeshiftData_t));
 	tshift->ts.fd = -1;
 	tshift->ts.vid_fd = -1;
-	timeshift_cmd_q_init(&tshift->cmd_q);
+	if (timeshift_cmd_q_init(&tshift->cmd_q)) {
+		AM_DEBUG(0, "create timeshift cmd queue failed, %s", strerror(errno));
+		free(tshift);
+		return NULL;
+	}
 #ifdef SUPPORT_CAS
 	tshift->buf = malloc(SECURE_BLOCK_SIZE);
 	if (!tshift->buf) {
 		AM_DEBUG(0, "alloc timeshihft buffer failed");
+		timeshift_cmd_q_destroy(&tshift->cmd_q);
 		free(tshift);
 		return NULL;
 	}
@@ -2558,7 +2599,7 @@ void tfile_evt_callback ( long dev_no, int event_type, void *param, void *user_d
 		AM_DEBUG(1, "tfile evt: rate[%dBps]", (int)param);
 		AV_TimeshiftData_t *tshift = (AV_TimeshiftData_t *)(((AM_AV_Device_t*)user_data)->timeshift_player.drv_data);
 		tshift->rate = (int)param;
-		pthread_cond_signal(&tshift->cond);
+		timeshift_cmd_q_wakeup(&tshift->cmd_q);
 	}
 }
 
@@ -2582,6 +2623,36 @@ static int aml_timeshift_get_delay(AV_TimeshiftData_t *tshift)
 	return aml_av_get_delay(tshift->ts.fd, has_video);
 }
 
+/**\brief 从录像索引中查找指定时间之前的关键帧位置*/
+static AM_Bool_t am_timeshift_index_seek(AV_TimeshiftData_t *tshift, int time, loff_t *offset)
+{
+	AM_TIndex_Entry_t entry;
+
+	if (!tshift->index || AM_TIndex_TimeSeek(tshift->index, time, &entry) != AM_SUCCESS)
+		return AM_FALSE;
+
+	*offset = entry.offset;
+	return AM_TRUE;
+}
+
+/**\brief 取得录像回放的当前时间，有索引时从最近的关键帧推算*/
+static int am_timeshift_playback_current(AV_TimeshiftData_t *tshift)
+{
+	loff_t off = AM_TFile_Tell(tshift->file);
+	AM_TIndex_Entry_t entry;
+	int time;
+
+	if (tshift->index && AM_TIndex_OffsetSeek(tshift->index, off, &entry) == AM_SUCCESS && off >= entry.offset)
+	{
+		time = entry.time;
+		if (tshift->rate)
+			time += (off - entry.offset) * 1000 / tshift->rate;
+		return time;
+	}
+
+	return tshift->rate ? off * 1000 / tshift->rate : 0;
+}
+
 static void aml_timeshift_get_current(AV_TimeshiftData_t *tshift, int *current, int *start, int *end)
 {
 	int timeshift = (tshift->para.para.mode == AM_AV_TIMESHIFT_MODE_TIMESHIFTING)? 1 : 0;
@@ -2589,7 +2660,7 @@ static void aml_timeshift_get_current(AV_TimeshiftData_t *tshift, int *current,
 	if (current)
 		*current = (timeshift)?
 			AM_TFile_TimeGetReadNow(tshift->file)
-			: (tshift->rate ? AM_TFile_Tell(tshift->file) * 1000 / tshift->rate : 0);
+			: am_timeshift_playback_current(tshift);
 	if (start)
 		*start = (timeshift)? AM_TFile_TimeGetStart(tshift->file) : 0;
 	if (end)
@@ -2922,6 +2993,16 @@ static AM_ErrorCode_t aml_start_timeshift(AV_TimeshiftData_t *tshift, AV_TimeShi
 			AM_DEBUG(1, "[timeshift] using TFile %p", tshift->file);
 		}
 
+		if (para->mode == AM_AV_TIMESHIFT_MODE_PLAYBACK)
+		{
+			char name[512];
+
+			/*录像时生成的关键帧索引，没有时按平均码率定位*/
+			snprintf(name, sizeof(name), "%s"AM_TINDEX_SUFFIX, tshift->file->name);
+			if (AM_TIndex_Open(&tshift->index, name) != AM_SUCCESS)
+				tshift->index = NULL;
+		}
+
 		if (! tshift->file->loop && tshift->duration)
 		{
 			tshift->rate = tshift->file->size * 1000 / tshift->duration;
@@ -2931,7 +3012,6 @@ static AM_ErrorCode_t aml_start_timeshift(AV_TimeshiftData_t *tshift, AV_TimeShi
 		tshift->offset = tshift_para->para.offset_ms;
 		tshift->para = *tshift_para;
 		pthread_mutex_init(&tshift->lock, NULL);
-		pthread_cond_init(&tshift->cond, NULL);
 		if (pthread_create(&tshift->thread, NULL, aml_timeshift_thread, (void*)tshift))
 		{
 			AM_DEBUG(1, "create the timeshift thread failed");
@@ -2947,11 +3027,18 @@ static AM_ErrorCode_t aml_start_timeshift(AV_TimeshiftData_t *tshift, AV_TimeShi
 static int aml_start_av_monitor(AM_AV_Device_t *dev, AV_Monitor_t *mon)
 {
 	AM_DEBUG(1, "[avmon] start av monitor SwitchSourceTime = %fs",getUptimeSeconds());
+	mon->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (mon->wake_fd == -1)
+		AM_DEBUG(1, "[avmon] cannot create eventfd, %s", strerror(errno));
 	mon->av_thread_running = AM_TRUE;
 	if (pthread_create(&mon->av_mon_thread, NULL, aml_av_monitor_thread, (void*)dev))
 	{
 		AM_DEBUG(1, "[avmon] create the av buf monitor thread failed");
 		mon->av_thread_running = AM_FALSE;
+		if (mon->wake_fd != -1) {
+			close(mon->wake_fd);
+			mon->wake_fd = -1;
+		}
 		return -1;
 	}
 	return 0;
@@ -2961,11 +3048,18 @@ static void aml_stop_av_monitor(AM_AV_Device_t *dev, AV_Monitor_t *mon)
 {
 	AM_DEBUG(1, "[avmon] stop av monitor");
 	if (mon->av_thread_running) {
+		uint64_t one = 1;
+
 		mon->av_thread_running = AM_FALSE;
-		pthread_cond_broadcast(&gAVMonCond);
+		if ((mon->wake_fd != -1) && (write(mon->wake_fd, &one, sizeof(one)) != sizeof(one)))
+			AM_DEBUG(1, "[avmon] cannot wake up the monitor, %s", strerror(errno));
 		AM_DEBUG(1, "[avmon] stop av monitor ---broardcast end join start\r\n");
 		pthread_join(mon->av_mon_thread, NULL);
 		AM_DEBUG(1, "[avmon] stop av monitor ---join end\r\n");
+		if (mon->wake_fd != -1) {
+			close(mon->wake_fd);
+			mon->wake_fd = -1;
+		}
 	}
 	if (dev)
 		dev->audio_switch = AM_FALSE;
@@ -3006,13 +3100,17 @@ static void aml_stop_timeshift(AV_TimeshiftData_t *tshift, AM_Bool_t destroy_thr
 	if (tshift->running && destroy_thread)
 	{
 		tshift->running = 0;
-		pthread_cond_broadcast(&tshift->cond);
+		timeshift_cmd_q_wakeup(&tshift->cmd_q);
 		pthread_join(tshift->thread, NULL);
 
 		aml_stop_av_monitor(tshift->dev, &tshift->dev->timeshift_player.mon);
 
 		if (!(tshift->file_flag & TIMESHIFT_TFILE_DETACHED))
 			AM_TFile_Close(tshift->file);
+		if (tshift->index) {
+			AM_TIndex_Close(tshift->index);
+			tshift->index = NULL;
+		}
 #ifdef SUPPORT_CAS
 		if (tshift->cas_open) {
 			AM_TFile_CasClose();
@@ -3059,6 +3157,7 @@ static void aml_destroy_timeshift_data(AV_TimeshiftData_t *tshift)
 		tshift->buf = NULL;
 	}
 #endif
+	timeshift_cmd_q_destroy(&tshift->cmd_q);
 	free(tshift);
 }
 
@@ -3115,7 +3214,8 @@ static int am_timeshift_fffb(AV_TimeshiftData_t *tshift, AV_PlayCmdPara_t *cmd)
 			loff_t offset;
 			next_time = tshift->fffb_current + speed * FFFB_JUMP_STEP;
 			next_time = am_timeshift_playback_time_check(tshift, next_time);
-			offset = (loff_t)next_time * tshift->rate / 1000;
+			if (!am_timeshift_index_seek(tshift, next_time, &offset))
+				offset = (loff_t)next_time * tshift->rate / 1000;
 #ifdef SUPPORT_CAS
 			if (tshift->para.para.secure_enable) {
 				offset = ROUNDUP(offset, SECURE_BLOCK_SIZE);
@@ -3199,10 +3299,11 @@ static int aml_timeshift_do_cmd_start(AV_TimeshiftData_t *tshift)
 		}
 	} else {//rec play
 		loff_t off = AM_TFile_Tell(tshift->file);
-		int current = off * 1000 / (loff_t)tshift->rate;
+		int current = am_timeshift_playback_current(tshift);
 		AM_DEBUG(1, "[timeshift] [start] file now[%lld][%dms] rate[%dbps]", off, current, tshift->rate);
 		if (current != tshift->current) {
-			offset = (loff_t)tshift->current / 1000 * (loff_t)tshift->rate;
+			if (!am_timeshift_index_seek(tshift, tshift->current, &offset))
+				offset = (loff_t)tshift->current / 1000 * (loff_t)tshift->rate;
 			AM_TFile_Seek(tshift->file, offset);
 			seeked = 1;
 		}
@@ -3315,7 +3416,8 @@ static int aml_timeshift_do_play_cmd(AV_TimeshiftData_t *tshift, AV_PlayCmdPara_
 				AM_TFile_TimeSeek(tshift->file, cmd->seek.seek_pos);
 			} else {
 				int pos = am_timeshift_playback_time_check(tshift, cmd->seek.seek_pos);
-				offset = (loff_t)pos / 1000 * (loff_t)tshift->rate;
+				if (!am_timeshift_index_seek(tshift, pos, &offset))
+					offset = (loff_t)pos / 1000 * (loff_t)tshift->rate;
 #ifdef SUPPORT_CAS
 				if (tshift->para.para.secure_enable) {
 					offset = ROUNDUP(offset, SECURE_BLOCK_SIZE);
@@ -3445,12 +3547,16 @@ static int aml_timeshift_fetch_data(AV_TimeshiftData_t *tshift, uint8_t *buf, si
 {
 	int cnt = 0;
 	int ret;
-	uint8_t ts_pkt[188];
 	AM_Crypt_Ops_t *crypt_ops = tshift->dev->crypt_ops;
 	void *cryptor = tshift->dev->cryptor;
 
 	if (CRYPT_SET(crypt_ops)) {
-		int skip = 0;
+		uint8_t *pkts = tshift->crypt_buf;
+		int skip = 0, have = tshift->crypt_have;
+
+		/*上次留下的数据只在文件没有被seek时有效*/
+		if (have && (AM_TFile_Tell(tshift->file) != tshift->crypt_pos))
+			have = 0;
 
 		/*skip the header*/
 		if (tshift->para.para.mode == AM_AV_TIMESHIFT_MODE_PLAYBACK) {
@@ -3458,39 +3564,54 @@ static int aml_timeshift_fetch_data(AV_TimeshiftData_t *tshift, uint8_t *buf, si
 				skip = 2;
 		}
 
-		while ((cnt + 188) <= size) {
-			if (AM_TFile_GetAvailable(tshift->file) < 188)
+		while ((cnt + CRYPT_PKT_SIZE) <= (int)size) {
+			loff_t avail = AM_TFile_GetAvailable(tshift->file);
+			int want, n, k, left;
+			uint8_t *p;
+
+			/*读取整数个包，缓冲区中可能已有重新同步后的部分数据*/
+			want = AM_MIN((int)size - cnt, (int)sizeof(tshift->crypt_buf));
+			want = AM_MIN(want, have + avail);
+			want -= want % CRYPT_PKT_SIZE;
+			if (want <= have)
 				break;
 
-			ret = AM_TFile_Read(tshift->file, ts_pkt, 1, timeout);
-			if (ret <= 0 || ret != 1) {
-				if (!cnt)
-					return 0;
-				else
-					break;
-			}
+			ret = AM_TFile_Read(tshift->file, pkts + have, want - have, timeout);
+			if (ret <= 0)
+				break;
+			have += ret;
 
-			if (ts_pkt[0] != 0x47)
-				continue;
+			/*同步的包一次解密*/
+			for (n = 0; ((n + 1) * CRYPT_PKT_SIZE <= have) && (pkts[n * CRYPT_PKT_SIZE] == 0x47); n++)
+				;
 
-			ret = AM_TFile_Read(tshift->file, ts_pkt+1, sizeof(ts_pkt)-1, timeout);
-			if (ret <= 0 || ret != (sizeof(ts_pkt)-1)) {
-				if (!cnt)
-					return 0;
-				else
-					break;
+			k = AM_MIN(skip, n);
+			if (k) {
+				memcpy(buf + cnt, pkts, k * CRYPT_PKT_SIZE);
+				skip -= k;
 			}
-
-			if (!skip) {
-				if (crypt_ops && crypt_ops->crypt)
-					crypt_ops->crypt(cryptor, buf+cnt, ts_pkt, 188, 1);
-			} else {
-				skip--;
-				memcpy(buf+cnt, ts_pkt, 188);
+			if (n > k)
+				AM_CRYPT_crypt_pkts(crypt_ops, cryptor, buf + cnt + k * CRYPT_PKT_SIZE,
+						pkts + k * CRYPT_PKT_SIZE, n - k, 1);
+			cnt += n * CRYPT_PKT_SIZE;
+
+			/*失去同步时丢弃下一个同步字节之前的数据*/
+			p = pkts + n * CRYPT_PKT_SIZE;
+			left = have - n * CRYPT_PKT_SIZE;
+			if (left && (p[0] != 0x47)) {
+				uint8_t *s = memchr(p + 1, 0x47, left - 1);
+
+				AM_DEBUG(1, "[timeshift] sync lost, skip %d bytes", s ? (int)(s - p) : left);
+				left = s ? left - (int)(s - p) : 0;
+				p = s;
 			}
-
-			cnt += 188;
+			if (left)
+				memmove(pkts, p, left);
+			have = left;
 		}
+
+		tshift->crypt_have = have;
+		tshift->crypt_pos = AM_TFile_Tell(tshift->file);
 	} else {
 		cnt = AM_TFile_Read(tshift->file, buf, size, timeout);
 	}
@@ -3534,7 +3655,6 @@ static void *aml_timeshift_thread(void *arg)
 	uint8_t buf[64*1024];
 #endif
 	const int FFFB_STEP = 150;
-	struct timespec rt;
 	AM_AV_TimeshiftInfo_t info;
 	struct am_io_param astatus;
 	struct am_io_param vstatus;
@@ -3594,12 +3714,8 @@ static void *aml_timeshift_thread(void *arg)
 
 		/*consume the cmds*/
 		do {
-			pthread_mutex_lock(&tshift->lock);
-			cmd_more = timeshift_cmd_more(tshift);
-			if (cmd_more)
-				timeshift_cmd_get(tshift, &cmd);
+			cmd_more = (timeshift_cmd_get(tshift, &cmd) == 0);
 			AM_DEBUG(5, ">>>exec cmd:%d pos:%d more:%d", cmd.cmd, cmd.seek.seek_pos, cmd_more);
-			pthread_mutex_unlock(&tshift->lock);
 
 			AM_TIME_GetClock(&now);
 
@@ -3610,6 +3726,8 @@ static void *aml_timeshift_thread(void *arg)
 			}
 
 			aml_timeshift_do_cmd(tshift, &cmd, do_update);
+			if (cmd_more)
+				timeshift_cmd_latency(tshift, &cmd);
 		} while (tshift->running && cmd_more);
 
 		/*start data inject*/
@@ -4012,21 +4130,13 @@ wait_for_next_loop:
 			}
 		}
 
-		if (tshift->timeout == -1)
-		{
-			pthread_mutex_lock(&tshift->lock);
-			pthread_cond_wait(&tshift->cond, &tshift->lock);
-			pthread_mutex_unlock(&tshift->lock);
-		}
-		else if (tshift->timeout > 0)
-		{
-			pthread_mutex_lock(&tshift->lock);
-			AM_TIME_GetTimeSpecTimeout(tshift->timeout, &rt);
-			pthread_cond_timedwait(&tshift->cond, &tshift->lock, &rt);
-			pthread_mutex_unlock(&tshift->lock);
-		}
+		/*a new cmd, the stop or the rate ready wakeup ends the wait at once*/
+		if ((tshift->timeout != 0) && tshift->running)
+			timeshift_cmd_q_wait(&tshift->cmd_q, tshift->timeout);
 	}
 
+	timeshift_cmd_latency_dump(tshift);
+
 	if (tshift->dev->crypt_ops && tshift->dev->crypt_ops->close) {
 		tshift->dev->crypt_ops->close(tshift->dev->cryptor);
 		tshift->dev->cryptor = NULL;
@@ -4075,7 +4185,7 @@ static AM_ErrorCode_t aml_timeshift_fill_data(AM_AV_Device_t *dev, uint8_t *data
 					{
 						/*Calculate the file size*/
 						tshift->file->size = (loff_t)tshift->rate * (loff_t)(tshift->duration / 1000);
-						pthread_cond_signal(&tshift->cond);
+						timeshift_cmd_q_wakeup(&tshift->cmd_q);
 						AM_DEBUG(1, "zzz @@@wirte record data %lld bytes in %d ms,so the rate is assumed to %d Bps, ring file size %lld",
 							tshift->rtotal, now - tshift->rtime, tshift->rate, tshift->file->size);
 					}
@@ -4142,7 +4252,6 @@ static AM_ErrorCode_t aml_timeshift_cmd(AM_AV_Device_t *dev, AV_PlayCmd_t cmd, v
 		}
 	}
 #endif
-	pthread_cond_signal(&data->cond);
 	pthread_mutex_unlock(&data->lock);
 
 	return AM_SUCCESS;
@@ -4411,7 +4520,6 @@ static AM_ErrorCode_t aml_open(AM_AV_Device_t *dev, const AM_AV_OpenPara_t *para
 	int v;
 
 	UNUSED(para);
-	pthread_cond_init(&gAVMonCond, NULL);
 	if (AM_FileRead(VID_AXIS_FILE, buf, sizeof(buf)) == AM_SUCCESS)
 	{
 		int left, top, right, bottom;
@@ -4587,7 +4695,6 @@ static AM_ErrorCode_t aml_open(AM_AV_Device_t *dev, const AM_AV_OpenPara_t *para
 static AM_ErrorCode_t aml_close(AM_AV_Device_t *dev)
 {
 	UNUSED(dev);
-	pthread_cond_destroy(&gAVMonCond);
 	return AM_SUCCESS;
 }
 
@@ -5145,6 +5252,153 @@ static void aml_av_heart_beat_status()
 
 int am_av_restart_pts_repeat_count = 2;
 
+/**\brief AV监控线程采样的sysfs节点*/
+enum {
+	AV_MON_NODE_VFRAME_COUNT,
+	AV_MON_NODE_APTS,
+	AV_MON_NODE_VPTS,
+	AV_MON_NODE_TSYNC_MODE,
+	AV_MON_NODE_DMX_APTS,
+	AV_MON_NODE_DMX_VPTS,
+	AV_MON_NODE_FIRST_APTS,
+	AV_MON_NODE_FIRST_VPTS,
+	AV_MON_NODE_COUNT
+};
+
+/**\brief 监控节点配置，period为采样间隔(ms)，0表示每次唤醒都采样，
+ * Android下可以通过属性AV_MON_PERIOD_PROP+name修改*/
+static const struct {
+	const char *path;
+	const char *name;
+	int         period;
+} av_mon_node_conf[AV_MON_NODE_COUNT] = {
+	{VIDEO_NEW_FRAME_COUNT_FILE,   "vframe_count", 0},
+	{AUDIO_PTS_FILE,               "apts",         0},
+	{VIDEO_PTS_FILE,               "vpts",         0},
+	{TSYNC_MODE_FILE,              "tsync_mode",   500},
+	{AUDIO_DMX_PTS_FILE,           "dmx_apts",     0},
+	{VIDEO_DMX_PTS_FILE,           "dmx_vpts",     0},
+	{TSYNC_FIRSTCHECKIN_APTS_FILE, "first_apts",   500},
+	{TSYNC_FIRSTCHECKIN_VPTS_FILE, "first_vpts",   500},
+};
+
+/**\brief 监控节点，文件一直保持打开，每次采样只需一次pread*/
+typedef struct {
+	int        fd;		/**< 节点句柄，-1表示无法打开，通过AM_FileRead读取*/
+	int        period;	/**< 采样间隔(ms)*/
+	int        time;	/**< 上次采样的时间*/
+	AM_Bool_t  valid;	/**< value中是上次采样的值*/
+	AM_Bool_t  notified;	/**< 驱动通过sysfs_notify通知了变化，下次读取时重新采样*/
+	char       value[32];
+} AV_MonNode_t;
+
+/**\brief 打开所有监控节点*/
+static void aml_av_mon_open(AV_MonNode_t *nodes)
+{
+	int i;
+
+	for (i = 0; i < AV_MON_NODE_COUNT; i++) {
+		AV_MonNode_t *n = &nodes[i];
+
+		memset(n, 0, sizeof(AV_MonNode_t));
+		n->fd = open(av_mon_node_conf[i].path, O_RDONLY | O_CLOEXEC);
+		n->period = av_mon_node_conf[i].period;
+#ifdef ANDROID
+		{
+			char prop[PROPERTY_KEY_MAX];
+
+			snprintf(prop, sizeof(prop), AV_MON_PERIOD_PROP"%s", av_mon_node_conf[i].name);
+			n->period = property_get_int32(prop, n->period);
+		}
+#endif
+	}
+}
+
+/**\brief 关闭所有监控节点*/
+static void aml_av_mon_close(AV_MonNode_t *nodes)
+{
+	int i;
+
+	for (i = 0; i < AV_MON_NODE_COUNT; i++) {
+		if (nodes[i].fd != -1) {
+			close(nodes[i].fd);
+			nodes[i].fd = -1;
+		}
+	}
+}
+
+/**\brief 读取监控节点，未到采样时间并且没有变化通知时返回上次的值，返回值和AM_FileRead相同*/
+static AM_ErrorCode_t aml_av_mon_read(AV_MonNode_t *nodes, int id, int now, char *buf, int len)
+{
+	AV_MonNode_t *n = &nodes[id];
+	int ret;
+
+	if (n->valid && !n->notified && (now - n->time < n->period)) {
+		snprintf(buf, len, "%s", n->value);
+		return AM_SUCCESS;
+	}
+
+	n->time = now;
+	n->notified = AM_FALSE;
+
+	if (n->fd == -1) {
+		/*可能只能通过系统服务访问*/
+		if (AM_FileRead(av_mon_node_conf[id].path, n->value, sizeof(n->value)) != AM_SUCCESS) {
+			n->valid = AM_FALSE;
+			return AM_FAILURE;
+		}
+	} else {
+		ret = pread(n->fd, n->value, sizeof(n->value) - 1, 0);
+		if (ret < 0) {
+			n->valid = AM_FALSE;
+			return AM_FAILURE;
+		}
+		n->value[ret] = 0;
+	}
+
+	n->valid = AM_TRUE;
+	snprintf(buf, len, "%s", n->value);
+	return AM_SUCCESS;
+}
+
+/**\brief 等待timeout毫秒，监控线程被唤醒或节点通知变化时提前返回*/
+static void aml_av_mon_wait(AV_Monitor_t *mon, AV_MonNode_t *nodes, int timeout)
+{
+	struct pollfd pfd[AV_MON_NODE_COUNT + 1];
+	int id[AV_MON_NODE_COUNT + 1];
+	int i, cnt = 0;
+	uint64_t v;
+
+	if (mon->wake_fd != -1) {
+		pfd[cnt].fd = mon->wake_fd;
+		pfd[cnt].events = POLLIN;
+		id[cnt++] = -1;
+	}
+
+	/*没有调用sysfs_notify的节点不会产生POLLPRI，已经通知的节点读取之前不再等待*/
+	for (i = 0; i < AV_MON_NODE_COUNT; i++) {
+		if ((nodes[i].fd == -1) || nodes[i].notified)
+			continue;
+		pfd[cnt].fd = nodes[i].fd;
+		pfd[cnt].events = POLLPRI;
+		id[cnt++] = i;
+	}
+
+	if (poll(pfd, cnt, timeout) <= 0)
+		return;
+
+	for (i = 0; i < cnt; i++) {
+		if (!pfd[i].revents)
+			continue;
+		if (id[i] == -1) {
+			if (read(mon->wake_fd, &v, sizeof(v)) != sizeof(v))
+				AM_DEBUG(1, "[avmon] cannot read eventfd, %s", strerror(errno));
+		} else if (pfd[i].revents & (POLLPRI | POLLERR)) {
+			nodes[id[i]].notified = AM_TRUE;
+		}
+	}
+}
+
 /**\brief AV buffer 监控线程*/
 static void* aml_av_monitor_thread(void *arg)
 {
@@ -5189,7 +5443,7 @@ static void* aml_av_monitor_thread(void *arg)
 	struct am_io_param vstatus;
 	int vdec_status, frame_width, frame_height, aspect_ratio;
 	int frame_width_old = -1, frame_height_old = -1, aspect_ratio_old = -1;
-	struct timespec rt;
+	AV_MonNode_t nodes[AV_MON_NODE_COUNT];
 	char buf[32];
 	AM_Bool_t is_avs_plus = AM_FALSE;
 	int avs_fmt = 0;
@@ -5254,6 +5508,8 @@ static void* aml_av_monitor_thread(void *arg)
 		AM_FileEcho(VID_BLACKOUT_FILE, "0");
 	}
 
+	aml_av_mon_open(nodes);
+
 	pthread_mutex_lock(&gAVMonLock);
 
 	if (tp->afmt == AFORMAT_AC3 ||
@@ -5265,12 +5521,9 @@ static void* aml_av_monitor_thread(void *arg)
 	AM_TIME_GetClock(&update_buflevel);
 	while (mon->av_thread_running) {
 
-		if (!adec_start || (has_video && no_video))
-			AM_TIME_GetTimeSpecTimeout(20, &rt);
-		else
-			AM_TIME_GetTimeSpecTimeout(200, &rt);
-
-		pthread_cond_timedwait(&gAVMonCond, &gAVMonLock, &rt);
+		pthread_mutex_unlock(&gAVMonLock);
+		aml_av_mon_wait(mon, nodes, (!adec_start || (has_video && no_video)) ? 20 : 200);
+		pthread_mutex_lock(&gAVMonLock);
 
 		if (! mon->av_thread_running)
 		{
@@ -5379,7 +5632,7 @@ static void* aml_av_monitor_thread(void *arg)
 		//check video frame available
 		if (has_video && !no_video_data) {
 #ifdef ANDROID
-			if (AM_FileRead(VIDEO_NEW_FRAME_COUNT_FILE, buf, sizeof(buf)) >= 0) {
+			if (aml_av_mon_read(nodes, AV_MON_NODE_VFRAME_COUNT, now, buf, sizeof(buf)) >= 0) {
 				sscanf(buf, "%i", &vframes_now);
 				if ((vframes_now >= 1) ) {
 					if (no_video) {
@@ -5449,21 +5702,21 @@ static void* aml_av_monitor_thread(void *arg)
 		else
 			is_avs_plus = AM_FALSE;
 
-		if (AM_FileRead(AUDIO_PTS_FILE, buf, sizeof(buf)) >= 0) {
+		if (aml_av_mon_read(nodes, AV_MON_NODE_APTS, now, buf, sizeof(buf)) >= 0) {
 			sscanf(buf+2, "%x", &apts);
 		} else {
 			AM_DEBUG(1, "[avmon] cannot read \"%s\"", AUDIO_PTS_FILE);
 			apts = 0;
 		}
 
-		if (AM_FileRead(VIDEO_PTS_FILE, buf, sizeof(buf)) >= 0) {
+		if (aml_av_mon_read(nodes, AV_MON_NODE_VPTS, now, buf, sizeof(buf)) >= 0) {
 			sscanf(buf+2, "%x", &vpts);
 		} else {
 			AM_DEBUG(1, "[avmon] cannot read \"%s\"", VIDEO_PTS_FILE);
 			vpts = 0;
 		}
 
-		if (AM_FileRead(TSYNC_MODE_FILE, buf, sizeof(buf)) >= 0) {
+		if (aml_av_mon_read(nodes, AV_MON_NODE_TSYNC_MODE, now, buf, sizeof(buf)) >= 0) {
 			sscanf(buf, "%d", &tsync_mode);
 		} else {
 			tsync_mode = 1;
@@ -5480,28 +5733,28 @@ static void* aml_av_monitor_thread(void *arg)
 			has_amaster = AM_TRUE;
 		}
 
-		if (AM_FileRead(AUDIO_DMX_PTS_FILE, buf, sizeof(buf)) >= 0) {
+		if (aml_av_mon_read(nodes, AV_MON_NODE_DMX_APTS, now, buf, sizeof(buf)) >= 0) {
 			sscanf(buf, "%u", &dmx_apts);
 		} else {
 			AM_DEBUG(1, "[avmon] cannot read \"%s\"", AUDIO_DMX_PTS_FILE);
 			dmx_apts = 0;
 		}
 
-		if (AM_FileRead(VIDEO_DMX_PTS_FILE, buf, sizeof(buf)) >= 0) {
+		if (aml_av_mon_read(nodes, AV_MON_NODE_DMX_VPTS, now, buf, sizeof(buf)) >= 0) {
 			sscanf(buf, "%u", &dmx_vpts);
 		} else {
 			AM_DEBUG(1, "[avmon] cannot read \"%s\"", VIDEO_DMX_PTS_FILE);
 			dmx_vpts = 0;
 		}
 
-		if (AM_FileRead(TSYNC_FIRSTCHECKIN_APTS_FILE, buf, sizeof(buf)) >= 0) {
+		if (aml_av_mon_read(nodes, AV_MON_NODE_FIRST_APTS, now, buf, sizeof(buf)) >= 0) {
 			sscanf(buf, "0x%x", &checkin_firstapts);
 		} else {
 			AM_DEBUG(1, "[avmon] cannot read \"%s\"", TSYNC_FIRSTCHECKIN_APTS_FILE);
 			checkin_firstapts = 0;
 		}
 
-		if (AM_FileRead(TSYNC_FIRSTCHECKIN_VPTS_FILE, buf, sizeof(buf)) >= 0) {
+		if (aml_av_mon_read(nodes, AV_MON_NODE_FIRST_VPTS, now, buf, sizeof(buf)) >= 0) {
 			sscanf(buf, "0x%x", &checkin_firstvpts);
 		} else {
 			AM_DEBUG(1, "[avmon] cannot read \"%s\"", TSYNC_FIRSTCHECKIN_VPTS_FILE);
@@ -6168,6 +6421,8 @@ static void* aml_av_monitor_thread(void *arg)
 
 	pthread_mutex_unlock(&gAVMonLock);
 
+	aml_av_mon_close(nodes);
+
 	dev->b_play_start = AM_FALSE;
 #ifndef ENABLE_PCR
 	if (resample_type) {
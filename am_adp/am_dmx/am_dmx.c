@@ -36,6 +36,9 @@
 #define DMX_SYNC
 
 #define DMX_BUF_SIZE       (4096)
+#define DMX_BATCH_BUF_SIZE (64*1024)
+/*异步队列至少能放下一次读出的最大数据和它的长度头*/
+#define DMX_ASYNC_MIN_QUEUE_SIZE ((int)(DMX_BATCH_BUF_SIZE + sizeof(uint32_t)))
 #define DMX_POLL_TIMEOUT   (50)
 #ifdef CHIP_8226H
 #define DMX_DEV_COUNT      (2)
@@ -129,9 +132,9 @@ static AM_INLINE AM_ErrorCode_t dmx_get_used_filter(AM_DMX_Device_t *dev, int fi
 {
 	AM_DMX_Filter_t *filter;
 	
-	if((filter_id<0) || (filter_id>=DMX_FILTER_COUNT))
+	if((filter_id<0) || (filter_id>=dev->filter_count))
 	{
-		AM_DEBUG(1, "invalid filter id, must in %d~%d", 0, DMX_FILTER_COUNT-1);
+		AM_DEBUG(1, "invalid filter id, must in %d~%d", 0, dev->filter_count-1);
 		return AM_DMX_ERR_INVALID_ID;
 	}
 	
@@ -147,6 +150,277 @@ static AM_INLINE AM_ErrorCode_t dmx_get_used_filter(AM_DMX_Device_t *dev, int fi
 	return AM_SUCCESS;
 }
 
+/**\brief 向环形缓冲区写入数据*/
+static void dmx_queue_write(AM_DMX_SecQueue_t *q, int pos, const uint8_t *data, int len)
+{
+	int cnt = AM_MIN(len, q->size - pos);
+
+	memcpy(q->buf + pos, data, cnt);
+	if(cnt < len)
+		memcpy(q->buf, data + cnt, len - cnt);
+}
+
+/**\brief 从环形缓冲区读出数据*/
+static void dmx_queue_read(AM_DMX_SecQueue_t *q, int pos, uint8_t *data, int len)
+{
+	int cnt = AM_MIN(len, q->size - pos);
+
+	memcpy(data, q->buf + pos, cnt);
+	if(cnt < len)
+		memcpy(data + cnt, q->buf, len - cnt);
+}
+
+/**\brief 将一个section加入过滤器的异步队列，队列满时丢弃*/
+static void dmx_queue_put(AM_DMX_Filter_t *filter, const uint8_t *data, int len)
+{
+	AM_DMX_SecQueue_t *q = filter->queue;
+	uint32_t hdr = len;
+	int need = sizeof(hdr) + len;
+
+	if(q->bytes + need > q->size)
+	{
+		if(!q->full)
+		{
+			AM_DEBUG(1, "filter %d async queue overflow", filter->id);
+			filter->stats.overflows++;
+			q->full = AM_TRUE;
+		}
+		filter->stats.dropped++;
+		return;
+	}
+
+	q->full = AM_FALSE;
+
+	dmx_queue_write(q, (q->head + q->bytes) % q->size, (uint8_t*)&hdr, sizeof(hdr));
+	if(len)
+		dmx_queue_write(q, (q->head + q->bytes + sizeof(hdr)) % q->size, data, len);
+
+	q->bytes += need;
+	q->count++;
+
+	filter->stats.sections++;
+	if(q->bytes > filter->stats.max_bytes)
+		filter->stats.max_bytes = q->bytes;
+}
+
+/**\brief 从异步队列中取出一个section*/
+static int dmx_queue_get(AM_DMX_SecQueue_t *q, uint8_t *data)
+{
+	uint32_t hdr;
+
+	dmx_queue_read(q, q->head, (uint8_t*)&hdr, sizeof(hdr));
+	q->head = (q->head + sizeof(hdr)) % q->size;
+
+	if(hdr)
+		dmx_queue_read(q, q->head, data, hdr);
+
+	q->head   = (q->head + hdr) % q->size;
+	q->bytes -= sizeof(hdr) + hdr;
+	q->count--;
+
+	return hdr;
+}
+
+/**\brief 查找一个有待分发数据且没有在回调中的过滤器*/
+static AM_DMX_Filter_t* dmx_async_pick(AM_DMX_Device_t *dev)
+{
+	int i, id;
+
+	for(i=0; i<dev->filter_count; i++)
+	{
+		AM_DMX_Filter_t *filter;
+
+		id = (dev->async_next + i) % dev->filter_count;
+		filter = &dev->filters[id];
+
+		if(filter->queue && filter->queue->count && !filter->queue->busy)
+		{
+			dev->async_next = id + 1;
+			return filter;
+		}
+	}
+
+	return NULL;
+}
+
+/**\brief 异步分发工作线程*/
+static void* dmx_async_thread(void *arg)
+{
+	AM_DMX_Device_t *dev = (AM_DMX_Device_t*)arg;
+	uint8_t *buf;
+	int self;
+
+	buf = (uint8_t*)malloc(DMX_BATCH_BUF_SIZE);
+	if(!buf)
+	{
+		AM_DEBUG(1, "not enough memory");
+		return NULL;
+	}
+
+	pthread_mutex_lock(&dev->async_lock);
+
+	/*dmx_async_start在async_lock保护下创建线程，此时workers已经设置*/
+	for(self=0; self<DMX_ASYNC_MAX_WORKERS-1; self++)
+	{
+		if(pthread_equal(dev->workers[self], pthread_self()))
+			break;
+	}
+
+	while(!dev->async_quit)
+	{
+		AM_DMX_Filter_t *filter;
+		AM_DMX_SecQueue_t *q;
+		AM_DMX_DataCb cb;
+		void *data;
+		int len;
+
+		filter = dmx_async_pick(dev);
+		if(!filter)
+		{
+			pthread_cond_wait(&dev->async_cond, &dev->async_lock);
+			continue;
+		}
+
+		q    = filter->queue;
+		len  = dmx_queue_get(q, buf);
+		cb   = filter->cb;
+		data = filter->user_data;
+
+		q->busy = AM_TRUE;
+		dev->async_cb_seq[self]++;
+
+		pthread_mutex_unlock(&dev->async_lock);
+
+		if(cb)
+			cb(dev->dev_no, filter->id, len ? buf : NULL, len, data);
+
+		pthread_mutex_lock(&dev->async_lock);
+
+		dev->async_cb_seq[self]++;
+
+		if(q->orphan)
+		{
+			free(q->buf);
+			free(q);
+		}
+		else
+		{
+			q->busy = AM_FALSE;
+			filter->stats.delivered++;
+		}
+
+		pthread_cond_broadcast(&dev->async_cond);
+	}
+
+	pthread_mutex_unlock(&dev->async_lock);
+
+	free(buf);
+
+	return NULL;
+}
+
+/**\brief 启动异步分发工作线程，需在async_lock保护下调用*/
+static AM_ErrorCode_t dmx_async_start(AM_DMX_Device_t *dev)
+{
+	int i, cnt;
+
+	if(dev->worker_running)
+		return AM_SUCCESS;
+
+	cnt = dev->worker_count ? dev->worker_count : DMX_ASYNC_DEF_WORKERS;
+	dev->async_quit = AM_FALSE;
+
+	for(i=0; i<cnt; i++)
+	{
+		dev->async_cb_seq[i] = 0;
+		if(pthread_create(&dev->workers[i], NULL, dmx_async_thread, dev))
+		{
+			AM_DEBUG(1, "cannot create dmx async worker");
+			break;
+		}
+		dev->worker_running++;
+	}
+
+	return dev->worker_running ? AM_SUCCESS : AM_DMX_ERR_CANNOT_CREATE_THREAD;
+}
+
+/**\brief 停止异步分发工作线程*/
+static void dmx_async_stop(AM_DMX_Device_t *dev)
+{
+	int i, cnt;
+
+	pthread_mutex_lock(&dev->async_lock);
+	cnt = dev->worker_running;
+	dev->async_quit = AM_TRUE;
+	pthread_cond_broadcast(&dev->async_cond);
+	pthread_mutex_unlock(&dev->async_lock);
+
+	for(i=0; i<cnt; i++)
+		pthread_join(dev->workers[i], NULL);
+
+	dev->worker_running = 0;
+}
+
+/**\brief 清空过滤器的异步队列，需在async_lock保护下调用
+ * 与同步模式一致，不等待正在进行的回调结束，避免回调中调用DMX接口时死锁*/
+static void dmx_async_flush(AM_DMX_Filter_t *filter)
+{
+	AM_DMX_SecQueue_t *q = filter->queue;
+
+	if(!q)
+		return;
+
+	q->head  = 0;
+	q->bytes = 0;
+	q->count = 0;
+	q->full  = AM_FALSE;
+}
+
+/**\brief 释放过滤器的异步队列，需在async_lock保护下调用*/
+static void dmx_async_release(AM_DMX_Filter_t *filter)
+{
+	AM_DMX_SecQueue_t *q = filter->queue;
+
+	if(!q)
+		return;
+
+	dmx_async_flush(filter);
+	filter->queue = NULL;
+
+	/*工作线程正在回调，由其在回调返回后释放*/
+	if(q->busy)
+	{
+		q->orphan = AM_TRUE;
+		return;
+	}
+
+	free(q->buf);
+	free(q);
+}
+
+/**\brief 将数据交给过滤器，异步模式下加入队列，否则直接回调*/
+static void dmx_deliver(AM_DMX_Device_t *dev, AM_DMX_Filter_t *filter, AM_DMX_DataCb cb, void *data, const uint8_t *sec, int len)
+{
+	if(filter->queue)
+	{
+		pthread_mutex_lock(&dev->async_lock);
+		if(filter->queue)
+		{
+			if(filter->enable)
+			{
+				dmx_queue_put(filter, sec, sec ? len : 0);
+				pthread_cond_signal(&dev->async_cond);
+			}
+			pthread_mutex_unlock(&dev->async_lock);
+			return;
+		}
+		pthread_mutex_unlock(&dev->async_lock);
+	}
+
+	if(cb)
+		cb(dev->dev_no, filter->id, sec, len, data);
+}
+
 /**\brief 数据检测线程*/
 static void* dmx_data_thread(void *arg)
 {
@@ -156,10 +430,10 @@ static void* dmx_data_thread(void *arg)
 	int sec_len;
 	AM_DMX_FilterMask_t mask;
 	AM_ErrorCode_t ret;
+	int buf_size;
 
-#define BUF_SIZE (4096)
-
-	sec_buf = (uint8_t*)malloc(BUF_SIZE);
+	buf_size = dev->drv->read_batch ? DMX_BATCH_BUF_SIZE : DMX_BUF_SIZE;
+	sec_buf = (uint8_t*)malloc(buf_size);
 	
 	while(dev->enable_thread)
 	{
@@ -178,19 +452,23 @@ static void* dmx_data_thread(void *arg)
 			pthread_mutex_unlock(&dev->lock);
 #endif
 				
-			for(id=0; id<DMX_FILTER_COUNT; id++)
+			/*只处理有数据的过滤器*/
+			for(id=AM_DMX_FILTER_MASK_NEXT(&mask, 0); id>=0; id=AM_DMX_FILTER_MASK_NEXT(&mask, id+1))
 			{
-				AM_DMX_Filter_t *filter=&dev->filters[id];
+				AM_DMX_Filter_t *filter;
 				AM_DMX_DataCb cb;
 				void *data;
+				AM_Bool_t is_pes = AM_FALSE;
 				
-				if(!AM_DMX_FILTER_MASK_ISSET(&mask, id))
-					continue;
+				if(id>=dev->filter_count)
+					break;
+				
+				filter=&dev->filters[id];
 				
 				if(!filter->enable || !filter->used)
 					continue;
 				
-				sec_len = BUF_SIZE;
+				sec_len = buf_size;
 
 #ifndef DMX_WAIT_CB
 				pthread_mutex_lock(&dev->lock);
@@ -203,7 +481,11 @@ static void* dmx_data_thread(void *arg)
 				{
 					cb   = filter->cb;
 					data = filter->user_data;
-					ret  = dev->drv->read(dev, filter, sec_buf, &sec_len);
+					is_pes = filter->is_pes;
+					if(dev->drv->read_batch)
+						ret = dev->drv->read_batch(dev, filter, sec_buf, &sec_len);
+					else
+						ret = dev->drv->read(dev, filter, sec_buf, &sec_len);
 				}
 #ifndef DMX_WAIT_CB
 				pthread_mutex_unlock(&dev->lock);
@@ -229,7 +511,25 @@ static void* dmx_data_thread(void *arg)
 						id, (long)filter->drv_data, sec_len,
 						sec[0], sec[1], sec[2], sec[3], sec[4],
 						sec[5], sec[6], sec[7], sec[8], sec[9]);
-					cb(dev->dev_no, id, sec, sec_len, data);
+					if(!sec || is_pes || !dev->drv->read_batch)
+					{
+						dmx_deliver(dev, filter, cb, data, sec, sec_len);
+					}
+					else
+					{
+						/*批量读出的数据包含多个section，逐个回调*/
+						while(sec_len >= 3)
+						{
+							int len = (((sec[1]<<8)|sec[2])&0xFFF) + 3;
+
+							if(len > sec_len)
+								break;
+
+							dmx_deliver(dev, filter, cb, data, sec, len);
+							sec += len;
+							sec_len -= len;
+						}
+					}
 					if(id && sec)
 					AM_DEBUG(5, "filter %d data callback ok", id);
 				}
@@ -288,6 +588,13 @@ static AM_ErrorCode_t dmx_stop_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *fil
 	if(ret>=0)
 	{
 		filter->enable = AM_FALSE;
+
+		if(filter->queue)
+		{
+			pthread_mutex_lock(&dev->async_lock);
+			dmx_async_flush(filter);
+			pthread_mutex_unlock(&dev->async_lock);
+		}
 	}
 	
 	return ret;
@@ -314,6 +621,10 @@ static int dmx_free_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *filter)
 	if(ret==AM_SUCCESS)
 	{
 		filter->used=AM_FALSE;
+
+		pthread_mutex_lock(&dev->async_lock);
+		dmx_async_release(filter);
+		pthread_mutex_unlock(&dev->async_lock);
 	}
 	
 	return ret;
@@ -357,6 +668,16 @@ AM_ErrorCode_t AM_DMX_Open(int dev_no, const AM_DMX_OpenPara_t *para)
 		dev->drv = &HW_DMX_DRV;
 	}
 	
+	dev->filter_count = dev->drv->filter_count ? dev->drv->filter_count : DMX_FILTER_COUNT;
+	dev->filter_count = AM_MIN(dev->filter_count, DMX_FILTER_MAX_COUNT);
+	dev->filters = (AM_DMX_Filter_t*)calloc(dev->filter_count, sizeof(AM_DMX_Filter_t));
+	if(!dev->filters)
+	{
+		AM_DEBUG(1, "not enough memory");
+		ret = AM_DMX_ERR_NO_MEM;
+		goto final;
+	}
+	
 	if(dev->drv->open)
 	{
 		ret = dev->drv->open(dev, para);
@@ -366,13 +687,20 @@ AM_ErrorCode_t AM_DMX_Open(int dev_no, const AM_DMX_OpenPara_t *para)
 	{
 		pthread_mutex_init(&dev->lock, NULL);
 		pthread_cond_init(&dev->cond, NULL);
+		pthread_mutex_init(&dev->async_lock, NULL);
+		pthread_cond_init(&dev->async_cond, NULL);
 		dev->enable_thread = AM_TRUE;
 		dev->flags = 0;
+		dev->worker_running = 0;
+		dev->worker_count = 0;
+		dev->async_next = 0;
 		
 		if(pthread_create(&dev->thread, NULL, dmx_data_thread, dev))
 		{
 			pthread_mutex_destroy(&dev->lock);
 			pthread_cond_destroy(&dev->cond);
+			pthread_mutex_destroy(&dev->async_lock);
+			pthread_cond_destroy(&dev->async_cond);
 			ret = AM_DMX_ERR_CANNOT_CREATE_THREAD;
 		}
 	}
@@ -381,6 +709,11 @@ AM_ErrorCode_t AM_DMX_Open(int dev_no, const AM_DMX_OpenPara_t *para)
 	{
 		dev->open_count = 1;
 	}
+	else
+	{
+		free(dev->filters);
+		dev->filters = NULL;
+	}
 final:
 	pthread_mutex_unlock(&am_gAdpLock);
 	
@@ -408,7 +741,9 @@ AM_ErrorCode_t AM_DMX_Close(int dev_no)
 		dev->enable_thread = AM_FALSE;
 		pthread_join(dev->thread, NULL);
 
-		for(i=0; i<DMX_FILTER_COUNT; i++)
+		dmx_async_stop(dev);
+
+		for(i=0; i<dev->filter_count; i++)
 		{
 			dmx_free_filter(dev, &dev->filters[i]);
 		}
@@ -418,8 +753,13 @@ AM_ErrorCode_t AM_DMX_Close(int dev_no)
 			dev->drv->close(dev);
 		}
 
+		free(dev->filters);
+		dev->filters = NULL;
+
 		pthread_mutex_destroy(&dev->lock);
 		pthread_cond_destroy(&dev->cond);
+		pthread_mutex_destroy(&dev->async_lock);
+		pthread_cond_destroy(&dev->async_cond);
 	}
 	dev->open_count--;
 	
@@ -448,13 +788,13 @@ AM_ErrorCode_t AM_DMX_AllocateFilter(int dev_no, int *fhandle)
 	pthread_mutex_lock(&am_gHwDmxLock);
 	pthread_mutex_lock(&dev->lock);
 	
-	for(fid=0; fid<DMX_FILTER_COUNT; fid++)
+	for(fid=0; fid<dev->filter_count; fid++)
 	{
 		if(!dev->filters[fid].used)
 			break;
 	}
 	
-	if(fid>=DMX_FILTER_COUNT)
+	if(fid>=dev->filter_count)
 	{
 		AM_DEBUG(1, "no free section filter");
 		ret = AM_DMX_ERR_NO_FREE_FILTER;
@@ -465,6 +805,9 @@ AM_ErrorCode_t AM_DMX_AllocateFilter(int dev_no, int *fhandle)
 		dmx_wait_cb(dev);
 		
 		dev->filters[fid].id   = fid;
+		dev->filters[fid].is_pes = AM_FALSE;
+		dev->filters[fid].queue  = NULL;
+		memset(&dev->filters[fid].stats, 0, sizeof(AM_DMX_FilterStats_t));
 		if(dev->drv->alloc_filter)
 		{
 			ret = dev->drv->alloc_filter(dev, &dev->filters[fid]);
@@ -521,6 +864,8 @@ AM_ErrorCode_t AM_DMX_SetSecFilter(int dev_no, int fhandle, const struct dmx_sct
 	if(ret==AM_SUCCESS)
 	{
 		ret = dev->drv->set_sec_filter(dev, filter, params);
+		if(ret==AM_SUCCESS)
+			filter->is_pes = AM_FALSE;
 		AM_DEBUG(5, "set sec filter %d PID: %d filter: %02x:%02x %02x:%02x %02x:%02x %02x:%02x %02x:%02x %02x:%02x %02x:%02x %02x:%02x",
 				fhandle, params->pid,
 				params->filter.filter[0], params->filter.mask[0],
@@ -577,6 +922,8 @@ AM_ErrorCode_t AM_DMX_SetPesFilter(int dev_no, int fhandle, const struct dmx_pes
 	if(ret==AM_SUCCESS)
 	{
 		ret = dev->drv->set_pes_filter(dev, filter, params);
+		if(ret==AM_SUCCESS)
+			filter->is_pes = AM_TRUE;
 		AM_DEBUG(2, "set pes filter %d PID %d", fhandle, params->pid);
 	}
 	
@@ -792,8 +1139,10 @@ AM_ErrorCode_t AM_DMX_SetCallback(int dev_no, int fhandle, AM_DMX_DataCb cb, voi
 	{
 		dmx_wait_cb(dev);
 	
+		pthread_mutex_lock(&dev->async_lock);
 		filter->cb = cb;
 		filter->user_data = data;
+		pthread_mutex_unlock(&dev->async_lock);
 	}
 	
 	pthread_mutex_unlock(&dev->lock);
@@ -839,6 +1188,205 @@ AM_ErrorCode_t AM_DMX_SetSource(int dev_no, AM_DMX_Source_t src)
 	return ret;
 }
 
+/**\brief 设置过滤器的异步分发模式
+ * \param dev_no 解复用设备号
+ * \param fhandle 过滤器句柄
+ * \param enable AM_TRUE使用异步分发，AM_FALSE在解复用线程中直接回调
+ * \param queue_size 异步队列大小(字节)，0表示缺省大小，小于一次读出的最大数据时使用最小值
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码(见am_dmx.h)
+ */
+AM_ErrorCode_t AM_DMX_SetAsyncMode(int dev_no, int fhandle, AM_Bool_t enable, int queue_size)
+{
+	AM_DMX_Device_t *dev;
+	AM_DMX_Filter_t *filter;
+	AM_DMX_SecQueue_t *q = NULL;
+	AM_ErrorCode_t ret = AM_SUCCESS;
+
+	AM_TRY(dmx_get_openned_dev(dev_no, &dev));
+
+	if(queue_size <= 0)
+		queue_size = DMX_ASYNC_DEF_QUEUE_SIZE;
+	queue_size = AM_MAX(queue_size, DMX_ASYNC_MIN_QUEUE_SIZE);
+
+	pthread_mutex_lock(&dev->lock);
+
+	ret = dmx_get_used_filter(dev, fhandle, &filter);
+
+	if((ret==AM_SUCCESS) && enable)
+	{
+		q = (AM_DMX_SecQueue_t*)malloc(sizeof(AM_DMX_SecQueue_t));
+		if(q)
+		{
+			memset(q, 0, sizeof(AM_DMX_SecQueue_t));
+			q->size = queue_size;
+			q->buf  = (uint8_t*)malloc(queue_size);
+			if(!q->buf)
+			{
+				free(q);
+				q = NULL;
+			}
+		}
+
+		if(!q)
+		{
+			AM_DEBUG(1, "not enough memory");
+			ret = AM_DMX_ERR_NO_MEM;
+		}
+	}
+
+	if(ret==AM_SUCCESS)
+	{
+		pthread_mutex_lock(&dev->async_lock);
+
+		if(enable)
+			ret = dmx_async_start(dev);
+
+		if(ret==AM_SUCCESS)
+		{
+			dmx_async_release(filter);
+			filter->queue = q;
+			q = NULL;
+		}
+
+		pthread_mutex_unlock(&dev->async_lock);
+	}
+
+	pthread_mutex_unlock(&dev->lock);
+
+	if(q)
+	{
+		free(q->buf);
+		free(q);
+	}
+
+	return ret;
+}
+
+/**\brief 设置异步分发工作线程数
+ * \param dev_no 解复用设备号
+ * \param count 工作线程数
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码(见am_dmx.h)
+ */
+AM_ErrorCode_t AM_DMX_SetAsyncWorkers(int dev_no, int count)
+{
+	AM_DMX_Device_t *dev;
+	AM_ErrorCode_t ret = AM_SUCCESS;
+
+	AM_TRY(dmx_get_openned_dev(dev_no, &dev));
+
+	if((count <= 0) || (count > DMX_ASYNC_MAX_WORKERS))
+	{
+		AM_DEBUG(1, "invalid worker count %d, must in %d~%d", count, 1, DMX_ASYNC_MAX_WORKERS);
+		return AM_DMX_ERR_NOT_SUPPORTED;
+	}
+
+	pthread_mutex_lock(&dev->async_lock);
+
+	if(dev->worker_running)
+	{
+		AM_DEBUG(1, "async workers are already running");
+		ret = AM_DMX_ERR_BUSY;
+	}
+	else
+	{
+		dev->worker_count = count;
+	}
+
+	pthread_mutex_unlock(&dev->async_lock);
+
+	return ret;
+}
+
+/**\brief 取得过滤器的分发统计信息
+ * \param dev_no 解复用设备号
+ * \param fhandle 过滤器句柄
+ * \param[out] stats 返回统计信息
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码(见am_dmx.h)
+ */
+AM_ErrorCode_t AM_DMX_GetFilterStats(int dev_no, int fhandle, AM_DMX_FilterStats_t *stats)
+{
+	AM_DMX_Device_t *dev;
+	AM_DMX_Filter_t *filter;
+	AM_ErrorCode_t ret = AM_SUCCESS;
+
+	assert(stats);
+
+	AM_TRY(dmx_get_openned_dev(dev_no, &dev));
+
+	pthread_mutex_lock(&dev->lock);
+
+	ret = dmx_get_used_filter(dev, fhandle, &filter);
+
+	if(ret==AM_SUCCESS)
+	{
+		pthread_mutex_lock(&dev->async_lock);
+		*stats = filter->stats;
+		pthread_mutex_unlock(&dev->async_lock);
+	}
+
+	pthread_mutex_unlock(&dev->lock);
+
+	return ret;
+}
+
+/**\brief 取得解复用驱动的硬件过滤器重配置统计
+ * \param dev_no 解复用设备号
+ * \param[out] stats 返回统计信息
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码(见am_dmx.h)
+ */
+AM_ErrorCode_t AM_DMX_GetReconfigStats(int dev_no, AM_DMX_ReconfigStats_t *stats)
+{
+	AM_DMX_Device_t *dev;
+	AM_ErrorCode_t ret = AM_SUCCESS;
+
+	assert(stats);
+
+	AM_TRY(dmx_get_openned_dev(dev_no, &dev));
+
+	pthread_mutex_lock(&dev->lock);
+	if(!dev->drv->get_reconfig_stats)
+	{
+		AM_DEBUG(1, "do not support get_reconfig_stats");
+		ret = AM_DMX_ERR_NOT_SUPPORTED;
+	}
+
+	if(ret==AM_SUCCESS)
+	{
+		ret = dev->drv->get_reconfig_stats(dev, stats);
+	}
+	pthread_mutex_unlock(&dev->lock);
+
+	return ret;
+}
+
+/**\brief 取得解复用设备支持的过滤器数目
+ * \param dev_no 解复用设备号
+ * \param[out] count 返回过滤器数目
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码(见am_dmx.h)
+ */
+AM_ErrorCode_t AM_DMX_GetFilterCount(int dev_no, int *count)
+{
+	AM_DMX_Device_t *dev;
+
+	assert(count);
+
+	AM_TRY(dmx_get_openned_dev(dev_no, &dev));
+
+	*count = dev->filter_count;
+
+	return AM_SUCCESS;
+}
+
 /**\brief DMX同步，可用于等待回调函数执行完毕
  * \param dev_no 解复用设备号
  * \return
@@ -849,6 +1397,8 @@ AM_ErrorCode_t AM_DMX_Sync(int dev_no)
 {
 	AM_DMX_Device_t *dev;
 	AM_ErrorCode_t ret = AM_SUCCESS;
+	unsigned int seq;
+	int i;
 	
 	AM_TRY(dmx_get_openned_dev(dev_no, &dev));
 	
@@ -859,6 +1409,19 @@ AM_ErrorCode_t AM_DMX_Sync(int dev_no)
 			pthread_cond_wait(&dev->cond, &dev->lock);
 	}
 	pthread_mutex_unlock(&dev->lock);
+
+	/*等待工作线程中正在执行的异步回调，回调中调用时不等待本线程*/
+	pthread_mutex_lock(&dev->async_lock);
+	for(i=0; i<dev->worker_running; i++)
+	{
+		if(pthread_equal(dev->workers[i], pthread_self()))
+			continue;
+
+		seq = dev->async_cb_seq[i];
+		while((seq & 1) && (dev->async_cb_seq[i] == seq))
+			pthread_cond_wait(&dev->async_cond, &dev->async_lock);
+	}
+	pthread_mutex_unlock(&dev->async_lock);
 	
 	return ret;
 }
@@ -19,6 +19,7 @@
 #include <am_dmx.h>
 #include <am_util.h>
 #include <am_thread.h>
+#include <string.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -29,10 +30,28 @@ extern "C"
  * Macro definitions
  ***************************************************************************/
 
+/*驱动未指定时的过滤器数目*/
 #define DMX_FILTER_COUNT      (32)
 
+/*一个设备最多支持的过滤器数目，决定过滤器位屏蔽的宽度*/
+#ifndef DMX_FILTER_MAX_COUNT
+#define DMX_FILTER_MAX_COUNT  (512)
+#endif
+
+#define DMX_FILTER_MASK_WORDS ((DMX_FILTER_MAX_COUNT+31)/32)
+
 #define DMX_FL_RUN_CB         (1)
 
+/*批量读取时一个section的最大长度*/
+#define DMX_SEC_MAX_SIZE      (4096)
+
+/*异步分发工作线程数上限*/
+#define DMX_ASYNC_MAX_WORKERS (8)
+/*缺省异步分发工作线程数*/
+#define DMX_ASYNC_DEF_WORKERS (1)
+/*缺省异步分发队列大小，能放下几次批量读出的数据*/
+#define DMX_ASYNC_DEF_QUEUE_SIZE (256*1024)
+
 /****************************************************************************
  * Type definitions
  ***************************************************************************/
@@ -43,13 +62,65 @@ typedef struct AM_DMX_Device AM_DMX_Device_t;
 /**\brief 过滤器*/
 typedef struct AM_DMX_Filter AM_DMX_Filter_t;
 
+/**\brief 异步分发队列，section按长度+数据的形式存放在环形缓冲区中*/
+typedef struct
+{
+	uint8_t   *buf;      /**< 环形缓冲区*/
+	int        size;     /**< 缓冲区大小*/
+	int        head;     /**< 读位置*/
+	int        bytes;    /**< 已使用的字节数*/
+	int        count;    /**< 队列中的section数*/
+	AM_Bool_t  full;     /**< 上次入队时队列已满*/
+	AM_Bool_t  busy;     /**< 工作线程正在回调此过滤器*/
+	AM_Bool_t  orphan;   /**< 回调过程中队列被释放，由工作线程负责释放*/
+} AM_DMX_SecQueue_t;
+
 /**\brief 过滤器位屏蔽*/
-typedef uint32_t AM_DMX_FilterMask_t;
+typedef struct
+{
+	uint32_t bits[DMX_FILTER_MASK_WORDS];
+} AM_DMX_FilterMask_t;
+
+#define AM_DMX_FILTER_MASK_ISEMPTY(m)    am_dmx_filter_mask_isempty(m)
+#define AM_DMX_FILTER_MASK_CLEAR(m)      memset((m), 0, sizeof(AM_DMX_FilterMask_t))
+#define AM_DMX_FILTER_MASK_ISSET(m,i)    ((m)->bits[(i)>>5]&(1U<<((i)&31)))
+#define AM_DMX_FILTER_MASK_SET(m,i)      ((m)->bits[(i)>>5]|=(1U<<((i)&31)))
+#define AM_DMX_FILTER_MASK_UNSET(m,i)    ((m)->bits[(i)>>5]&=~(1U<<((i)&31)))
+/*返回从i开始的第一个置位的过滤器ID，没有时返回-1*/
+#define AM_DMX_FILTER_MASK_NEXT(m,i)     am_dmx_filter_mask_next(m, i)
+
+static AM_INLINE AM_Bool_t am_dmx_filter_mask_isempty(const AM_DMX_FilterMask_t *m)
+{
+	int i;
+
+	for(i=0; i<DMX_FILTER_MASK_WORDS; i++)
+	{
+		if(m->bits[i])
+			return AM_FALSE;
+	}
+
+	return AM_TRUE;
+}
+
+static AM_INLINE int am_dmx_filter_mask_next(const AM_DMX_FilterMask_t *m, int i)
+{
+	int w = i>>5;
+	uint32_t bits;
+
+	if(i >= DMX_FILTER_MAX_COUNT)
+		return -1;
+
+	bits = m->bits[w] & (0xFFFFFFFFU<<(i&31));
 
-#define AM_DMX_FILTER_MASK_ISEMPTY(m)    (!(*(m)))
-#define AM_DMX_FILTER_MASK_CLEAR(m)      (*(m)=0)
-#define AM_DMX_FILTER_MASK_ISSET(m,i)    (*(m)&(1<<(i)))
-#define AM_DMX_FILTER_MASK_SET(m,i)      (*(m)|=(1<<(i)))
+	while(!bits)
+	{
+		if(++w >= DMX_FILTER_MASK_WORDS)
+			return -1;
+		bits = m->bits[w];
+	}
+
+	return (w<<5) + __builtin_ctz(bits);
+}
 
 /**\brief 解复用设备驱动*/
 typedef struct
@@ -64,7 +135,12 @@ typedef struct
 	AM_ErrorCode_t (*set_buf_size)(AM_DMX_Device_t *dev, AM_DMX_Filter_t *filter, int size);
 	AM_ErrorCode_t (*poll)(AM_DMX_Device_t *dev, AM_DMX_FilterMask_t *mask, int timeout);
 	AM_ErrorCode_t (*read)(AM_DMX_Device_t *dev, AM_DMX_Filter_t *filter, uint8_t *buf, int *size);
+	/*一次读出过滤器中所有可读的数据，section首尾相接存放在buf中*/
+	AM_ErrorCode_t (*read_batch)(AM_DMX_Device_t *dev, AM_DMX_Filter_t *filter, uint8_t *buf, int *size);
 	AM_ErrorCode_t (*set_source)(AM_DMX_Device_t *dev, AM_DMX_Source_t src);
+	AM_ErrorCode_t (*get_reconfig_stats)(AM_DMX_Device_t *dev, AM_DMX_ReconfigStats_t *stats);
+	/*驱动支持的过滤器数目，0表示DMX_FILTER_COUNT*/
+	int filter_count;
 } AM_DMX_Driver_t;
 
 /**\brief Section过滤器*/
@@ -73,9 +149,12 @@ struct AM_DMX_Filter
 	void      *drv_data; /**< 驱动私有数据*/
 	AM_Bool_t  used;     /**< 此Filter是否已经分配*/
 	AM_Bool_t  enable;   /**< 此Filter设备是否使能*/
+	AM_Bool_t  is_pes;   /**< 此Filter是否为PES过滤器*/
 	int        id;       /**< Filter ID*/
 	AM_DMX_DataCb       cb;        /**< 解复用数据回调函数*/
 	void               *user_data; /**< 数据回调函数用户参数*/
+	AM_DMX_SecQueue_t  *queue;     /**< 异步分发队列，NULL表示同步回调*/
+	AM_DMX_FilterStats_t stats;    /**< 分发统计*/
 };
 
 /**\brief 解复用设备*/
@@ -84,7 +163,8 @@ struct AM_DMX_Device
 	int                 dev_no;  /**< 设备号*/
 	const AM_DMX_Driver_t *drv;  /**< 设备驱动*/
 	void               *drv_data;/**< 驱动私有数据*/
-	AM_DMX_Filter_t     filters[DMX_FILTER_COUNT];   /**< 设备中的Filter*/
+	AM_DMX_Filter_t    *filters;      /**< 设备中的Filter*/
+	int                 filter_count; /**< Filter数目*/
 	int                 open_count; /**< 设备已经打开次数*/
 	AM_Bool_t           enable_thread; /**< 数据线程已经运行*/
 	int                 flags;   /**< 线程运行状态控制标志*/
@@ -92,6 +172,14 @@ struct AM_DMX_Device
 	pthread_mutex_t     lock;    /**< 设备保护互斥体*/
 	pthread_cond_t      cond;    /**< 条件变量*/
 	AM_DMX_Source_t     src;     /**< TS输入源*/
+	pthread_mutex_t     async_lock;   /**< 异步分发队列保护互斥体*/
+	pthread_cond_t      async_cond;   /**< 异步分发条件变量*/
+	pthread_t           workers[DMX_ASYNC_MAX_WORKERS]; /**< 异步分发工作线程*/
+	int                 worker_count; /**< 配置的工作线程数，0表示缺省值*/
+	int                 worker_running; /**< 正在运行的工作线程数*/
+	unsigned int        async_cb_seq[DMX_ASYNC_MAX_WORKERS]; /**< 工作线程回调计数，奇数表示正在执行回调*/
+	AM_Bool_t           async_quit;   /**< 工作线程退出标志*/
+	int                 async_next;   /**< 下一个检查的过滤器*/
 };
 
 
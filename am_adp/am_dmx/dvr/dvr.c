@@ -22,6 +22,8 @@
 #include <am_mem.h>
 #include <am_misc.h>
 #include <am_dvr.h>
+#include <am_time.h>
+#include <am_crc.h>
 #include "../am_dmx_internal.h"
 #include <limits.h>
 #include <sys/types.h>
@@ -53,8 +55,15 @@ struct DVR_Channel_s
 	int          size;
 	int          cc;
 	AM_Bool_t    is_sec;
+	int          fd;             /**< 录制此PID的demux句柄*/
+	int16_t      tid_head[256];  /**< 按table_id分组的过滤器链表头*/
+	int          any_head;       /**< 不限定table_id的过滤器链表头*/
 };
 
+/*过滤字节 filter[0]对应section字节0, filter[i](i>0)对应section字节i+2,
+ *编译为两个64位字进行比较*/
+#define DVR_SEC_KEY_WORDS  (DMX_FILTER_SIZE/8)
+
 struct DVR_Filter_s
 {
 	AM_Bool_t    used;
@@ -62,23 +71,34 @@ struct DVR_Filter_s
 	AM_DMX_Filter_t *dmx_filter;
 	DVR_Channel *chan;
 	int          pid;
-	uint8_t      filter[DMX_FILTER_SIZE];
-	uint8_t      maskandmode[DMX_FILTER_SIZE];
-	uint8_t      maskandnotmode[DMX_FILTER_SIZE];
+	uint64_t     value[DVR_SEC_KEY_WORDS];
+	uint64_t     maskandmode[DVR_SEC_KEY_WORDS];
+	uint64_t     maskandnotmode[DVR_SEC_KEY_WORDS];
+	AM_Bool_t    neq;       /**< 存在不等匹配条件*/
+	AM_Bool_t    check_crc; /**< 无section_syntax_indicator时也校验CRC*/
+	int          tid;       /**< 精确匹配的table_id, -1表示任意*/
+	int          next;      /**< 同组中下一个过滤器索引*/
 };
 
-#define DVR_CHANNEL_COUNT 32
-#define DVR_FILTER_COUNT  32
-#define DVR_PID_COUNT     32
+/*软件过滤不受硬件过滤器数目限制*/
+#define DVR_CHANNEL_COUNT 64
+#define DVR_FILTER_COUNT  256
+
+#define DVR_TS_PKT_SIZE   188
+#define DVR_TS_SYNC_BYTE  0x47
+#define DVR_PID_MAP_SIZE  8192
 
 typedef struct{
 	uint8_t      buf[256*1024];
 	size_t       start;
+	DVR_Channel *pid_map[DVR_PID_MAP_SIZE]; /**< PID到通道的查找表*/
 	DVR_Channel  dvr_channels[DVR_CHANNEL_COUNT];
 	DVR_Filter   dvr_filters[DVR_FILTER_COUNT];
 	int          dvr_fd;
-	int          dmx_fds[DVR_PID_COUNT];
-	int          dmx_cnt;
+	int          tap_fd;     /**< 通过DMX_ADD_PID录制多个PID的demux句柄*/
+	int          tap_pids;   /**< tap_fd上的PID数目*/
+	AM_Bool_t    add_pid_ok; /**< 驱动是否支持DMX_ADD_PID*/
+	AM_DMX_ReconfigStats_t stats;
 }DVR_Demux;
 
 /****************************************************************************
@@ -96,6 +116,7 @@ static AM_ErrorCode_t dvr_set_buf_size(AM_DMX_Device_t *dev, AM_DMX_Filter_t *fi
 static AM_ErrorCode_t dvr_poll(AM_DMX_Device_t *dev, AM_DMX_FilterMask_t *mask, int timeout);
 static AM_ErrorCode_t dvr_read(AM_DMX_Device_t *dev, AM_DMX_Filter_t *filter, uint8_t *buf, int *size);
 static AM_ErrorCode_t dvr_set_source(AM_DMX_Device_t *dev, AM_DMX_Source_t src);
+static AM_ErrorCode_t dvr_get_reconfig_stats(AM_DMX_Device_t *dev, AM_DMX_ReconfigStats_t *stats);
 
 const AM_DMX_Driver_t dvr_dmx_drv = {
 .open  = dvr_open,
@@ -108,7 +129,9 @@ const AM_DMX_Driver_t dvr_dmx_drv = {
 .set_buf_size   = dvr_set_buf_size,
 .poll           = dvr_poll,
 .read           = dvr_read,
-.set_source     = dvr_set_source
+.set_source     = dvr_set_source,
+.get_reconfig_stats = dvr_get_reconfig_stats,
+.filter_count   = DVR_FILTER_COUNT
 };
 
 
@@ -158,6 +181,8 @@ static AM_ErrorCode_t dvr_open(AM_DMX_Device_t *dev, const AM_DMX_OpenPara_t *pa
 
 	memset(dmx, 0, sizeof(DVR_Demux));
 	dmx->dvr_fd = fd;
+	dmx->tap_fd = -1;
+	dmx->add_pid_ok = AM_TRUE;
 	dev->drv_data = dmx;
 
 	AM_DEBUG(1, "open DVR demux");
@@ -171,10 +196,16 @@ static AM_ErrorCode_t dvr_close(AM_DMX_Device_t *dev)
 	int i;
 
 	AM_DEBUG(1, "try to close DVR demux");
-	for(i=0; i<DVR_PID_COUNT; i++){
-		close(dmx->dmx_fds[i]);
+	for(i=0; i<DVR_CHANNEL_COUNT; i++){
+		DVR_Channel *ch = &dmx->dvr_channels[i];
+
+		if(ch->used && (ch->fd != -1) && (ch->fd != dmx->tap_fd))
+			close(ch->fd);
 	}
 
+	if(dmx->tap_fd != -1)
+		close(dmx->tap_fd);
+
 	close(dmx->dvr_fd);
 	free(dmx);
 
@@ -203,6 +234,13 @@ static AM_ErrorCode_t dvr_alloc_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *fi
 	f->dmx_filter = filter;
 	f->sec_filter = AM_TRUE;
 	f->pid  = 0x1FFF;
+	f->chan = NULL;
+	f->tid  = -1;
+	f->neq  = AM_FALSE;
+	f->check_crc = AM_FALSE;
+	memset(f->value, 0, sizeof(f->value));
+	memset(f->maskandmode, 0, sizeof(f->maskandmode));
+	memset(f->maskandnotmode, 0, sizeof(f->maskandnotmode));
 
 	filter->drv_data = f;
 
@@ -225,6 +263,7 @@ static AM_ErrorCode_t dvr_set_sec_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *
 	DVR_Demux *dmx = (DVR_Demux*)dev->drv_data;
 	DVR_Filter *f = (DVR_Filter*)filter->drv_data;
 	AM_Bool_t enable = filter->enable;
+	uint8_t value[DMX_FILTER_SIZE], mam[DMX_FILTER_SIZE], manm[DMX_FILTER_SIZE];
 	int i;
 
 	if(enable){
@@ -233,25 +272,32 @@ static AM_ErrorCode_t dvr_set_sec_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *
 
 	f->sec_filter = AM_TRUE;
 	f->pid = params->pid;
+	f->neq = AM_FALSE;
+	f->check_crc = (params->flags & DMX_CHECK_CRC) ? AM_TRUE : AM_FALSE;
 
 	for(i=0; i<DMX_FILTER_SIZE; i++){
 		uint8_t mode, mask;
 
-		if((i == 1) || (i == 2)){
-			f->filter[i] = 0;
-			f->maskandmode[i] = 0;
-			f->maskandnotmode[i] = 0;
-			continue;
-		}
-
 		mask = params->filter.mask[i];
 		mode = ~params->filter.mode[i];
 
-		f->filter[i] = params->filter.filter[i];
-		f->maskandmode[i] = mask & mode;
-		f->maskandnotmode[i] = mask & ~mode;
+		value[i] = params->filter.filter[i];
+		mam[i]   = mask & mode;
+		manm[i]  = mask & ~mode;
+
+		if(manm[i])
+			f->neq = AM_TRUE;
 	}
 
+	memcpy(f->value, value, sizeof(value));
+	memcpy(f->maskandmode, mam, sizeof(mam));
+	memcpy(f->maskandnotmode, manm, sizeof(manm));
+
+	if((mam[0] == 0xFF) && !manm[0])
+		f->tid = value[0];
+	else
+		f->tid = -1;
+
 	if(enable){
 		dvr_enable_filter(dev, filter, AM_TRUE);
 	}
@@ -272,6 +318,7 @@ static AM_ErrorCode_t dvr_set_pes_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *
 
 	f->sec_filter = AM_FALSE;
 	f->pid = params->pid;
+	f->tid = -1;
 
 	if(enable){
 		dvr_enable_filter(dev, filter, AM_TRUE);
@@ -280,6 +327,32 @@ static AM_ErrorCode_t dvr_set_pes_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *
 	return AM_SUCCESS;
 }
 
+/**\brief 重建通道的过滤器分组，各组内按过滤器索引升序排列*/
+static void dvr_compile_channel(DVR_Demux *dmx, DVR_Channel *ch)
+{
+	DVR_Filter *f;
+	int i;
+
+	for(i=0; i<256; i++)
+		ch->tid_head[i] = -1;
+	ch->any_head = -1;
+
+	for(i=DVR_FILTER_COUNT-1; i>=0; i--){
+		f = &dmx->dvr_filters[i];
+
+		if(!f->used || f->chan!=ch)
+			continue;
+
+		if(f->tid >= 0){
+			f->next = ch->tid_head[f->tid];
+			ch->tid_head[f->tid] = i;
+		}else{
+			f->next = ch->any_head;
+			ch->any_head = i;
+		}
+	}
+}
+
 static DVR_Channel* dvr_find_channel(DVR_Demux *dmx, int pid, AM_Bool_t is_sec)
 {
 	DVR_Channel *ch;
@@ -304,7 +377,11 @@ static DVR_Channel* dvr_find_channel(DVR_Demux *dmx, int pid, AM_Bool_t is_sec)
 			ch->is_sec = is_sec;
 			ch->pid = pid;
 			ch->cc  = -1;
+			ch->size = 0;
+			ch->fd  = -1;
 			ch->filters = NULL;
+			if(pid < DVR_PID_MAP_SIZE)
+				dmx->pid_map[pid] = ch;
 			return ch;
 		}
 	}
@@ -312,6 +389,110 @@ static DVR_Channel* dvr_find_channel(DVR_Demux *dmx, int pid, AM_Bool_t is_sec)
 	return NULL;
 }
 
+/**\brief 打开一个demux句柄并开始录制指定PID*/
+static int dvr_hw_open_pid(AM_DMX_Device_t *dev, int pid)
+{
+	DVR_Demux *dmx = (DVR_Demux*)dev->drv_data;
+	struct dmx_pes_filter_params pparam;
+	char name[64];
+	int fd, r;
+
+	snprintf(name, sizeof(name), "/dev/dvb0.demux%d", dev->dev_no);
+
+	fd = open(name, O_RDONLY);
+	dmx->stats.reconfig_ops++;
+	if(fd==-1){
+		AM_DEBUG(1, "cannot open %s", name);
+		return -1;
+	}
+
+	memset(&pparam, 0, sizeof(pparam));
+	pparam.pid = pid;
+	pparam.input = DMX_IN_FRONTEND;
+	pparam.output = DMX_OUT_TS_TAP;
+	pparam.pes_type = DMX_PES_OTHER;
+
+	r = ioctl(fd, DMX_SET_PES_FILTER, &pparam);
+	dmx->stats.reconfig_ops++;
+	if(r==-1){
+		AM_DEBUG(1, "DMX_SET_PES_FILTER failed");
+	}
+
+	r = ioctl(fd, DMX_START);
+	dmx->stats.reconfig_ops++;
+	if(r==-1){
+		AM_DEBUG(1, "DMX_START failed");
+	}
+
+	return fd;
+}
+
+/**\brief 在硬件中加入一个通道的PID，其他已录制的PID不受影响*/
+static void dvr_hw_add_pid(AM_DMX_Device_t *dev, DVR_Channel *ch)
+{
+	DVR_Demux *dmx = (DVR_Demux*)dev->drv_data;
+
+	if(dmx->add_pid_ok && (dmx->tap_fd != -1)){
+		uint16_t pid = ch->pid;
+		int r;
+
+		r = ioctl(dmx->tap_fd, DMX_ADD_PID, &pid);
+		dmx->stats.reconfig_ops++;
+		if(r != -1){
+			AM_DEBUG(1, "dvr add pid %d", ch->pid);
+			ch->fd = dmx->tap_fd;
+			dmx->tap_pids++;
+			return;
+		}
+
+		AM_DEBUG(1, "DMX_ADD_PID not supported (%s), use one handle per pid", strerror(errno));
+		dmx->add_pid_ok = AM_FALSE;
+	}
+
+	ch->fd = dvr_hw_open_pid(dev, ch->pid);
+	if(ch->fd == -1)
+		return;
+
+	AM_DEBUG(1, "dvr record pid %d", ch->pid);
+
+	if(dmx->add_pid_ok && (dmx->tap_fd == -1)){
+		dmx->tap_fd = ch->fd;
+		dmx->tap_pids = 1;
+	}
+}
+
+/**\brief 从硬件中移除一个通道的PID，其他已录制的PID不受影响*/
+static void dvr_hw_remove_pid(AM_DMX_Device_t *dev, DVR_Channel *ch)
+{
+	DVR_Demux *dmx = (DVR_Demux*)dev->drv_data;
+
+	if(ch->fd == -1)
+		return;
+
+	if(ch->fd == dmx->tap_fd){
+		if(dmx->tap_pids > 1){
+			uint16_t pid = ch->pid;
+
+			if(ioctl(dmx->tap_fd, DMX_REMOVE_PID, &pid) == -1){
+				AM_DEBUG(1, "DMX_REMOVE_PID %d failed (%s)", ch->pid, strerror(errno));
+			}
+			dmx->stats.reconfig_ops++;
+			dmx->tap_pids--;
+			ch->fd = -1;
+			return;
+		}
+
+		dmx->tap_fd = -1;
+		dmx->tap_pids = 0;
+	}
+
+	close(ch->fd);
+	dmx->stats.reconfig_ops++;
+	ch->fd = -1;
+
+	AM_DEBUG(1, "dvr stop pid %d", ch->pid);
+}
+
 static AM_ErrorCode_t dvr_enable_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *filter, AM_Bool_t enable)
 {
 	DVR_Demux *dmx = (DVR_Demux*)dev->drv_data;
@@ -330,6 +511,8 @@ static AM_ErrorCode_t dvr_enable_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *f
 		}
 
 		f->chan = ch;
+		if(!ch->filters)
+			ch->filters = f;
 
 		if(ch->used == 1)
 			reset = AM_TRUE;
@@ -337,57 +520,47 @@ static AM_ErrorCode_t dvr_enable_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *f
 		ch = f->chan;
 
 		ch->used--;
+		f->chan = NULL;
 
-		if(ch->used == 0)
-			reset = AM_TRUE;
-	}
-
-	if(reset){
-		char name[64];
-		struct dmx_pes_filter_params pparam;
-		int i;
+		/*通道上还有其他过滤器时改用其中一个接收PES数据*/
+		if(ch->filters == f){
+			int i;
 
-		for(i=0; i<dmx->dmx_cnt; i++){
-			close(dmx->dmx_fds[i]);
+			ch->filters = NULL;
+			for(i=0; i<DVR_FILTER_COUNT; i++){
+				if(dmx->dvr_filters[i].used && (dmx->dvr_filters[i].chan == ch)){
+					ch->filters = &dmx->dvr_filters[i];
+					break;
+				}
+			}
 		}
-		dmx->dmx_cnt = 0;
 
-		snprintf(name, sizeof(name), "/dev/dvb0.demux%d", dev->dev_no);
+		if(ch->used == 0){
+			if(ch->pid < DVR_PID_MAP_SIZE)
+				dmx->pid_map[ch->pid] = NULL;
+			reset = AM_TRUE;
+		}
+	}
 
-		for(i=0; i<DVR_CHANNEL_COUNT; i++){
-			ch = &dmx->dvr_channels[i];
-			if(ch->used){
-				int fd;
-				int r;
+	dvr_compile_channel(dmx, ch);
 
-				fd = open(name, O_RDONLY);
-				if(fd==-1){
-					AM_DEBUG(1, "cannot open %s", name);
-					continue;
-				}
+	if(reset){
+		struct timespec begin, end;
 
-				memset(&pparam, 0, sizeof(pparam));
-				pparam.pid = ch->pid;
-				pparam.input = DMX_IN_FRONTEND;
-				pparam.output = DMX_OUT_TS_TAP;
-				pparam.pes_type = DMX_PES_OTHER;
+		AM_TIME_GetTimeSpec(&begin);
 
-				r = ioctl(fd, DMX_SET_PES_FILTER, &pparam);
-				if(r==-1){
-					AM_DEBUG(1, "DMX_SET_PES_FILTER failed");
-				}
+		if(enable)
+			dvr_hw_add_pid(dev, ch);
+		else
+			dvr_hw_remove_pid(dev, ch);
 
-				r = ioctl(fd, DMX_START);
-				if(r==-1){
-					AM_DEBUG(1, "DMX_START failed");
-				}
+		AM_TIME_GetTimeSpec(&end);
 
-				AM_DEBUG(1, "dvr record pid %d", ch->pid);
-				dmx->dmx_fds[dmx->dmx_cnt++] = fd;
-			}
-		}
+		dmx->stats.reconfig_count++;
+		dmx->stats.reconfig_time_us += (end.tv_sec - begin.tv_sec) * 1000000LL +
+				(end.tv_nsec - begin.tv_nsec) / 1000;
 	}
-	
+
 	return AM_SUCCESS;
 }
 
@@ -414,14 +587,94 @@ static void data_cb(AM_DMX_Device_t *dev, AM_DMX_Filter_t *filter, uint8_t *data
 	pthread_mutex_lock(&dev->lock);
 }
 
-static int check_sec(AM_DMX_Device_t *dev, DVR_Channel *ch, uint8_t *data, int left)
+/**\brief 取出section中参与过滤的字节，生成比较字*/
+static void dvr_sec_key(const uint8_t *sec, int len, uint64_t *key)
+{
+	uint8_t b[DMX_FILTER_SIZE];
+	int n = AM_MIN(len - 3, DMX_FILTER_SIZE - 1);
+
+	memset(b, 0, sizeof(b));
+	b[0] = sec[0];
+	if(n > 0)
+		memcpy(b + 1, sec + 3, n);
+
+	memcpy(key, b, sizeof(b));
+}
+
+static AM_INLINE AM_Bool_t dvr_filter_match(DVR_Filter *f, const uint64_t *key)
+{
+	uint64_t eq = 0, neq = 0;
+	int i;
+
+	for(i=0; i<DVR_SEC_KEY_WORDS; i++){
+		uint64_t xor = key[i] ^ f->value[i];
+
+		eq  |= xor & f->maskandmode[i];
+		neq |= xor & f->maskandnotmode[i];
+	}
+
+	if(eq)
+		return AM_FALSE;
+
+	if(f->neq && !neq)
+		return AM_FALSE;
+
+	return AM_TRUE;
+}
+
+/**\brief 将完整的section交给第一个匹配的过滤器*/
+static void dvr_sec_dispatch(AM_DMX_Device_t *dev, DVR_Channel *ch)
 {
 	DVR_Demux *dmx = (DVR_Demux*)dev->drv_data;
+	uint64_t key[DVR_SEC_KEY_WORDS];
+	int crc_state = -1;
+	int a, b, fid;
+	DVR_Filter *f;
+
+	a = ch->tid_head[ch->buf[0]];
+	b = ch->any_head;
+	if((a < 0) && (b < 0))
+		return;
+
+	dvr_sec_key(ch->buf, ch->size, key);
+
+	while((a >= 0) || (b >= 0)){
+		if((b < 0) || ((a >= 0) && (a < b))){
+			fid = a;
+			a = dmx->dvr_filters[a].next;
+		}else{
+			fid = b;
+			b = dmx->dvr_filters[b].next;
+		}
+
+		f = &dmx->dvr_filters[fid];
+
+		if(!dvr_filter_match(f, key))
+			continue;
+
+		if((ch->buf[1] & 0x80) || f->check_crc){
+			if(crc_state < 0)
+				crc_state = AM_CRC32_CheckSection(ch->buf, ch->size);
+
+			if(!crc_state){
+				AM_DEBUG(1, "section CRC error, pid %d table_id 0x%02x", ch->pid, ch->buf[0]);
+				return;
+			}
+		}
+
+		data_cb(dev, f->dmx_filter, ch->buf, ch->size);
+		return;
+	}
+}
+
+static int check_sec(AM_DMX_Device_t *dev, DVR_Channel *ch, uint8_t *data, int left)
+{
 	int slen;
 	int cpy, ret=0;
 
 	if(ch->size + left < 3){
 		memcpy(ch->buf+ch->size, data, left);
+		ch->size += left;
 		return left;
 	}
 
@@ -435,6 +688,12 @@ static int check_sec(AM_DMX_Device_t *dev, DVR_Channel *ch, uint8_t *data, int l
 	}
 
 	slen = (((ch->buf[1]<<8)|ch->buf[2])&0xFFF) + 3;
+	if(slen > (int)sizeof(ch->buf)){
+		AM_DEBUG(1, "invalid section length %d", slen);
+		ch->size = 0;
+		return ret + left;
+	}
+
 	cpy = AM_MIN(slen - ch->size, left);
 	if(cpy){
 		memcpy(ch->buf+ch->size, data, cpy);
@@ -443,43 +702,7 @@ static int check_sec(AM_DMX_Device_t *dev, DVR_Channel *ch, uint8_t *data, int l
 	}
 
 	if(slen==ch->size){
-		int fid;
-		DVR_Filter *f;
-
-		for(fid=0; fid<DVR_FILTER_COUNT; fid++){
-			AM_Bool_t match = AM_TRUE;
-			AM_Bool_t check_neq = AM_FALSE, neq = AM_FALSE;
-			int i;
-
-			f = &dmx->dvr_filters[fid];
-
-			if(!f->used || f->chan!=ch)
-				continue;
-
-			for(i=0; i<DMX_FILTER_SIZE; i++){
-				uint8_t xor = ch->buf[i]^f->filter[i];
-
-				if(xor & f->maskandmode[i]){
-					match = AM_FALSE;
-					break;
-				}
-
-				if(f->maskandnotmode[i])
-					check_neq = AM_TRUE;
-
-				if(xor & f->maskandnotmode[i])
-					neq = AM_TRUE;
-			}
-
-			if(match && check_neq && !neq)
-				match = AM_FALSE;
-
-			if(match){
-				data_cb(dev, f->dmx_filter, ch->buf, ch->size);
-				break;
-			}
-		}
-
+		dvr_sec_dispatch(dev, ch);
 		ch->size = 0;
 	}
 
@@ -523,93 +746,120 @@ static void parse_pes(AM_DMX_Device_t *dev, DVR_Channel *ch, uint8_t *data, int
 {
 	AM_DMX_Filter_t *filter;
 
+	if(!ch->filters)
+		return;
+
 	filter = ch->filters->dmx_filter;
 	data_cb(dev, filter, data, left);
 }
 
-static int parse_ts_packet(AM_DMX_Device_t *dev, uint8_t *buf, int left)
+/**\brief 查找下一个TS包起始位置，要求下一个包的同步字节也正确*/
+static int dvr_ts_resync(uint8_t *buf, int left)
 {
-	uint8_t *p = buf;
-	int off;
-	int pid, error, cc, ap_flags, s_flags, p_start;
+	uint8_t *p;
+	int off = 0;
 
-	for(off=0; off<left; off++){
-		if(p[off] == 0x47)
-			break;
-	}
+	while(off < left){
+		p = memchr(buf+off, DVR_TS_SYNC_BYTE, left-off);
+		if(!p)
+			return left;
+
+		off = p - buf;
+
+		/*数据不足以确认下一个同步字节，等待后续数据*/
+		if(off + DVR_TS_PKT_SIZE >= left)
+			return off;
 
-	if(off){
-		AM_DEBUG(1, "skip %d bytes", off);
-		p += off;
-		left -= off;
+		if(buf[off+DVR_TS_PKT_SIZE] == DVR_TS_SYNC_BYTE)
+			return off;
+
+		off++;
 	}
 
-	if(left < 188)
-		return off;
+	return left;
+}
+
+static void parse_ts_packet(AM_DMX_Device_t *dev, DVR_Channel *ch, uint8_t *p)
+{
+	int error, cc, ap_flags, s_flags, p_start;
+	uint8_t *payload;
+	int plen;
 
-	pid     = ((p[1]<<8)|p[2])&0x1FFF;
 	error   = p[1]&0x80;
 	p_start = p[1]&0x40;
 	s_flags = p[3]&0xC0;
 	ap_flags= p[3]&0x30;
 	cc      = p[3]&0x0F;
 
-	if((pid!=0x1FFF) && !s_flags && !error && (ap_flags&0x10)){
-		DVR_Demux *dmx = (DVR_Demux*)dev->drv_data;
-		int i;
-		DVR_Channel *ch;
-
-		pthread_mutex_lock(&dev->lock);
+	if(s_flags || error || !(ap_flags&0x10))
+		return;
 
-		for(i=0; i<DVR_CHANNEL_COUNT; i++){
-			ch = &dmx->dvr_channels[i];
-
-			if(ch->used && ch->pid==pid)
-				break;
+	if(ch->cc >= 0){
+		if(((ch->cc+1)&0x0F) != cc){
+			AM_DEBUG(1, "TS packet discontinue");
 		}
+	}
 
-		if(i<DVR_CHANNEL_COUNT){
-			uint8_t *payload;
-			int plen;
+	payload = p+4;
+	plen = DVR_TS_PKT_SIZE-4;
 
-			if(ch->cc >= 0){
-				int ecc;
+	if(ap_flags & 0x20){
+		int alen = payload[0] + 1;
 
-				if(ap_flags & 0x10){
-					ecc = (ch->cc+1)&0x0F;
-				}else{
-					ecc = ch->cc;
-				}
-				if(ecc != cc){
-					AM_DEBUG(1, "TS packet discontinue");
-				}
-			}
+		payload += alen;
+		plen -= alen;
+	}
 
-			payload = p+4;
-			plen = 188-4;
+	if(plen > 0){
+		if(ch->is_sec){
+			parse_sec(dev, ch, payload, plen, p_start);
+		}else{
+			parse_pes(dev, ch, payload, plen);
+		}
+	}
 
-			if(ap_flags & 0x20){
-				int alen = payload[0] + 1;
+	ch->cc = cc;
+}
 
-				payload += alen;
-				plen -= alen;
-			}
+/**\brief 解析一批TS数据，整批只加锁一次，返回已处理的字节数*/
+static int parse_ts_batch(AM_DMX_Device_t *dev, uint8_t *buf, int left)
+{
+	DVR_Demux *dmx = (DVR_Demux*)dev->drv_data;
+	uint8_t *p = buf;
 
-			if(plen > 0){
-				if(ch->is_sec){
-					parse_sec(dev, ch, payload, plen, p_start);
-				}else{
-					parse_pes(dev, ch, payload, plen);
-				}
-			}
+	pthread_mutex_lock(&dev->lock);
 
-			ch->cc = cc;
+	while(left >= DVR_TS_PKT_SIZE){
+		DVR_Channel *ch;
+		int pid;
+
+		/*以包长为步长校验同步字节，能看到下一包时同时校验下一包*/
+		if((p[0] != DVR_TS_SYNC_BYTE) ||
+				((left > DVR_TS_PKT_SIZE) && (p[DVR_TS_PKT_SIZE] != DVR_TS_SYNC_BYTE))){
+			int off = dvr_ts_resync(p, left);
+
+			AM_DEBUG(1, "skip %d bytes", off);
+			p += off;
+			left -= off;
+			/*同步字节尚未被确认，留到下次读取后处理*/
+			if(left <= DVR_TS_PKT_SIZE)
+				break;
+			continue;
 		}
 
-		pthread_mutex_unlock(&dev->lock);
+		pid = ((p[1]<<8)|p[2])&0x1FFF;
+		ch  = dmx->pid_map[pid];
+
+		if(ch && (pid != 0x1FFF))
+			parse_ts_packet(dev, ch, p);
+
+		p += DVR_TS_PKT_SIZE;
+		left -= DVR_TS_PKT_SIZE;
 	}
 
-	return off + 188;
+	pthread_mutex_unlock(&dev->lock);
+
+	return p - buf;
 }
 
 static AM_ErrorCode_t dvr_poll(AM_DMX_Device_t *dev, AM_DMX_FilterMask_t *mask, int timeout)
@@ -631,19 +881,13 @@ static AM_ErrorCode_t dvr_poll(AM_DMX_Device_t *dev, AM_DMX_FilterMask_t *mask,
 
 	ret = read(dmx->dvr_fd, dmx->buf+dmx->start, sizeof(dmx->buf)-dmx->start);
 	if(ret > 0){
-		uint8_t *data = dmx->buf;
 		int total = ret + dmx->start;
-		int left = total;
-		int cnt;
+		int left;
 
 		//AM_DEBUG(1, "read DVR %d bytes", ret);
 
-		do{
-			cnt = parse_ts_packet(dev, data, left);
-			data += cnt;
-			left -= cnt;
-		}while(cnt && left);
-		
+		left = total - parse_ts_batch(dev, dmx->buf, total);
+
 		if(left)
 			memmove(dmx->buf, dmx->buf + total - left, left);
 
@@ -663,6 +907,15 @@ static AM_ErrorCode_t dvr_read(AM_DMX_Device_t *dev, AM_DMX_Filter_t *filter, ui
 	return AM_SUCCESS;
 }
 
+static AM_ErrorCode_t dvr_get_reconfig_stats(AM_DMX_Device_t *dev, AM_DMX_ReconfigStats_t *stats)
+{
+	DVR_Demux *dmx = (DVR_Demux*)dev->drv_data;
+
+	*stats = dmx->stats;
+
+	return AM_SUCCESS;
+}
+
 static AM_ErrorCode_t dvr_set_source(AM_DMX_Device_t *dev, AM_DMX_Source_t src)
 {
 	char buf[32];
@@ -27,6 +27,10 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <limits.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "../am_dmx_internal.h"
 
 /****************************************************************************
@@ -35,6 +39,11 @@
 
 #define FILTER_BUF_SIZE        (4096+4)
 #define PARSER_BUF_SIZE        (512*1024)
+#define EMU_FILTER_COUNT       (256)
+#define PID_MAP_SIZE           (8192)
+/*限速时每次解析的数据对应的时间(毫秒)*/
+#define PARSER_PACE_MS         (10)
+#define PARSER_MIN_CHUNK       (204*8)
  
 /****************************************************************************
  * Type definitions
@@ -95,18 +104,35 @@ struct Channel {
 	int            offset;
 };
 
+/**\brief Input rate mode*/
+typedef enum {
+	RATE_MODE_ESTIMATE, /**< Estimate the rate from PTS*/
+	RATE_MODE_FIXED,    /**< Fixed bitrate set by AM_TSFILE_BITRATE*/
+	RATE_MODE_FAST      /**< As fast as possible*/
+} RateMode_t;
+
 /**\brief TS parser*/
 typedef struct {
 	Channel_t *channels;
 	Filter_t  *filters;
+	Channel_t *pid_map[PID_MAP_SIZE];     /**< PID to channel lookup table*/
+	uint16_t   pid_filters[PID_MAP_SIZE]; /**< Enabled filter count of each PID*/
 	char       fname[PATH_MAX];
 	FILE      *fp;
 	uint8_t    buf[PARSER_BUF_SIZE];
+	uint8_t   *data;     /**< Data being parsed, points to buf or the mapped file*/
+	uint8_t   *map;      /**< The mapped TS file*/
+	size_t     map_size;
+	size_t     map_pos;
+	int        base;     /**< File offset of data[0]*/
 	int        bytes;
 	int        parsed;
 	int        packet_len;
 	int        start_time;
 	int        rate;
+	RateMode_t rate_mode;
+	int        fixed_rate; /**< Rate set by AM_TSFILE_BITRATE (bytes/s)*/
+	uint64_t   deadline; /**< Output time of the next chunk (ns)*/
 	pthread_t  thread;
 	pthread_mutex_t lock;
 	pthread_cond_t  cond;
@@ -140,7 +166,8 @@ const AM_DMX_Driver_t emu_dmx_drv = {
 .set_buf_size   = emu_set_buf_size,
 .poll  = emu_poll,
 .read  = emu_read,
-.set_source     = emu_set_source
+.set_source     = emu_set_source,
+.filter_count   = EMU_FILTER_COUNT
 };
 
 /****************************************************************************
@@ -178,16 +205,10 @@ static void parser_reset(TSParser_t *parser)
 /**\brief Get the channel in the parser*/
 static Channel_t* parser_get_chan(TSParser_t *parser, uint16_t pid)
 {
-	Channel_t *chan = NULL;
+	Channel_t *chan = parser->pid_map[pid];
 	
-	if(parser->channels)
-	{
-		for(chan=parser->channels; chan; chan=chan->next)
-		{
-			if(chan->pid==pid)
-				return chan;
-		}
-	}
+	if(chan)
+		return chan;
 	
 	chan = (Channel_t*)malloc(sizeof(Channel_t));
 	if(!chan)
@@ -214,9 +235,23 @@ static Channel_t* parser_get_chan(TSParser_t *parser, uint16_t pid)
 		parser->channels = chan;
 	}
 	
+	parser->pid_map[pid] = chan;
+	
 	return chan;
 }
 
+/**\brief Update the enabled filter count of the PID*/
+static void parser_ref_pid(TSParser_t *parser, uint16_t pid, int delta)
+{
+	pid &= 0x1FFF;
+	
+	/*Packets of this PID may have been skipped, restart the channel*/
+	if(!parser->pid_filters[pid] && (delta>0) && parser->pid_map[pid])
+		chan_reset(parser->pid_map[pid]);
+	
+	parser->pid_filters[pid] += delta;
+}
+
 /**\brief Parse the PTS from the PES header*/
 static int parse_pts(uint8_t *buf, uint64_t *pts)
 {
@@ -281,7 +316,7 @@ static int parse_payload(TSParser_t *parser, Channel_t *chan, uint8_t *ptr, int
 		
 		if(parse_pts(chan->buf, &pts)>=0)
 		{
-			int offset = ftell(parser->fp)-parser->bytes+parser->parsed;
+			int offset = parser->base+parser->parsed;
 			if(chan->pts)
 			{
 				parser->rate = ((uint64_t)(offset-chan->offset))*1000/((pts-chan->pts)/90);
@@ -345,6 +380,7 @@ retry:
 						memcpy(f->buf, chan->buf+cnt, cnt2);
 					}
 					
+					f->bytes += len;
 					pthread_cond_broadcast(&parser->cond);
 				}
 				chan->bytes = 0;
@@ -456,14 +492,16 @@ static int parse_ts_packet(TSParser_t *parser)
 	Channel_t *chan;
 	
 	/*Scan the sync byte*/
-	while(parser->buf[p]!=0x47)
+	if(parser->data[p]!=0x47)
 	{
-		p++;
-		if(p>=parser->bytes)
+		uint8_t *sync = memchr(parser->data+p, 0x47, parser->bytes-p);
+		
+		if(!sync)
 		{
 			parser->parsed = parser->bytes;
 			return 0;
 		}
+		p = sync-parser->data;
 	}
 	
 	if(p!=parser->parsed)
@@ -476,14 +514,14 @@ static int parse_ts_packet(TSParser_t *parser)
 	{
 		if(parser->bytes-p>188)
 		{
-			if(parser->buf[p+188]==0x47)
+			if(parser->data[p+188]==0x47)
 			{
 				parser->packet_len = 188;
 			}
 		}
 		if(!parser->packet_len && (parser->bytes-p>204))
 		{
-			if(parser->buf[p+204]==0x47)
+			if(parser->data[p+204]==0x47)
 			{
 				parser->packet_len = 204;
 			}
@@ -502,7 +540,7 @@ static int parse_ts_packet(TSParser_t *parser)
 	if(parser->bytes-p<parser->packet_len)
 		return 0;
 	
-	ptr = &parser->buf[p];
+	ptr = &parser->data[p];
 	tei = ptr[1]&0x80;
 	ts_start = ptr[1]&0x40;
 	pid = ((ptr[1]<<8)|ptr[2])&0x1FFF;
@@ -514,6 +552,10 @@ static int parse_ts_packet(TSParser_t *parser)
 	if(pid==0x1FFF)
 		goto end;
 	
+	/*Only the rate estimation needs the PIDs without filter*/
+	if(!parser->pid_filters[pid] && (parser->rate_mode!=RATE_MODE_ESTIMATE))
+		goto end;
+	
 	if(tei)
 	{
 		AM_DEBUG(3, "ts error");
@@ -553,136 +595,280 @@ end:
 	return 1;
 }
 
+/**\brief Unmap or close the current TS file*/
+static void parser_close_file(TSParser_t *parser)
+{
+	if(parser->map)
+	{
+		munmap(parser->map, parser->map_size);
+		parser->map = NULL;
+	}
+
+	if(parser->fp)
+	{
+		fclose(parser->fp);
+		parser->fp = NULL;
+	}
+}
+
+/**\brief Open the TS file, map it into memory if possible*/
+static void parser_open_file(TSParser_t *parser, const char *fname)
+{
+	struct stat st;
+
+	parser->fp = fopen(fname, "r");
+	if(!parser->fp)
+	{
+		AM_DEBUG(2, "cannot open \"%s\"", fname);
+		return;
+	}
+
+	parser->map = NULL;
+	parser->map_pos = 0;
+
+	if(!fstat(fileno(parser->fp), &st) && S_ISREG(st.st_mode) && (st.st_size>0))
+	{
+		void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(parser->fp), 0);
+
+		if(map!=MAP_FAILED)
+		{
+			madvise(map, st.st_size, MADV_SEQUENTIAL);
+			parser->map = (uint8_t*)map;
+			parser->map_size = st.st_size;
+		}
+	}
+
+	AM_DEBUG(2, "switch to ts file \"%s\"%s", fname, parser->map ? " (mmap)" : "");
+}
+
+/**\brief Get the input rate mode from AM_TSFILE_BITRATE*/
+static void parser_get_rate_mode(TSParser_t *parser)
+{
+	char *env = getenv("AM_TSFILE_BITRATE");
+
+	if(!env)
+	{
+		parser->rate_mode = RATE_MODE_ESTIMATE;
+	}
+	else if(atoi(env)<=0)
+	{
+		parser->rate_mode = RATE_MODE_FAST;
+	}
+	else
+	{
+		parser->rate_mode  = RATE_MODE_FIXED;
+		parser->fixed_rate = atoi(env)/8;
+	}
+}
+
+/**\brief Get the current input rate in bytes per second, 0 means no limit*/
+static int parser_get_rate(TSParser_t *parser)
+{
+	switch(parser->rate_mode)
+	{
+		case RATE_MODE_FIXED:
+			return parser->fixed_rate;
+		case RATE_MODE_FAST:
+			return 0;
+		default:
+			return parser->rate;
+	}
+}
+
+/**\brief Get the size of the next chunk to parse*/
+static int parser_get_chunk(TSParser_t *parser, int rate)
+{
+	int chunk;
+
+	if(!rate)
+		return PARSER_BUF_SIZE;
+
+	chunk = ((int64_t)rate)*PARSER_PACE_MS/1000;
+	chunk = AM_MAX(chunk, PARSER_MIN_CHUNK);
+	chunk = AM_MIN(chunk, PARSER_BUF_SIZE);
+
+	return chunk;
+}
+
+/**\brief Sleep until the parsed data should have been received at the target rate*/
+static void parser_pace(TSParser_t *parser, int rate, int bytes)
+{
+	struct timespec ts;
+	uint64_t now;
+
+	if(!rate || !bytes)
+		return;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	now = ((uint64_t)ts.tv_sec)*1000000000ULL+ts.tv_nsec;
+
+	/*Restart the clock at the beginning or when we are too late*/
+	if(!parser->deadline || (now>parser->deadline+1000000000ULL))
+		parser->deadline = now;
+
+	parser->deadline += ((uint64_t)bytes)*1000000000ULL/rate;
+
+	if(parser->deadline>now)
+	{
+		ts.tv_sec  = parser->deadline/1000000000ULL;
+		ts.tv_nsec = parser->deadline%1000000000ULL;
+		while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)==EINTR);
+	}
+}
+
+/**\brief Get the next chunk of data to parse, return the byte count*/
+static int parser_get_data(TSParser_t *parser, int chunk)
+{
+	int min = parser->packet_len ? parser->packet_len : 205;
+
+	if(parser->map)
+	{
+		/*Parse in the mapped file directly*/
+		if(parser->map_size-parser->map_pos<(size_t)min)
+		{
+			parser->map_pos = 0;
+			parser_reset(parser);
+			AM_TIME_GetClock(&parser->start_time);
+			AM_DEBUG(2, "ts file rewind");
+		}
+
+		parser->data  = parser->map+parser->map_pos;
+		parser->base  = parser->map_pos;
+		parser->bytes = AM_MIN((size_t)chunk, parser->map_size-parser->map_pos);
+	}
+	else
+	{
+		int left = AM_MIN(chunk, (int)sizeof(parser->buf))-parser->bytes;
+		int cnt;
+
+		if(feof(parser->fp))
+		{
+			rewind(parser->fp);
+			parser_reset(parser);
+			AM_TIME_GetClock(&parser->start_time);
+			AM_DEBUG(2, "ts file rewind");
+			left = AM_MIN(chunk, (int)sizeof(parser->buf));
+		}
+
+		parser->data = parser->buf;
+
+		if(left>0)
+		{
+			cnt = fread(parser->buf+parser->bytes, 1, left, parser->fp);
+			if((cnt==0) && !feof(parser->fp))
+			{
+				AM_DEBUG(1, "read ts file error");
+				return -1;
+			}
+
+			parser->bytes += cnt;
+		}
+
+		parser->base = ftell(parser->fp)-parser->bytes;
+	}
+
+	return parser->bytes;
+}
+
 /**\brief TS file parser thread*/
 static void* parser_thread(void *arg)
 {
 	TSParser_t *parser = (TSParser_t*)arg;
-	
+
 	parser->fname[0] = 0;
 	parser->fp = NULL;
+	parser->map = NULL;
+	parser->deadline = 0;
 	parser_reset(parser);
-	
+
 	while(parser->running)
 	{
 		char *fname;
-		FILE *fp;
-		
+		int rate, chunk, parsed;
+
 		/*Reset the input file*/
 		fname = getenv("AM_TSFILE");
-		if(fname)
+		if(!fname)
 		{
-			if(!strcmp(fname, parser->fname))
-			{
-				fp = parser->fp;
-			}
-			else
+			if(parser->fp)
 			{
-				int len = AM_MIN(strlen(fname), sizeof(parser->fname)-1);
-				
-				strncpy(parser->fname, fname, len);
-				parser->fname[len] = 0;
-				fp = fopen(fname, "r");
-				if(!fp)
-					AM_DEBUG(2, "cannot open \"%s\"", fname);
-				else
-					AM_DEBUG(2, "switch to ts file \"%s\"", fname);
-				AM_TIME_GetClock(&parser->start_time);
+				parser_close_file(parser);
+				parser->fname[0] = 0;
+				parser_reset(parser);
 			}
 		}
-		else
+		else if(strcmp(fname, parser->fname))
 		{
-			fp = NULL;
+			int len = AM_MIN(strlen(fname), sizeof(parser->fname)-1);
+
+			parser_close_file(parser);
+
+			strncpy(parser->fname, fname, len);
+			parser->fname[len] = 0;
+			parser_open_file(parser, fname);
+			parser_get_rate_mode(parser);
+			parser_reset(parser);
+			parser->deadline = 0;
+			AM_TIME_GetClock(&parser->start_time);
 		}
-		
-		if(fp!=parser->fp)
+
+		if(!parser->fp)
 		{
-			if(parser->fp)
-				fclose(parser->fp);
-			parser->fp = fp;
-			parser_reset(parser);
+			usleep(100000);
+			continue;
 		}
-		
+
+		rate  = parser_get_rate(parser);
+		chunk = parser_get_chunk(parser, rate);
+
 		/*Read the TS file*/
-		if(parser->fp)
+		if(parser_get_data(parser, chunk)<=0)
 		{
-			int left = sizeof(parser->buf)-parser->bytes;
-			int cnt;
-			
-			if(feof(parser->fp))
-			{
-				rewind(parser->fp);
-				parser_reset(parser);
-				AM_TIME_GetClock(&parser->start_time);
-				AM_DEBUG(2, "ts file rewind");
-			}
-			
-			cnt = fread(parser->buf+parser->bytes, 1, left, parser->fp);
-			if(cnt==0)
-			{
-				AM_DEBUG(1, "read ts file error");
-				sleep(1);
-				continue;
-			}
-			
-			parser->bytes += cnt;
+			sleep(1);
+			continue;
 		}
-		
+
 		/*Parse the TS file*/
-		if(parser->bytes)
+		parser->parsed = 0;
+
+		pthread_mutex_lock(&parser->lock);
+
+		while(1)
 		{
-			int left;
-			
-			if(parser->bytes<parser->packet_len)
-				continue;
-			
-			parser->parsed = 0;
-			
-			pthread_mutex_lock(&parser->lock);
-			
-			while(1)
-			{
-				if(!parse_ts_packet(parser))
-					break;
-			}
-			
-			pthread_mutex_unlock(&parser->lock);
-			
-			left = parser->bytes-parser->parsed;
-			if(left)
-			{
-				memmove(parser->buf, parser->buf+parser->parsed, left);
-			}
-			parser->bytes = left;
+			if(!parse_ts_packet(parser))
+				break;
 		}
-		
-		if(parser->fp)
+
+		pthread_mutex_unlock(&parser->lock);
+
+		/*Packet length not detected, skip the byte*/
+		if(!parser->parsed)
+			parser->parsed = 1;
+
+		parsed = parser->parsed;
+
+		if(parser->map)
 		{
-			/*Sleep according to the bit rate*/
-			if(parser->rate)
-			{
-				int end_clock, end_pos;
-				int wait;
-				
-				end_pos = ftell(parser->fp);
-				AM_TIME_GetClock(&end_clock);
-				wait = (((uint64_t)end_pos)*1000)/parser->rate-(end_clock-parser->start_time);
-				if(wait>0)
-				{
-					usleep(wait*1000);
-				}
-			}
+			parser->map_pos += parsed;
+			parser->bytes = 0;
 		}
 		else
 		{
-			usleep(100000);
+			int left = parser->bytes-parsed;
+
+			if(left)
+			{
+				memmove(parser->buf, parser->buf+parsed, left);
+			}
+			parser->bytes = left;
 		}
+
+		/*Sleep according to the bit rate*/
+		parser_pace(parser, rate, parsed);
 	}
-	
-	if(parser->fp)
-	{
-		fclose(parser->fp);
-	}
-	
+
+	parser_close_file(parser);
+
 	return NULL;
 }
 
@@ -697,6 +883,8 @@ static AM_ErrorCode_t emu_open(AM_DMX_Device_t *dev, const AM_DMX_OpenPara_t *pa
 		return AM_DMX_ERR_NO_MEM;
 	}
 	
+	memset(parser->pid_map, 0, sizeof(parser->pid_map));
+	memset(parser->pid_filters, 0, sizeof(parser->pid_filters));
 	parser->channels = NULL;
 	parser->filters  = NULL;
 	parser->running  = AM_TRUE;
@@ -797,6 +985,9 @@ static AM_ErrorCode_t emu_free_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *fil
 	
 	pthread_mutex_lock(&parser->lock);
 	
+	if(f->enable)
+		parser_ref_pid(parser, f->params.pid, -1);
+	
 	if(f->prev)
 	{
 		f->prev->next = f->next;
@@ -827,10 +1018,16 @@ static AM_ErrorCode_t emu_set_sec_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *
 	
 	pthread_mutex_lock(&parser->lock);
 	
+	if(f->enable)
+		parser_ref_pid(parser, f->params.pid, -1);
+	
 	f->type = CHAN_TYPE_SEC;
 	f->params.sct = *params;
 	f->neq = AM_FALSE;
 	
+	if(f->enable)
+		parser_ref_pid(parser, f->params.pid, 1);
+	
 	for(i=0; i<DMX_FILTER_SIZE; i++)
 	{
 		int pos = i?(i+2):i;
@@ -864,9 +1061,15 @@ static AM_ErrorCode_t emu_set_pes_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *
 	
 	pthread_mutex_lock(&parser->lock);
 	
+	if(f->enable)
+		parser_ref_pid(parser, f->params.pid, -1);
+	
 	f->type = CHAN_TYPE_PES;
 	f->params.pes = *params;
 	
+	if(f->enable)
+		parser_ref_pid(parser, f->params.pid, 1);
+	
 	pthread_mutex_unlock(&parser->lock);
 	
 	return AM_SUCCESS;
@@ -879,6 +1082,9 @@ static AM_ErrorCode_t emu_enable_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *f
 	
 	pthread_mutex_lock(&parser->lock);
 	
+	if(f->enable!=enable)
+		parser_ref_pid(parser, f->params.pid, enable?1:-1);
+	
 	f->enable = enable;
 	f->bytes  = 0;
 
@@ -57,6 +57,10 @@ typedef struct
 {
 	char   dev_name[32];
 	int    fd[DMX_FILTER_COUNT];
+	struct pollfd fds[DMX_FILTER_COUNT];  /**< poll使用的句柄集合*/
+	int    fids[DMX_FILTER_COUNT];        /**< fds中各句柄对应的过滤器ID*/
+	int    poll_cnt;                      /**< fds中的句柄数*/
+	AM_Bool_t poll_dirty;                 /**< 过滤器变化，需要重建fds，在dev->lock保护下原子修改*/
 } DVBDmx_t;
 
 /****************************************************************************
@@ -73,6 +77,7 @@ static AM_ErrorCode_t dvb_enable_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *f
 static AM_ErrorCode_t dvb_set_buf_size(AM_DMX_Device_t *dev, AM_DMX_Filter_t *filter, int size);
 static AM_ErrorCode_t dvb_poll(AM_DMX_Device_t *dev, AM_DMX_FilterMask_t *mask, int timeout);
 static AM_ErrorCode_t dvb_read(AM_DMX_Device_t *dev, AM_DMX_Filter_t *filter, uint8_t *buf, int *size);
+static AM_ErrorCode_t dvb_read_batch(AM_DMX_Device_t *dev, AM_DMX_Filter_t *filter, uint8_t *buf, int *size);
 static AM_ErrorCode_t dvb_set_source(AM_DMX_Device_t *dev, AM_DMX_Source_t src);
 
 const AM_DMX_Driver_t linux_dvb_dmx_drv = {
@@ -86,6 +91,7 @@ const AM_DMX_Driver_t linux_dvb_dmx_drv = {
 .set_buf_size   = dvb_set_buf_size,
 .poll           = dvb_poll,
 .read           = dvb_read,
+.read_batch     = dvb_read_batch,
 .set_source     = dvb_set_source
 };
 
@@ -112,6 +118,9 @@ static AM_ErrorCode_t dvb_open(AM_DMX_Device_t *dev, const AM_DMX_OpenPara_t *pa
 	
 	for(i=0; i<DMX_FILTER_COUNT; i++)
 		dmx->fd[i] = -1;
+
+	dmx->poll_cnt   = 0;
+	dmx->poll_dirty = AM_FALSE;
 	
 	dev->drv_data = dmx;
 	return AM_SUCCESS;
@@ -130,7 +139,7 @@ static AM_ErrorCode_t dvb_alloc_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *fi
 	DVBDmx_t *dmx = (DVBDmx_t*)dev->drv_data;
 	int fd;
 
-	fd = open(dmx->dev_name, O_RDWR);
+	fd = open(dmx->dev_name, O_RDWR|O_NONBLOCK);
 	if(fd==-1)
 	{
 		AM_DEBUG(1, "cannot open \"%s\" (%s)", dmx->dev_name, strerror(errno));
@@ -138,6 +147,7 @@ static AM_ErrorCode_t dvb_alloc_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *fi
 	}
 	
 	dmx->fd[filter->id] = fd;
+	__atomic_store_n(&dmx->poll_dirty, AM_TRUE, __ATOMIC_RELEASE);
 
 	filter->drv_data = (void*)(long)fd;
 	
@@ -151,6 +161,7 @@ static AM_ErrorCode_t dvb_free_filter(AM_DMX_Device_t *dev, AM_DMX_Filter_t *fil
 
 	close(fd);
 	dmx->fd[filter->id] = -1;
+	__atomic_store_n(&dmx->poll_dirty, AM_TRUE, __ATOMIC_RELEASE);
 	
 	return AM_SUCCESS;
 }
@@ -237,38 +248,57 @@ static AM_ErrorCode_t dvb_set_buf_size(AM_DMX_Device_t *dev, AM_DMX_Filter_t *fi
 	return AM_SUCCESS;
 }
 
-static AM_ErrorCode_t dvb_poll(AM_DMX_Device_t *dev, AM_DMX_FilterMask_t *mask, int timeout)
+/**\brief 过滤器分配或释放后重建poll句柄集合*/
+static void dvb_rebuild_pollfds(AM_DMX_Device_t *dev)
 {
 	DVBDmx_t *dmx = (DVBDmx_t*)dev->drv_data;
-	struct pollfd fds[DMX_FILTER_COUNT];
-	int fids[DMX_FILTER_COUNT];
-	int i, cnt = 0, ret;
-	
-	for(i=0; i<DMX_FILTER_COUNT; i++)
+	int i, cnt = 0;
+
+	pthread_mutex_lock(&dev->lock);
+
+	if(__atomic_load_n(&dmx->poll_dirty, __ATOMIC_ACQUIRE))
 	{
-		if(dmx->fd[i]!=-1)
+		for(i=0; i<DMX_FILTER_COUNT; i++)
 		{
-			fds[cnt].events = POLLIN|POLLERR;
-			fds[cnt].fd     = dmx->fd[i];
-			fids[cnt] = i;
-			cnt++;
+			if(dmx->fd[i]!=-1)
+			{
+				dmx->fds[cnt].events = POLLIN|POLLERR;
+				dmx->fds[cnt].fd     = dmx->fd[i];
+				dmx->fids[cnt] = i;
+				cnt++;
+			}
 		}
+
+		dmx->poll_cnt   = cnt;
+		__atomic_store_n(&dmx->poll_dirty, AM_FALSE, __ATOMIC_RELEASE);
 	}
+
+	pthread_mutex_unlock(&dev->lock);
+}
+
+static AM_ErrorCode_t dvb_poll(AM_DMX_Device_t *dev, AM_DMX_FilterMask_t *mask, int timeout)
+{
+	DVBDmx_t *dmx = (DVBDmx_t*)dev->drv_data;
+	int i, ret;
+	
+	/*过滤器由其他线程在dev->lock保护下分配和释放，这里不加锁检查*/
+	if(__atomic_load_n(&dmx->poll_dirty, __ATOMIC_ACQUIRE))
+		dvb_rebuild_pollfds(dev);
 	
-	if(!cnt)
+	if(!dmx->poll_cnt)
 		return AM_DMX_ERR_TIMEOUT;
 	
-	ret = poll(fds, cnt, timeout);
+	ret = poll(dmx->fds, dmx->poll_cnt, timeout);
 	if(ret<=0)
 	{
 		return AM_DMX_ERR_TIMEOUT;
 	}
 	
-	for(i=0; i<cnt; i++)
+	for(i=0; i<dmx->poll_cnt; i++)
 	{
-		if(fds[i].revents&(POLLIN|POLLERR))
+		if(dmx->fds[i].revents&(POLLIN|POLLERR))
 		{
-			AM_DMX_FILTER_MASK_SET(mask, fids[i]);
+			AM_DMX_FILTER_MASK_SET(mask, dmx->fids[i]);
 		}
 	}
 	
@@ -280,25 +310,23 @@ static AM_ErrorCode_t dvb_read(AM_DMX_Device_t *dev, AM_DMX_Filter_t *filter, ui
 	int fd = (long)filter->drv_data;
 	int len = *size;
 	int ret;
-	struct pollfd pfd;
 
 	UNUSED(dev);
 	
 	if(fd==-1)
 		return AM_DMX_ERR_NOT_ALLOCATED;
 	
-	pfd.events = POLLIN|POLLERR;
-	pfd.fd     = fd;
-	
-	ret = poll(&pfd, 1, 0);
-	if(ret<=0)
-		return AM_DMX_ERR_NO_DATA;
-	
+	/*句柄为非阻塞模式，无数据时直接返回EAGAIN*/
 	ret = read(fd, buf, len);
 	if(ret<=0)
 	{
+		if((errno==EAGAIN) || (errno==EWOULDBLOCK))
+			return AM_DMX_ERR_NO_DATA;
 		if(errno==ETIMEDOUT)
 			return AM_DMX_ERR_TIMEOUT;
+		/*驱动缓冲区溢出，记录到过滤器统计中*/
+		if(errno==EOVERFLOW)
+			filter->stats.drv_overflows++;
 		AM_DEBUG(1, "read demux failed (%s) %d", strerror(errno), errno);
 		return AM_DMX_ERR_SYS;
 	}
@@ -307,6 +335,36 @@ static AM_ErrorCode_t dvb_read(AM_DMX_Device_t *dev, AM_DMX_Filter_t *filter, ui
 	return AM_SUCCESS;
 }
 
+static AM_ErrorCode_t dvb_read_batch(AM_DMX_Device_t *dev, AM_DMX_Filter_t *filter, uint8_t *buf, int *size)
+{
+	int left = *size;
+	int total = 0;
+	int len;
+	AM_ErrorCode_t ret;
+
+	/*每次读出一个section，直到没有数据或缓冲区不足以容纳一个完整section*/
+	do
+	{
+		len = filter->is_pes ? left : AM_MIN(left, DMX_SEC_MAX_SIZE);
+
+		ret = dvb_read(dev, filter, buf+total, &len);
+		if(ret!=AM_SUCCESS)
+			break;
+
+		total += len;
+		left  -= len;
+	}
+	while(left >= DMX_SEC_MAX_SIZE);
+
+	if(total)
+	{
+		*size = total;
+		return AM_SUCCESS;
+	}
+
+	return ret;
+}
+
 static AM_ErrorCode_t dvb_set_source(AM_DMX_Device_t *dev, AM_DMX_Source_t src)
 {
 	char buf[32];
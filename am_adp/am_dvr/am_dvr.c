@@ -369,6 +369,79 @@ AM_ErrorCode_t AM_DVR_StartRecord(int dev_no, const AM_DVR_StartRecPara_t *para)
 	return ret;
 }
 
+/**\brief 修改正在录制的PID，新旧参数中都有的PID不停止过滤，数据不中断
+ * \param dev_no DVR设备号
+ * \param [in] para 新的录像参数
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码(见am_dvr.h)
+ */
+AM_ErrorCode_t AM_DVR_ChangeRecordPids(int dev_no, const AM_DVR_StartRecPara_t *para)
+{
+	AM_DVR_Device_t *dev;
+	AM_ErrorCode_t ret = AM_SUCCESS;
+	int pid_cnt, i, j;
+
+	assert(para);
+	if (para->pid_count <= 0)
+	{
+		AM_DEBUG(1, "Invalid pid count %d", para->pid_count);
+		return AM_DVR_ERR_INVALID_ARG;
+	}
+	pid_cnt = para->pid_count;
+	if (pid_cnt > AM_DVR_MAX_PID_COUNT)
+		pid_cnt = AM_DVR_MAX_PID_COUNT;
+
+	AM_TRY(dvr_get_openned_dev(dev_no, &dev));
+
+	pthread_mutex_lock(&dev->lock);
+
+	/*停止不再需要的流*/
+	for (i=0, j=0; i<dev->stream_cnt; i++)
+	{
+		int k;
+
+		for (k=0; k<pid_cnt; k++)
+		{
+			if (para->pids[k] == dev->streams[i].pid)
+				break;
+		}
+
+		if (k < pid_cnt)
+		{
+			dev->streams[j++] = dev->streams[i];
+		}
+		else if (dev->streams[i].fid != -1)
+		{
+			AM_DEBUG(1, "Stop stream(pid=%d)...", dev->streams[i].pid);
+			AM_DMX_StopFilter(dev->dmx_no, dev->streams[i].fid);
+			AM_DMX_FreeFilter(dev->dmx_no, dev->streams[i].fid);
+		}
+	}
+	dev->stream_cnt = j;
+
+	/*添加新的流*/
+	for (i=0; i<pid_cnt; i++)
+	{
+		for (j=0; j<dev->stream_cnt; j++)
+		{
+			if (dev->streams[j].pid == para->pids[i])
+				break;
+		}
+
+		if (j == dev->stream_cnt)
+			dvr_add_stream(dev, (uint16_t)para->pids[i]);
+	}
+
+	dvr_start_all_streams(dev);
+	dev->record = AM_TRUE;
+	dev->start_para = *para;
+
+	pthread_mutex_unlock(&dev->lock);
+
+	return ret;
+}
+
 /**\brief 停止录像
  * \param dev_no DVR设备号
  * \return
@@ -12,6 +12,10 @@
 /**\file
  * \brief  emu dvr 驱动
  *
+ * 从TS文件中读取数据模拟DVR设备。源文件由环境变量AM_TSFILE<源号>指定，
+ * 未设置时使用AM_TSFILE。环境变量AM_DVR_BITRATE(bit/s)设置数据输出速率，
+ * 未设置或为0时不限速。只输出正在录制的PID的TS包。
+ *
  * \author Xia Lei Peng <leipeng.xia@amlogic.com>
  * \date 2010-12-13: create the document
  ***************************************************************************/
@@ -19,12 +23,47 @@
 #define AM_DEBUG_LEVEL 2
 
 #include <am_debug.h>
+#include <am_time.h>
 #include "../am_dvr_internal.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <am_cond.h>
+
+/****************************************************************************
+ * Macro definitions
+ ***************************************************************************/
+
+#define EMU_TS_PKT_SIZE    (188)
+#define EMU_TS_SYNC_BYTE   (0x47)
+#define EMU_PID_MAP_SIZE   (8192)
+#define EMU_BUF_SIZE       (EMU_TS_PKT_SIZE*512)
+/*无数据时的最长等待时间(毫秒)*/
+#define EMU_IDLE_WAIT      (100)
 
 /****************************************************************************
  * Type definitions
  ***************************************************************************/
 
+/**\brief emu DVR设备数据*/
+typedef struct
+{
+	char      fname[PATH_MAX];  /**< 当前的TS文件*/
+	int       fd;               /**< TS文件句柄*/
+	AM_DVR_Source_t src;        /**< 数据源*/
+	int       rate;             /**< 输出速率(字节/秒), 0表示不限速*/
+	int       start_time;       /**< 开始计时的时间*/
+	uint64_t  consumed;         /**< 计时开始后从文件中读出的字节数*/
+	uint8_t   buf[EMU_BUF_SIZE];/**< 文件读缓冲*/
+	int       pos;              /**< buf中的读位置*/
+	int       bytes;            /**< buf中的数据长度*/
+	uint8_t   pid_map[EMU_PID_MAP_SIZE/8]; /**< 录制的PID位图*/
+	pthread_cond_t cond;        /**< 限速等待用的条件变量*/
+} EmuDVR_t;
 
 /****************************************************************************
  * Static data definitions
@@ -35,6 +74,7 @@ static AM_ErrorCode_t emu_close(AM_DVR_Device_t *dev);
 static AM_ErrorCode_t emu_set_buf_size(AM_DVR_Device_t *dev, int size);
 static AM_ErrorCode_t emu_poll(AM_DVR_Device_t *dev, int timeout);
 static AM_ErrorCode_t emu_read(AM_DVR_Device_t *dev, uint8_t *buf, int *size);
+static AM_ErrorCode_t emu_set_source(AM_DVR_Device_t *dev, AM_DVR_Source_t src);
 
 const AM_DVR_Driver_t emu_dvr_drv = {
 .open  			= emu_open,
@@ -42,6 +82,7 @@ const AM_DVR_Driver_t emu_dvr_drv = {
 .set_buf_size   = emu_set_buf_size,
 .poll           = emu_poll,
 .read           = emu_read,
+.set_source     = emu_set_source,
 };
 
 
@@ -49,28 +90,280 @@ const AM_DVR_Driver_t emu_dvr_drv = {
  * Static functions
  ***************************************************************************/
 
+/**\brief 重新开始计时*/
+static void emu_reset_clock(EmuDVR_t *emu)
+{
+	AM_TIME_GetClock(&emu->start_time);
+	emu->consumed = 0;
+}
+
+/**\brief 等待指定的毫秒数，等待期间释放设备锁，不阻塞其他DVR操作*/
+static void emu_wait(AM_DVR_Device_t *dev, EmuDVR_t *emu, int ms)
+{
+	struct timespec ts;
+
+	AM_TIME_GetTimeSpecTimeout(ms, &ts);
+	while(pthread_cond_timedwait(&emu->cond, &dev->lock, &ts) == 0);
+}
+
+/**\brief 检查数据源对应的TS文件，文件改变时重新打开*/
+static void emu_check_file(EmuDVR_t *emu)
+{
+	char env[32];
+	char *fname;
+
+	snprintf(env, sizeof(env), "AM_TSFILE%d", emu->src);
+	fname = getenv(env);
+	if(!fname)
+		fname = getenv("AM_TSFILE");
+
+	if(!fname)
+	{
+		if(emu->fd != -1)
+		{
+			close(emu->fd);
+			emu->fd = -1;
+			emu->fname[0] = 0;
+		}
+		return;
+	}
+
+	if(!strcmp(fname, emu->fname))
+		return;
+
+	if(emu->fd != -1)
+		close(emu->fd);
+
+	strncpy(emu->fname, fname, sizeof(emu->fname)-1);
+	emu->fname[sizeof(emu->fname)-1] = 0;
+
+	emu->fd = open(fname, O_RDONLY);
+	if(emu->fd == -1)
+		AM_DEBUG(2, "cannot open \"%s\" (%s)", fname, strerror(errno));
+	else
+		AM_DEBUG(2, "switch to ts file \"%s\"", fname);
+
+	emu->pos   = 0;
+	emu->bytes = 0;
+	emu_reset_clock(emu);
+}
+
+/**\brief 按照速率计算当前允许从文件中读出的字节数*/
+static int64_t emu_allowed(EmuDVR_t *emu)
+{
+	int now;
+
+	if(!emu->rate)
+		return EMU_BUF_SIZE;
+
+	AM_TIME_GetClock(&now);
+
+	return ((int64_t)(now - emu->start_time))*emu->rate/1000 - (int64_t)emu->consumed;
+}
+
+/**\brief 根据正在录制的流生成PID位图，返回PID数目*/
+static int emu_update_pids(AM_DVR_Device_t *dev, EmuDVR_t *emu)
+{
+	int i, cnt = 0;
+
+	memset(emu->pid_map, 0, sizeof(emu->pid_map));
+
+	if(!dev->record)
+		return 0;
+
+	for(i=0; i<dev->stream_cnt; i++)
+	{
+		int pid = dev->streams[i].pid & 0x1FFF;
+
+		if(dev->streams[i].fid == -1)
+			continue;
+
+		emu->pid_map[pid>>3] |= 1<<(pid&7);
+		cnt++;
+	}
+
+	return cnt;
+}
+
+/**\brief 从TS文件中补充数据，到文件结尾时回到开头*/
+static AM_Bool_t emu_fill(EmuDVR_t *emu)
+{
+	int left = emu->bytes - emu->pos;
+	int cnt;
+
+	if(left && emu->pos)
+		memmove(emu->buf, emu->buf + emu->pos, left);
+
+	emu->pos   = 0;
+	emu->bytes = left;
+
+	cnt = read(emu->fd, emu->buf + left, sizeof(emu->buf) - left);
+	if(cnt == 0)
+	{
+		lseek(emu->fd, 0, SEEK_SET);
+		AM_DEBUG(2, "ts file rewind");
+		cnt = read(emu->fd, emu->buf + left, sizeof(emu->buf) - left);
+	}
+
+	if(cnt <= 0)
+		return AM_FALSE;
+
+	emu->bytes += cnt;
+	return AM_TRUE;
+}
+
 static AM_ErrorCode_t emu_open(AM_DVR_Device_t *dev, const AM_DVR_OpenPara_t *para)
 {
-	return AM_DVR_ERR_NOT_SUPPORTED;
+	EmuDVR_t *emu;
+	char *rate;
+
+	UNUSED(para);
+
+	emu = (EmuDVR_t*)malloc(sizeof(EmuDVR_t));
+	if(!emu)
+	{
+		AM_DEBUG(1, "not enough memory");
+		return AM_DVR_ERR_NO_MEM;
+	}
+
+	memset(emu, 0, sizeof(EmuDVR_t));
+	emu->fd  = -1;
+	emu->src = dev->src;
+	pthread_cond_init(&emu->cond, NULL);
+
+	rate = getenv("AM_DVR_BITRATE");
+	if(rate)
+		emu->rate = atoi(rate)/8;
+
+	AM_DEBUG(2, "emu dvr%d rate %d bytes/s", dev->dev_no, emu->rate);
+
+	dev->drv_data = emu;
+	return AM_SUCCESS;
 }
 
 static AM_ErrorCode_t emu_close(AM_DVR_Device_t *dev)
 {
-	return AM_DVR_ERR_NOT_SUPPORTED;
+	EmuDVR_t *emu = (EmuDVR_t*)dev->drv_data;
+
+	if(emu->fd != -1)
+		close(emu->fd);
+
+	pthread_cond_destroy(&emu->cond);
+	free(emu);
+	dev->drv_data = NULL;
+
+	return AM_SUCCESS;
 }
 
 static AM_ErrorCode_t emu_set_buf_size(AM_DVR_Device_t *dev, int size)
 {
-	return AM_DVR_ERR_NOT_SUPPORTED;
+	UNUSED(dev);
+	UNUSED(size);
+
+	return AM_SUCCESS;
 }
 
 static AM_ErrorCode_t emu_poll(AM_DVR_Device_t *dev, int timeout)
 {
-	return AM_DVR_ERR_NOT_SUPPORTED;
+	EmuDVR_t *emu = (EmuDVR_t*)dev->drv_data;
+	int64_t allowed;
+	int wait;
+
+	emu_check_file(emu);
+
+	/*没有数据源或未在录制，等待后返回超时*/
+	if((emu->fd == -1) || !emu_update_pids(dev, emu))
+	{
+		wait = (timeout < 0) ? EMU_IDLE_WAIT : AM_MIN(timeout, EMU_IDLE_WAIT);
+		if(wait > 0)
+			emu_wait(dev, emu, wait);
+		emu_reset_clock(emu);
+		return AM_DVR_ERR_TIMEOUT;
+	}
+
+	allowed = emu_allowed(emu);
+	if(allowed >= EMU_TS_PKT_SIZE)
+		return AM_SUCCESS;
+
+	/*等待至少一个TS包的数据到达*/
+	wait = (int)((EMU_TS_PKT_SIZE - allowed)*1000/emu->rate) + 1;
+	if((timeout >= 0) && (wait > timeout))
+	{
+		if(timeout > 0)
+			emu_wait(dev, emu, timeout);
+		return AM_DVR_ERR_TIMEOUT;
+	}
+
+	emu_wait(dev, emu, wait);
+	return AM_SUCCESS;
 }
 
 static AM_ErrorCode_t emu_read(AM_DVR_Device_t *dev, uint8_t *buf, int *size)
 {
-	return AM_DVR_ERR_NOT_SUPPORTED;
+	EmuDVR_t *emu = (EmuDVR_t*)dev->drv_data;
+	int64_t allowed;
+	int len = 0, scanned = 0;
+
+	if(emu->fd == -1)
+		return AM_DVR_ERR_NOT_ALLOCATED;
+
+	if(!emu_update_pids(dev, emu))
+		return AM_DVR_ERR_NO_DATA;
+
+	allowed = emu_allowed(emu);
+
+	/*最多扫描一个缓冲区的输入数据，避免录制的PID不存在时长时间占用设备*/
+	while((len + EMU_TS_PKT_SIZE <= *size) && (allowed >= EMU_TS_PKT_SIZE) && (scanned < EMU_BUF_SIZE))
+	{
+		uint8_t *p;
+		int pid;
+
+		if(emu->bytes - emu->pos < EMU_TS_PKT_SIZE)
+		{
+			if(!emu_fill(emu) || (emu->bytes - emu->pos < EMU_TS_PKT_SIZE))
+				break;
+		}
+
+		p = emu->buf + emu->pos;
+
+		if(p[0] != EMU_TS_SYNC_BYTE)
+		{
+			uint8_t *s = memchr(p + 1, EMU_TS_SYNC_BYTE, emu->bytes - emu->pos - 1);
+			int skip = s ? (s - p) : (emu->bytes - emu->pos);
+
+			emu->pos       += skip;
+			emu->consumed  += skip;
+			allowed        -= skip;
+			scanned        += skip;
+			continue;
+		}
+
+		pid = ((p[1]<<8)|p[2])&0x1FFF;
+		if(emu->pid_map[pid>>3] & (1<<(pid&7)))
+		{
+			memcpy(buf + len, p, EMU_TS_PKT_SIZE);
+			len += EMU_TS_PKT_SIZE;
+		}
+
+		emu->pos      += EMU_TS_PKT_SIZE;
+		emu->consumed += EMU_TS_PKT_SIZE;
+		allowed       -= EMU_TS_PKT_SIZE;
+		scanned       += EMU_TS_PKT_SIZE;
+	}
+
+	if(!len)
+		return AM_DVR_ERR_NO_DATA;
+
+	*size = len;
+	return AM_SUCCESS;
 }
 
+static AM_ErrorCode_t emu_set_source(AM_DVR_Device_t *dev, AM_DVR_Source_t src)
+{
+	EmuDVR_t *emu = (EmuDVR_t*)dev->drv_data;
+
+	emu->src = src;
+	emu_check_file(emu);
+
+	return AM_SUCCESS;
+}
@@ -26,7 +26,9 @@
  * Macro definitions
  ***************************************************************************/
 
-#define AM_PTR_ALIGN (sizeof(void*))
+/*按8字节对齐，32位平台上的64位成员也能直接访问*/
+#define AM_PTR_ALIGN (AM_MAX(sizeof(void*), 8))
+#define AM_ALIGN(_s) (((_s)+AM_PTR_ALIGN-1)&~(AM_PTR_ALIGN-1))
 
 /****************************************************************************
  * Type definitions
@@ -42,6 +44,9 @@ struct AM_MEM_BlockHeader
 	int                   used;        /**< 已使用内存大小*/
 };
 
+/**\brief 内存块头部占用的空间，数据从对齐的位置开始*/
+#define AM_MEM_BLOCK_HDR_SIZE AM_ALIGN(sizeof(AM_MEM_BlockHeader_t))
+
 /****************************************************************************
  * API functions
  ***************************************************************************/
@@ -55,6 +60,7 @@ void AM_MEM_PoolInit(AM_MEM_Pool_t *pool, int pool_size)
 	assert(pool && pool_size);
 	
 	pool->pools = NULL;
+	pool->cur = NULL;
 	pool->pool_size = pool_size;
 }
 
@@ -67,34 +73,53 @@ void AM_MEM_PoolInit(AM_MEM_Pool_t *pool, int pool_size)
  */
 void* AM_MEM_PoolAlloc(AM_MEM_Pool_t *pool, int size)
 {
-	AM_MEM_BlockHeader_t *hdr;
+	AM_MEM_BlockHeader_t *hdr, *next;
 	void *ptr;
 	
-	assert(pool && size);
+	assert(pool && (size >= 0));
 	
-	size = (size+AM_PTR_ALIGN-1)&~(AM_PTR_ALIGN-1);
-	hdr = (AM_MEM_BlockHeader_t*)pool->pools;
+	size = AM_ALIGN(size);
+	hdr = (AM_MEM_BlockHeader_t*)pool->cur;
 	
 	if(!hdr || (size>(hdr->size-hdr->used)))
 	{
-		int allocs=AM_MAX(size, pool->pool_size);
-	
-		hdr = (AM_MEM_BlockHeader_t*)AM_MEM_Alloc(allocs+sizeof(AM_MEM_BlockHeader_t));
-		if(!hdr)
-			return NULL;
+		/*当前块后面的内存块都是清空后保留的*/
+		next = hdr ? hdr->next : NULL;
+		if(next && (size<=next->size))
+		{
+			hdr = next;
+		}
+		else
+		{
+			int allocs=AM_MAX(size, pool->pool_size);
+			AM_MEM_BlockHeader_t *blk;
 		
-		hdr->next = pool->pools;
-		hdr->size = allocs;
-		hdr->used = 0;
+			blk = (AM_MEM_BlockHeader_t*)AM_MEM_Alloc(allocs+AM_MEM_BLOCK_HDR_SIZE);
+			if(!blk)
+				return NULL;
+			
+			blk->next = next;
+			blk->size = allocs;
+			blk->used = 0;
+			
+			if(hdr)
+				hdr->next = blk;
+			else
+				pool->pools = blk;
+			hdr = blk;
+		}
+		
+		pool->cur = hdr;
 	}
 	
-	ptr = ((char*)(hdr+1))+hdr->used;
+	ptr = ((char*)hdr)+AM_MEM_BLOCK_HDR_SIZE+hdr->used;
 	hdr->used += size;
 	
 	return ptr;
 }
 
 /**\brief 将缓冲池内全部以分配的内存标记，但不调用系统free()
+ * 内存块都被保留，之后的分配重新从第一个内存块开始
  * \param[in,out] pool 缓冲池指针
  */
 void AM_MEM_PoolClear(AM_MEM_Pool_t *pool)
@@ -103,19 +128,10 @@ void AM_MEM_PoolClear(AM_MEM_Pool_t *pool)
 	
 	assert(pool);
 	
-	hdr = (AM_MEM_BlockHeader_t*)pool->pools;
-	if(hdr)
-	{
-		while(hdr->next)
-		{
-			AM_MEM_BlockHeader_t *tmp = hdr;
-			hdr = hdr->next;
-			AM_MEM_Free(tmp);
-		}
-		
+	for(hdr=(AM_MEM_BlockHeader_t*)pool->pools; hdr; hdr=hdr->next)
 		hdr->used = 0;
-		pool->pools = hdr;
-	}
+	
+	pool->cur = pool->pools;
 }
 
 /**\brief 将缓冲池内全部以分配的内存标记，调用系统free()释放全部资源
@@ -136,5 +152,6 @@ void AM_MEM_PoolFree(AM_MEM_Pool_t *pool)
 	}
 	
 	pool->pools = NULL;
+	pool->cur = NULL;
 }
 
@@ -0,0 +1,349 @@
+#ifdef _FORTIFY_SOURCE
+#undef _FORTIFY_SOURCE
+#endif
+/***************************************************************************
+ * Copyright (c) 2019 Amlogic, Inc. All rights reserved.
+ *
+ * This source code is subject to the terms and conditions defined in the
+ * file 'LICENSE' which is part of this source code package.
+ *
+ * Description:
+ */
+/**\file
+ * \brief MPEG-2 CRC32计算
+ *
+ * slice-by-8: 8张表，每次处理8个字节，表在第一次使用时生成。
+ * 折叠: 数据按16字节大端序看作128位多项式，用无进位乘法乘以x^N mod P
+ * 向后折叠，最后剩下的16字节和不足16字节的尾部再查表计算。
+ ***************************************************************************/
+
+#define AM_DEBUG_LEVEL 1
+
+#include <string.h>
+#include <pthread.h>
+#include <am_types.h>
+#include <am_debug.h>
+#include <am_crc.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+#define CRC_HW_X86
+#define CRC_HW_TARGET __attribute__((target("pclmul,ssse3")))
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__linux__)
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_PMULL
+#define HWCAP_PMULL (1 << 4)
+#endif
+#define CRC_HW_ARM
+#ifdef __clang__
+#define CRC_HW_TARGET __attribute__((target("crypto")))
+#else
+#define CRC_HW_TARGET __attribute__((target("+crypto")))
+#endif
+#endif
+
+/****************************************************************************
+ * Macro definitions
+ ***************************************************************************/
+
+/**\brief CRC32生成多项式(不含x^32)*/
+#define CRC32_POLY      0x04C11DB7
+/**\brief 短于此长度的数据不使用折叠算法*/
+#define CRC32_CLMUL_MIN 64
+/**\brief 同时折叠的128位数量*/
+#define CRC32_LANES     4
+
+#define GETU32(p) (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[2] << 8) | (uint32_t)(p)[3])
+
+/****************************************************************************
+ * Static data
+ ***************************************************************************/
+
+static uint32_t crc_tab[8][256];
+/*折叠128, 256, 384, 512位的常数{x^(N+64) mod P, x^N mod P}*/
+static uint64_t crc_fold_k[CRC32_LANES][2];
+static AM_Bool_t crc_hw;
+static pthread_once_t crc_once = PTHREAD_ONCE_INIT;
+
+/****************************************************************************
+ * Static functions
+ ***************************************************************************/
+
+/**\brief 计算x^n mod P*/
+static uint32_t crc32_xpow(int n)
+{
+	uint32_t r = 1;
+
+	while (n--)
+		r = (r << 1) ^ ((r & 0x80000000) ? CRC32_POLY : 0);
+
+	return r;
+}
+
+static AM_Bool_t crc32_hw_probe(void)
+{
+#if defined(CRC_HW_X86)
+	unsigned int a, b, c, d;
+
+	if (!__get_cpuid(1, &a, &b, &c, &d))
+		return AM_FALSE;
+	return ((c & bit_PCLMUL) && (c & bit_SSSE3)) ? AM_TRUE : AM_FALSE;
+#elif defined(CRC_HW_ARM)
+	return (getauxval(AT_HWCAP) & HWCAP_PMULL) ? AM_TRUE : AM_FALSE;
+#else
+	return AM_FALSE;
+#endif
+}
+
+static void crc32_init(void)
+{
+	int i, j;
+
+	for (i = 0; i < 256; i++)
+	{
+		uint32_t c = (uint32_t)i << 24;
+
+		for (j = 0; j < 8; j++)
+			c = (c << 1) ^ ((c & 0x80000000) ? CRC32_POLY : 0);
+		crc_tab[0][i] = c;
+	}
+
+	/*crc_tab[n]是字节后面再跟n个0字节的结果*/
+	for (i = 0; i < 256; i++)
+	{
+		for (j = 1; j < 8; j++)
+		{
+			uint32_t c = crc_tab[j - 1][i];
+
+			crc_tab[j][i] = (c << 8) ^ crc_tab[0][c >> 24];
+		}
+	}
+
+	for (i = 0; i < CRC32_LANES; i++)
+	{
+		crc_fold_k[i][0] = crc32_xpow(128 * (i + 1) + 64);
+		crc_fold_k[i][1] = crc32_xpow(128 * (i + 1));
+	}
+
+	crc_hw = crc32_hw_probe();
+	AM_DEBUG(2, "CRC32 folding with carry-less multiply: %s", crc_hw ? "yes" : "no");
+}
+
+static uint32_t crc32_byte(uint32_t crc, const uint8_t *p, int len)
+{
+	while (len-- > 0)
+		crc = (crc << 8) ^ crc_tab[0][(crc >> 24) ^ *p++];
+
+	return crc;
+}
+
+static uint32_t crc32_slice8(uint32_t crc, const uint8_t *p, int len)
+{
+	while (len >= 8)
+	{
+		uint32_t a = crc ^ GETU32(p);
+		uint32_t b = GETU32(p + 4);
+
+		crc = crc_tab[7][a >> 24] ^ crc_tab[6][(a >> 16) & 0xff] ^
+			crc_tab[5][(a >> 8) & 0xff] ^ crc_tab[4][a & 0xff] ^
+			crc_tab[3][b >> 24] ^ crc_tab[2][(b >> 16) & 0xff] ^
+			crc_tab[1][(b >> 8) & 0xff] ^ crc_tab[0][b & 0xff];
+		p += 8;
+		len -= 8;
+	}
+
+	return crc32_byte(crc, p, len);
+}
+
+#if defined(CRC_HW_X86) || defined(CRC_HW_ARM)
+
+/*crc_vec_t中的128位多项式，高64位是数据的前8个字节*/
+#if defined(CRC_HW_X86)
+
+typedef __m128i crc_vec_t;
+
+static inline CRC_HW_TARGET crc_vec_t crc_vec_bswap(crc_vec_t v)
+{
+	return _mm_shuffle_epi8(v, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+static inline CRC_HW_TARGET crc_vec_t crc_vec_load(const uint8_t *p)
+{
+	return crc_vec_bswap(_mm_loadu_si128((const __m128i *)p));
+}
+
+static inline CRC_HW_TARGET void crc_vec_store(uint8_t *p, crc_vec_t v)
+{
+	_mm_storeu_si128((__m128i *)p, crc_vec_bswap(v));
+}
+
+static inline CRC_HW_TARGET crc_vec_t crc_vec_xor(crc_vec_t a, crc_vec_t b)
+{
+	return _mm_xor_si128(a, b);
+}
+
+static inline CRC_HW_TARGET crc_vec_t crc_vec_crc(uint32_t crc)
+{
+	return _mm_set_epi32((int)crc, 0, 0, 0);
+}
+
+static inline CRC_HW_TARGET crc_vec_t crc_vec_fold(crc_vec_t v, const uint64_t *k)
+{
+	crc_vec_t kv = _mm_set_epi64x((long long)k[0], (long long)k[1]);
+
+	return _mm_xor_si128(_mm_clmulepi64_si128(v, kv, 0x11), _mm_clmulepi64_si128(v, kv, 0x00));
+}
+
+#else
+
+typedef uint64x2_t crc_vec_t;
+
+static inline CRC_HW_TARGET crc_vec_t crc_vec_bswap(uint8x16_t v)
+{
+	v = vrev64q_u8(v);
+	return vreinterpretq_u64_u8(vextq_u8(v, v, 8));
+}
+
+static inline CRC_HW_TARGET crc_vec_t crc_vec_load(const uint8_t *p)
+{
+	return crc_vec_bswap(vld1q_u8(p));
+}
+
+static inline CRC_HW_TARGET void crc_vec_store(uint8_t *p, crc_vec_t v)
+{
+	vst1q_u8(p, vreinterpretq_u8_u64(crc_vec_bswap(vreinterpretq_u8_u64(v))));
+}
+
+static inline CRC_HW_TARGET crc_vec_t crc_vec_xor(crc_vec_t a, crc_vec_t b)
+{
+	return veorq_u64(a, b);
+}
+
+static inline CRC_HW_TARGET crc_vec_t crc_vec_crc(uint32_t crc)
+{
+	return vcombine_u64(vcreate_u64(0), vcreate_u64((uint64_t)crc << 32));
+}
+
+static inline CRC_HW_TARGET crc_vec_t crc_vec_fold(crc_vec_t v, const uint64_t *k)
+{
+	poly128_t h = vmull_p64((poly64_t)vgetq_lane_u64(v, 1), (poly64_t)k[0]);
+	poly128_t l = vmull_p64((poly64_t)vgetq_lane_u64(v, 0), (poly64_t)k[1]);
+
+	return veorq_u64(vreinterpretq_u64_p128(h), vreinterpretq_u64_p128(l));
+}
+
+#endif
+
+static CRC_HW_TARGET uint32_t crc32_clmul(uint32_t crc, const uint8_t *p, int len)
+{
+	crc_vec_t x0, x1, x2, x3;
+	uint8_t buf[16];
+
+	if (len < CRC32_CLMUL_MIN)
+		return crc32_slice8(crc, p, len);
+
+	/*初始值和数据的前32位异或，之后按初始值为0计算*/
+	x0 = crc_vec_xor(crc_vec_load(p), crc_vec_crc(crc));
+
+	if (len >= 2 * 16 * CRC32_LANES)
+	{
+		x1 = crc_vec_load(p + 16);
+		x2 = crc_vec_load(p + 32);
+		x3 = crc_vec_load(p + 48);
+		p += 16 * CRC32_LANES;
+		len -= 16 * CRC32_LANES;
+
+		while (len >= 16 * CRC32_LANES)
+		{
+			x0 = crc_vec_xor(crc_vec_fold(x0, crc_fold_k[3]), crc_vec_load(p));
+			x1 = crc_vec_xor(crc_vec_fold(x1, crc_fold_k[3]), crc_vec_load(p + 16));
+			x2 = crc_vec_xor(crc_vec_fold(x2, crc_fold_k[3]), crc_vec_load(p + 32));
+			x3 = crc_vec_xor(crc_vec_fold(x3, crc_fold_k[3]), crc_vec_load(p + 48));
+			p += 16 * CRC32_LANES;
+			len -= 16 * CRC32_LANES;
+		}
+
+		x0 = crc_vec_xor(crc_vec_fold(x0, crc_fold_k[2]), crc_vec_fold(x1, crc_fold_k[1]));
+		x0 = crc_vec_xor(x0, crc_vec_xor(crc_vec_fold(x2, crc_fold_k[0]), x3));
+	}
+	else
+	{
+		p += 16;
+		len -= 16;
+	}
+
+	while (len >= 16)
+	{
+		x0 = crc_vec_xor(crc_vec_fold(x0, crc_fold_k[0]), crc_vec_load(p));
+		p += 16;
+		len -= 16;
+	}
+
+	/*剩下的128位和尾部查表计算*/
+	crc_vec_store(buf, x0);
+	crc = crc32_slice8(0, buf, 16);
+
+	return crc32_slice8(crc, p, len);
+}
+
+#endif
+
+/****************************************************************************
+ * API functions
+ ***************************************************************************/
+
+uint32_t AM_CRC32_CalcEngine(AM_CRC32_Engine_t engine, uint32_t crc, const uint8_t *data, int len)
+{
+	pthread_once(&crc_once, crc32_init);
+
+	switch (engine)
+	{
+		case AM_CRC32_ENGINE_BYTE:
+			return crc32_byte(crc, data, len);
+		case AM_CRC32_ENGINE_AUTO:
+		case AM_CRC32_ENGINE_CLMUL:
+#if defined(CRC_HW_X86) || defined(CRC_HW_ARM)
+			if (crc_hw)
+				return crc32_clmul(crc, data, len);
+#endif
+		default:
+			break;
+	}
+
+	return crc32_slice8(crc, data, len);
+}
+
+uint32_t AM_CRC32_Calc(uint32_t crc, const uint8_t *data, int len)
+{
+	return AM_CRC32_CalcEngine(AM_CRC32_ENGINE_AUTO, crc, data, len);
+}
+
+AM_Bool_t AM_CRC32_CheckSection(const uint8_t *sec, int len)
+{
+	if (len <= 4)
+		return AM_FALSE;
+
+	return AM_CRC32_Calc(AM_CRC32_INIT, sec, len) ? AM_FALSE : AM_TRUE;
+}
+
+AM_Bool_t AM_CRC32_EngineAvailable(AM_CRC32_Engine_t engine)
+{
+	pthread_once(&crc_once, crc32_init);
+
+	if (engine == AM_CRC32_ENGINE_CLMUL)
+		return crc_hw;
+
+	return AM_TRUE;
+}
+
+AM_CRC32_Engine_t AM_CRC32_GetEngine(void)
+{
+	pthread_once(&crc_once, crc32_init);
+
+	return crc_hw ? AM_CRC32_ENGINE_CLMUL : AM_CRC32_ENGINE_SLICE8;
+}
+
@@ -25,17 +25,42 @@
 #include <am_types.h>
 #include <am_debug.h>
 #include <am_mem.h>
+#include <am_time.h>
 #include <string.h>
 #include <errno.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <assert.h>
 #include <dlfcn.h>
+#include <pthread.h>
 #include "am_misc.h"
 /****************************************************************************
  * Macro definitions
  ***************************************************************************/
 
+/**\brief 文件句柄缓存的哈希表大小*/
+#define FILE_HANDLE_HASH_SIZE	64
+/**\brief 最多缓存的文件句柄数，超过后不再缓存*/
+#define FILE_HANDLE_MAX		128
+
+/****************************************************************************
+ * Type definitions
+ ***************************************************************************/
+
+/**\brief 缓存的文件句柄，打开后一直保留到进程退出*/
+struct AM_FileHandle_s
+{
+	struct AM_FileHandle_s *next;	/**< 哈希表中的下一个句柄*/
+	pthread_mutex_t lock;	/**< 保护rfd、wfd和nocache，读写文件时一直持有，文件不会被其他线程关闭*/
+	int       rfd;		/**< 读句柄，-1表示未打开*/
+	int       wfd;		/**< 写句柄，-1表示未打开*/
+	int       time;		/**< value的读取时间*/
+	AM_Bool_t valid;	/**< value中是最近读取的值*/
+	AM_Bool_t nocache;	/**< 不保留打开的文件，每次重新打开*/
+	char      value[64];
+	char      name[1];
+};
+
 /****************************************************************************
  * Static functions
  ***************************************************************************/
@@ -61,6 +86,10 @@ typedef struct am_rw_prop_cb_s
 
 am_rw_prop_cb_t rwPropCb = {.readPropCb = NULL, .writePropCb = NULL};
 
+static pthread_mutex_t file_handle_lock = PTHREAD_MUTEX_INITIALIZER;
+static AM_FileHandle_t file_handles[FILE_HANDLE_HASH_SIZE];
+static int file_handle_cnt;
+
 #ifdef ANDROID
 
 # define SUN_LEN(ptr) ((size_t) (((struct sockaddr_un*) 0)->sun_path) + strlen ((ptr)->sun_path) )
@@ -159,6 +188,308 @@ static AM_ErrorCode_t try_read(int fd, char *buf, int len)
 	return AM_SUCCESS;
 }
 
+/**\brief 查找文件名对应的缓存句柄，没有时创建，需在file_handle_lock保护下调用*/
+static AM_FileHandle_t file_handle_get(const char *name)
+{
+	AM_FileHandle_t h;
+	unsigned int hash = 5381;
+	const char *p;
+	int len;
+
+	for (p = name; *p; p++)
+		hash = hash * 33 + (unsigned char)*p;
+	hash %= FILE_HANDLE_HASH_SIZE;
+
+	for (h = file_handles[hash]; h; h = h->next)
+	{
+		if (!strcmp(h->name, name))
+			return h;
+	}
+
+	if (file_handle_cnt >= FILE_HANDLE_MAX)
+		return NULL;
+
+	len = strlen(name);
+	h = (AM_FileHandle_t)malloc(sizeof(struct AM_FileHandle_s) + len);
+	if (!h)
+		return NULL;
+
+	memcpy(h->name, name, len + 1);
+	pthread_mutex_init(&h->lock, NULL);
+	h->rfd   = -1;
+	h->wfd   = -1;
+	h->time  = 0;
+	h->valid = AM_FALSE;
+	/*普通文件可能被删除或替换，只保留sysfs和设备节点打开的文件*/
+	h->nocache = strncmp(name, "/sys/", 5) && strncmp(name, "/dev/", 5);
+	h->next  = file_handles[hash];
+	file_handles[hash] = h;
+	file_handle_cnt++;
+
+	return h;
+}
+
+/**\brief 取得句柄中打开的文件，-1表示无法使用缓存的句柄，需在h->lock保护下调用*/
+static int file_handle_fd(AM_FileHandle_t h, AM_Bool_t wr)
+{
+	int *pfd = wr ? &h->wfd : &h->rfd;
+
+	if (h->nocache)
+		return -1;
+	if (*pfd == -1)
+		*pfd = open(h->name, (wr ? O_WRONLY : O_RDONLY) | O_CLOEXEC);
+
+	return *pfd;
+}
+
+/**\brief pread/pwrite失败后关闭句柄中的文件，下次重新打开，需在h->lock保护下调用*/
+static void file_handle_drop_fd(AM_FileHandle_t h, int fd, int err)
+{
+	/*设备文件等不支持指定位置读写*/
+	if (err == ESPIPE)
+		h->nocache = AM_TRUE;
+
+	if (h->rfd == fd)
+		h->rfd = -1;
+	else if (h->wfd == fd)
+		h->wfd = -1;
+	else
+		return;
+
+	close(fd);
+}
+
+/**\brief 关闭句柄中打开的文件，需在file_handle_lock保护下调用，等待正在进行的读写结束*/
+static void file_handle_close(AM_FileHandle_t h)
+{
+	pthread_mutex_lock(&h->lock);
+	if (h->rfd != -1)
+	{
+		close(h->rfd);
+		h->rfd = -1;
+	}
+	if (h->wfd != -1)
+	{
+		close(h->wfd);
+		h->wfd = -1;
+	}
+	pthread_mutex_unlock(&h->lock);
+	h->valid = AM_FALSE;
+}
+
+/**\brief 不使用缓存，打开文件读取一行*/
+static AM_ErrorCode_t file_read_once(const char *name, char *buf, int len)
+{
+	FILE *fp;
+	char *ret;
+
+	fp = fopen(name, "r");
+	if(!fp)
+	{
+		AM_DEBUG(1, "cannot open file \"%s\"", name);
+		return AM_FAILURE;
+	}
+	
+	ret = fgets(buf, len, fp);
+	if(!ret)
+	{
+		AM_DEBUG(1, "read the file:\"%s\" error:\"%s\" failed", name, strerror(errno));
+	}
+	
+	fclose(fp);
+	
+	return ret ? AM_SUCCESS : AM_FAILURE;
+}
+
+/**\brief 不使用缓存，打开文件写入字符串*/
+static AM_ErrorCode_t file_echo_once(const char *name, const char *cmd)
+{
+	int fd, len, ret;
+
+	fd = open(name, O_WRONLY);
+	if(fd==-1)
+	{
+		AM_DEBUG(1, "cannot open file \"%s\"", name);
+		return AM_FAILURE;
+	}
+	
+	len = strlen(cmd);
+	
+	ret = write(fd, cmd, len);
+	if(ret!=len)
+	{
+		AM_DEBUG(1, "write failed file:\"%s\" cmd:\"%s\" error:\"%s\"", name, cmd, strerror(errno));
+		close(fd);
+		return AM_FAILURE;
+	}
+
+	close(fd);
+
+	return AM_SUCCESS;
+}
+
+/**\brief 从文件开始处读取一行，优先使用缓存的句柄(一次pread)*/
+static AM_ErrorCode_t file_handle_pread(AM_FileHandle_t h, const char *name, char *buf, int len)
+{
+	int fd, ret, err, retry;
+	char *nl;
+
+	if (!h || (len <= 1))
+		return file_read_once(name, buf, len);
+
+	for (retry = 0; retry < 2; retry++)
+	{
+		pthread_mutex_lock(&h->lock);
+		fd = file_handle_fd(h, AM_FALSE);
+		if (fd == -1)
+		{
+			pthread_mutex_unlock(&h->lock);
+			break;
+		}
+
+		ret = pread(fd, buf, len - 1, 0);
+		if (ret > 0)
+		{
+			pthread_mutex_unlock(&h->lock);
+			/*和fgets一样只返回第一行*/
+			buf[ret] = 0;
+			nl = strchr(buf, '\n');
+			if (nl)
+				nl[1] = 0;
+			return AM_SUCCESS;
+		}
+		if (ret == 0)
+		{
+			pthread_mutex_unlock(&h->lock);
+			break;
+		}
+
+		/*节点可能被删除后重建，重新打开一次*/
+		err = errno;
+		file_handle_drop_fd(h, fd, err);
+		pthread_mutex_unlock(&h->lock);
+	}
+
+	/*由原来的方式读取并报告错误*/
+	return file_read_once(name, buf, len);
+}
+
+/**\brief 在文件开始处写入字符串，优先使用缓存的句柄(一次pwrite)*/
+static AM_ErrorCode_t file_handle_pwrite(AM_FileHandle_t h, const char *name, const char *cmd)
+{
+	int fd, ret, err, retry, len = strlen(cmd);
+
+	if (!h)
+		return file_echo_once(name, cmd);
+
+	for (retry = 0; retry < 2; retry++)
+	{
+		pthread_mutex_lock(&file_handle_lock);
+		h->valid = AM_FALSE;
+		pthread_mutex_unlock(&file_handle_lock);
+
+		pthread_mutex_lock(&h->lock);
+		fd = file_handle_fd(h, AM_TRUE);
+		if (fd == -1)
+		{
+			pthread_mutex_unlock(&h->lock);
+			break;
+		}
+
+		ret = pwrite(fd, cmd, len, 0);
+		if (ret == len)
+		{
+			pthread_mutex_unlock(&h->lock);
+			return AM_SUCCESS;
+		}
+
+		/*驱动拒绝写入的值时和原来一样报告错误*/
+		err = errno;
+		if ((ret >= 0) || ((err != ENODEV) && (err != EBADF) && (err != ESPIPE)))
+		{
+			pthread_mutex_unlock(&h->lock);
+			AM_DEBUG(1, "write failed file:\"%s\" cmd:\"%s\" error:\"%s\"", name, cmd, strerror(err));
+			return AM_FAILURE;
+		}
+
+		file_handle_drop_fd(h, fd, err);
+		pthread_mutex_unlock(&h->lock);
+	}
+
+	return file_echo_once(name, cmd);
+}
+
+/**\brief 向文件打印字符串*/
+static AM_ErrorCode_t file_handle_echo(AM_FileHandle_t h, const char *name, const char *cmd)
+{
+	if (rwSysfsCb.writeSysfsCb)
+	{
+		rwSysfsCb.writeSysfsCb(name, cmd);
+		return AM_SUCCESS;
+	}else
+	{
+		am_init_syscontrol_api();
+		if (Write_Sysfs_ptr != NULL)
+		{
+			if (h)
+			{
+				pthread_mutex_lock(&file_handle_lock);
+				h->valid = AM_FALSE;
+				pthread_mutex_unlock(&file_handle_lock);
+			}
+			return Write_Sysfs_ptr(name,cmd);
+		}
+	}
+
+	return file_handle_pwrite(h, name, cmd);
+}
+
+/**\brief 读取文件，max_age>0时返回不超过max_age毫秒的缓存值*/
+static AM_ErrorCode_t file_handle_read(AM_FileHandle_t h, const char *name, char *buf, int len, int max_age)
+{
+	AM_ErrorCode_t ret;
+	int now = 0;
+
+	if (h && (max_age > 0))
+	{
+		AM_TIME_GetClock(&now);
+
+		pthread_mutex_lock(&file_handle_lock);
+		if (h->valid && (now - h->time < max_age) && ((int)strlen(h->value) < len))
+		{
+			strcpy(buf, h->value);
+			pthread_mutex_unlock(&file_handle_lock);
+			return AM_SUCCESS;
+		}
+		pthread_mutex_unlock(&file_handle_lock);
+	}
+
+	if (rwSysfsCb.readSysfsCb)
+	{
+		rwSysfsCb.readSysfsCb(name, buf, len);
+		ret = AM_SUCCESS;
+	}
+	else
+	{
+		am_init_syscontrol_api();
+		if (ReadNum_Sysfs_ptr != NULL)
+			ret = ReadNum_Sysfs_ptr(name, buf, len);
+		else
+			ret = file_handle_pread(h, name, buf, len);
+	}
+
+	if (h && (max_age > 0) && (ret == AM_SUCCESS) && ((int)strnlen(buf, len) < (int)sizeof(h->value)))
+	{
+		pthread_mutex_lock(&file_handle_lock);
+		strcpy(h->value, buf);
+		h->time  = now;
+		h->valid = AM_TRUE;
+		pthread_mutex_unlock(&file_handle_lock);
+	}
+
+	return ret;
+}
+
 /****************************************************************************
  * API functions
  ***************************************************************************/
@@ -228,43 +559,15 @@ void AM_UnRegisterRWPropFun()
  */
 AM_ErrorCode_t AM_FileEcho(const char *name, const char *cmd)
 {
-	int fd, len, ret;
+	AM_FileHandle_t h;
 
 	assert(name && cmd);
 
-	if (rwSysfsCb.writeSysfsCb)
-	{
-		rwSysfsCb.writeSysfsCb(name, cmd);
-		return AM_SUCCESS;
-	}else
-	{
-		am_init_syscontrol_api();
-		if (Write_Sysfs_ptr != NULL)
-		{
-			return Write_Sysfs_ptr(name,cmd);
-		}
-	}
-
-	fd = open(name, O_WRONLY);
-	if(fd==-1)
-	{
-		AM_DEBUG(1, "cannot open file \"%s\"", name);
-		return AM_FAILURE;
-	}
-	
-	len = strlen(cmd);
-	
-	ret = write(fd, cmd, len);
-	if(ret!=len)
-	{
-		AM_DEBUG(1, "write failed file:\"%s\" cmd:\"%s\" error:\"%s\"", name, cmd, strerror(errno));
-		close(fd);
-		return AM_FAILURE;
-	}
-
-	close(fd);
+	pthread_mutex_lock(&file_handle_lock);
+	h = file_handle_get(name);
+	pthread_mutex_unlock(&file_handle_lock);
 
-	return AM_SUCCESS;
+	return file_handle_echo(h, name, cmd);
 }
 
 /**\brief 读取一个文件中的字符串
@@ -277,41 +580,93 @@ AM_ErrorCode_t AM_FileEcho(const char *name, const char *cmd)
  */
 AM_ErrorCode_t AM_FileRead(const char *name, char *buf, int len)
 {
-	FILE *fp;
-	char *ret;
-	
+	return AM_FileReadCached(name, buf, len, 0);
+}
+
+/**\brief 读取一个文件中的字符串，可以返回缓存的值
+ * \param[in] name 文件名
+ * \param[out] buf 存放字符串的缓冲区
+ * \param len 缓冲区大小
+ * \param max_age 缓存值的最长有效时间(毫秒)，<=0表示总是重新读取
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码
+ */
+AM_ErrorCode_t AM_FileReadCached(const char *name, char *buf, int len, int max_age)
+{
+	AM_FileHandle_t h;
+
 	assert(name && buf);
 
-	if (rwSysfsCb.readSysfsCb)
-	{
-		rwSysfsCb.readSysfsCb(name, buf, len);
-		return AM_SUCCESS;
-	}else
-	{
-		am_init_syscontrol_api();
-		if (ReadNum_Sysfs_ptr != NULL)
-		{
-			return ReadNum_Sysfs_ptr(name,buf,len);
-		}
-	}
+	pthread_mutex_lock(&file_handle_lock);
+	h = file_handle_get(name);
+	pthread_mutex_unlock(&file_handle_lock);
 
+	return file_handle_read(h, name, buf, len, max_age);
+}
 
-	fp = fopen(name, "r");
-	if(!fp)
-	{
-		AM_DEBUG(1, "cannot open file \"%s\"", name);
-		return AM_FAILURE;
-	}
-	
-	ret = fgets(buf, len, fp);
-	if(!ret)
+/**\brief 取得文件的句柄，同一文件名在进程中共用一个句柄
+ * \param[in] name 文件名
+ * \param[out] handle 返回句柄
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码
+ */
+AM_ErrorCode_t AM_FileOpenHandle(const char *name, AM_FileHandle_t *handle)
+{
+	assert(name && handle);
+
+	pthread_mutex_lock(&file_handle_lock);
+	*handle = file_handle_get(name);
+	pthread_mutex_unlock(&file_handle_lock);
+
+	return *handle ? AM_SUCCESS : AM_FAILURE;
+}
+
+/**\brief 通过句柄读取文件中的字符串
+ * \param handle 文件句柄
+ * \param[out] buf 存放字符串的缓冲区
+ * \param len 缓冲区大小
+ * \param max_age 缓存值的最长有效时间(毫秒)，<=0表示总是重新读取
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码
+ */
+AM_ErrorCode_t AM_FileHandleRead(AM_FileHandle_t handle, char *buf, int len, int max_age)
+{
+	assert(handle && buf);
+
+	return file_handle_read(handle, handle->name, buf, len, max_age);
+}
+
+/**\brief 通过句柄向文件打印字符串
+ * \param handle 文件句柄
+ * \param[in] cmd 向文件打印的字符串
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码
+ */
+AM_ErrorCode_t AM_FileHandleEcho(AM_FileHandle_t handle, const char *cmd)
+{
+	assert(handle && cmd);
+
+	return file_handle_echo(handle, handle->name, cmd);
+}
+
+/**\brief 关闭所有句柄中打开的文件，句柄仍然有效，下次访问时重新打开
+ */
+void AM_FileCloseHandles(void)
+{
+	AM_FileHandle_t h;
+	int i;
+
+	pthread_mutex_lock(&file_handle_lock);
+	for (i = 0; i < FILE_HANDLE_HASH_SIZE; i++)
 	{
-		AM_DEBUG(1, "read the file:\"%s\" error:\"%s\" failed", name, strerror(errno));
+		for (h = file_handles[i]; h; h = h->next)
+			file_handle_close(h);
 	}
-	
-	fclose(fp);
-	
-	return ret ? AM_SUCCESS : AM_FAILURE;
+	pthread_mutex_unlock(&file_handle_lock);
 }
 
 
@@ -0,0 +1,378 @@
+/***************************************************************************
+ * Copyright (c) 2019 Amlogic, Inc. All rights reserved.
+ *
+ * This source code is subject to the terms and conditions defined in the
+ * file 'LICENSE' which is part of this source code package.
+ ***************************************************************************/
+/**\file
+ * \brief AES block cipher
+ *
+ * The lookup tables are built from the S-box on first use. The blocks are
+ * handled as four big endian words, the same as in FIPS-197.
+ */
+
+#include <string.h>
+#include <pthread.h>
+#include "aes.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <wmmintrin.h>
+#define AES_HW_X86
+#define AES_HW_TARGET __attribute__((target("aes,sse2")))
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__linux__)
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_AES
+#define HWCAP_AES (1 << 3)
+#endif
+#define AES_HW_ARM
+#ifdef __clang__
+#define AES_HW_TARGET __attribute__((target("crypto")))
+#else
+#define AES_HW_TARGET __attribute__((target("+crypto")))
+#endif
+#endif
+
+/*blocks crypted together, hides the latency of the AES instructions*/
+#define AES_HW_LANES  4
+
+#define GETU32(p) (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[2] << 8) | (uint32_t)(p)[3])
+#define PUTU32(p, v) do { (p)[0] = (uint8_t)((v) >> 24); (p)[1] = (uint8_t)((v) >> 16); \
+	(p)[2] = (uint8_t)((v) >> 8); (p)[3] = (uint8_t)(v); } while (0)
+
+static uint8_t  sbox[256];
+static uint8_t  inv_sbox[256];
+static uint32_t te[4][256];
+static uint32_t td[4][256];
+static int      hw_aes;
+static pthread_once_t tables_once = PTHREAD_ONCE_INIT;
+
+static inline uint8_t xtime(uint8_t x)
+{
+	return (uint8_t)((x << 1) ^ ((x & 0x80) ? 0x1b : 0));
+}
+
+static uint8_t gf_mul(uint8_t a, uint8_t b)
+{
+	uint8_t r = 0;
+
+	while (b) {
+		if (b & 1)
+			r ^= a;
+		a = xtime(a);
+		b >>= 1;
+	}
+	return r;
+}
+
+static inline uint32_t ror32(uint32_t x, int n)
+{
+	return (x >> n) | (x << (32 - n));
+}
+
+static inline uint8_t rol8(uint8_t x, int n)
+{
+	return (uint8_t)((x << n) | (x >> (8 - n)));
+}
+
+static int aes_hw_probe(void)
+{
+#if defined(AES_HW_X86)
+	unsigned int a, b, c, d;
+
+	if (!__get_cpuid(1, &a, &b, &c, &d))
+		return 0;
+	return (c & bit_AES) && (d & bit_SSE2);
+#elif defined(AES_HW_ARM)
+	return (getauxval(AT_HWCAP) & HWCAP_AES) ? 1 : 0;
+#else
+	return 0;
+#endif
+}
+
+static void aes_init_tables(void)
+{
+	uint8_t p = 1, q = 1;
+	int i;
+
+	/*p runs through the multiplicative group with generator 3, q = 1/p*/
+	do {
+		p = p ^ xtime(p);
+		q ^= q << 1;
+		q ^= q << 2;
+		q ^= q << 4;
+		if (q & 0x80)
+			q ^= 0x09;
+		sbox[p] = q ^ rol8(q, 1) ^ rol8(q, 2) ^ rol8(q, 3) ^ rol8(q, 4) ^ 0x63;
+	} while (p != 1);
+	sbox[0] = 0x63;
+
+	for (i = 0; i < 256; i++)
+		inv_sbox[sbox[i]] = (uint8_t)i;
+
+	for (i = 0; i < 256; i++) {
+		uint8_t s = sbox[i], t = inv_sbox[i];
+
+		te[0][i] = ((uint32_t)xtime(s) << 24) | ((uint32_t)s << 16) | ((uint32_t)s << 8) | (uint32_t)(xtime(s) ^ s);
+		td[0][i] = ((uint32_t)gf_mul(t, 14) << 24) | ((uint32_t)gf_mul(t, 9) << 16) |
+			((uint32_t)gf_mul(t, 13) << 8) | (uint32_t)gf_mul(t, 11);
+		te[1][i] = ror32(te[0][i], 8);
+		te[2][i] = ror32(te[0][i], 16);
+		te[3][i] = ror32(te[0][i], 24);
+		td[1][i] = ror32(td[0][i], 8);
+		td[2][i] = ror32(td[0][i], 16);
+		td[3][i] = ror32(td[0][i], 24);
+	}
+
+	hw_aes = aes_hw_probe();
+}
+
+static inline uint32_t sub_word(uint32_t w)
+{
+	return ((uint32_t)sbox[w >> 24] << 24) | ((uint32_t)sbox[(w >> 16) & 0xff] << 16) |
+		((uint32_t)sbox[(w >> 8) & 0xff] << 8) | (uint32_t)sbox[w & 0xff];
+}
+
+/*InvMixColumns of a round key word*/
+static inline uint32_t inv_mix_word(uint32_t w)
+{
+	return td[0][sbox[w >> 24]] ^ td[1][sbox[(w >> 16) & 0xff]] ^
+		td[2][sbox[(w >> 8) & 0xff]] ^ td[3][sbox[w & 0xff]];
+}
+
+static void aes_c_encrypt(const AESContext *a, uint8_t *dst, const uint8_t *src)
+{
+	const uint32_t *rk = a->ek;
+	uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+	int r;
+
+	s0 = GETU32(src) ^ rk[0];
+	s1 = GETU32(src + 4) ^ rk[1];
+	s2 = GETU32(src + 8) ^ rk[2];
+	s3 = GETU32(src + 12) ^ rk[3];
+
+	for (r = 1; r < a->rounds; r++) {
+		rk += 4;
+		t0 = te[0][s0 >> 24] ^ te[1][(s1 >> 16) & 0xff] ^ te[2][(s2 >> 8) & 0xff] ^ te[3][s3 & 0xff] ^ rk[0];
+		t1 = te[0][s1 >> 24] ^ te[1][(s2 >> 16) & 0xff] ^ te[2][(s3 >> 8) & 0xff] ^ te[3][s0 & 0xff] ^ rk[1];
+		t2 = te[0][s2 >> 24] ^ te[1][(s3 >> 16) & 0xff] ^ te[2][(s0 >> 8) & 0xff] ^ te[3][s1 & 0xff] ^ rk[2];
+		t3 = te[0][s3 >> 24] ^ te[1][(s0 >> 16) & 0xff] ^ te[2][(s1 >> 8) & 0xff] ^ te[3][s2 & 0xff] ^ rk[3];
+		s0 = t0;
+		s1 = t1;
+		s2 = t2;
+		s3 = t3;
+	}
+
+	rk += 4;
+	t0 = ((uint32_t)sbox[s0 >> 24] << 24) | ((uint32_t)sbox[(s1 >> 16) & 0xff] << 16) |
+		((uint32_t)sbox[(s2 >> 8) & 0xff] << 8) | (uint32_t)sbox[s3 & 0xff];
+	t1 = ((uint32_t)sbox[s1 >> 24] << 24) | ((uint32_t)sbox[(s2 >> 16) & 0xff] << 16) |
+		((uint32_t)sbox[(s3 >> 8) & 0xff] << 8) | (uint32_t)sbox[s0 & 0xff];
+	t2 = ((uint32_t)sbox[s2 >> 24] << 24) | ((uint32_t)sbox[(s3 >> 16) & 0xff] << 16) |
+		((uint32_t)sbox[(s0 >> 8) & 0xff] << 8) | (uint32_t)sbox[s1 & 0xff];
+	t3 = ((uint32_t)sbox[s3 >> 24] << 24) | ((uint32_t)sbox[(s0 >> 16) & 0xff] << 16) |
+		((uint32_t)sbox[(s1 >> 8) & 0xff] << 8) | (uint32_t)sbox[s2 & 0xff];
+
+	PUTU32(dst, t0 ^ rk[0]);
+	PUTU32(dst + 4, t1 ^ rk[1]);
+	PUTU32(dst + 8, t2 ^ rk[2]);
+	PUTU32(dst + 12, t3 ^ rk[3]);
+}
+
+static void aes_c_decrypt(const AESContext *a, uint8_t *dst, const uint8_t *src)
+{
+	const uint32_t *rk = a->dk;
+	uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+	int r;
+
+	s0 = GETU32(src) ^ rk[0];
+	s1 = GETU32(src + 4) ^ rk[1];
+	s2 = GETU32(src + 8) ^ rk[2];
+	s3 = GETU32(src + 12) ^ rk[3];
+
+	for (r = 1; r < a->rounds; r++) {
+		rk += 4;
+		t0 = td[0][s0 >> 24] ^ td[1][(s3 >> 16) & 0xff] ^ td[2][(s2 >> 8) & 0xff] ^ td[3][s1 & 0xff] ^ rk[0];
+		t1 = td[0][s1 >> 24] ^ td[1][(s0 >> 16) & 0xff] ^ td[2][(s3 >> 8) & 0xff] ^ td[3][s2 & 0xff] ^ rk[1];
+		t2 = td[0][s2 >> 24] ^ td[1][(s1 >> 16) & 0xff] ^ td[2][(s0 >> 8) & 0xff] ^ td[3][s3 & 0xff] ^ rk[2];
+		t3 = td[0][s3 >> 24] ^ td[1][(s2 >> 16) & 0xff] ^ td[2][(s1 >> 8) & 0xff] ^ td[3][s0 & 0xff] ^ rk[3];
+		s0 = t0;
+		s1 = t1;
+		s2 = t2;
+		s3 = t3;
+	}
+
+	rk += 4;
+	t0 = ((uint32_t)inv_sbox[s0 >> 24] << 24) | ((uint32_t)inv_sbox[(s3 >> 16) & 0xff] << 16) |
+		((uint32_t)inv_sbox[(s2 >> 8) & 0xff] << 8) | (uint32_t)inv_sbox[s1 & 0xff];
+	t1 = ((uint32_t)inv_sbox[s1 >> 24] << 24) | ((uint32_t)inv_sbox[(s0 >> 16) & 0xff] << 16) |
+		((uint32_t)inv_sbox[(s3 >> 8) & 0xff] << 8) | (uint32_t)inv_sbox[s2 & 0xff];
+	t2 = ((uint32_t)inv_sbox[s2 >> 24] << 24) | ((uint32_t)inv_sbox[(s1 >> 16) & 0xff] << 16) |
+		((uint32_t)inv_sbox[(s0 >> 8) & 0xff] << 8) | (uint32_t)inv_sbox[s3 & 0xff];
+	t3 = ((uint32_t)inv_sbox[s3 >> 24] << 24) | ((uint32_t)inv_sbox[(s2 >> 16) & 0xff] << 16) |
+		((uint32_t)inv_sbox[(s1 >> 8) & 0xff] << 8) | (uint32_t)inv_sbox[s0 & 0xff];
+
+	PUTU32(dst, t0 ^ rk[0]);
+	PUTU32(dst + 4, t1 ^ rk[1]);
+	PUTU32(dst + 8, t2 ^ rk[2]);
+	PUTU32(dst + 12, t3 ^ rk[3]);
+}
+
+#if defined(AES_HW_X86)
+
+AES_HW_TARGET static void aes_hw_ecb(const AESContext *a, uint8_t *dst, const uint8_t *src, int count, int decrypt)
+{
+	const uint8_t *rk8 = decrypt ? a->dk8 : a->ek8;
+	__m128i k[AES_MAX_ROUNDS + 1], b[AES_HW_LANES];
+	int n = a->rounds, i, j, r;
+
+	for (r = 0; r <= n; r++)
+		k[r] = _mm_loadu_si128((const __m128i *)(rk8 + r * AES_BLOCK_SIZE));
+
+	while (count > 0) {
+		int lanes = (count < AES_HW_LANES) ? count : AES_HW_LANES;
+
+		for (j = 0; j < lanes; j++)
+			b[j] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(src + j * AES_BLOCK_SIZE)), k[0]);
+
+		if (decrypt) {
+			for (r = 1; r < n; r++)
+				for (j = 0; j < lanes; j++)
+					b[j] = _mm_aesdec_si128(b[j], k[r]);
+			for (j = 0; j < lanes; j++)
+				b[j] = _mm_aesdeclast_si128(b[j], k[n]);
+		} else {
+			for (r = 1; r < n; r++)
+				for (j = 0; j < lanes; j++)
+					b[j] = _mm_aesenc_si128(b[j], k[r]);
+			for (j = 0; j < lanes; j++)
+				b[j] = _mm_aesenclast_si128(b[j], k[n]);
+		}
+
+		for (j = 0; j < lanes; j++)
+			_mm_storeu_si128((__m128i *)(dst + j * AES_BLOCK_SIZE), b[j]);
+
+		i = lanes * AES_BLOCK_SIZE;
+		src += i;
+		dst += i;
+		count -= lanes;
+	}
+}
+
+#elif defined(AES_HW_ARM)
+
+AES_HW_TARGET static void aes_hw_ecb(const AESContext *a, uint8_t *dst, const uint8_t *src, int count, int decrypt)
+{
+	const uint8_t *rk8 = decrypt ? a->dk8 : a->ek8;
+	uint8x16_t k[AES_MAX_ROUNDS + 1], b[AES_HW_LANES];
+	int n = a->rounds, i, j, r;
+
+	for (r = 0; r <= n; r++)
+		k[r] = vld1q_u8(rk8 + r * AES_BLOCK_SIZE);
+
+	while (count > 0) {
+		int lanes = (count < AES_HW_LANES) ? count : AES_HW_LANES;
+
+		for (j = 0; j < lanes; j++)
+			b[j] = vld1q_u8(src + j * AES_BLOCK_SIZE);
+
+		/*AESE/AESD add the round key first, the last key is added alone*/
+		if (decrypt) {
+			for (r = 0; r < n - 1; r++)
+				for (j = 0; j < lanes; j++)
+					b[j] = vaesimcq_u8(vaesdq_u8(b[j], k[r]));
+			for (j = 0; j < lanes; j++)
+				b[j] = veorq_u8(vaesdq_u8(b[j], k[n - 1]), k[n]);
+		} else {
+			for (r = 0; r < n - 1; r++)
+				for (j = 0; j < lanes; j++)
+					b[j] = vaesmcq_u8(vaeseq_u8(b[j], k[r]));
+			for (j = 0; j < lanes; j++)
+				b[j] = veorq_u8(vaeseq_u8(b[j], k[n - 1]), k[n]);
+		}
+
+		for (j = 0; j < lanes; j++)
+			vst1q_u8(dst + j * AES_BLOCK_SIZE, b[j]);
+
+		i = lanes * AES_BLOCK_SIZE;
+		src += i;
+		dst += i;
+		count -= lanes;
+	}
+}
+
+#endif
+
+int aes_hw_available(void)
+{
+	pthread_once(&tables_once, aes_init_tables);
+	return hw_aes;
+}
+
+int aes_init(AESContext *a, const uint8_t *key, int key_bits, int soft)
+{
+	uint32_t *w = a->ek;
+	uint8_t rcon = 1;
+	int nk, total, i, j;
+
+	if ((key_bits != 128) && (key_bits != 192) && (key_bits != 256))
+		return -1;
+
+	pthread_once(&tables_once, aes_init_tables);
+
+	nk = key_bits / 32;
+	a->rounds = nk + 6;
+	a->hw = soft ? 0 : hw_aes;
+	total = 4 * (a->rounds + 1);
+
+	for (i = 0; i < nk; i++)
+		w[i] = GETU32(key + 4 * i);
+
+	for (i = nk; i < total; i++) {
+		uint32_t t = w[i - 1];
+
+		if (i % nk == 0) {
+			t = sub_word((t << 8) | (t >> 24)) ^ ((uint32_t)rcon << 24);
+			rcon = xtime(rcon);
+		} else if ((nk > 6) && (i % nk == 4)) {
+			t = sub_word(t);
+		}
+		w[i] = w[i - nk] ^ t;
+	}
+
+	/*equivalent inverse cipher, the round keys in reverse order with InvMixColumns*/
+	for (i = 0; i <= a->rounds; i++) {
+		for (j = 0; j < 4; j++) {
+			uint32_t k = w[4 * (a->rounds - i) + j];
+
+			a->dk[4 * i + j] = ((i == 0) || (i == a->rounds)) ? k : inv_mix_word(k);
+		}
+	}
+
+	for (i = 0; i < total; i++) {
+		PUTU32(a->ek8 + 4 * i, a->ek[i]);
+		PUTU32(a->dk8 + 4 * i, a->dk[i]);
+	}
+
+	return 0;
+}
+
+void aes_ecb(const AESContext *a, uint8_t *dst, const uint8_t *src, int count, int decrypt)
+{
+#if defined(AES_HW_X86) || defined(AES_HW_ARM)
+	if (a->hw) {
+		aes_hw_ecb(a, dst, src, count, decrypt);
+		return;
+	}
+#endif
+
+	while (count-- > 0) {
+		if (decrypt)
+			aes_c_decrypt(a, dst, src);
+		else
+			aes_c_encrypt(a, dst, src);
+		src += AES_BLOCK_SIZE;
+		dst += AES_BLOCK_SIZE;
+	}
+}
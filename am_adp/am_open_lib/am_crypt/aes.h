@@ -0,0 +1,46 @@
+/***************************************************************************
+ * Copyright (c) 2019 Amlogic, Inc. All rights reserved.
+ *
+ * This source code is subject to the terms and conditions defined in the
+ * file 'LICENSE' which is part of this source code package.
+ ***************************************************************************/
+/**\file
+ * \brief AES block cipher (FIPS-197), ECB
+ *
+ * The portable code uses the usual 32 bit lookup tables. When the CPU has
+ * AES instructions (AES-NI on x86, the ARMv8 crypto extension on AArch64)
+ * they are detected at run time and used instead, several blocks at a time.
+ */
+
+#ifndef _AM_AES_H
+#define _AM_AES_H
+
+#include <stdint.h>
+
+#define AES_BLOCK_SIZE  16
+#define AES_MAX_ROUNDS  14
+
+/**\brief Expanded key*/
+typedef struct {
+	uint32_t ek[4 * (AES_MAX_ROUNDS + 1)];	/**< encryption round keys*/
+	uint32_t dk[4 * (AES_MAX_ROUNDS + 1)];	/**< equivalent inverse cipher round keys*/
+	uint8_t  ek8[AES_BLOCK_SIZE * (AES_MAX_ROUNDS + 1)];	/**< ek in byte order, for the AES instructions*/
+	uint8_t  dk8[AES_BLOCK_SIZE * (AES_MAX_ROUNDS + 1)];	/**< dk in byte order, for the AES instructions*/
+	int      rounds;
+	int      hw;	/**< use the AES instructions*/
+} AESContext;
+
+/**\brief Check if the CPU has AES instructions*/
+int aes_hw_available(void);
+
+/**\brief Expand a key
+ * \param key_bits must be 128, 192 or 256
+ * \param soft do not use the AES instructions even if the CPU has them
+ * \return zero on success, negative value otherwise
+ */
+int aes_init(AESContext *a, const uint8_t *key, int key_bits, int soft);
+
+/**\brief Crypt count 16 byte blocks in ECB mode, dst can be equal to src*/
+void aes_ecb(const AESContext *a, uint8_t *dst, const uint8_t *src, int count, int decrypt);
+
+#endif
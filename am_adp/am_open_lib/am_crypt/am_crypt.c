@@ -1,20 +1,37 @@
+#include <stdlib.h>
 #include <string.h>
 #include "des.h"
+#include "des_bs.h"
+#include "aes.h"
+#include "am_types.h"
+#include "am_crypt.h"
 
-static void av_des_crypt_ts_packet(AVDES* d, uint8_t* dst, const uint8_t *src, int decrypt)
+/*4 bytes TS header in clear, then whole DES blocks*/
+#define DES_TS_HEADER	4
+#define DES_TS_BLOCKS	((188 - DES_TS_HEADER) / 8)
+
+typedef struct {
+	AVDES       des;
+	DESBitslice bs;
+} AM_CRYPT_Des_t;
+
+static void av_des_crypt_ts_packet(AVDES* d, uint8_t* dst, const uint8_t *src, int len, int decrypt)
 {
-	memmove(dst, src, 4);
-	av_des_crypt(d, dst + 4, src + 4, 24, NULL, decrypt);
+	memmove(dst, src, DES_TS_HEADER);
+	av_des_crypt(d, dst + DES_TS_HEADER, src + DES_TS_HEADER, (len - DES_TS_HEADER) / 8, NULL, decrypt);
 }
 
 
 void *AM_CRYPT_des_open(const uint8_t *key, int key_bits)
 {
-	AVDES *d = (AVDES *)malloc(sizeof(AVDES));
+	AM_CRYPT_Des_t *d = (AM_CRYPT_Des_t *)malloc(sizeof(AM_CRYPT_Des_t));
 	if (d) {
-		int ret = av_des_init(d, key, key_bits);
-		if (ret)
+		int ret = av_des_init(&d->des, key, key_bits);
+		if (ret) {
+			free(d);
 			return NULL;
+		}
+		des_bs_init(&d->bs, &d->des);
 	}
 	return d;
 }
@@ -27,5 +44,114 @@ int AM_CRYPT_des_close(void *cryptor)
 
 void AM_CRYPT_des_crypt(void* cryptor, uint8_t* dst, const uint8_t *src, int len, uint8_t *iv, int decrypt)
 {
-	av_des_crypt_ts_packet((AVDES *)cryptor, dst, src, decrypt);
+	UNUSED(iv);
+
+	av_des_crypt_ts_packet(&((AM_CRYPT_Des_t *)cryptor)->des, dst, src, len, decrypt);
+}
+
+void AM_CRYPT_des_crypt_pkts(void* cryptor, uint8_t* dst, const uint8_t *src, int pkt_cnt, int decrypt)
+{
+	AM_CRYPT_Des_t *d = (AM_CRYPT_Des_t *)cryptor;
+	uint8_t *dblk[DES_BS_LANES];
+	const uint8_t *sblk[DES_BS_LANES];
+	int i, j, n = 0;
+
+	/*the blocks of all the packets are crypted DES_BS_LANES at a time*/
+	for (i = 0; i < pkt_cnt; i++) {
+		const uint8_t *s = src + i * 188;
+		uint8_t *p = dst + i * 188;
+
+		memmove(p, s, DES_TS_HEADER);
+
+		for (j = 0; j < DES_TS_BLOCKS; j++) {
+			sblk[n] = s + DES_TS_HEADER + j * 8;
+			dblk[n] = p + DES_TS_HEADER + j * 8;
+			if (++n == DES_BS_LANES) {
+				des_bs_crypt(&d->bs, dblk, sblk, n, decrypt);
+				n = 0;
+			}
+		}
+	}
+
+	if (n)
+		des_bs_crypt(&d->bs, dblk, sblk, n, decrypt);
+}
+
+/*4 bytes TS header in clear, 11 whole AES blocks and 8 bytes left*/
+#define AES_TS_HEADER	4
+#define AES_TS_BLOCKS	((188 - AES_TS_HEADER) / AES_BLOCK_SIZE)
+#define AES_TS_TAIL	((188 - AES_TS_HEADER) % AES_BLOCK_SIZE)
+
+typedef struct {
+	AESContext aes;
+	int        flags;
+} AM_CRYPT_Aes_t;
+
+static void aes_crypt_ts_packet(AM_CRYPT_Aes_t *a, uint8_t *dst, const uint8_t *src, int decrypt)
+{
+	const uint8_t *s = src + AES_TS_HEADER;
+	uint8_t *d = dst + AES_TS_HEADER;
+	int whole = a->flags & AM_CRYPT_AES_FL_WHOLE_PAYLOAD;
+	uint8_t x[AES_BLOCK_SIZE], y[AES_BLOCK_SIZE];
+
+	memmove(dst, src, AES_TS_HEADER);
+
+	if (!whole) {
+		aes_ecb(&a->aes, d, s, AES_TS_BLOCKS, decrypt);
+		memmove(d + AES_TS_BLOCKS * AES_BLOCK_SIZE, s + AES_TS_BLOCKS * AES_BLOCK_SIZE, AES_TS_TAIL);
+		return;
+	}
+
+	/*ciphertext stealing, the tail is crypted with the end of the last whole block,
+	 *the same steps undo it*/
+	memcpy(y, s + AES_TS_BLOCKS * AES_BLOCK_SIZE, AES_TS_TAIL);
+	aes_ecb(&a->aes, d, s, AES_TS_BLOCKS, decrypt);
+	d += (AES_TS_BLOCKS - 1) * AES_BLOCK_SIZE;
+
+	memcpy(x, d, AES_BLOCK_SIZE);
+	memcpy(y + AES_TS_TAIL, x + AES_TS_TAIL, AES_BLOCK_SIZE - AES_TS_TAIL);
+	aes_ecb(&a->aes, d, y, 1, decrypt);
+	memcpy(d + AES_BLOCK_SIZE, x, AES_TS_TAIL);
+}
+
+void *AM_CRYPT_aes_open(const uint8_t *key, int key_bits, int flags)
+{
+	AM_CRYPT_Aes_t *a = (AM_CRYPT_Aes_t *)malloc(sizeof(AM_CRYPT_Aes_t));
+
+	if (a) {
+		if (aes_init(&a->aes, key, key_bits, flags & AM_CRYPT_AES_FL_SOFT)) {
+			free(a);
+			return NULL;
+		}
+		a->flags = flags;
+	}
+	return a;
+}
+
+int AM_CRYPT_aes_close(void *cryptor)
+{
+	free(cryptor);
+	return 0;
+}
+
+int AM_CRYPT_aes_hw_available(void)
+{
+	return aes_hw_available();
+}
+
+void AM_CRYPT_aes_crypt(void* cryptor, uint8_t* dst, const uint8_t *src, int len, uint8_t *iv, int decrypt)
+{
+	UNUSED(len);
+	UNUSED(iv);
+
+	aes_crypt_ts_packet((AM_CRYPT_Aes_t *)cryptor, dst, src, decrypt);
+}
+
+void AM_CRYPT_aes_crypt_pkts(void* cryptor, uint8_t* dst, const uint8_t *src, int pkt_cnt, int decrypt)
+{
+	AM_CRYPT_Aes_t *a = (AM_CRYPT_Aes_t *)cryptor;
+	int i;
+
+	for (i = 0; i < pkt_cnt; i++)
+		aes_crypt_ts_packet(a, dst + i * 188, src + i * 188, decrypt);
 }
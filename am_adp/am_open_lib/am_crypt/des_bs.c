@@ -0,0 +1,608 @@
+/***************************************************************************
+ * Copyright (c) 2019 Amlogic, Inc. All rights reserved.
+ *
+ * This source code is subject to the terms and conditions defined in the
+ * file 'LICENSE' which is part of this source code package.
+ ***************************************************************************/
+/**\file
+ * \brief Bitsliced DES
+ *
+ * The tables and bit numbers follow FIPS 46-3, bit 1 is the most
+ * significant bit of a block.
+ */
+
+#include <string.h>
+#include "des_bs.h"
+
+static const uint8_t IP[64] = {
+	58, 50, 42, 34, 26, 18, 10, 2,
+	60, 52, 44, 36, 28, 20, 12, 4,
+	62, 54, 46, 38, 30, 22, 14, 6,
+	64, 56, 48, 40, 32, 24, 16, 8,
+	57, 49, 41, 33, 25, 17,  9, 1,
+	59, 51, 43, 35, 27, 19, 11, 3,
+	61, 53, 45, 37, 29, 21, 13, 5,
+	63, 55, 47, 39, 31, 23, 15, 7
+};
+
+static const uint8_t FP[64] = {
+	40, 8, 48, 16, 56, 24, 64, 32,
+	39, 7, 47, 15, 55, 23, 63, 31,
+	38, 6, 46, 14, 54, 22, 62, 30,
+	37, 5, 45, 13, 53, 21, 61, 29,
+	36, 4, 44, 12, 52, 20, 60, 28,
+	35, 3, 43, 11, 51, 19, 59, 27,
+	34, 2, 42, 10, 50, 18, 58, 26,
+	33, 1, 41,  9, 49, 17, 57, 25
+};
+
+static const uint8_t E[48] = {
+	32,  1,  2,  3,  4,  5,
+	 4,  5,  6,  7,  8,  9,
+	 8,  9, 10, 11, 12, 13,
+	12, 13, 14, 15, 16, 17,
+	16, 17, 18, 19, 20, 21,
+	20, 21, 22, 23, 24, 25,
+	24, 25, 26, 27, 28, 29,
+	28, 29, 30, 31, 32,  1
+};
+
+static const uint8_t P[32] = {
+	16,  7, 20, 21, 29, 12, 28, 17,
+	 1, 15, 23, 26,  5, 18, 31, 10,
+	 2,  8, 24, 14, 32, 27,  3,  9,
+	19, 13, 30,  6, 22, 11,  4, 25
+};
+
+/*transpose a 64x64 bit matrix, bit 63 is column 0*/
+static void transpose64(uint64_t a[64])
+{
+	uint64_t m, t;
+	int j, k;
+
+	for (j = 32, m = 0x00000000ffffffffULL; j; j >>= 1, m ^= m << j) {
+		for (k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+			t = (a[k] ^ (a[k | j] >> j)) & m;
+			a[k] ^= t;
+			a[k | j] ^= t << j;
+		}
+	}
+}
+
+/*the 16 minterms of the column bits x[1]..x[4]*/
+static inline void decode_col(const uint64_t *x, uint64_t *m)
+{
+	uint64_t h[4], l[4];
+	int i;
+
+	h[0] = ~x[1] & ~x[2];
+	h[1] = ~x[1] &  x[2];
+	h[2] =  x[1] & ~x[2];
+	h[3] =  x[1] &  x[2];
+	l[0] = ~x[3] & ~x[4];
+	l[1] = ~x[3] &  x[4];
+	l[2] =  x[3] & ~x[4];
+	l[3] =  x[3] &  x[4];
+
+	for (i = 0; i < 16; i++)
+		m[i] = h[i >> 2] & l[i & 3];
+}
+
+/*select the row x[0] x[5]*/
+static inline uint64_t select_row(const uint64_t *x, const uint64_t *r)
+{
+	uint64_t lo = r[0] ^ ((r[0] ^ r[1]) & x[5]);
+	uint64_t hi = r[2] ^ ((r[2] ^ r[3]) & x[5]);
+
+	return lo ^ ((lo ^ hi) & x[0]);
+}
+
+/*The S-boxes below are generated from the FIPS 46-3 tables. Each row of
+ *an output bit is the OR of the columns where the bit is 1, the ORs used
+ *by more than one row are computed once into m[16...]. o[0] is the most
+ *significant bit of the output.
+ */
+static inline void sbox1(const uint64_t *x, uint64_t *o)
+{
+	uint64_t m[37], r[4];
+
+	decode_col(x, m);
+	m[16] = m[1] | m[11];
+	m[17] = m[2] | m[5];
+	m[18] = m[4] | m[8];
+	m[19] = m[0] | m[9];
+	m[20] = m[6] | m[13];
+	m[21] = m[12] | m[16];
+	m[22] = m[7] | m[10];
+	m[23] = m[14] | m[18];
+	m[24] = m[6] | m[15];
+	m[25] = m[7] | m[20];
+	m[26] = m[11] | m[17];
+	m[27] = m[15] | m[17];
+	m[28] = m[2] | m[3];
+	m[29] = m[3] | m[12];
+	m[30] = m[5] | m[19];
+	m[31] = m[9] | m[28];
+	m[32] = m[10] | m[18];
+	m[33] = m[16] | m[23];
+	m[34] = m[19] | m[26];
+	m[35] = m[21] | m[27];
+	m[36] = m[24] | m[30];
+	r[0] = m[25] | m[34];
+	r[1] = m[21] | m[24] | m[32];
+	r[2] = m[13] | m[18] | m[22] | m[31];
+	r[3] = m[19] | m[35];
+	o[0] = select_row(x, r);
+	r[0] = m[0] | m[10] | m[35];
+	r[1] = m[1] | m[4] | m[10] | m[20] | m[31];
+	r[2] = m[23] | m[34];
+	r[3] = m[0] | m[7] | m[15] | m[33];
+	o[1] = select_row(x, r);
+	r[0] = m[32] | m[36];
+	r[1] = m[9] | m[17] | m[33];
+	r[2] = m[8] | m[12] | m[25] | m[26];
+	r[3] = m[11] | m[14] | m[19] | m[22] | m[29];
+	o[2] = select_row(x, r);
+	r[0] = m[8] | m[20] | m[27] | m[29];
+	r[1] = m[2] | m[14] | m[21] | m[25];
+	r[2] = m[21] | m[22] | m[23];
+	r[3] = m[8] | m[22] | m[36];
+	o[3] = select_row(x, r);
+}
+
+static inline void sbox2(const uint64_t *x, uint64_t *o)
+{
+	uint64_t m[36], r[4];
+
+	decode_col(x, m);
+	m[16] = m[3] | m[4];
+	m[17] = m[0] | m[5];
+	m[18] = m[11] | m[14];
+	m[19] = m[1] | m[15];
+	m[20] = m[2] | m[8];
+	m[21] = m[6] | m[9];
+	m[22] = m[7] | m[12];
+	m[23] = m[10] | m[16];
+	m[24] = m[17] | m[18];
+	m[25] = m[15] | m[17];
+	m[26] = m[16] | m[22];
+	m[27] = m[19] | m[20];
+	m[28] = m[1] | m[8];
+	m[29] = m[3] | m[20];
+	m[30] = m[4] | m[7];
+	m[31] = m[5] | m[10];
+	m[32] = m[6] | m[13];
+	m[33] = m[13] | m[19];
+	m[34] = m[21] | m[23];
+	m[35] = m[21] | m[24];
+	r[0] = m[11] | m[12] | m[25] | m[29];
+	r[1] = m[18] | m[28] | m[30] | m[32];
+	r[2] = m[12] | m[19] | m[34];
+	r[3] = m[24] | m[27];
+	o[0] = select_row(x, r);
+	r[0] = m[0] | m[9] | m[18] | m[26];
+	r[1] = m[26] | m[27];
+	r[2] = m[6] | m[11] | m[27] | m[31];
+	r[3] = m[10] | m[13] | m[35];
+	o[1] = select_row(x, r);
+	r[0] = m[25] | m[34];
+	r[1] = m[24] | m[26];
+	r[2] = m[2] | m[16] | m[18] | m[33];
+	r[3] = m[9] | m[14] | m[20] | m[30] | m[31];
+	o[2] = select_row(x, r);
+	r[0] = m[28] | m[35];
+	r[1] = m[0] | m[14] | m[23] | m[33];
+	r[2] = m[15] | m[22] | m[29] | m[32];
+	r[3] = m[8] | m[13] | m[23] | m[25];
+	o[3] = select_row(x, r);
+}
+
+static inline void sbox3(const uint64_t *x, uint64_t *o)
+{
+	uint64_t m[38], r[4];
+
+	decode_col(x, m);
+	m[16] = m[0] | m[12];
+	m[17] = m[11] | m[14];
+	m[18] = m[5] | m[6];
+	m[19] = m[7] | m[9];
+	m[20] = m[1] | m[10];
+	m[21] = m[4] | m[13];
+	m[22] = m[2] | m[15];
+	m[23] = m[3] | m[16];
+	m[24] = m[3] | m[21];
+	m[25] = m[8] | m[18];
+	m[26] = m[11] | m[19];
+	m[27] = m[0] | m[24];
+	m[28] = m[1] | m[17];
+	m[29] = m[2] | m[26];
+	m[30] = m[4] | m[17];
+	m[31] = m[5] | m[16];
+	m[32] = m[6] | m[10];
+	m[33] = m[8] | m[21];
+	m[34] = m[9] | m[22];
+	m[35] = m[12] | m[20];
+	m[36] = m[14] | m[15];
+	m[37] = m[20] | m[36];
+	r[0] = m[23] | m[32] | m[34];
+	r[1] = m[13] | m[17] | m[19] | m[23];
+	r[2] = m[5] | m[8] | m[17] | m[27];
+	r[3] = m[18] | m[34] | m[35];
+	o[0] = select_row(x, r);
+	r[0] = m[24] | m[26] | m[32];
+	r[1] = m[16] | m[17] | m[18] | m[20];
+	r[2] = m[22] | m[28] | m[31];
+	r[3] = m[10] | m[19] | m[22] | m[33];
+	o[1] = select_row(x, r);
+	r[0] = m[18] | m[23] | m[30];
+	r[1] = m[6] | m[7] | m[28] | m[33];
+	r[2] = m[13] | m[25] | m[37];
+	r[3] = m[19] | m[30] | m[35];
+	o[2] = select_row(x, r);
+	r[0] = m[12] | m[25] | m[29];
+	r[1] = m[27] | m[37];
+	r[2] = m[9] | m[15] | m[23] | m[25];
+	r[3] = m[13] | m[29] | m[31];
+	o[3] = select_row(x, r);
+}
+
+static inline void sbox4(const uint64_t *x, uint64_t *o)
+{
+	uint64_t m[44], r[4];
+
+	decode_col(x, m);
+	m[16] = m[0] | m[5];
+	m[17] = m[1] | m[11];
+	m[18] = m[12] | m[15];
+	m[19] = m[2] | m[7];
+	m[20] = m[6] | m[8];
+	m[21] = m[10] | m[13];
+	m[22] = m[17] | m[20];
+	m[23] = m[3] | m[9];
+	m[24] = m[4] | m[14];
+	m[25] = m[13] | m[15];
+	m[26] = m[16] | m[19];
+	m[27] = m[17] | m[25];
+	m[28] = m[18] | m[22];
+	m[29] = m[18] | m[23];
+	m[30] = m[0] | m[3];
+	m[31] = m[1] | m[6];
+	m[32] = m[2] | m[14];
+	m[33] = m[4] | m[7];
+	m[34] = m[5] | m[9];
+	m[35] = m[8] | m[11];
+	m[36] = m[16] | m[21];
+	m[37] = m[16] | m[27];
+	m[38] = m[19] | m[21];
+	m[39] = m[22] | m[36];
+	m[40] = m[24] | m[35];
+	m[41] = m[26] | m[29];
+	m[42] = m[28] | m[33];
+	m[43] = m[32] | m[37];
+	r[0] = m[18] | m[31] | m[38];
+	r[1] = m[43];
+	r[2] = m[26] | m[40];
+	r[3] = m[42];
+	o[0] = select_row(x, r);
+	r[0] = m[43];
+	r[1] = m[16] | m[23] | m[40];
+	r[2] = m[42];
+	r[3] = m[21] | m[29] | m[31];
+	o[1] = select_row(x, r);
+	r[0] = m[41];
+	r[1] = m[24] | m[34] | m[38];
+	r[2] = m[39];
+	r[3] = m[24] | m[27] | m[30];
+	o[2] = select_row(x, r);
+	r[0] = m[28] | m[30];
+	r[1] = m[41];
+	r[2] = m[10] | m[12] | m[19] | m[20] | m[34];
+	r[3] = m[39];
+	o[3] = select_row(x, r);
+}
+
+static inline void sbox5(const uint64_t *x, uint64_t *o)
+{
+	uint64_t m[39], r[4];
+
+	decode_col(x, m);
+	m[16] = m[5] | m[8];
+	m[17] = m[0] | m[11];
+	m[18] = m[1] | m[12];
+	m[19] = m[3] | m[6];
+	m[20] = m[4] | m[15];
+	m[21] = m[7] | m[9];
+	m[22] = m[10] | m[16];
+	m[23] = m[2] | m[18];
+	m[24] = m[3] | m[21];
+	m[25] = m[5] | m[17];
+	m[26] = m[9] | m[19];
+	m[27] = m[2] | m[13];
+	m[28] = m[4] | m[14];
+	m[29] = m[6] | m[7];
+	m[30] = m[6] | m[15];
+	m[31] = m[10] | m[25];
+	m[32] = m[11] | m[16];
+	m[33] = m[12] | m[26];
+	m[34] = m[13] | m[18];
+	m[35] = m[14] | m[17];
+	m[36] = m[19] | m[20];
+	m[37] = m[20] | m[24];
+	m[38] = m[21] | m[23];
+	r[0] = m[14] | m[18] | m[30] | m[32];
+	r[1] = m[1] | m[10] | m[13] | m[19] | m[35];
+	r[2] = m[22] | m[37];
+	r[3] = m[25] | m[38];
+	o[0] = select_row(x, r);
+	r[0] = m[11] | m[28] | m[38];
+	r[1] = m[0] | m[22] | m[36];
+	r[2] = m[12] | m[17] | m[22] | m[30];
+	r[3] = m[14] | m[16] | m[24] | m[27];
+	o[1] = select_row(x, r);
+	r[0] = m[28] | m[29] | m[31];
+	r[1] = m[15] | m[23] | m[31];
+	r[2] = m[8] | m[34] | m[36];
+	r[3] = m[0] | m[15] | m[16] | m[33];
+	o[2] = select_row(x, r);
+	r[0] = m[10] | m[11] | m[20] | m[33];
+	r[1] = m[22] | m[29] | m[34];
+	r[2] = m[26] | m[27] | m[32];
+	r[3] = m[35] | m[37];
+	o[3] = select_row(x, r);
+}
+
+static inline void sbox6(const uint64_t *x, uint64_t *o)
+{
+	uint64_t m[37], r[4];
+
+	decode_col(x, m);
+	m[16] = m[1] | m[11];
+	m[17] = m[3] | m[13];
+	m[18] = m[6] | m[15];
+	m[19] = m[2] | m[7];
+	m[20] = m[4] | m[8];
+	m[21] = m[0] | m[12];
+	m[22] = m[5] | m[10];
+	m[23] = m[9] | m[14];
+	m[24] = m[16] | m[20];
+	m[25] = m[1] | m[10];
+	m[26] = m[18] | m[22];
+	m[27] = m[0] | m[13];
+	m[28] = m[2] | m[17];
+	m[29] = m[3] | m[9];
+	m[30] = m[4] | m[15];
+	m[31] = m[6] | m[16];
+	m[32] = m[6] | m[23];
+	m[33] = m[8] | m[19];
+	m[34] = m[11] | m[21];
+	m[35] = m[14] | m[17];
+	m[36] = m[19] | m[24];
+	r[0] = m[19] | m[21] | m[29] | m[30];
+	r[1] = m[16] | m[26] | m[27];
+	r[2] = m[2] | m[5] | m[14] | m[27] | m[31];
+	r[3] = m[3] | m[7] | m[18] | m[20] | m[23];
+	o[0] = select_row(x, r);
+	r[0] = m[17] | m[32] | m[34];
+	r[1] = m[22] | m[36];
+	r[2] = m[8] | m[18] | m[25] | m[28];
+	r[3] = m[5] | m[18] | m[29] | m[34];
+	o[1] = select_row(x, r);
+	r[0] = m[12] | m[26] | m[28];
+	r[1] = m[0] | m[24] | m[35];
+	r[2] = m[14] | m[15] | m[36];
+	r[3] = m[9] | m[12] | m[31] | m[33];
+	o[2] = select_row(x, r);
+	r[0] = m[17] | m[23] | m[25] | m[30];
+	r[1] = m[4] | m[7] | m[13] | m[25] | m[32];
+	r[2] = m[21] | m[33] | m[35];
+	r[3] = m[24] | m[26];
+	o[3] = select_row(x, r);
+}
+
+static inline void sbox7(const uint64_t *x, uint64_t *o)
+{
+	uint64_t m[41], r[4];
+
+	decode_col(x, m);
+	m[16] = m[7] | m[9];
+	m[17] = m[2] | m[8];
+	m[18] = m[3] | m[13];
+	m[19] = m[4] | m[11];
+	m[20] = m[0] | m[5];
+	m[21] = m[1] | m[6];
+	m[22] = m[10] | m[18];
+	m[23] = m[12] | m[15];
+	m[24] = m[14] | m[17];
+	m[25] = m[1] | m[19];
+	m[26] = m[2] | m[20];
+	m[27] = m[0] | m[12];
+	m[28] = m[3] | m[16];
+	m[29] = m[4] | m[16];
+	m[30] = m[6] | m[9];
+	m[31] = m[7] | m[11];
+	m[32] = m[11] | m[23];
+	m[33] = m[13] | m[31];
+	m[34] = m[14] | m[27];
+	m[35] = m[16] | m[17];
+	m[36] = m[19] | m[28];
+	m[37] = m[21] | m[22];
+	m[38] = m[24] | m[25];
+	m[39] = m[26] | m[30];
+	m[40] = m[29] | m[37];
+	r[0] = m[40];
+	r[1] = m[20] | m[24] | m[33];
+	r[2] = m[24] | m[36];
+	r[3] = m[3] | m[17] | m[21] | m[32];
+	o[0] = select_row(x, r);
+	r[0] = m[34] | m[36];
+	r[1] = m[0] | m[8] | m[15] | m[19] | m[22];
+	r[2] = m[40];
+	r[3] = m[16] | m[26] | m[32];
+	o[1] = select_row(x, r);
+	r[0] = m[18] | m[38];
+	r[1] = m[18] | m[23] | m[35];
+	r[2] = m[5] | m[6] | m[10] | m[15] | m[35];
+	r[3] = m[21] | m[33] | m[34];
+	o[2] = select_row(x, r);
+	r[0] = m[7] | m[8] | m[10] | m[23] | m[25];
+	r[1] = m[22] | m[39];
+	r[2] = m[14] | m[18] | m[39];
+	r[3] = m[16] | m[38];
+	o[3] = select_row(x, r);
+}
+
+static inline void sbox8(const uint64_t *x, uint64_t *o)
+{
+	uint64_t m[41], r[4];
+
+	decode_col(x, m);
+	m[16] = m[5] | m[6];
+	m[17] = m[0] | m[12];
+	m[18] = m[1] | m[10];
+	m[19] = m[2] | m[8];
+	m[20] = m[4] | m[11];
+	m[21] = m[3] | m[14];
+	m[22] = m[7] | m[9];
+	m[23] = m[15] | m[16];
+	m[24] = m[13] | m[18];
+	m[25] = m[9] | m[11];
+	m[26] = m[13] | m[21];
+	m[27] = m[14] | m[16];
+	m[28] = m[19] | m[22];
+	m[29] = m[20] | m[23];
+	m[30] = m[25] | m[27];
+	m[31] = m[0] | m[30];
+	m[32] = m[1] | m[20];
+	m[33] = m[5] | m[15];
+	m[34] = m[6] | m[24];
+	m[35] = m[10] | m[23];
+	m[36] = m[17] | m[21];
+	m[37] = m[17] | m[22];
+	m[38] = m[18] | m[29];
+	m[39] = m[26] | m[32];
+	m[40] = m[33] | m[36];
+	r[0] = m[19] | m[31];
+	r[1] = m[19] | m[39];
+	r[2] = m[12] | m[38];
+	r[3] = m[28] | m[35];
+	o[0] = select_row(x, r);
+	r[0] = m[20] | m[40];
+	r[1] = m[28] | m[34];
+	r[2] = m[2] | m[17] | m[30];
+	r[3] = m[4] | m[26] | m[28];
+	o[1] = select_row(x, r);
+	r[0] = m[8] | m[38];
+	r[1] = m[24] | m[29];
+	r[2] = m[34] | m[37];
+	r[3] = m[19] | m[40];
+	o[2] = select_row(x, r);
+	r[0] = m[35] | m[37];
+	r[1] = m[1] | m[2] | m[31];
+	r[2] = m[17] | m[39];
+	r[3] = m[3] | m[7] | m[8] | m[12] | m[15] | m[24];
+	o[3] = select_row(x, r);
+}
+
+/*L ^= f(R, K)*/
+static void des_bs_round(uint64_t *l, const uint64_t *r, const uint64_t *k)
+{
+	uint64_t x[48], s[32];
+	int i;
+
+	for (i = 0; i < 48; i++)
+		x[i] = r[E[i] - 1] ^ k[i];
+
+	sbox1(x,      s);
+	sbox2(x + 6,  s + 4);
+	sbox3(x + 12, s + 8);
+	sbox4(x + 18, s + 12);
+	sbox5(x + 24, s + 16);
+	sbox6(x + 30, s + 20);
+	sbox7(x + 36, s + 24);
+	sbox8(x + 42, s + 28);
+
+	for (i = 0; i < 32; i++)
+		l[i] ^= s[P[i] - 1];
+}
+
+/*16 rounds, the halves are swapped as in the output block R16 L16*/
+static void des_bs_rounds(uint64_t **l, uint64_t **r, const uint64_t (*k)[48], int decrypt)
+{
+	uint64_t *t;
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		des_bs_round(*l, *r, k[decrypt ? 15 - i : i]);
+		t  = *l;
+		*l = *r;
+		*r = t;
+	}
+
+	t  = *l;
+	*l = *r;
+	*r = t;
+}
+
+void des_bs_init(DESBitslice *bs, const AVDES *d)
+{
+	int n, i, j;
+
+	bs->triple_des = d->triple_des;
+
+	for (n = 0; n < (d->triple_des ? 3 : 1); n++)
+		for (i = 0; i < 16; i++)
+			for (j = 0; j < 48; j++)
+				bs->keys[n][i][j] = -(uint64_t)((d->round_keys[n][i] >> (47 - j)) & 1);
+}
+
+void des_bs_crypt(const DESBitslice *bs, uint8_t **dst, const uint8_t **src, int count, int decrypt)
+{
+	uint64_t a[64], b[64];
+	uint64_t *l = b, *r = b + 32;
+	int i, j;
+
+	for (i = 0; i < count; i++) {
+		const uint8_t *p = src[i];
+		uint64_t v = 0;
+
+		for (j = 0; j < 8; j++)
+			v = (v << 8) | p[j];
+		a[i] = v;
+	}
+	for (; i < 64; i++)
+		a[i] = 0;
+
+	/*a[n] is bit n+1 of all the blocks*/
+	transpose64(a);
+
+	for (i = 0; i < 64; i++)
+		b[i] = a[IP[i] - 1];
+
+	/*the output R16 L16 of a pass is the input L0 R0 of the next one*/
+	if (!bs->triple_des) {
+		des_bs_rounds(&l, &r, bs->keys[0], decrypt);
+	} else if (!decrypt) {
+		des_bs_rounds(&l, &r, bs->keys[0], 0);
+		des_bs_rounds(&l, &r, bs->keys[1], 1);
+		des_bs_rounds(&l, &r, bs->keys[2], 0);
+	} else {
+		des_bs_rounds(&l, &r, bs->keys[2], 1);
+		des_bs_rounds(&l, &r, bs->keys[1], 0);
+		des_bs_rounds(&l, &r, bs->keys[0], 1);
+	}
+
+	for (i = 0; i < 64; i++)
+		a[i] = (FP[i] <= 32) ? l[FP[i] - 1] : r[FP[i] - 33];
+
+	transpose64(a);
+
+	for (i = 0; i < count; i++) {
+		uint8_t *p = dst[i];
+		uint64_t v = a[i];
+
+		for (j = 7; j >= 0; j--) {
+			p[j] = (uint8_t)v;
+			v >>= 8;
+		}
+	}
+}
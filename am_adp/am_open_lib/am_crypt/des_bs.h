@@ -0,0 +1,41 @@
+/***************************************************************************
+ * Copyright (c) 2019 Amlogic, Inc. All rights reserved.
+ *
+ * This source code is subject to the terms and conditions defined in the
+ * file 'LICENSE' which is part of this source code package.
+ ***************************************************************************/
+/**\file
+ * \brief Bitsliced DES, crypts up to 64 blocks in parallel
+ *
+ * Bit n of every block is kept in one 64 bit word, one block per bit.
+ * The permutations become plain word moves and the S-boxes are evaluated
+ * as boolean functions, so all the blocks cost the same as one word
+ * operation per gate. Used for the batch packet crypt, the result is the
+ * same as av_des_crypt() in ECB mode.
+ */
+
+#ifndef _AM_DES_BS_H
+#define _AM_DES_BS_H
+
+#include <stdint.h>
+#include "des.h"
+
+/**\brief Number of blocks crypted in one call*/
+#define DES_BS_LANES 64
+
+/**\brief Round keys of the bitsliced DES*/
+typedef struct {
+	uint64_t keys[3][16][48];	/**< round key bits, each is all 0 or all 1*/
+	int      triple_des;
+} DESBitslice;
+
+/**\brief Get the round keys from an initialized AVDES context*/
+void des_bs_init(DESBitslice *bs, const AVDES *d);
+
+/**\brief Crypt count (at most DES_BS_LANES) 8 byte blocks in ECB mode
+ * \param dst destination of each block, can be equal to its source
+ * \param src source of each block
+ */
+void des_bs_crypt(const DESBitslice *bs, uint8_t **dst, const uint8_t **src, int count, int decrypt);
+
+#endif
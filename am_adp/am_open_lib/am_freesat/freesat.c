@@ -21,10 +21,10 @@
 #include <time.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <pthread.h>
 #include <am_debug.h>
 
 
-#define RELOAD_TIME     600      /* Minimum time between checking for updated tables */
 #ifndef FREESAT_DATA_DIRECTORY
 #define FREESAT_DATA_DIRECTORY       "/data/"
 #endif
@@ -39,78 +39,65 @@
 
 //#define FREESAT_PRINT_MISSED_DECODING
 
-struct hufftab {
-    unsigned int value;
-    short bits;
-    char next;
-};
-
 #define START   '\0'
 #define STOP    '\0'
 #define ESCAPE  '\1'
 
+/* The tables are compiled into lookup tables for each previous character.
+ * The root table is indexed by the next ROOT_BITS bits of the input, longer
+ * codes continue in sub tables indexed by SUB_BITS more bits per step.
+ * An entry either holds the whole code length and the character, or links
+ * to a sub table, counted in units of SUB_SIZE entries.  A zero entry is
+ * a code missing from the table.
+ */
+#define ROOT_BITS   8
+#define SUB_BITS    4
+#define SUB_SIZE    (1 << SUB_BITS)
+#define ROOT_UNITS  ((1 << ROOT_BITS) / SUB_SIZE)
+#define MAX_UNITS   0x8000
+#define MAX_BITS    32
+
+#define HUFF_LINK           0x8000
+#define HUFF_LEAF(bits, ch) (((bits) << 8) | (unsigned char)(ch))
+#define HUFF_BITS(e)        (((e) >> 8) & 0x3f)
+#define HUFF_CHAR(e)        ((e) & 0xff)
+
+struct huffdec {
+    unsigned short  root[2][256];   /* Root table unit of each previous character, 0 if none */
+    unsigned short *entries;
+    int             units;          /* Allocated units */
+    int             used;           /* Used units */
+};
+
 
 int freesat_decode_error = 0;  /* If set an error has occurred during decoding */
 
-static struct hufftab *tables[2][256];
-static int             table_size[2][256];
-static time_t          load_time = 0;
+/* Built once by freesat_table_load() and only read afterwards, so it can be
+ * shared by all the decoding threads */
+static struct huffdec  decoder;
+static pthread_once_t  decoder_once = PTHREAD_ONCE_INIT;
 
 static void load_file(int tableid, const char *input);
 
 
-static void freesat_table_load()
+static void freesat_table_load(void)
 {
-    struct stat sb;
-    time_t      now = time(NULL);
-    int         i;
-
-
-    /* Only reload if we've never loaded, or it's more than 10 minutes away */
-    if ( load_time != 0 ) {
-#if 0
-        int reload = 1;
-        if ( now - load_time < RELOAD_TIME ) {
-            return;
-        }
-        if ( stat(TABLE1_FILENAME,&sb) == 0 ) {
-            if ( sb.st_mtime < load_time ) {
-                if ( stat(TABLE2_FILENAME,&sb) == 0 ) {
-                    if ( sb.st_mtime < load_time ) {
-                        reload = 0;
-                    }
-                }
-            }
-        }
-        if ( reload == 0 ) {
-            return;
-        }
-#else
-		return;
-#endif
-    }
-
-    /* Reset the load time */
-    load_time = now;
+    /* Unit 0 is never used, so a zero root means no table */
+    decoder.used = 1;
 
+    /* And load the files up */
+    load_file(1, freesat_table1);
+    load_file(2, freesat_table2);
 
-    /* Reset all the tables */
-    for ( i = 0 ; i < 256; i++ ) {
-        if ( tables[0][i] != NULL ) {
-            free(tables[0][i]);
-        }
-        if ( tables[1][i] ) {
-            free(tables[1][i]);
+    if ( decoder.entries ) {
+        unsigned short *e = (unsigned short *)realloc(decoder.entries, decoder.used * SUB_SIZE * sizeof(*e));
+        if ( e ) {
+            decoder.entries = e;
+            decoder.units = decoder.used;
         }
-        tables[0][i] = NULL;
-        tables[1][i] = NULL;
-        table_size[0][i] = 0;
-        table_size[1][i] = 0;
     }
 
-    /* And load the files up */
-    load_file(1, freesat_table1);
-    load_file(2, freesat_table2);
+    AM_DEBUG(1,"Freesat tables compiled, %d entries",decoder.units * SUB_SIZE);
 }
 
 
@@ -184,6 +171,106 @@ input_gets(const char *input, int *ppos, char *buf)
 	return buf;
 }
 
+/** \brief Allocate zeroed table units
+ *
+ *  \param d     - Decoder being built
+ *  \param units - Number of units
+ *
+ *  \return Index of the first unit, -1 if out of memory
+ */
+static int huff_alloc(struct huffdec *d, int units)
+{
+    int i;
+
+    if ( d->used + units > d->units ) {
+        unsigned short *e;
+        int n = d->units ? d->units : 256;
+
+        while ( n < d->used + units ) {
+            n *= 2;
+        }
+        if ( n > MAX_UNITS ) {
+            n = MAX_UNITS;
+            if ( d->used + units > n ) {
+                return -1;
+            }
+        }
+        e = (unsigned short *)realloc(d->entries, n * SUB_SIZE * sizeof(*e));
+        if ( e == NULL ) {
+            return -1;
+        }
+        memset(e + d->units * SUB_SIZE, 0, (n - d->units) * SUB_SIZE * sizeof(*e));
+        d->entries = e;
+        d->units = n;
+    }
+
+    i = d->used;
+    d->used += units;
+    return i;
+}
+
+/** \brief Store a leaf in the empty entries of a table range
+ *
+ *  An entry already holding a leaf belongs to a code listed earlier, which
+ *  the old linear search would have matched first, so it is kept.
+ */
+static void huff_fill(struct huffdec *d, int pos, int n, unsigned short leaf)
+{
+    for ( ; n > 0; n--, pos++ ) {
+        unsigned short e = d->entries[pos];
+
+        if ( e == 0 ) {
+            d->entries[pos] = leaf;
+        } else if ( e & HUFF_LINK ) {
+            huff_fill(d, (e & ~HUFF_LINK) * SUB_SIZE, SUB_SIZE, leaf);
+        }
+    }
+}
+
+/** \brief Add a code to the lookup tables of a previous character
+ *
+ *  \param d     - Decoder being built
+ *  \param unit  - Root table unit
+ *  \param value - Code, left aligned
+ *  \param bits  - Code length
+ *  \param next  - Decoded character
+ *
+ *  \return 0 on success, -1 if out of memory
+ */
+static int huff_insert(struct huffdec *d, int unit, unsigned value, int bits, char next)
+{
+    int width = ROOT_BITS;
+    int shift = 0;
+
+    for ( ;; ) {
+        int pos = unit * SUB_SIZE + ((value << shift) >> (32 - width));
+        unsigned short e;
+
+        if ( bits - shift <= width ) {
+            huff_fill(d, pos, 1 << (width - (bits - shift)), HUFF_LEAF(bits, next));
+            return 0;
+        }
+
+        e = d->entries[pos];
+        if ( e == 0 ) {
+            int sub = huff_alloc(d, 1);
+
+            if ( sub < 0 ) {
+                return -1;
+            }
+            e = HUFF_LINK | sub;
+            d->entries[pos] = e;
+        } else if ( !(e & HUFF_LINK) ) {
+            /* A shorter code listed earlier hides this one */
+            return 0;
+        }
+
+        unit = e & ~HUFF_LINK;
+        shift += width;
+        width = SUB_BITS;
+    }
+}
+
 /** \brief Load an individual freesat data file
  *
  *  \param tableid   - Table id that should be loaded
@@ -193,14 +280,12 @@ static void load_file(int tableid, const char *input)
 {
     char     buf[1024];
 	int      pos = 0;
-    //char    *from, *to, *binary;
 
     tableid--;
 
 	AM_DEBUG(1,"Loading table %d",tableid + 1);
 
 	while ( input_gets(input, &pos, buf) != NULL ) {
-		//from = binary = to = NULL;
 		char from[128]={0};
 		char to[128]={0};
 		char binary[128]={0};
@@ -208,23 +293,30 @@ static void load_file(int tableid, const char *input)
 
 		int elems = sscanf(buf,"%[^:]:%[^:]:%[^:]:",from, binary, to);
 
-		//AM_DEBUG(1,"--elems=%d,tableid=%d,buf=%s-\n",elems,tableid,buf);
-		//AM_DEBUG(1,"--from=%s,binary=%s,to=%s\n",from,binary,to);
 	   if ( elems == 3 ) {
 			int bin_len = strlen(binary);
 			int from_char = resolve_char(from);
 			char to_char = resolve_char(to);
 			unsigned long bin = decode_binary(binary);
-			int i = table_size[tableid][from_char]++;
 
-			tables[tableid][from_char] = (struct hufftab *)realloc(tables[tableid][from_char], (i+1) * sizeof(tables[tableid][from_char][0]));
-			tables[tableid][from_char][i].value = bin;
-			tables[tableid][from_char][i].next = to_char;
-			tables[tableid][from_char][i].bits = bin_len;
+			if ( bin_len == 0 || bin_len > MAX_BITS ) {
+				continue;
+			}
 
-		   // free(from);
-		   // free(to);
-		   // free(binary);
+			if ( decoder.root[tableid][from_char] == 0 ) {
+				int root = huff_alloc(&decoder, ROOT_UNITS);
+
+				if ( root < 0 ) {
+					AM_DEBUG(1,"No memory for table %d",tableid + 1);
+					return;
+				}
+				decoder.root[tableid][from_char] = root;
+			}
+
+			if ( huff_insert(&decoder, decoder.root[tableid][from_char], bin, bin_len, to_char) < 0 ) {
+				AM_DEBUG(1,"No memory for table %d",tableid + 1);
+				return;
+			}
 		}
 	}
 }
@@ -261,6 +353,34 @@ static void write_message(const unsigned char *src, size_t size)
 }
 #endif
 
+/** \brief Get the 32 bits starting at a bit position, zero past the end
+ *
+ *  \param src  - Input buffer
+ *  \param size - Size of the buffer
+ *  \param pos  - Bit position
+ *
+ *  \return The bits, left aligned
+ */
+static unsigned peek_bits(const unsigned char *src, size_t size, size_t pos)
+{
+    size_t byte = pos >> 3;
+    unsigned long long v = 0;
+    int i;
+
+    if ( byte + 5 <= size ) {
+        v = ((unsigned long long)src[byte] << 32) | ((unsigned)src[byte + 1] << 24) |
+            (src[byte + 2] << 16) | (src[byte + 3] << 8) | src[byte + 4];
+    } else {
+        for ( i = 0; i < 5; i++ ) {
+            v <<= 8;
+            if ( byte + i < size )
+                v |= src[byte + i];
+        }
+    }
+
+    return (unsigned)(v >> (8 - (pos & 7)));
+}
+
 /** \brief Decode an EPG string as necessary
  *
  *  \param src - Possibly encoded string
@@ -271,121 +391,86 @@ static void write_message(const unsigned char *src, size_t size)
  */
 char  *freesat_huffman_decode( const unsigned char *src, size_t size)
 {
-    int tableid;
-
     freesat_decode_error = 0;
 
 #ifdef FREESAT_ARCHIVE_MESSAGES
     write_message(src, size);
 #endif
-    if (src[0] == 0x1f && (src[1] == 1 || src[1] == 2)) {
-        int    uncompressed_len = 30;
-        char * uncompressed = (char *)calloc(1,uncompressed_len + 1);
-        unsigned value = 0, byte = 2, bit = 0;
+    if (size >= 2 && src[0] == 0x1f && (src[1] == 1 || src[1] == 2)) {
+        /* Every character takes at least one bit, and decoding stops when
+         * the rest of the input is zero, so this is enough for any string */
+        int    uncompressed_len = (size - 2) * 8 + 1;
+        char * uncompressed = (char *)malloc(uncompressed_len + 1);
+        const unsigned short *root;
+        size_t pos = 16;
+        unsigned value;
         int p = 0;
-        int lastch = START;
+        unsigned char lastch = START;
 
-        tableid = src[1] - 1;
-        while (byte < 6 && byte < size) {
-            value |= src[byte] << ((5-byte) * 8);
-            byte++;
-        }
+        if (uncompressed == NULL)
+            return NULL;
 
-        freesat_table_load();   /**< Load the tables as necessary */
+        pthread_once(&decoder_once, freesat_table_load);   /**< Load the tables as necessary */
+        root = decoder.root[src[1] - 1];
 
-        do {
-            int found = 0;
-            unsigned bitShift = 0;
+        value = peek_bits(src, size, pos);
 
+        do {
             if (lastch == ESCAPE) {
                 char nextCh = (value >> 24) & 0xff;
-                found = 1;
                 // Encoded in the next 8 bits.
                 // Terminated by the first ASCII character.
-                bitShift = 8;
                 if ((nextCh & 0x80) == 0)
                     lastch = nextCh;
-                if (p >= uncompressed_len) {
-                    uncompressed_len += 10;
-                    uncompressed = (char *)realloc(uncompressed, uncompressed_len + 1);
-                }
                 uncompressed[p++] = nextCh;
-                uncompressed[p] = 0;
+                pos += 8;
             } else {
-                int j;
-                for ( j = 0; j < table_size[tableid][lastch]; j++) {
-                    unsigned mask = 0, maskbit = 0x80000000;
-                    short kk;
-                    for ( kk = 0; kk < tables[tableid][lastch][j].bits; kk++) {
-                        mask |= maskbit;
-                        maskbit >>= 1;
-                    }
-                    if ((value & mask) == tables[tableid][lastch][j].value) {
-                        char nextCh = tables[tableid][lastch][j].next;
-                        bitShift = tables[tableid][lastch][j].bits;
-                        if (nextCh != STOP && nextCh != ESCAPE) {
-                            if (p >= uncompressed_len) {
-                                uncompressed_len += 10;
-                                uncompressed = (char *)realloc(uncompressed, uncompressed_len + 1);
-                            }
-                            uncompressed[p++] = nextCh;
-                            uncompressed[p] = 0;
-                        }
-                        found = 1;
-                        lastch = nextCh;
-                        break;
-                    }
-                }
-            }
-            if (found) {
-                // Shift up by the number of bits.
-
-                unsigned b;
-                for ( b = 0; b < bitShift; b++)
-                {
-                    value = (value << 1) & 0xfffffffe;
-                    if (byte < size)
-                        value |= (src[byte] >> (7-bit)) & 1;
-                    if (bit == 7)
-                    {
-                        bit = 0;
-                        byte++;
+                unsigned short e = 0;
+
+                if (root[lastch]) {
+                    int shift = ROOT_BITS;
+
+                    e = decoder.entries[root[lastch] * SUB_SIZE + (value >> (32 - ROOT_BITS))];
+                    while (e & HUFF_LINK) {
+                        e = decoder.entries[(e & ~HUFF_LINK) * SUB_SIZE + ((value << shift) >> (32 - SUB_BITS))];
+                        shift += SUB_BITS;
                     }
-                    else bit++;
                 }
-            } else {
-#ifdef FREESAT_PRINT_MISSED_DECODING
-                char  temp[1020];
-                size_t   tlen = 0;
-
-                tlen = snprintf(temp,sizeof(temp),"...[%02x][%02x][%02x][%02x]",(value >> 24 ) & 0xff, (value >> 16 ) & 0xff, (value >> 8) & 0xff, value &0xff);
-                do {
-                    // Shift up by the number of bits.
-                    unsigned b;
-                    for ( b = 0; b < 8; b++) {
-                        value = (value << 1) & 0xfffffffe;
-                        if (byte < size)
-                            value |= (src[byte] >> (7-bit)) & 1;
-                        if (bit == 7) {
-                            bit = 0;
-                            byte++;
-                        }
-                        else bit++;
-                    }
-                    tlen += snprintf(temp+tlen, sizeof(temp) - tlen,"[%02x]", value & 0xff);
-                } while ( tlen < sizeof(temp) - 6 && byte <  size);
 
-                uncompressed_len += tlen;
-                uncompressed = (char *)realloc(uncompressed, uncompressed_len + 1);
-                freesat_decode_error = 1;
-                strcpy(uncompressed + p, temp);
+                if (e == 0) {
+                    uncompressed[p] = 0;
+#ifdef FREESAT_PRINT_MISSED_DECODING
+                    char  temp[1020];
+                    size_t   tlen = 0;
+
+                    tlen = snprintf(temp,sizeof(temp),"...[%02x][%02x][%02x][%02x]",(value >> 24 ) & 0xff, (value >> 16 ) & 0xff, (value >> 8) & 0xff, value &0xff);
+                    do {
+                        // Shift up by 8 bits.
+                        pos += 8;
+                        value = peek_bits(src, size, pos);
+                        tlen += snprintf(temp+tlen, sizeof(temp) - tlen,"[%02x]", value & 0xff);
+                    } while ( tlen < sizeof(temp) - 6 && (pos >> 3) + 4 < size);
+
+                    uncompressed = (char *)realloc(uncompressed, p + tlen + 1);
+                    freesat_decode_error = 1;
+                    strcpy(uncompressed + p, temp);
 #endif
-                AM_DEBUG(1,"Missing table %d entry: <%s>",tableid + 1, uncompressed);
-                // Entry missing in table.
-                return uncompressed;
+                    AM_DEBUG(1,"Missing table %d entry: <%s>",src[1], uncompressed);
+                    // Entry missing in table.
+                    return uncompressed;
+                }
+
+                lastch = HUFF_CHAR(e);
+                if (lastch != STOP && lastch != ESCAPE)
+                    uncompressed[p++] = lastch;
+                pos += HUFF_BITS(e);
             }
-        } while (lastch != STOP && value != 0);
 
+            // Shift up by the number of bits.
+            value = peek_bits(src, size, pos);
+        } while (lastch != STOP && value != 0 && p < uncompressed_len);
+
+        uncompressed[p] = 0;
         return uncompressed;
     }
     return NULL;
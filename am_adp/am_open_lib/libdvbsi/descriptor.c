@@ -107,7 +107,7 @@ dvbpsi_descriptor_t* dvbpsi_NewDescriptor(uint8_t i_tag, uint8_t i_length,
 {
     //AM_DEBUG(1, "malloc descriptor\n");
     dvbpsi_descriptor_t* p_descriptor
-        = (dvbpsi_descriptor_t*)malloc(sizeof(dvbpsi_descriptor_t));
+        = (dvbpsi_descriptor_t*)dvbpsi_malloc(sizeof(dvbpsi_descriptor_t));
     if (!p_descriptor)
     {
         AM_DEBUG(1,"descriptor malloc failed\n");
@@ -123,9 +123,10 @@ dvbpsi_descriptor_t* dvbpsi_NewDescriptor(uint8_t i_tag, uint8_t i_length,
             p_descriptor->i_length = i_length;
             p_descriptor->p_decoded = NULL;
             p_descriptor->p_next = NULL;
+            p_descriptor->p_pool = dvbpsi_GetAllocPool();
             return p_descriptor;
         }
-        p_descriptor->p_data = (uint8_t*)malloc(i_length * sizeof(uint8_t));
+        p_descriptor->p_data = (uint8_t*)dvbpsi_malloc(i_length * sizeof(uint8_t));
 
         if (p_descriptor->p_data)
         {
@@ -135,12 +136,13 @@ dvbpsi_descriptor_t* dvbpsi_NewDescriptor(uint8_t i_tag, uint8_t i_length,
                 memcpy(p_descriptor->p_data, p_data, i_length);
             p_descriptor->p_decoded = NULL;
             p_descriptor->p_next = NULL;
+            p_descriptor->p_pool = dvbpsi_GetAllocPool();
         }
         else
         {
             AM_DEBUG(1, "descriptor pdata malloc failed\n");
             if (p_descriptor)
-                free(p_descriptor);
+                dvbpsi_free(p_descriptor);
             p_descriptor = NULL;
         }
     }
@@ -176,12 +178,12 @@ void dvbpsi_DeleteDescriptors(dvbpsi_descriptor_t* p_descriptor)
         dvbpsi_descriptor_t* p_next = p_descriptor->p_next;
 
         if (p_descriptor->p_data != NULL)
-            free(p_descriptor->p_data);
+            dvbpsi_free(p_descriptor->p_data);
 
         if (p_descriptor->p_decoded != NULL)
-            free(p_descriptor->p_decoded);
+            dvbpsi_free(p_descriptor->p_decoded);
 
-        free(p_descriptor);
+        dvbpsi_free(p_descriptor);
         p_descriptor = p_next;
     }
 }
@@ -219,7 +221,7 @@ void *dvbpsi_DuplicateDecodedDescriptor(void *p_decoded, ssize_t i_size)
     if (!p_decoded)
         return NULL;
 
-    void *p_duplicate = calloc(1, i_size);
+    void *p_duplicate = dvbpsi_calloc(1, i_size);
     if (p_duplicate)
         memcpy(p_duplicate, p_decoded, i_size);
     return p_duplicate;
@@ -62,7 +62,7 @@ dvbpsi_vstream_dr_t * dvbpsi_DecodeVStreamDr(dvbpsi_descriptor_t * p_descriptor)
     return p_descriptor->p_decoded;
 
   /* Allocate memory */
-  p_decoded = (dvbpsi_vstream_dr_t*)malloc(sizeof(dvbpsi_vstream_dr_t));
+  p_decoded = (dvbpsi_vstream_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_vstream_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_02 decoder", "out of memory");
@@ -77,7 +77,7 @@ dvbpsi_vstream_dr_t * dvbpsi_DecodeVStreamDr(dvbpsi_descriptor_t * p_descriptor)
   {
     DVBPSI_ERROR_ARG("dr_02 decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
 
     return NULL;
   }
@@ -137,7 +137,7 @@ dvbpsi_descriptor_t * dvbpsi_GenVStreamDr(dvbpsi_vstream_dr_t * p_decoded,
     {
       /* Duplicate decoded data */
       dvbpsi_vstream_dr_t * p_dup_decoded =
-                (dvbpsi_vstream_dr_t*)malloc(sizeof(dvbpsi_vstream_dr_t));
+                (dvbpsi_vstream_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_vstream_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_vstream_dr_t));
 
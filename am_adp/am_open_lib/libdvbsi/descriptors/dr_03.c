@@ -63,7 +63,7 @@ dvbpsi_astream_dr_t * dvbpsi_DecodeAStreamDr(dvbpsi_descriptor_t * p_descriptor)
     return p_descriptor->p_decoded;
 
   /* Allocate memory */
-  p_decoded = (dvbpsi_astream_dr_t*)malloc(sizeof(dvbpsi_astream_dr_t));
+  p_decoded = (dvbpsi_astream_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_astream_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_03 decoder", "out of memory");
@@ -75,7 +75,7 @@ dvbpsi_astream_dr_t * dvbpsi_DecodeAStreamDr(dvbpsi_descriptor_t * p_descriptor)
   {
     DVBPSI_ERROR_ARG("dr_03 decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -111,7 +111,7 @@ dvbpsi_descriptor_t * dvbpsi_GenAStreamDr(dvbpsi_astream_dr_t * p_decoded,
     {
       /* Duplicate decoded data */
       dvbpsi_astream_dr_t * p_dup_decoded =
-                (dvbpsi_astream_dr_t*)malloc(sizeof(dvbpsi_astream_dr_t));
+                (dvbpsi_astream_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_astream_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_astream_dr_t));
 
@@ -64,7 +64,7 @@ dvbpsi_hierarchy_dr_t * dvbpsi_DecodeHierarchyDr(
     return p_descriptor->p_decoded;
 
   /* Allocate memory */
-  p_decoded = (dvbpsi_hierarchy_dr_t*)malloc(sizeof(dvbpsi_hierarchy_dr_t));
+  p_decoded = (dvbpsi_hierarchy_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_hierarchy_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_04 decoder", "out of memory");
@@ -76,7 +76,7 @@ dvbpsi_hierarchy_dr_t * dvbpsi_DecodeHierarchyDr(
   {
     DVBPSI_ERROR_ARG("dr_04 decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -112,7 +112,7 @@ dvbpsi_descriptor_t * dvbpsi_GenHierarchyDr(dvbpsi_hierarchy_dr_t * p_decoded,
     {
       /* Duplicate decoded data */
       dvbpsi_hierarchy_dr_t * p_dup_decoded =
-                (dvbpsi_hierarchy_dr_t*)malloc(sizeof(dvbpsi_hierarchy_dr_t));
+                (dvbpsi_hierarchy_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_hierarchy_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_hierarchy_dr_t));
 
@@ -65,7 +65,7 @@ dvbpsi_registration_dr_t * dvbpsi_DecodeRegistrationDr(
 
   /* Allocate memory */
   p_decoded = (dvbpsi_registration_dr_t*)
-                                malloc(sizeof(dvbpsi_registration_dr_t));
+                                dvbpsi_malloc(sizeof(dvbpsi_registration_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_05 decoder", "out of memory");
@@ -77,7 +77,7 @@ dvbpsi_registration_dr_t * dvbpsi_DecodeRegistrationDr(
   {
     DVBPSI_ERROR_ARG("dr_05 decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -124,7 +124,7 @@ dvbpsi_descriptor_t * dvbpsi_GenRegistrationDr(
     {
       /* Duplicate decoded data */
       dvbpsi_registration_dr_t * p_dup_decoded =
-        (dvbpsi_registration_dr_t*)malloc(sizeof(dvbpsi_registration_dr_t));
+        (dvbpsi_registration_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_registration_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_registration_dr_t));
 
@@ -65,7 +65,7 @@ dvbpsi_ds_alignment_dr_t * dvbpsi_DecodeDSAlignmentDr(
 
   /* Allocate memory */
   p_decoded = (dvbpsi_ds_alignment_dr_t*)
-                                malloc(sizeof(dvbpsi_ds_alignment_dr_t));
+                                dvbpsi_malloc(sizeof(dvbpsi_ds_alignment_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_06 decoder", "out of memory");
@@ -77,7 +77,7 @@ dvbpsi_ds_alignment_dr_t * dvbpsi_DecodeDSAlignmentDr(
   {
     DVBPSI_ERROR_ARG("dr_06 decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -108,7 +108,7 @@ dvbpsi_descriptor_t * dvbpsi_GenDSAlignmentDr(
     {
       /* Duplicate decoded data */
       dvbpsi_ds_alignment_dr_t * p_dup_decoded =
-        (dvbpsi_ds_alignment_dr_t*)malloc(sizeof(dvbpsi_ds_alignment_dr_t));
+        (dvbpsi_ds_alignment_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_ds_alignment_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_ds_alignment_dr_t));
 
@@ -65,7 +65,7 @@ dvbpsi_target_bg_grid_dr_t * dvbpsi_DecodeTargetBgGridDr(
 
   /* Allocate memory */
   p_decoded = (dvbpsi_target_bg_grid_dr_t*)
-                                malloc(sizeof(dvbpsi_target_bg_grid_dr_t));
+                                dvbpsi_malloc(sizeof(dvbpsi_target_bg_grid_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_07 decoder", "out of memory");
@@ -77,7 +77,7 @@ dvbpsi_target_bg_grid_dr_t * dvbpsi_DecodeTargetBgGridDr(
   {
     DVBPSI_ERROR_ARG("dr_07 decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -119,7 +119,7 @@ dvbpsi_descriptor_t * dvbpsi_GenTargetBgGridDr(
     {
       /* Duplicate decoded data */
       dvbpsi_target_bg_grid_dr_t * p_dup_decoded =
-        (dvbpsi_target_bg_grid_dr_t*)malloc(sizeof(dvbpsi_target_bg_grid_dr_t));
+        (dvbpsi_target_bg_grid_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_target_bg_grid_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_target_bg_grid_dr_t));
 
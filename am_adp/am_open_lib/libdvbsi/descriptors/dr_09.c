@@ -63,7 +63,7 @@ dvbpsi_ca_dr_t * dvbpsi_DecodeCADr(dvbpsi_descriptor_t * p_descriptor)
     return p_descriptor->p_decoded;
 
   /* Allocate memory */
-  p_decoded = (dvbpsi_ca_dr_t*)malloc(sizeof(dvbpsi_ca_dr_t));
+  p_decoded = (dvbpsi_ca_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_ca_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_09 decoder", "out of memory");
@@ -75,7 +75,7 @@ dvbpsi_ca_dr_t * dvbpsi_DecodeCADr(dvbpsi_descriptor_t * p_descriptor)
   {
     DVBPSI_ERROR_ARG("dr_09 decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -121,7 +121,7 @@ dvbpsi_descriptor_t * dvbpsi_GenCADr(dvbpsi_ca_dr_t * p_decoded,
     {
       /* Duplicate decoded data */
       dvbpsi_ca_dr_t * p_dup_decoded =
-                        (dvbpsi_ca_dr_t*)malloc(sizeof(dvbpsi_ca_dr_t));
+                        (dvbpsi_ca_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_ca_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_ca_dr_t));
 
@@ -63,7 +63,7 @@ dvbpsi_iso639_dr_t * dvbpsi_DecodeISO639Dr(dvbpsi_descriptor_t * p_descriptor)
     return p_descriptor->p_decoded;
 
   /* Allocate memory */
-  p_decoded = (dvbpsi_iso639_dr_t*)malloc(sizeof(dvbpsi_iso639_dr_t));
+  p_decoded = (dvbpsi_iso639_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_iso639_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_0a decoder", "out of memory");
@@ -75,7 +75,7 @@ dvbpsi_iso639_dr_t * dvbpsi_DecodeISO639Dr(dvbpsi_descriptor_t * p_descriptor)
   {
     DVBPSI_ERROR_ARG("dr_0a decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -123,7 +123,7 @@ dvbpsi_descriptor_t * dvbpsi_GenISO639Dr(dvbpsi_iso639_dr_t * p_decoded,
     {
       /* Duplicate decoded data */
       dvbpsi_iso639_dr_t * p_dup_decoded =
-                        (dvbpsi_iso639_dr_t*)malloc(sizeof(dvbpsi_iso639_dr_t));
+                        (dvbpsi_iso639_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_iso639_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_iso639_dr_t));
 
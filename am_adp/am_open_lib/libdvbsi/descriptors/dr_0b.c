@@ -65,7 +65,7 @@ dvbpsi_system_clock_dr_t * dvbpsi_DecodeSystemClockDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_system_clock_dr_t*)malloc(sizeof(dvbpsi_system_clock_dr_t));
+        (dvbpsi_system_clock_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_system_clock_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_0b decoder", "out of memory");
@@ -77,7 +77,7 @@ dvbpsi_system_clock_dr_t * dvbpsi_DecodeSystemClockDr(
   {
     DVBPSI_ERROR_ARG("dr_0b decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -115,7 +115,7 @@ dvbpsi_descriptor_t * dvbpsi_GenSystemClockDr(
     {
       /* Duplicate decoded data */
       dvbpsi_system_clock_dr_t * p_dup_decoded =
-        (dvbpsi_system_clock_dr_t*)malloc(sizeof(dvbpsi_system_clock_dr_t));
+        (dvbpsi_system_clock_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_system_clock_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_system_clock_dr_t));
 
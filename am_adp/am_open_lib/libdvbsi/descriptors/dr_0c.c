@@ -65,7 +65,7 @@ dvbpsi_mx_buff_utilization_dr_t * dvbpsi_DecodeMxBuffUtilizationDr(
 
   /* Allocate memory */
   p_decoded = (dvbpsi_mx_buff_utilization_dr_t*)
-                        malloc(sizeof(dvbpsi_mx_buff_utilization_dr_t));
+                        dvbpsi_malloc(sizeof(dvbpsi_mx_buff_utilization_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_0c decoder", "out of memory");
@@ -77,7 +77,7 @@ dvbpsi_mx_buff_utilization_dr_t * dvbpsi_DecodeMxBuffUtilizationDr(
   {
     DVBPSI_ERROR_ARG("dr_0c decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -118,7 +118,7 @@ dvbpsi_descriptor_t * dvbpsi_GenMxBuffUtilizationDr(
       /* Duplicate decoded data */
       dvbpsi_mx_buff_utilization_dr_t * p_dup_decoded =
                 (dvbpsi_mx_buff_utilization_dr_t*)
-                        malloc(sizeof(dvbpsi_mx_buff_utilization_dr_t));
+                        dvbpsi_malloc(sizeof(dvbpsi_mx_buff_utilization_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded,
                p_decoded,
@@ -65,7 +65,7 @@ dvbpsi_copyright_dr_t * dvbpsi_DecodeCopyrightDr(
 
   /* Allocate memory */
   p_decoded = (dvbpsi_copyright_dr_t*)
-                                malloc(sizeof(dvbpsi_copyright_dr_t));
+                                dvbpsi_malloc(sizeof(dvbpsi_copyright_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_0d decoder", "out of memory");
@@ -77,7 +77,7 @@ dvbpsi_copyright_dr_t * dvbpsi_DecodeCopyrightDr(
   {
     DVBPSI_ERROR_ARG("dr_0c decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -125,7 +125,7 @@ dvbpsi_descriptor_t * dvbpsi_GenCopyrightDr(
     {
       /* Duplicate decoded data */
       dvbpsi_copyright_dr_t * p_dup_decoded =
-        (dvbpsi_copyright_dr_t*)malloc(sizeof(dvbpsi_copyright_dr_t));
+        (dvbpsi_copyright_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_copyright_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_copyright_dr_t));
 
@@ -64,7 +64,7 @@ dvbpsi_max_bitrate_dr_t * dvbpsi_DecodeMaxBitrateDr(
     return p_descriptor->p_decoded;
 
   /* Allocate memory */
-  p_decoded = (dvbpsi_max_bitrate_dr_t*)malloc(sizeof(dvbpsi_max_bitrate_dr_t));
+  p_decoded = (dvbpsi_max_bitrate_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_max_bitrate_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_0e decoder", "out of memory");
@@ -76,7 +76,7 @@ dvbpsi_max_bitrate_dr_t * dvbpsi_DecodeMaxBitrateDr(
   {
     DVBPSI_ERROR_ARG("dr_0e decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -113,7 +113,7 @@ dvbpsi_descriptor_t * dvbpsi_GenMaxBitrateDr(
     {
       /* Duplicate decoded data */
       dvbpsi_max_bitrate_dr_t * p_dup_decoded =
-        (dvbpsi_max_bitrate_dr_t*)malloc(sizeof(dvbpsi_max_bitrate_dr_t));
+        (dvbpsi_max_bitrate_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_max_bitrate_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_max_bitrate_dr_t));
 
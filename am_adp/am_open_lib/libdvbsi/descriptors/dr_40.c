@@ -66,7 +66,7 @@ dvbpsi_network_name_dr_t * dvbpsi_DecodeNetworkNameDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_network_name_dr_t*)malloc(sizeof(dvbpsi_network_name_dr_t));
+        (dvbpsi_network_name_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_network_name_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_40 decoder", "out of memory");
@@ -68,7 +68,7 @@ dvbpsi_service_list_dr_t * dvbpsi_DecodeServiceListDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_service_list_dr_t*)malloc(sizeof(dvbpsi_service_list_dr_t));
+        (dvbpsi_service_list_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_service_list_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_41 decoder", "out of memory");
@@ -66,7 +66,7 @@ dvbpsi_stuffing_dr_t * dvbpsi_DecodeStuffingDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_stuffing_dr_t*)malloc(sizeof(dvbpsi_stuffing_dr_t));
+        (dvbpsi_stuffing_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_stuffing_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_42 decoder", "out of memory");
@@ -109,7 +109,7 @@ dvbpsi_descriptor_t * dvbpsi_GenStuffingDr(
     {
       /* Duplicate decoded data */
       dvbpsi_stuffing_dr_t * p_dup_decoded =
-        (dvbpsi_stuffing_dr_t*)malloc(sizeof(dvbpsi_stuffing_dr_t));
+        (dvbpsi_stuffing_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_stuffing_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_stuffing_dr_t));
 
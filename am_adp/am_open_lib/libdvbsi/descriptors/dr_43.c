@@ -65,7 +65,7 @@ dvbpsi_sat_deliv_sys_dr_t * dvbpsi_DecodeSatDelivSysDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_sat_deliv_sys_dr_t*)malloc(sizeof(dvbpsi_sat_deliv_sys_dr_t));
+        (dvbpsi_sat_deliv_sys_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_sat_deliv_sys_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_43 decoder", "out of memory");
@@ -135,7 +135,7 @@ dvbpsi_descriptor_t * dvbpsi_GenSatDelivSysDr(
     {
       /* Duplicate decoded data */
       dvbpsi_sat_deliv_sys_dr_t * p_dup_decoded =
-        (dvbpsi_sat_deliv_sys_dr_t*)malloc(sizeof(dvbpsi_sat_deliv_sys_dr_t));
+        (dvbpsi_sat_deliv_sys_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_sat_deliv_sys_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_sat_deliv_sys_dr_t));
 
@@ -66,7 +66,7 @@ dvbpsi_cable_delivery_dr_t * dvbpsi_DecodeCableDeliveryDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_cable_delivery_dr_t*)malloc(sizeof(dvbpsi_cable_delivery_dr_t));
+        (dvbpsi_cable_delivery_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_cable_delivery_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_44 decoder", "out of memory");
@@ -78,7 +78,7 @@ dvbpsi_cable_delivery_dr_t * dvbpsi_DecodeCableDeliveryDr(
   {
     DVBPSI_ERROR_ARG("dr_44 decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -83,7 +83,7 @@ dvbpsi_vbi_dr_t * dvbpsi_DecodeVBIDataDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_vbi_dr_t*)malloc(sizeof(dvbpsi_vbi_dr_t));
+        (dvbpsi_vbi_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_vbi_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_45 decoder", "out of memory");
@@ -174,7 +174,7 @@ dvbpsi_descriptor_t * dvbpsi_GenVBIDataDr(
     {
       /* Duplicate decoded data */
       dvbpsi_vbi_dr_t * p_dup_decoded =
-        (dvbpsi_vbi_dr_t*)malloc(sizeof(dvbpsi_vbi_dr_t));
+        (dvbpsi_vbi_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_vbi_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_vbi_dr_t));
 
@@ -66,7 +66,7 @@ dvbpsi_bouquet_name_dr_t * dvbpsi_DecodeBouquetNameDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_bouquet_name_dr_t*)malloc(sizeof(dvbpsi_bouquet_name_dr_t));
+        (dvbpsi_bouquet_name_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_bouquet_name_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_47 decoder", "out of memory");
@@ -109,7 +109,7 @@ dvbpsi_descriptor_t * dvbpsi_GenBouquetNameDr(
     {
       /* Duplicate decoded data */
       dvbpsi_bouquet_name_dr_t * p_dup_decoded =
-        (dvbpsi_bouquet_name_dr_t*)malloc(sizeof(dvbpsi_bouquet_name_dr_t));
+        (dvbpsi_bouquet_name_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_bouquet_name_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_bouquet_name_dr_t));
 
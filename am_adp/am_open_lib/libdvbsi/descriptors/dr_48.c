@@ -66,7 +66,7 @@ dvbpsi_service_dr_t * dvbpsi_DecodeServiceDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_service_dr_t*)malloc(sizeof(dvbpsi_service_dr_t));
+        (dvbpsi_service_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_service_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_48 decoder", "out of memory");
@@ -78,7 +78,7 @@ dvbpsi_service_dr_t * dvbpsi_DecodeServiceDr(
   {
     DVBPSI_ERROR_ARG("dr_07 decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -149,7 +149,7 @@ dvbpsi_descriptor_t * dvbpsi_GenServiceDr(
     {
       /* Duplicate decoded data */
       dvbpsi_service_dr_t * p_dup_decoded =
-        (dvbpsi_service_dr_t*)malloc(sizeof(dvbpsi_service_dr_t));
+        (dvbpsi_service_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_service_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_service_dr_t));
 
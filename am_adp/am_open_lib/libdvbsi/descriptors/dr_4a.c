@@ -66,7 +66,7 @@ dvbpsi_linkage_dr_t * dvbpsi_DecodeLinkageDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_linkage_dr_t*)malloc(sizeof(dvbpsi_linkage_dr_t));
+        (dvbpsi_linkage_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_linkage_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_4a decoder", "out of memory");
@@ -78,7 +78,7 @@ dvbpsi_linkage_dr_t * dvbpsi_DecodeLinkageDr(
   {
     DVBPSI_ERROR_ARG("dr_4a decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -73,7 +73,7 @@ dvbpsi_short_event_dr_t * dvbpsi_DecodeShortEventDr(dvbpsi_descriptor_t * p_desc
     return p_descriptor->p_decoded;
 
   /* Allocate memory */
-  p_decoded = malloc(sizeof(dvbpsi_short_event_dr_t));
+  p_decoded = dvbpsi_malloc(sizeof(dvbpsi_short_event_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_4d decoder", "out of memory");
@@ -123,7 +123,7 @@ dvbpsi_descriptor_t * dvbpsi_GenShortEventDr(dvbpsi_short_event_dr_t * p_decoded
     {
       /* Duplicate decoded data */
       dvbpsi_short_event_dr_t * p_dup_decoded =
-                (dvbpsi_short_event_dr_t*)malloc(sizeof(dvbpsi_short_event_dr_t));
+                (dvbpsi_short_event_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_short_event_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_short_event_dr_t));
 
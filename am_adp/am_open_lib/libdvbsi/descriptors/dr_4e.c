@@ -110,7 +110,7 @@ dvbpsi_extended_event_dr_t * dvbpsi_DecodeExtendedEventDr(dvbpsi_descriptor_t *
     return p_descriptor->p_decoded;
 
   /* Allocate memory */
-  p_decoded = malloc(sizeof(dvbpsi_extended_event_dr_t));
+  p_decoded = dvbpsi_malloc(sizeof(dvbpsi_extended_event_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_4e decoder", "out of memory");
@@ -205,7 +205,7 @@ dvbpsi_descriptor_t * dvbpsi_GenExtendedEventDr(dvbpsi_extended_event_dr_t * p_d
     {
       /* Duplicate decoded data */
       dvbpsi_extended_event_dr_t * p_dup_decoded =
-                (dvbpsi_extended_event_dr_t*)malloc(sizeof(dvbpsi_extended_event_dr_t));
+                (dvbpsi_extended_event_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_extended_event_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_extended_event_dr_t));
 
@@ -64,7 +64,7 @@ dvbpsi_stream_identifier_dr_t * dvbpsi_DecodeStreamIdentifierDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_stream_identifier_dr_t*)malloc(sizeof(dvbpsi_stream_identifier_dr_t));
+        (dvbpsi_stream_identifier_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_stream_identifier_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_52 decoder", "out of memory");
@@ -76,7 +76,7 @@ dvbpsi_stream_identifier_dr_t * dvbpsi_DecodeStreamIdentifierDr(
   {
     DVBPSI_ERROR_ARG("dr_52 decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -108,7 +108,7 @@ dvbpsi_descriptor_t * dvbpsi_GenStreamIdentifierDr(
     {
       /* Duplicate decoded data */
       dvbpsi_stream_identifier_dr_t * p_dup_decoded =
-        (dvbpsi_stream_identifier_dr_t*)malloc(sizeof(dvbpsi_stream_identifier_dr_t));
+        (dvbpsi_stream_identifier_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_stream_identifier_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_stream_identifier_dr_t));
 
@@ -64,7 +64,7 @@ dvbpsi_content_dr_t * dvbpsi_DecodeContentDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_content_dr_t*)malloc(sizeof(dvbpsi_content_dr_t));
+        (dvbpsi_content_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_content_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_54 decoder", "out of memory");
@@ -76,7 +76,7 @@ dvbpsi_content_dr_t * dvbpsi_DecodeContentDr(
   {
     DVBPSI_ERROR_ARG("dr_54 decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
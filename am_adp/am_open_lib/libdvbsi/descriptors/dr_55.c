@@ -66,7 +66,7 @@ dvbpsi_parental_rating_dr_t * dvbpsi_DecodeParentalRatingDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_parental_rating_dr_t*)malloc(sizeof(dvbpsi_parental_rating_dr_t));
+        (dvbpsi_parental_rating_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_parental_rating_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_55 decoder", "out of memory");
@@ -78,7 +78,7 @@ dvbpsi_parental_rating_dr_t * dvbpsi_DecodeParentalRatingDr(
   {
     DVBPSI_ERROR_ARG("dr_55 decoder", "length not multiple of 4 (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -135,7 +135,7 @@ dvbpsi_descriptor_t * dvbpsi_GenParentalRatingDr(
     {
       /* Duplicate decoded data */
       dvbpsi_parental_rating_dr_t * p_dup_decoded =
-        (dvbpsi_parental_rating_dr_t*)malloc(sizeof(dvbpsi_parental_rating_dr_t));
+        (dvbpsi_parental_rating_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_parental_rating_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_parental_rating_dr_t));
 
@@ -81,7 +81,7 @@ dvbpsi_teletext_dr_t * dvbpsi_DecodeTeletextDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_teletext_dr_t*)malloc(sizeof(dvbpsi_teletext_dr_t));
+        (dvbpsi_teletext_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_teletext_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_46/dr_56 decoder", "out of memory");
@@ -146,7 +146,7 @@ dvbpsi_descriptor_t * dvbpsi_GenTeletextDr(
     {
       /* Duplicate decoded data */
       dvbpsi_teletext_dr_t * p_dup_decoded =
-        (dvbpsi_teletext_dr_t*)malloc(sizeof(dvbpsi_teletext_dr_t));
+        (dvbpsi_teletext_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_teletext_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_teletext_dr_t));
 
@@ -67,7 +67,7 @@ dvbpsi_local_time_offset_dr_t * dvbpsi_DecodeLocalTimeOffsetDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_local_time_offset_dr_t*)malloc(sizeof(dvbpsi_local_time_offset_dr_t));
+        (dvbpsi_local_time_offset_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_local_time_offset_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_58 decoder", "out of memory");
@@ -149,7 +149,7 @@ dvbpsi_descriptor_t * dvbpsi_GenLocalTimeOffsetDr(
     {
       /* Duplicate decoded data */
       dvbpsi_local_time_offset_dr_t * p_dup_decoded =
-        (dvbpsi_local_time_offset_dr_t*)malloc(sizeof(dvbpsi_local_time_offset_dr_t));
+        (dvbpsi_local_time_offset_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_local_time_offset_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_local_time_offset_dr_t));
 
@@ -67,7 +67,7 @@ dvbpsi_subtitling_dr_t * dvbpsi_DecodeSubtitlingDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_subtitling_dr_t*)malloc(sizeof(dvbpsi_subtitling_dr_t));
+        (dvbpsi_subtitling_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_subtitling_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_59 decoder", "out of memory");
@@ -79,7 +79,7 @@ dvbpsi_subtitling_dr_t * dvbpsi_DecodeSubtitlingDr(
   {
     DVBPSI_ERROR_ARG("dr_59 decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -87,7 +87,7 @@ dvbpsi_subtitling_dr_t * dvbpsi_DecodeSubtitlingDr(
   {
     DVBPSI_ERROR_ARG("dr_59 decoder", "length not multiple of 8 (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -160,7 +160,7 @@ dvbpsi_descriptor_t * dvbpsi_GenSubtitlingDr(
     {
       /* Duplicate decoded data */
       dvbpsi_subtitling_dr_t * p_dup_decoded =
-        (dvbpsi_subtitling_dr_t*)malloc(sizeof(dvbpsi_subtitling_dr_t));
+        (dvbpsi_subtitling_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_subtitling_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_subtitling_dr_t));
 
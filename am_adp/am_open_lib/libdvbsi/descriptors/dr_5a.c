@@ -65,7 +65,7 @@ dvbpsi_terr_deliv_sys_dr_t * dvbpsi_DecodeTerrDelivSysDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_terr_deliv_sys_dr_t*)malloc(sizeof(dvbpsi_terr_deliv_sys_dr_t));
+        (dvbpsi_terr_deliv_sys_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_terr_deliv_sys_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_5a decoder", "out of memory");
@@ -134,7 +134,7 @@ dvbpsi_descriptor_t * dvbpsi_GenTerrDelivSysDr(
     {
       /* Duplicate decoded data */
       dvbpsi_terr_deliv_sys_dr_t * p_dup_decoded =
-        (dvbpsi_terr_deliv_sys_dr_t*)malloc(sizeof(dvbpsi_terr_deliv_sys_dr_t));
+        (dvbpsi_terr_deliv_sys_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_terr_deliv_sys_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_terr_deliv_sys_dr_t));
 
@@ -70,7 +70,7 @@ dvbpsi_multi_service_name_dr_t * dvbpsi_DecodeMultiServiceNameDr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_multi_service_name_dr_t*)malloc(sizeof(dvbpsi_multi_service_name_dr_t));
+        (dvbpsi_multi_service_name_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_multi_service_name_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_5d decoder", "out of memory");
@@ -71,7 +71,7 @@ dvbpsi_PDC_dr_t * dvbpsi_DecodePDCDr(dvbpsi_descriptor_t * p_descriptor)
   }
 
   /* Allocate memory */
-  p_decoded = (dvbpsi_PDC_dr_t*)malloc(sizeof(dvbpsi_PDC_dr_t));
+  p_decoded = (dvbpsi_PDC_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_PDC_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_69 decoder", "out of memory");
@@ -114,7 +114,7 @@ dvbpsi_descriptor_t * dvbpsi_GenPDCDr(dvbpsi_PDC_dr_t * p_decoded,
     {
       /* Duplicate decoded data */
       dvbpsi_PDC_dr_t * p_dup_decoded =
-                (dvbpsi_PDC_dr_t*)malloc(sizeof(dvbpsi_PDC_dr_t));
+                (dvbpsi_PDC_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_PDC_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_PDC_dr_t));
 
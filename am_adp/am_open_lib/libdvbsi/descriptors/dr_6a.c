@@ -62,7 +62,7 @@ dvbpsi_AC3_dr_t * dvbpsi_DecodeAC3Dr(dvbpsi_descriptor_t * p_descriptor)
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_AC3_dr_t *)malloc(sizeof(dvbpsi_AC3_dr_t));
+        (dvbpsi_AC3_dr_t *)dvbpsi_malloc(sizeof(dvbpsi_AC3_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_6a decoder", "out of memory");
@@ -82,7 +82,7 @@ dvbpsi_AC3_dr_t * dvbpsi_DecodeAC3Dr(dvbpsi_descriptor_t * p_descriptor)
   {
     DVBPSI_ERROR_ARG("dr_6a decoder", "bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
@@ -63,7 +63,7 @@ dvbpsi_ENAC3_dr_t * dvbpsi_DecodeENAC3Dr(dvbpsi_descriptor_t * p_descriptor)
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_ENAC3_dr_t *)malloc(sizeof(dvbpsi_ENAC3_dr_t));
+        (dvbpsi_ENAC3_dr_t *)dvbpsi_malloc(sizeof(dvbpsi_ENAC3_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_7a decoder", "out of memory");
@@ -95,7 +95,7 @@ dvbpsi_ENAC3_dr_t * dvbpsi_DecodeENAC3Dr(dvbpsi_descriptor_t * p_descriptor)
                      p_descriptor->i_length);
     AM_DEBUG(1, "dr_7a decoder bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
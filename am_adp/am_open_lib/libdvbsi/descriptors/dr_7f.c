@@ -96,7 +96,7 @@ dvbpsi_EXTENTION_dr_t * dvbpsi_DecodeEXTENTIONDr(dvbpsi_descriptor_t * p_descrip
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_EXTENTION_dr_t *)malloc(sizeof(dvbpsi_EXTENTION_dr_t));
+        (dvbpsi_EXTENTION_dr_t *)dvbpsi_malloc(sizeof(dvbpsi_EXTENTION_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_7f decoder", "out of memory");
@@ -63,7 +63,7 @@ dvbpsi_atsc_ac3_audio_dr_t *dvbpsi_decode_atsc_ac3_audio_dr(dvbpsi_descriptor_t
     if (p_descriptor->i_length < 3)
         return NULL;
 
-    p_decoded = (dvbpsi_atsc_ac3_audio_dr_t*)calloc(1, sizeof(dvbpsi_atsc_ac3_audio_dr_t));
+    p_decoded = (dvbpsi_atsc_ac3_audio_dr_t*)dvbpsi_calloc(1, sizeof(dvbpsi_atsc_ac3_audio_dr_t));
     if (!p_decoded)
         return NULL;
 
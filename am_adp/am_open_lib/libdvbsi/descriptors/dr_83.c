@@ -68,7 +68,7 @@ dvbpsi_logical_channel_number_83_dr_t * dvbpsi_DecodeLogicalChannelNumber83Dr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_logical_channel_number_83_dr_t*)malloc(sizeof(dvbpsi_logical_channel_number_83_dr_t));
+        (dvbpsi_logical_channel_number_83_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_logical_channel_number_83_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_83 decoder", "out of memory");
@@ -142,7 +142,7 @@ dvbpsi_descriptor_t * dvbpsi_GenLogicalChannelNumber83Dr(
     {
       /* Duplicate decoded data */
       dvbpsi_logical_channel_number_83_dr_t * p_dup_decoded =
-        (dvbpsi_logical_channel_number_83_dr_t*)malloc(sizeof(dvbpsi_logical_channel_number_83_dr_t));
+        (dvbpsi_logical_channel_number_83_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_logical_channel_number_83_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_logical_channel_number_83_dr_t));
 
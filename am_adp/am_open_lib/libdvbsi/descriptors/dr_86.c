@@ -62,7 +62,7 @@ dvbpsi_atsc_caption_service_dr_t *dvbpsi_decode_atsc_caption_service_dr(dvbpsi_d
     if ((p_descriptor->i_length - 1) % 6)
         return NULL;
 
-    p_decoded = (dvbpsi_atsc_caption_service_dr_t*)malloc(sizeof(dvbpsi_atsc_caption_service_dr_t));
+    p_decoded = (dvbpsi_atsc_caption_service_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_caption_service_dr_t));
     if (!p_decoded)
         return NULL;
 
@@ -67,7 +67,7 @@ dvbpsi_logical_channel_number_87_dr_t * dvbpsi_DecodeLogicalChannelNumber87Dr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_logical_channel_number_87_dr_t*)malloc(sizeof(dvbpsi_logical_channel_number_87_dr_t));
+        (dvbpsi_logical_channel_number_87_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_logical_channel_number_87_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_87 decoder", "out of memory");
@@ -184,7 +184,7 @@ dvbpsi_descriptor_t * dvbpsi_GenLogicalChannelNumber87Dr(
     {
       /* Duplicate decoded data */
       dvbpsi_logical_channel_number_87_dr_t * p_dup_decoded =
-        (dvbpsi_logical_channel_number_87_dr_t*)malloc(sizeof(dvbpsi_logical_channel_number_87_dr_t));
+        (dvbpsi_logical_channel_number_87_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_logical_channel_number_87_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_logical_channel_number_87_dr_t));
 
@@ -52,7 +52,7 @@ dvbpsi_atsc_content_advisory_dr_t *dvbpsi_decode_atsc_content_advisory_dr(dvbpsi
     if (dvbpsi_IsDescriptorDecoded(p_descriptor))
         return p_descriptor->p_decoded;
 
-    p_decoded = (dvbpsi_atsc_content_advisory_dr_t*)malloc(sizeof(dvbpsi_atsc_content_advisory_dr_t));
+    p_decoded = (dvbpsi_atsc_content_advisory_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_content_advisory_dr_t));
     if (!p_decoded)
         return NULL;
 
@@ -105,7 +105,7 @@ dvbpsi_atsc_content_advisory_dr_t *dvbpsi_decode_atsc_content_advisory_dr(dvbpsi
     p_decoded->i_rating_region_count = region;
     return p_decoded;
 ERROR:
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     p_descriptor->p_decoded = NULL;
     return NULL;
 }
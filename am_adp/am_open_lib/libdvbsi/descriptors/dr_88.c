@@ -67,7 +67,7 @@ dvbpsi_logical_channel_number_88_dr_t * dvbpsi_DecodeLogicalChannelNumber88Dr(
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_logical_channel_number_88_dr_t*)malloc(sizeof(dvbpsi_logical_channel_number_88_dr_t));
+        (dvbpsi_logical_channel_number_88_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_logical_channel_number_88_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_88 decoder", "out of memory");
@@ -137,7 +137,7 @@ dvbpsi_descriptor_t * dvbpsi_GenLogicalChannelNumber88Dr(
     {
       /* Duplicate decoded data */
       dvbpsi_logical_channel_number_88_dr_t * p_dup_decoded =
-        (dvbpsi_logical_channel_number_88_dr_t*)malloc(sizeof(dvbpsi_logical_channel_number_88_dr_t));
+        (dvbpsi_logical_channel_number_88_dr_t*)dvbpsi_malloc(sizeof(dvbpsi_logical_channel_number_88_dr_t));
       if (p_dup_decoded)
         memcpy(p_dup_decoded, p_decoded, sizeof(dvbpsi_logical_channel_number_88_dr_t));
 
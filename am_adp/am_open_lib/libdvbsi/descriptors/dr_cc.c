@@ -63,7 +63,7 @@ dvbpsi_PSIPENAC3_dr_t * dvbpsi_DecodePSIPENAC3Dr(dvbpsi_descriptor_t * p_descrip
 
   /* Allocate memory */
   p_decoded =
-        (dvbpsi_PSIPENAC3_dr_t *)malloc(sizeof(dvbpsi_PSIPENAC3_dr_t));
+        (dvbpsi_PSIPENAC3_dr_t *)dvbpsi_malloc(sizeof(dvbpsi_PSIPENAC3_dr_t));
   if (!p_decoded)
   {
     DVBPSI_ERROR("dr_cc decoder", "out of memory");
@@ -86,7 +86,7 @@ dvbpsi_PSIPENAC3_dr_t * dvbpsi_DecodePSIPENAC3Dr(dvbpsi_descriptor_t * p_descrip
                      p_descriptor->i_length);
     AM_DEBUG(1, "dr_cc decoder bad length (%d)",
                      p_descriptor->i_length);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
   //p_decoded->i_component_type_flag = (p_descriptor->p_data[0] & AM_ENAC3_CMP_FLAG) ? 1 : 0;
@@ -128,7 +128,7 @@ dvbpsi_PSIPENAC3_dr_t * dvbpsi_DecodePSIPENAC3Dr(dvbpsi_descriptor_t * p_descrip
                      p_descriptor->i_length);
     AM_DEBUG(1, "dr_cc decoder bad length (%d)limit_len(%d)",
                      p_descriptor->i_length, limit_len);
-    free(p_decoded);
+    dvbpsi_free(p_decoded);
     return NULL;
   }
 
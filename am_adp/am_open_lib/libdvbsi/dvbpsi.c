@@ -32,6 +32,8 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
 
 #if defined(HAVE_INTTYPES_H)
 #include <inttypes.h>
@@ -140,6 +142,75 @@ uint32_t dvbpsi_crc32_table[256] =
 };
 
 
+/*****************************************************************************
+ * Allocation pool of the current thread
+ *****************************************************************************/
+static pthread_key_t  alloc_pool_key;
+static pthread_once_t alloc_pool_once = PTHREAD_ONCE_INIT;
+
+static void dvbpsi_InitAllocPool(void)
+{
+  pthread_key_create(&alloc_pool_key, NULL);
+}
+
+/*****************************************************************************
+ * dvbpsi_GetAllocPool
+ *****************************************************************************
+ * Get the allocation pool of the current thread.
+ *****************************************************************************/
+AM_MEM_Pool_t *dvbpsi_GetAllocPool(void)
+{
+  pthread_once(&alloc_pool_once, dvbpsi_InitAllocPool);
+  return (AM_MEM_Pool_t*)pthread_getspecific(alloc_pool_key);
+}
+
+/*****************************************************************************
+ * dvbpsi_SetAllocPool
+ *****************************************************************************
+ * Set the allocation pool of the current thread.
+ *****************************************************************************/
+AM_MEM_Pool_t *dvbpsi_SetAllocPool(AM_MEM_Pool_t *p_pool)
+{
+  AM_MEM_Pool_t *p_old = dvbpsi_GetAllocPool();
+
+  pthread_setspecific(alloc_pool_key, p_pool);
+
+  return p_old;
+}
+
+/*****************************************************************************
+ * dvbpsi_malloc, dvbpsi_calloc, dvbpsi_free
+ *****************************************************************************
+ * Allocate from the pool of the current thread if there is one.
+ *****************************************************************************/
+void *dvbpsi_malloc(size_t i_size)
+{
+  AM_MEM_Pool_t *p_pool = dvbpsi_GetAllocPool();
+
+  if (p_pool)
+    return AM_MEM_PoolAlloc(p_pool, i_size);
+
+  return malloc(i_size);
+}
+
+void *dvbpsi_calloc(size_t i_count, size_t i_size)
+{
+  AM_MEM_Pool_t *p_pool = dvbpsi_GetAllocPool();
+
+  if (p_pool)
+    return AM_MEM_PoolAlloc0(p_pool, i_count * i_size);
+
+  return calloc(i_count, i_size);
+}
+
+void dvbpsi_free(void *p_ptr)
+{
+  /* Pool memory is released with the pool */
+  if (!dvbpsi_GetAllocPool())
+    free(p_ptr);
+}
+
+
 /*****************************************************************************
  * dvbpsi_PushPacket
  *****************************************************************************
@@ -39,6 +39,7 @@
 #include <stdint.h>
 #endif
 
+#include <am_crc.h>
 #include "dvbpsi.h"
 #include "dvbpsi_private.h"
 #include "psi.h"
@@ -107,14 +108,8 @@ int dvbpsi_ValidPSISection(dvbpsi_psi_section_t* p_section)
   if (p_section->b_syntax_indicator)
   {
     /* Check the CRC_32 if b_syntax_indicator is 0 */
-    uint32_t i_crc = 0xffffffff;
-    uint8_t* p_byte = p_section->p_data;
-
-    while (p_byte < p_section->p_payload_end + 4)
-    {
-      i_crc = (i_crc << 8) ^ dvbpsi_crc32_table[(i_crc >> 24) ^ (*p_byte)];
-      p_byte++;
-    }
+    uint32_t i_crc = AM_CRC32_Calc(AM_CRC32_INIT, p_section->p_data,
+                                   p_section->p_payload_end + 4 - p_section->p_data);
 
     if (i_crc == 0)
     {
@@ -172,14 +167,8 @@ void dvbpsi_BuildPSISection(dvbpsi_psi_section_t* p_section)
     p_section->p_data[7] = p_section->i_last_number;
 
     /* CRC_32 */
-    p_section->i_crc = 0xffffffff;
-
-    while (p_byte < p_section->p_payload_end)
-    {
-      p_section->i_crc =   (p_section->i_crc << 8)
-                         ^ dvbpsi_crc32_table[(p_section->i_crc >> 24) ^ (*p_byte)];
-      p_byte++;
-    }
+    p_section->i_crc = AM_CRC32_Calc(AM_CRC32_INIT, p_byte,
+                                     p_section->p_payload_end - p_byte);
 
     p_section->p_payload_end[0] = (p_section->i_crc >> 24) & 0xff;
     p_section->p_payload_end[1] = (p_section->i_crc >> 16) & 0xff;
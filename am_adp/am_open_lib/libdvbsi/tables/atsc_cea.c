@@ -146,7 +146,7 @@ dvbpsi_atsc_cea_t *dvbpsi_atsc_NewCEA(uint8_t i_table_id, uint16_t i_extension,
                                       uint8_t i_version, bool b_current_next)
 {
     dvbpsi_atsc_cea_t *p_cea;
-    p_cea = (dvbpsi_atsc_cea_t*) malloc(sizeof(dvbpsi_atsc_cea_t));
+    p_cea = (dvbpsi_atsc_cea_t*) dvbpsi_malloc(sizeof(dvbpsi_atsc_cea_t));
     memset(p_cea, 0, sizeof(dvbpsi_atsc_cea_t));
 #ifdef CEA_DEBUG
     AM_DEBUG(1, "new CEA %d %d %d %d",
@@ -173,7 +173,7 @@ void dvbpsi_atsc_EmptyCEA(dvbpsi_atsc_cea_t* p_cea)
   while (p_multi_text != NULL)
   {
     dvbpsi_atsc_cea_multi_str_t* p_tmp = p_multi_text->p_next;
-    free(p_multi_text);
+    dvbpsi_free(p_multi_text);
     p_multi_text = p_tmp;
   }
   p_cea->p_first_multi_text = NULL;
@@ -187,7 +187,7 @@ void dvbpsi_atsc_DeleteCEA(dvbpsi_atsc_cea_t *p_cea)
     AM_DEBUG(1, "delete CEA info");
     if (p_cea) {
         dvbpsi_atsc_EmptyCEA(p_cea);
-        free(p_cea);
+        dvbpsi_free(p_cea);
         p_cea = NULL;
     }
 }
@@ -296,7 +296,7 @@ static dvbpsi_atsc_cea_multi_str_t *dvbpsi_atsc_CEAAddMulti(dvbpsi_atsc_cea_t* p
 {
 
   dvbpsi_atsc_cea_multi_str_t * p_multi_text
-                = (dvbpsi_atsc_cea_multi_str_t*)malloc(sizeof(dvbpsi_atsc_cea_multi_str_t));
+                = (dvbpsi_atsc_cea_multi_str_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_cea_multi_str_t));
 
   if (p_multi_text)
   {
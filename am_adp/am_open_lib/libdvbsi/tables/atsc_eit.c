@@ -192,7 +192,7 @@ dvbpsi_atsc_eit_t *dvbpsi_atsc_NewEIT(uint8_t i_table_id, uint16_t i_extension,
                                       uint16_t i_source_id, bool b_current_next)
 {
     dvbpsi_atsc_eit_t *p_eit;
-    p_eit = (dvbpsi_atsc_eit_t*) malloc(sizeof(dvbpsi_atsc_eit_t));
+    p_eit = (dvbpsi_atsc_eit_t*) dvbpsi_malloc(sizeof(dvbpsi_atsc_eit_t));
     if (p_eit != NULL)
         dvbpsi_atsc_InitEIT(p_eit, i_table_id, i_extension, i_version,
                             i_protocol, i_source_id, b_current_next);
@@ -212,7 +212,7 @@ void dvbpsi_atsc_EmptyEIT(dvbpsi_atsc_eit_t* p_eit)
   {
     dvbpsi_atsc_eit_event_t* p_tmp = p_event->p_next;
     dvbpsi_DeleteDescriptors(p_event->p_first_descriptor);
-    free(p_event);
+    dvbpsi_free(p_event);
     p_event = p_tmp;
   }
   p_eit->p_first_event = NULL;
@@ -225,7 +225,7 @@ void dvbpsi_atsc_DeleteEIT(dvbpsi_atsc_eit_t *p_eit)
 {
     if (p_eit)
         dvbpsi_atsc_EmptyEIT(p_eit);
-    free(p_eit);
+    dvbpsi_free(p_eit);
     p_eit = NULL;
 }
 
@@ -243,7 +243,7 @@ static dvbpsi_atsc_eit_event_t *dvbpsi_atsc_EITAddEvent(dvbpsi_atsc_eit_t* p_eit
                                             uint8_t *p_title)
 {
   dvbpsi_atsc_eit_event_t * p_event
-                = (dvbpsi_atsc_eit_event_t*)malloc(sizeof(dvbpsi_atsc_eit_event_t));
+                = (dvbpsi_atsc_eit_event_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_eit_event_t));
   if (p_event)
   {
     p_event->i_event_id = i_event_id;
@@ -447,7 +447,7 @@ static void dvbpsi_atsc_GatherEITSections(dvbpsi_t * p_dvbpsi,
                 if ((!p_eit_decoder->current_eit.b_current_next) &&
                      (p_section->b_current_next))
                 {
-                    dvbpsi_atsc_eit_t * p_eit = (dvbpsi_atsc_eit_t*)malloc(sizeof(dvbpsi_atsc_eit_t));
+                    dvbpsi_atsc_eit_t * p_eit = (dvbpsi_atsc_eit_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_eit_t));
                     if (p_eit)
                     {
                         p_eit_decoder->current_eit.b_current_next = true;
@@ -198,7 +198,7 @@ dvbpsi_atsc_ett_t *dvbpsi_atsc_NewETT(uint8_t i_table_id, uint16_t i_extension,
                                       uint32_t i_etm_id, bool b_current_next)
 {
     dvbpsi_atsc_ett_t *p_ett;
-    p_ett = (dvbpsi_atsc_ett_t*)malloc(sizeof(dvbpsi_atsc_ett_t));
+    p_ett = (dvbpsi_atsc_ett_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_ett_t));
     if (p_ett != NULL)
         dvbpsi_atsc_InitETT(p_ett, i_table_id, i_extension, i_version,
                             i_protocol, i_etm_id, b_current_next);
@@ -216,7 +216,7 @@ void dvbpsi_atsc_EmptyETT(dvbpsi_atsc_ett_t *p_ett)
 
     dvbpsi_DeleteDescriptors(p_ett->p_first_descriptor);
 
-    free(p_ett->p_etm_data);
+    dvbpsi_free(p_ett->p_etm_data);
     p_ett->i_etm_length = 0;
     p_ett->p_etm_data = NULL;
     p_ett->p_first_descriptor = NULL;
@@ -226,7 +226,7 @@ void dvbpsi_atsc_DeleteETT(dvbpsi_atsc_ett_t *p_ett)
 {
     if (p_ett)
         dvbpsi_atsc_EmptyETT(p_ett);
-    free(p_ett);
+    dvbpsi_free(p_ett);
     p_ett = NULL;
 }
 
@@ -427,7 +427,7 @@ void dvbpsi_atsc_DecodeETTSections(dvbpsi_atsc_ett_t* p_ett,
          * the PSI table is spread over multiple PSI sections */
         if (p_ett->p_etm_data)
             abort();
-        p_ett->p_etm_data = calloc(i_etm_length, sizeof(uint8_t));
+        p_ett->p_etm_data = dvbpsi_calloc(i_etm_length, sizeof(uint8_t));
         if (!p_ett->p_etm_data)
             continue;
         /* FIXME: Decode the separate strings. For now copy the data in the
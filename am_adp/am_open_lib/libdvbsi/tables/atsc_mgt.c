@@ -196,7 +196,7 @@ dvbpsi_atsc_mgt_t *dvbpsi_atsc_NewMGT(uint8_t i_table_id, uint16_t i_extension,
                                       uint8_t i_version, uint8_t i_protocol, bool b_current_next)
 {
     dvbpsi_atsc_mgt_t* p_mgt;
-    p_mgt = (dvbpsi_atsc_mgt_t*)calloc(1, sizeof(dvbpsi_atsc_mgt_t));
+    p_mgt = (dvbpsi_atsc_mgt_t*)dvbpsi_calloc(1, sizeof(dvbpsi_atsc_mgt_t));
     if (p_mgt != NULL)
         dvbpsi_atsc_InitMGT(p_mgt, i_table_id, i_extension, i_version, i_protocol, b_current_next);
     return p_mgt;
@@ -215,7 +215,7 @@ void dvbpsi_atsc_EmptyMGT(dvbpsi_atsc_mgt_t* p_mgt)
   {
     dvbpsi_atsc_mgt_table_t* p_tmp = p_table->p_next;
     dvbpsi_DeleteDescriptors(p_table->p_first_descriptor);
-    free(p_table);
+    dvbpsi_free(p_table);
     p_table = p_tmp;
   }
   dvbpsi_DeleteDescriptors(p_mgt->p_first_descriptor);
@@ -227,7 +227,7 @@ void dvbpsi_atsc_DeleteMGT(dvbpsi_atsc_mgt_t *p_mgt)
 {
     if (p_mgt)
         dvbpsi_atsc_EmptyMGT(p_mgt);
-    free(p_mgt);
+    dvbpsi_free(p_mgt);
     p_mgt = NULL;
 }
 
@@ -267,7 +267,7 @@ static dvbpsi_atsc_mgt_table_t *dvbpsi_atsc_MGTAddTable(dvbpsi_atsc_mgt_t* p_mgt
 						 uint32_t i_number_bytes)
 {
   dvbpsi_atsc_mgt_table_t * p_table
-                = (dvbpsi_atsc_mgt_table_t*)malloc(sizeof(dvbpsi_atsc_mgt_table_t));
+                = (dvbpsi_atsc_mgt_table_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_mgt_table_t));
   if (p_table)
   {
     p_table->i_table_type = i_table_type;
@@ -473,7 +473,7 @@ static void dvbpsi_atsc_GatherMGTSections(dvbpsi_t * p_dvbpsi,
                 if ((!p_mgt_decoder->current_mgt.b_current_next) &&
                      (p_section->b_current_next))
                 {
-                    dvbpsi_atsc_mgt_t * p_mgt = (dvbpsi_atsc_mgt_t*)malloc(sizeof(dvbpsi_atsc_mgt_t));
+                    dvbpsi_atsc_mgt_t * p_mgt = (dvbpsi_atsc_mgt_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_mgt_t));
                     if (p_mgt)
                     {
                         p_mgt_decoder->current_mgt.b_current_next = true;
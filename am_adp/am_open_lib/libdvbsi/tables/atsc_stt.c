@@ -187,7 +187,7 @@ dvbpsi_atsc_stt_t *dvbpsi_atsc_NewSTT(uint8_t i_table_id, uint16_t i_extension,
                                       uint8_t i_version, bool b_current_next)
 {
     dvbpsi_atsc_stt_t *p_stt;
-    p_stt = (dvbpsi_atsc_stt_t*)malloc(sizeof(dvbpsi_atsc_stt_t));
+    p_stt = (dvbpsi_atsc_stt_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_stt_t));
     if (p_stt != NULL)
         dvbpsi_atsc_InitSTT(p_stt, i_table_id, i_extension, i_version, b_current_next);
     return p_stt;
@@ -213,7 +213,7 @@ void dvbpsi_atsc_DeleteSTT(dvbpsi_atsc_stt_t *p_stt)
 {
     if (p_stt)
         dvbpsi_atsc_EmptySTT(p_stt);
-    free(p_stt);
+    dvbpsi_free(p_stt);
     p_stt = NULL;
 }
 
@@ -378,7 +378,7 @@ static void dvbpsi_atsc_GatherSTTSections(dvbpsi_t *p_dvbpsi,
                 if ((!p_stt_decoder->current_stt.b_current_next)
                     && (p_section->b_current_next))
                 {
-                    dvbpsi_atsc_stt_t * p_stt = (dvbpsi_atsc_stt_t*)malloc(sizeof(dvbpsi_atsc_stt_t));
+                    dvbpsi_atsc_stt_t * p_stt = (dvbpsi_atsc_stt_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_stt_t));
                     if (p_stt)
                     {
                         p_stt_decoder->current_stt.b_current_next = 1;
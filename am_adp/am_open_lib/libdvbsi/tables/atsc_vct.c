@@ -189,7 +189,7 @@ void dvbpsi_atsc_DetachVCT(dvbpsi_t *p_dvbpsi, uint8_t i_table_id, uint16_t i_ex
 dvbpsi_atsc_vct_t *dvbpsi_atsc_NewVCT(uint8_t i_table_id, uint16_t i_extension,
         uint8_t i_protocol, bool b_cable_vct, uint8_t i_version, bool b_current_next)
 {
-    dvbpsi_atsc_vct_t *p_vct = (dvbpsi_atsc_vct_t*)malloc(sizeof(dvbpsi_atsc_vct_t));
+    dvbpsi_atsc_vct_t *p_vct = (dvbpsi_atsc_vct_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_vct_t));
     if (p_vct != NULL)
         dvbpsi_atsc_InitVCT(p_vct, i_table_id, i_extension,  i_protocol,
                             b_cable_vct, i_version, b_current_next);
@@ -232,7 +232,7 @@ void dvbpsi_atsc_EmptyVCT(dvbpsi_atsc_vct_t* p_vct)
     {
         dvbpsi_atsc_vct_channel_t* p_tmp = p_channel->p_next;
         dvbpsi_DeleteDescriptors(p_channel->p_first_descriptor);
-        free(p_channel);
+        dvbpsi_free(p_channel);
         p_channel = p_tmp;
     }
     p_vct->p_first_channel = NULL;
@@ -247,7 +247,7 @@ void dvbpsi_atsc_DeleteVCT(dvbpsi_atsc_vct_t *p_vct)
 {
     if (p_vct)
         dvbpsi_atsc_EmptyVCT(p_vct);
-    free(p_vct);
+    dvbpsi_free(p_vct);
 }
 
 /*****************************************************************************
@@ -296,7 +296,7 @@ static dvbpsi_atsc_vct_channel_t *dvbpsi_atsc_VCTAddChannel(dvbpsi_atsc_vct_t* p
                                             uint16_t i_source_id)
 {
     dvbpsi_atsc_vct_channel_t * p_channel
-            = (dvbpsi_atsc_vct_channel_t*)malloc(sizeof(dvbpsi_atsc_vct_channel_t));
+            = (dvbpsi_atsc_vct_channel_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_vct_channel_t));
     if (p_channel)
     {
         memcpy(p_channel->i_short_name, p_short_name, sizeof(uint16_t) * 7);
@@ -511,7 +511,7 @@ static void dvbpsi_atsc_GatherVCTSections(dvbpsi_t *p_dvbpsi,
                 if ((!p_vct_decoder->current_vct.b_current_next)
                     && (p_section->b_current_next))
                 {
-                    dvbpsi_atsc_vct_t * p_vct = (dvbpsi_atsc_vct_t*)malloc(sizeof(dvbpsi_atsc_vct_t));
+                    dvbpsi_atsc_vct_t * p_vct = (dvbpsi_atsc_vct_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_vct_t));
                     if (p_vct)
                     {
                         p_vct_decoder->current_vct.b_current_next = 1;
@@ -78,17 +78,17 @@ int dvbpsi_AttachBAT(dvbpsi_decoder_t * p_psi_decoder, uint8_t i_table_id,
     return 1;
   }
 
-  p_subdec = (dvbpsi_demux_subdec_t*)malloc(sizeof(dvbpsi_demux_subdec_t));
+  p_subdec = (dvbpsi_demux_subdec_t*)dvbpsi_malloc(sizeof(dvbpsi_demux_subdec_t));
   if (p_subdec == NULL)
   {
     return 1;
   }
 
-  p_bat_decoder = (dvbpsi_bat_decoder_t*)malloc(sizeof(dvbpsi_bat_decoder_t));
+  p_bat_decoder = (dvbpsi_bat_decoder_t*)dvbpsi_malloc(sizeof(dvbpsi_bat_decoder_t));
 
   if (p_bat_decoder == NULL)
   {
-    free(p_subdec);
+    dvbpsi_free(p_subdec);
     return 1;
   }
 
@@ -143,7 +143,7 @@ void dvbpsi_DetachBAT(dvbpsi_demux_t * p_demux, uint8_t i_table_id,
 
   p_bat_decoder = (dvbpsi_bat_decoder_t*)p_subdec->p_cb_data;
 
-  free(p_bat_decoder->p_building_bat);
+  dvbpsi_free(p_bat_decoder->p_building_bat);
 
   for (i = 0; i <= 255; i++)
   {
@@ -151,14 +151,14 @@ void dvbpsi_DetachBAT(dvbpsi_demux_t * p_demux, uint8_t i_table_id,
       dvbpsi_DeletePSISections(p_bat_decoder->ap_sections[i]);
   }
 
-  free(p_subdec->p_cb_data);
+  dvbpsi_free(p_subdec->p_cb_data);
 
   pp_prev_subdec = &p_demux->p_first_subdec;
   while (*pp_prev_subdec != p_subdec)
     pp_prev_subdec = &(*pp_prev_subdec)->p_next;
 
   *pp_prev_subdec = p_subdec->p_next;
-  free(p_subdec);
+  dvbpsi_free(p_subdec);
 }
 
 
@@ -193,7 +193,7 @@ void dvbpsi_EmptyBAT(dvbpsi_bat_t* p_bat)
   {
     dvbpsi_bat_ts_t* p_tmp = p_ts->p_next;
     dvbpsi_DeleteDescriptors(p_ts->p_first_descriptor);
-    free(p_ts);
+    dvbpsi_free(p_ts);
     p_ts = p_tmp;
   }
 
@@ -241,7 +241,7 @@ dvbpsi_descriptor_t* dvbpsi_BATAddDescriptor(dvbpsi_bat_t* p_bat,
 dvbpsi_bat_ts_t* dvbpsi_BATAddTS(dvbpsi_bat_t* p_bat,
                                  uint16_t i_ts_id, uint16_t i_orig_network_id)
 {
-  dvbpsi_bat_ts_t* p_ts = (dvbpsi_bat_ts_t*)malloc(sizeof(dvbpsi_bat_ts_t));
+  dvbpsi_bat_ts_t* p_ts = (dvbpsi_bat_ts_t*)dvbpsi_malloc(sizeof(dvbpsi_bat_ts_t));
 
   if (p_ts)
   {
@@ -400,7 +400,7 @@ void dvbpsi_GatherBATSections(dvbpsi_decoder_t * p_decoder,
     /* Free structures */
     if (p_bat_decoder->p_building_bat)
     {
-      free(p_bat_decoder->p_building_bat);
+      dvbpsi_free(p_bat_decoder->p_building_bat);
       p_bat_decoder->p_building_bat = NULL;
     }
     /* Clear the section array */
@@ -423,7 +423,7 @@ void dvbpsi_GatherBATSections(dvbpsi_decoder_t * p_decoder,
     if (!p_bat_decoder->p_building_bat)
     {
       p_bat_decoder->p_building_bat =
-                                (dvbpsi_bat_t*)malloc(sizeof(dvbpsi_bat_t));
+                                (dvbpsi_bat_t*)dvbpsi_malloc(sizeof(dvbpsi_bat_t));
       dvbpsi_InitBAT(p_bat_decoder->p_building_bat,
                      p_bat_decoder->i_bouquet_id,
                      p_section->i_version,
@@ -61,18 +61,18 @@ DEF_SET_DECODE_DESCRIPTOR_CALLBACK(cat)
 dvbpsi_handle dvbpsi_AttachCAT(dvbpsi_cat_callback pf_callback,
                                void* p_cb_data)
 {
-  dvbpsi_handle h_dvbpsi = (dvbpsi_decoder_t*)malloc(sizeof(dvbpsi_decoder_t));
+  dvbpsi_handle h_dvbpsi = (dvbpsi_decoder_t*)dvbpsi_malloc(sizeof(dvbpsi_decoder_t));
   dvbpsi_cat_decoder_t* p_cat_decoder;
   unsigned int i;
 
   if (h_dvbpsi == NULL)
     return NULL;
 
-  p_cat_decoder = (dvbpsi_cat_decoder_t*)malloc(sizeof(dvbpsi_cat_decoder_t));
+  p_cat_decoder = (dvbpsi_cat_decoder_t*)dvbpsi_malloc(sizeof(dvbpsi_cat_decoder_t));
 
   if (p_cat_decoder == NULL)
   {
-    free(h_dvbpsi);
+    dvbpsi_free(h_dvbpsi);
     return NULL;
   }
 
@@ -109,18 +109,18 @@ void dvbpsi_DetachCAT(dvbpsi_handle h_dvbpsi)
                         = (dvbpsi_cat_decoder_t*)h_dvbpsi->p_private_decoder;
   unsigned int i;
 
-  free(p_cat_decoder->p_building_cat);
+  dvbpsi_free(p_cat_decoder->p_building_cat);
 
   for (i = 0; i <= 255; i++)
   {
     if (p_cat_decoder->ap_sections[i])
-      free(p_cat_decoder->ap_sections[i]);
+      dvbpsi_free(p_cat_decoder->ap_sections[i]);
   }
 
-  free(h_dvbpsi->p_private_decoder);
+  dvbpsi_free(h_dvbpsi->p_private_decoder);
   if (h_dvbpsi->p_current_section)
     dvbpsi_DeletePSISections(h_dvbpsi->p_current_section);
-  free(h_dvbpsi);
+  dvbpsi_free(h_dvbpsi);
 }
 
 
@@ -273,7 +273,7 @@ void dvbpsi_GatherCATSections(dvbpsi_decoder_t* p_decoder,
     /* Free structures */
     if (p_cat_decoder->p_building_cat)
     {
-      free(p_cat_decoder->p_building_cat);
+      dvbpsi_free(p_cat_decoder->p_building_cat);
       p_cat_decoder->p_building_cat = NULL;
     }
     /* Clear the section array */
@@ -296,7 +296,7 @@ void dvbpsi_GatherCATSections(dvbpsi_decoder_t* p_decoder,
     if (!p_cat_decoder->p_building_cat)
     {
       p_cat_decoder->p_building_cat =
-                                (dvbpsi_cat_t*)malloc(sizeof(dvbpsi_cat_t));
+                                (dvbpsi_cat_t*)dvbpsi_malloc(sizeof(dvbpsi_cat_t));
       dvbpsi_InitCAT(p_cat_decoder->p_building_cat,
                      p_section->i_version,
                      p_section->b_current_next);
@@ -77,17 +77,17 @@ int dvbpsi_AttachEIT(dvbpsi_decoder_t * p_psi_decoder, uint8_t i_table_id,
     return 1;
   }
 
-  p_subdec = (dvbpsi_demux_subdec_t*)malloc(sizeof(dvbpsi_demux_subdec_t));
+  p_subdec = (dvbpsi_demux_subdec_t*)dvbpsi_malloc(sizeof(dvbpsi_demux_subdec_t));
   if (p_subdec == NULL)
   {
     return 1;
   }
 
-  p_eit_decoder = (dvbpsi_eit_decoder_t*)malloc(sizeof(dvbpsi_eit_decoder_t));
+  p_eit_decoder = (dvbpsi_eit_decoder_t*)dvbpsi_malloc(sizeof(dvbpsi_eit_decoder_t));
 
   if (p_eit_decoder == NULL)
   {
-    free(p_subdec);
+    dvbpsi_free(p_subdec);
     return 1;
   }
 
@@ -141,7 +141,7 @@ void dvbpsi_DetachEIT(dvbpsi_demux_t * p_demux, uint8_t i_table_id,
 
   p_eit_decoder = (dvbpsi_eit_decoder_t*)p_subdec->p_cb_data;
 
-  free(p_eit_decoder->p_building_eit);
+  dvbpsi_free(p_eit_decoder->p_building_eit);
 
   for (i = 0; i <= 255; i++)
   {
@@ -149,14 +149,14 @@ void dvbpsi_DetachEIT(dvbpsi_demux_t * p_demux, uint8_t i_table_id,
       dvbpsi_DeletePSISections(p_eit_decoder->ap_sections[i]);
   }
 
-  free(p_subdec->p_cb_data);
+  dvbpsi_free(p_subdec->p_cb_data);
 
   pp_prev_subdec = &p_demux->p_first_subdec;
   while (*pp_prev_subdec != p_subdec)
     pp_prev_subdec = &(*pp_prev_subdec)->p_next;
 
   *pp_prev_subdec = p_subdec->p_next;
-  free(p_subdec);
+  dvbpsi_free(p_subdec);
 }
 
 
@@ -194,7 +194,7 @@ void dvbpsi_EmptyEIT(dvbpsi_eit_t* p_eit)
   {
     dvbpsi_eit_event_t* p_tmp = p_event->p_next;
     dvbpsi_DeleteDescriptors(p_event->p_first_descriptor);
-    free(p_event);
+    dvbpsi_free(p_event);
     p_event = p_tmp;
   }
 
@@ -212,7 +212,7 @@ dvbpsi_eit_event_t* dvbpsi_EITAddEvent(dvbpsi_eit_t* p_eit,
     uint8_t i_running_status,int b_free_ca)
 {
   dvbpsi_eit_event_t* p_event
-                = (dvbpsi_eit_event_t*)malloc(sizeof(dvbpsi_eit_event_t));
+                = (dvbpsi_eit_event_t*)dvbpsi_malloc(sizeof(dvbpsi_eit_event_t));
 
   if (p_event)
   {
@@ -367,7 +367,7 @@ void dvbpsi_GatherEITSections(dvbpsi_decoder_t * p_psi_decoder,
     /* Free structures */
     if (p_eit_decoder->p_building_eit)
     {
-      free(p_eit_decoder->p_building_eit);
+      dvbpsi_free(p_eit_decoder->p_building_eit);
       p_eit_decoder->p_building_eit = NULL;
     }
     /* Clear the section array */
@@ -390,7 +390,7 @@ void dvbpsi_GatherEITSections(dvbpsi_decoder_t * p_psi_decoder,
     if (!p_eit_decoder->p_building_eit)
     {
       p_eit_decoder->p_building_eit =
-                                (dvbpsi_eit_t*)malloc(sizeof(dvbpsi_eit_t));
+                                (dvbpsi_eit_t*)dvbpsi_malloc(sizeof(dvbpsi_eit_t));
       dvbpsi_InitEIT(p_eit_decoder->p_building_eit,
                      p_section->i_extension,
                      p_section->i_version,
@@ -78,17 +78,17 @@ int dvbpsi_AttachNIT(dvbpsi_decoder_t * p_psi_decoder, uint8_t i_table_id,
     return 1;
   }
 
-  p_subdec = (dvbpsi_demux_subdec_t*)malloc(sizeof(dvbpsi_demux_subdec_t));
+  p_subdec = (dvbpsi_demux_subdec_t*)dvbpsi_malloc(sizeof(dvbpsi_demux_subdec_t));
   if (p_subdec == NULL)
   {
     return 1;
   }
 
-  p_nit_decoder = (dvbpsi_nit_decoder_t*)malloc(sizeof(dvbpsi_nit_decoder_t));
+  p_nit_decoder = (dvbpsi_nit_decoder_t*)dvbpsi_malloc(sizeof(dvbpsi_nit_decoder_t));
 
   if (p_nit_decoder == NULL)
   {
-    free(p_subdec);
+    dvbpsi_free(p_subdec);
     return 1;
   }
 
@@ -143,7 +143,7 @@ void dvbpsi_DetachNIT(dvbpsi_demux_t * p_demux, uint8_t i_table_id,
 
   p_nit_decoder = (dvbpsi_nit_decoder_t*)p_subdec->p_cb_data;
 
-  free(p_nit_decoder->p_building_nit);
+  dvbpsi_free(p_nit_decoder->p_building_nit);
 
   for (i = 0; i <= 255; i++)
   {
@@ -151,14 +151,14 @@ void dvbpsi_DetachNIT(dvbpsi_demux_t * p_demux, uint8_t i_table_id,
       dvbpsi_DeletePSISections(p_nit_decoder->ap_sections[i]);
   }
 
-  free(p_subdec->p_cb_data);
+  dvbpsi_free(p_subdec->p_cb_data);
 
   pp_prev_subdec = &p_demux->p_first_subdec;
   while (*pp_prev_subdec != p_subdec)
     pp_prev_subdec = &(*pp_prev_subdec)->p_next;
 
   *pp_prev_subdec = p_subdec->p_next;
-  free(p_subdec);
+  dvbpsi_free(p_subdec);
 }
 
 
@@ -193,7 +193,7 @@ void dvbpsi_EmptyNIT(dvbpsi_nit_t* p_nit)
   {
     dvbpsi_nit_ts_t* p_tmp = p_ts->p_next;
     dvbpsi_DeleteDescriptors(p_ts->p_first_descriptor);
-    free(p_ts);
+    dvbpsi_free(p_ts);
     p_ts = p_tmp;
   }
 
@@ -241,7 +241,7 @@ dvbpsi_descriptor_t* dvbpsi_NITAddDescriptor(dvbpsi_nit_t* p_nit,
 dvbpsi_nit_ts_t* dvbpsi_NITAddTS(dvbpsi_nit_t* p_nit,
                                  uint16_t i_ts_id, uint16_t i_orig_network_id)
 {
-  dvbpsi_nit_ts_t* p_ts = (dvbpsi_nit_ts_t*)malloc(sizeof(dvbpsi_nit_ts_t));
+  dvbpsi_nit_ts_t* p_ts = (dvbpsi_nit_ts_t*)dvbpsi_malloc(sizeof(dvbpsi_nit_ts_t));
 
   if (p_ts)
   {
@@ -400,7 +400,7 @@ void dvbpsi_GatherNITSections(dvbpsi_decoder_t * p_decoder,
     /* Free structures */
     if (p_nit_decoder->p_building_nit)
     {
-      free(p_nit_decoder->p_building_nit);
+      dvbpsi_free(p_nit_decoder->p_building_nit);
       p_nit_decoder->p_building_nit = NULL;
     }
     /* Clear the section array */
@@ -423,7 +423,7 @@ void dvbpsi_GatherNITSections(dvbpsi_decoder_t * p_decoder,
     if (!p_nit_decoder->p_building_nit)
     {
       p_nit_decoder->p_building_nit =
-                                (dvbpsi_nit_t*)malloc(sizeof(dvbpsi_nit_t));
+                                (dvbpsi_nit_t*)dvbpsi_malloc(sizeof(dvbpsi_nit_t));
       dvbpsi_InitNIT(p_nit_decoder->p_building_nit,
                      p_nit_decoder->i_network_id,
                      p_section->i_version,
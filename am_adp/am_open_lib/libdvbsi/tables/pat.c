@@ -56,18 +56,18 @@
 dvbpsi_handle dvbpsi_AttachPAT(dvbpsi_pat_callback pf_callback,
                                void* p_cb_data)
 {
-  dvbpsi_handle h_dvbpsi = (dvbpsi_decoder_t*)malloc(sizeof(dvbpsi_decoder_t));
+  dvbpsi_handle h_dvbpsi = (dvbpsi_decoder_t*)dvbpsi_malloc(sizeof(dvbpsi_decoder_t));
   dvbpsi_pat_decoder_t* p_pat_decoder;
   unsigned int i;
 
   if (h_dvbpsi == NULL)
     return NULL;
 
-  p_pat_decoder = (dvbpsi_pat_decoder_t*)malloc(sizeof(dvbpsi_pat_decoder_t));
+  p_pat_decoder = (dvbpsi_pat_decoder_t*)dvbpsi_malloc(sizeof(dvbpsi_pat_decoder_t));
 
   if (p_pat_decoder == NULL)
   {
-    free(h_dvbpsi);
+    dvbpsi_free(h_dvbpsi);
     return NULL;
   }
 
@@ -104,18 +104,18 @@ void dvbpsi_DetachPAT(dvbpsi_handle h_dvbpsi)
                         = (dvbpsi_pat_decoder_t*)h_dvbpsi->p_private_decoder;
   unsigned int i;
 
-  free(p_pat_decoder->p_building_pat);
+  dvbpsi_free(p_pat_decoder->p_building_pat);
 
   for (i = 0; i <= 255; i++)
   {
     if (p_pat_decoder->ap_sections[i])
-      free(p_pat_decoder->ap_sections[i]);
+      dvbpsi_free(p_pat_decoder->ap_sections[i]);
   }
 
-  free(h_dvbpsi->p_private_decoder);
+  dvbpsi_free(h_dvbpsi->p_private_decoder);
   if (h_dvbpsi->p_current_section)
     dvbpsi_DeletePSISections(h_dvbpsi->p_current_section);
-  free(h_dvbpsi);
+  dvbpsi_free(h_dvbpsi);
 }
 
 
@@ -147,7 +147,7 @@ void dvbpsi_EmptyPAT(dvbpsi_pat_t* p_pat)
   while (p_program != NULL)
   {
     dvbpsi_pat_program_t* p_tmp = p_program->p_next;
-    free(p_program);
+    dvbpsi_free(p_program);
     p_program = p_tmp;
   }
 
@@ -164,7 +164,7 @@ dvbpsi_pat_program_t* dvbpsi_PATAddProgram(dvbpsi_pat_t* p_pat,
                                            uint16_t i_number, uint16_t i_pid)
 {
   dvbpsi_pat_program_t* p_program
-                = (dvbpsi_pat_program_t*)malloc(sizeof(dvbpsi_pat_program_t));
+                = (dvbpsi_pat_program_t*)dvbpsi_malloc(sizeof(dvbpsi_pat_program_t));
 
   if (p_program)
   {
@@ -290,7 +290,7 @@ void dvbpsi_GatherPATSections(dvbpsi_decoder_t* p_decoder,
     /* Free structures */
     if (p_pat_decoder->p_building_pat)
     {
-      free(p_pat_decoder->p_building_pat);
+      dvbpsi_free(p_pat_decoder->p_building_pat);
       p_pat_decoder->p_building_pat = NULL;
     }
     /* Clear the section array */
@@ -313,7 +313,7 @@ void dvbpsi_GatherPATSections(dvbpsi_decoder_t* p_decoder,
     if (!p_pat_decoder->p_building_pat)
     {
       p_pat_decoder->p_building_pat =
-                                (dvbpsi_pat_t*)malloc(sizeof(dvbpsi_pat_t));
+                                (dvbpsi_pat_t*)dvbpsi_malloc(sizeof(dvbpsi_pat_t));
       dvbpsi_InitPAT(p_pat_decoder->p_building_pat,
                      p_section->i_extension,
                      p_section->i_version,
@@ -60,18 +60,18 @@ dvbpsi_handle dvbpsi_AttachPMT(uint16_t i_program_number,
                                dvbpsi_pmt_callback pf_callback,
                                void* p_cb_data)
 {
-  dvbpsi_handle h_dvbpsi = (dvbpsi_decoder_t*)malloc(sizeof(dvbpsi_decoder_t));
+  dvbpsi_handle h_dvbpsi = (dvbpsi_decoder_t*)dvbpsi_malloc(sizeof(dvbpsi_decoder_t));
   dvbpsi_pmt_decoder_t* p_pmt_decoder;
   unsigned int i;
 
   if (h_dvbpsi == NULL)
     return NULL;
 
-  p_pmt_decoder = (dvbpsi_pmt_decoder_t*)malloc(sizeof(dvbpsi_pmt_decoder_t));
+  p_pmt_decoder = (dvbpsi_pmt_decoder_t*)dvbpsi_malloc(sizeof(dvbpsi_pmt_decoder_t));
 
   if (p_pmt_decoder == NULL)
   {
-    free(h_dvbpsi);
+    dvbpsi_free(h_dvbpsi);
     return NULL;
   }
 
@@ -109,18 +109,18 @@ void dvbpsi_DetachPMT(dvbpsi_handle h_dvbpsi)
                         = (dvbpsi_pmt_decoder_t*)h_dvbpsi->p_private_decoder;
   unsigned int i;
 
-  free(p_pmt_decoder->p_building_pmt);
+  dvbpsi_free(p_pmt_decoder->p_building_pmt);
 
   for (i = 0; i <= 255; i++)
   {
     if (p_pmt_decoder->ap_sections[i])
-      free(p_pmt_decoder->ap_sections[i]);
+      dvbpsi_free(p_pmt_decoder->ap_sections[i]);
   }
 
-  free(h_dvbpsi->p_private_decoder);
+  dvbpsi_free(h_dvbpsi->p_private_decoder);
   if (h_dvbpsi->p_current_section)
     dvbpsi_DeletePSISections(h_dvbpsi->p_current_section);
-  free(h_dvbpsi);
+  dvbpsi_free(h_dvbpsi);
 }
 
 
@@ -156,7 +156,7 @@ void dvbpsi_EmptyPMT(dvbpsi_pmt_t* p_pmt)
   {
     dvbpsi_pmt_es_t* p_tmp = p_es->p_next;
     dvbpsi_DeleteDescriptors(p_es->p_first_descriptor);
-    free(p_es);
+    dvbpsi_free(p_es);
     p_es = p_tmp;
   }
 
@@ -204,7 +204,7 @@ dvbpsi_descriptor_t* dvbpsi_PMTAddDescriptor(dvbpsi_pmt_t* p_pmt,
 dvbpsi_pmt_es_t* dvbpsi_PMTAddES(dvbpsi_pmt_t* p_pmt,
                                  uint8_t i_type, uint16_t i_pid)
 {
-  dvbpsi_pmt_es_t* p_es = (dvbpsi_pmt_es_t*)malloc(sizeof(dvbpsi_pmt_es_t));
+  dvbpsi_pmt_es_t* p_es = (dvbpsi_pmt_es_t*)dvbpsi_malloc(sizeof(dvbpsi_pmt_es_t));
 
   if (p_es)
   {
@@ -363,7 +363,7 @@ void dvbpsi_GatherPMTSections(dvbpsi_decoder_t* p_decoder,
     /* Free structures */
     if (p_pmt_decoder->p_building_pmt)
     {
-      free(p_pmt_decoder->p_building_pmt);
+      dvbpsi_free(p_pmt_decoder->p_building_pmt);
       p_pmt_decoder->p_building_pmt = NULL;
     }
     /* Clear the section array */
@@ -386,7 +386,7 @@ void dvbpsi_GatherPMTSections(dvbpsi_decoder_t* p_decoder,
     if (!p_pmt_decoder->p_building_pmt)
     {
       p_pmt_decoder->p_building_pmt =
-                                (dvbpsi_pmt_t*)malloc(sizeof(dvbpsi_pmt_t));
+                                (dvbpsi_pmt_t*)dvbpsi_malloc(sizeof(dvbpsi_pmt_t));
       dvbpsi_InitPMT(p_pmt_decoder->p_building_pmt,
                      p_pmt_decoder->i_program_number,
                      p_section->i_version,
@@ -76,17 +76,17 @@ int dvbpsi_AttachSDT(dvbpsi_decoder_t * p_psi_decoder, uint8_t i_table_id,
     return 1;
   }
 
-  p_subdec = (dvbpsi_demux_subdec_t*)malloc(sizeof(dvbpsi_demux_subdec_t));
+  p_subdec = (dvbpsi_demux_subdec_t*)dvbpsi_malloc(sizeof(dvbpsi_demux_subdec_t));
   if (p_subdec == NULL)
   {
     return 1;
   }
 
-  p_sdt_decoder = (dvbpsi_sdt_decoder_t*)malloc(sizeof(dvbpsi_sdt_decoder_t));
+  p_sdt_decoder = (dvbpsi_sdt_decoder_t*)dvbpsi_malloc(sizeof(dvbpsi_sdt_decoder_t));
 
   if (p_sdt_decoder == NULL)
   {
-    free(p_subdec);
+    dvbpsi_free(p_subdec);
     return 1;
   }
 
@@ -140,7 +140,7 @@ void dvbpsi_DetachSDT(dvbpsi_demux_t * p_demux, uint8_t i_table_id,
 
   p_sdt_decoder = (dvbpsi_sdt_decoder_t*)p_subdec->p_cb_data;
 
-  free(p_sdt_decoder->p_building_sdt);
+  dvbpsi_free(p_sdt_decoder->p_building_sdt);
 
   for (i = 0; i <= 255; i++)
   {
@@ -148,14 +148,14 @@ void dvbpsi_DetachSDT(dvbpsi_demux_t * p_demux, uint8_t i_table_id,
       dvbpsi_DeletePSISections(p_sdt_decoder->ap_sections[i]);
   }
 
-  free(p_subdec->p_cb_data);
+  dvbpsi_free(p_subdec->p_cb_data);
 
   pp_prev_subdec = &p_demux->p_first_subdec;
   while (*pp_prev_subdec != p_subdec)
     pp_prev_subdec = &(*pp_prev_subdec)->p_next;
 
   *pp_prev_subdec = p_subdec->p_next;
-  free(p_subdec);
+  dvbpsi_free(p_subdec);
 }
 
 
@@ -188,7 +188,7 @@ void dvbpsi_EmptySDT(dvbpsi_sdt_t* p_sdt)
   {
     dvbpsi_sdt_service_t* p_tmp = p_service->p_next;
     dvbpsi_DeleteDescriptors(p_service->p_first_descriptor);
-    free(p_service);
+    dvbpsi_free(p_service);
     p_service = p_tmp;
   }
 
@@ -209,7 +209,7 @@ dvbpsi_sdt_service_t *dvbpsi_SDTAddService(dvbpsi_sdt_t* p_sdt,
                                            int b_free_ca)
 {
   dvbpsi_sdt_service_t * p_service
-                = (dvbpsi_sdt_service_t*)malloc(sizeof(dvbpsi_sdt_service_t));
+                = (dvbpsi_sdt_service_t*)dvbpsi_malloc(sizeof(dvbpsi_sdt_service_t));
 
   if (p_service)
   {
@@ -364,7 +364,7 @@ void dvbpsi_GatherSDTSections(dvbpsi_decoder_t * p_psi_decoder,
     /* Free structures */
     if (p_sdt_decoder->p_building_sdt)
     {
-      free(p_sdt_decoder->p_building_sdt);
+      dvbpsi_free(p_sdt_decoder->p_building_sdt);
       p_sdt_decoder->p_building_sdt = NULL;
     }
     /* Clear the section array */
@@ -387,7 +387,7 @@ void dvbpsi_GatherSDTSections(dvbpsi_decoder_t * p_psi_decoder,
     if (!p_sdt_decoder->p_building_sdt)
     {
       p_sdt_decoder->p_building_sdt =
-                                (dvbpsi_sdt_t*)malloc(sizeof(dvbpsi_sdt_t));
+                                (dvbpsi_sdt_t*)dvbpsi_malloc(sizeof(dvbpsi_sdt_t));
       dvbpsi_InitSDT(p_sdt_decoder->p_building_sdt,
                      p_section->i_extension,
                      p_section->i_version,
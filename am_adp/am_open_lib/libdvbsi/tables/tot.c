@@ -43,6 +43,7 @@
 #include <stdint.h>
 #endif
 
+#include <am_crc.h>
 #include "../dvbpsi.h"
 #include "../dvbpsi_private.h"
 #include "../psi.h"
@@ -77,17 +78,17 @@ int dvbpsi_AttachTOT(dvbpsi_decoder_t * p_psi_decoder, uint8_t i_table_id,
     return 1;
   }
 
-  p_subdec = (dvbpsi_demux_subdec_t*)malloc(sizeof(dvbpsi_demux_subdec_t));
+  p_subdec = (dvbpsi_demux_subdec_t*)dvbpsi_malloc(sizeof(dvbpsi_demux_subdec_t));
   if (p_subdec == NULL)
   {
     return 1;
   }
 
-  p_tot_decoder = (dvbpsi_tot_decoder_t*)malloc(sizeof(dvbpsi_tot_decoder_t));
+  p_tot_decoder = (dvbpsi_tot_decoder_t*)dvbpsi_malloc(sizeof(dvbpsi_tot_decoder_t));
 
   if (p_tot_decoder == NULL)
   {
-    free(p_subdec);
+    dvbpsi_free(p_subdec);
     return 1;
   }
 
@@ -130,14 +131,14 @@ void dvbpsi_DetachTOT(dvbpsi_demux_t * p_demux, uint8_t i_table_id,
     return;
   }
 
-  free(p_subdec->p_cb_data);
+  dvbpsi_free(p_subdec->p_cb_data);
 
   pp_prev_subdec = &p_demux->p_first_subdec;
   while (*pp_prev_subdec != p_subdec)
     pp_prev_subdec = &(*pp_prev_subdec)->p_next;
 
   *pp_prev_subdec = p_subdec->p_next;
-  free(p_subdec);
+  dvbpsi_free(p_subdec);
 }
 
 
@@ -242,7 +243,7 @@ void dvbpsi_GatherTOTSections(dvbpsi_decoder_t* p_decoder,
       p_decoder->b_discontinuity = 0;
     }
 
-    p_building_tot = (dvbpsi_tot_t*)malloc(sizeof(dvbpsi_tot_t));
+    p_building_tot = (dvbpsi_tot_t*)dvbpsi_malloc(sizeof(dvbpsi_tot_t));
     dvbpsi_InitTOT(p_building_tot,   ((uint64_t)p_section->p_payload_start[0] << 32)
                                    | ((uint64_t)p_section->p_payload_start[1] << 24)
                                    | ((uint64_t)p_section->p_payload_start[2] << 16)
@@ -273,14 +274,8 @@ int dvbpsi_ValidTOTSection(dvbpsi_psi_section_t* p_section)
   if (p_section->i_table_id == 0x73)
   {
     /* Check the CRC_32 if it's a TOT */
-    uint32_t i_crc = 0xffffffff;
-    uint8_t* p_byte = p_section->p_data;
-
-    while (p_byte < p_section->p_payload_end)
-    {
-      i_crc = (i_crc << 8) ^ dvbpsi_crc32_table[(i_crc >> 24) ^ (*p_byte)];
-      p_byte++;
-    }
+    uint32_t i_crc = AM_CRC32_Calc(AM_CRC32_INIT, p_section->p_data,
+                                   p_section->p_payload_end - p_section->p_data);
 
     if (i_crc == 0)
     {
@@ -435,16 +430,10 @@ dvbpsi_psi_section_t* dvbpsi_GenTOTSections(dvbpsi_tot_t* p_tot)
   dvbpsi_BuildPSISection(p_result);
 
   if (p_result->i_table_id == 0x73) {
-    uint8_t* p_byte = p_result->p_data;
+    uint8_t* p_byte = p_result->p_payload_end - 4;
 
-    p_tot->i_crc = 0xffffffff;
-
-    while (p_byte < p_result->p_payload_end - 4)
-    {
-      p_tot->i_crc =   (p_tot->i_crc << 8)
-                     ^ dvbpsi_crc32_table[(p_tot->i_crc >> 24) ^ (*p_byte)];
-      p_byte++;
-    }
+    p_tot->i_crc = AM_CRC32_Calc(AM_CRC32_INIT, p_result->p_data,
+                                 p_byte - p_result->p_data);
 
     p_byte[0] = (p_tot->i_crc >> 24) & 0xff;
     p_byte[1] = (p_tot->i_crc >> 16) & 0xff;
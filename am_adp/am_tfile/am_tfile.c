@@ -22,10 +22,14 @@
 
 #include <unistd.h>
 //#include <sys/types.h>
-#ifdef SUPPORT_CAS
 #include <limits.h>
+#ifdef SUPPORT_CAS
 #include <byteswap.h>
 #endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <am_types.h>
@@ -48,15 +52,29 @@
 /****************************************************************************
  * Macro definitions
  ***************************************************************************/
+/*fragments preallocated for the timer, the array grows if more are needed*/
+#define TFILE_TIMER_MIN_FRAGS	(64)
+#define TFILE_TIMER_MAX_FRAGS	(4*3600)
+
+#if defined(SYS_futex) && defined(FUTEX_WAIT_PRIVATE)
+#define TFILE_USE_FUTEX
+#endif
+
+/*poll interval of the readers without futex, and of the close waiting for the readers*/
+#define TFILE_POLL_MS	(10)
+
 typedef struct {
-	struct list_head head;
 	int time;
 	loff_t start;
 	loff_t end;
 } tfragment_t;
 
+/*1s fragments in a circular array, sorted by time*/
 typedef struct {
-	struct list_head list;
+	tfragment_t *frags;
+	int cap;
+	int head;	/*index of the earliest fragment*/
+	int count;
 	int wrap;
 	int now;
 	int wstart;
@@ -64,6 +82,8 @@ typedef struct {
 	AM_TFile_t file;
 } tfile_timer_t;
 
+#define timer_frag(_ptimer_, _i_) (&(_ptimer_)->frags[((_ptimer_)->head + (_i_)) % (_ptimer_)->cap])
+
 #ifdef SUPPORT_CAS
 typedef struct
 {
@@ -89,13 +109,48 @@ static CAS_RecInfo_t cas_rec_info = {
  * Static functions
  ***************************************************************************/
 
+//file offset of a stream position
+static AM_INLINE loff_t tfile_offset(AM_TFile_t tfile, loff_t pos)
+{
+	return tfile->loop ? pos % __atomic_load_n(&tfile->size, __ATOMIC_ACQUIRE) : pos;
+}
+
+//wait until wseq is changed from seq, timeout in ms, <0 means forever
+static void tfile_wait(AM_TFile_t tfile, uint32_t seq, int timeout)
+{
+#ifdef TFILE_USE_FUTEX
+	struct timespec ts;
+
+	ts.tv_sec = timeout / 1000;
+	ts.tv_nsec = (timeout % 1000) * 1000000;
+
+	__atomic_add_fetch(&tfile->waiters, 1, __ATOMIC_SEQ_CST);
+	syscall(SYS_futex, &tfile->wseq, FUTEX_WAIT_PRIVATE, seq, (timeout < 0) ? NULL : &ts, NULL, 0);
+	__atomic_sub_fetch(&tfile->waiters, 1, __ATOMIC_SEQ_CST);
+#else
+	UNUSED(seq);
+	usleep(((timeout < 0) ? TFILE_POLL_MS : AM_MIN(timeout, TFILE_POLL_MS)) * 1000);
+#endif
+}
+
+//publish the new positions and wake up the readers
+static void tfile_wake(AM_TFile_t tfile)
+{
+	__atomic_add_fetch(&tfile->wseq, 1, __ATOMIC_SEQ_CST);
+#ifdef TFILE_USE_FUTEX
+	/*no syscall if nobody waits, a reader going to wait sees the new wseq*/
+	if (__atomic_load_n(&tfile->waiters, __ATOMIC_SEQ_CST))
+		syscall(SYS_futex, &tfile->wseq, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#endif
+}
+
 static int timer_get_total(void *timer)
 {
 	if (!timer)
 		return 0;
 	tfile_timer_t *ptimer = (tfile_timer_t*)timer;
-	tfragment_t *pfirst = list_first_entry(&ptimer->list, tfragment_t, head);
-	tfragment_t *plast = list_entry(ptimer->list.prev, tfragment_t, head);
+	tfragment_t *pfirst = timer_frag(ptimer, 0);
+	tfragment_t *plast = timer_frag(ptimer, ptimer->count - 1);
 
 	AM_DEBUG(3, "[tfile] total [%d, %d - %d]ms [%lld - %lld]B",
 		plast->time - pfirst->time, pfirst->time, plast->time,
@@ -104,6 +159,75 @@ static int timer_get_total(void *timer)
 	return plast->time - pfirst->time;
 }
 
+//last fragment with time <= time_ms, or the first one
+static int timer_find_time(tfile_timer_t *ptimer, int time_ms)
+{
+	int lo = 0, hi = ptimer->count - 1, mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo + 1) / 2;
+		if (timer_frag(ptimer, mid)->time <= time_ms)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	return lo;
+}
+
+//last fragment in [lo, hi] with start <= offset, or -1
+static int timer_find_offset(tfile_timer_t *ptimer, int lo, int hi, loff_t offset)
+{
+	int mid, found = -1;
+
+	while (lo <= hi) {
+		mid = lo + (hi - lo) / 2;
+		if (timer_frag(ptimer, mid)->start <= offset) {
+			found = mid;
+			lo = mid + 1;
+		} else {
+			hi = mid - 1;
+		}
+	}
+	return found;
+}
+
+//first fragment written after the file wrapped, or count
+static int timer_find_wrap(tfile_timer_t *ptimer)
+{
+	loff_t first = timer_frag(ptimer, 0)->start;
+	int lo = 1, hi = ptimer->count, mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (timer_frag(ptimer, mid)->start < first)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	return lo;
+}
+
+//append a fragment, called with the lock held
+static tfragment_t *timer_append_fragment(tfile_timer_t *ptimer)
+{
+	if (ptimer->count == ptimer->cap) {
+		int i, cap = ptimer->cap * 2;
+		tfragment_t *frags = malloc(sizeof(tfragment_t) * cap);
+
+		if (!frags)
+			return NULL;
+		for (i = 0; i < ptimer->count; i++)
+			frags[i] = *timer_frag(ptimer, i);
+		free(ptimer->frags);
+		ptimer->frags = frags;
+		ptimer->cap = cap;
+		ptimer->head = 0;
+		AM_DEBUG(3, "[tfile] fragments grow to %d", cap);
+	}
+
+	return timer_frag(ptimer, ptimer->count++);
+}
+
 static int timer_try_add_fragment(void *timer, loff_t pre_end, loff_t offset, int force)
 {
 	tfile_timer_t *ptimer = (tfile_timer_t*)timer;
@@ -119,14 +243,14 @@ static int timer_try_add_fragment(void *timer, loff_t pre_end, loff_t offset, in
 
 	ptimer->last = ptimer->now;
 
-	AM_EVT_Signal((long )ptimer->file, AM_TFILE_EVT_END_TIME_CHANGED, (void*)(long)ptimer->now);
+	pthread_mutex_lock(&ptimer->file->lock);
 
-	if (!list_empty(&ptimer->list)) {
-		plast = list_entry(ptimer->list.prev, tfragment_t, head);
-	}
+	if (ptimer->count)
+		plast = timer_frag(ptimer, ptimer->count - 1);
 
 	if (plast && (plast->start == offset)) {
 		/*write fail? fragment too large? should not get here!!*/
+		pthread_mutex_unlock(&ptimer->file->lock);
 		AM_DEBUG(0, "[tfile] FATAL ERROR");
 		return 0;
 	}
@@ -134,17 +258,25 @@ static int timer_try_add_fragment(void *timer, loff_t pre_end, loff_t offset, in
 	if (plast)
 		plast->end = pre_end;
 
-	pnow = malloc(sizeof(tfragment_t));
-	memset(pnow, 0, sizeof(tfragment_t));
+	pnow = timer_append_fragment(ptimer);
+	if (!pnow) {
+		pthread_mutex_unlock(&ptimer->file->lock);
+		AM_DEBUG(0, "[tfile] no mem for fragment");
+		return -1;
+	}
 
 	pnow->time = ptimer->now;
 	pnow->start = offset;
 	pnow->end = 0;
 
-	list_add_tail(&pnow->head, &ptimer->list);
+	__atomic_store_n(&ptimer->file->end_time, pnow->time, __ATOMIC_RELEASE);
+
+	pthread_mutex_unlock(&ptimer->file->lock);
+
+	AM_EVT_Signal((long )ptimer->file, AM_TFILE_EVT_END_TIME_CHANGED, (void*)(long)ptimer->now);
 
-	AM_DEBUG(3, "[tfile] add fragment %p[time:%d start:%lld] force[%d]",
-		pnow, pnow->time, pnow->start, force);
+	AM_DEBUG(3, "[tfile] add fragment [time:%d start:%lld] force[%d]",
+		ptimer->now, (long long)offset, force);
 
 	return 0;
 }
@@ -154,71 +286,79 @@ static int timer_try_add_fragment_continuous(void *timer, loff_t offset, int for
 	return timer_try_add_fragment(timer, offset, offset, force);
 }
 
-//remove earliest fragment, return removed size and next fragment's start
-static loff_t timer_remove_earliest_fragment(void *timer, loff_t *next)
+//remove earliest fragment, return next fragment's start
+//called with the lock held
+static loff_t timer_remove_earliest_fragment(void *timer)
 {
 	tfile_timer_t *ptimer = (tfile_timer_t*)timer;
-	loff_t size = 0;
+	tfragment_t *pfirst, *pnext;
 
-	if (!list_empty(&ptimer->list))
+	if (ptimer->count <= 1)
 	{
-		tfragment_t *pfirst, *pnext;
+		/*the only fragment is overwritten, restart it at the write position*/
+		loff_t write = tfile_offset(ptimer->file, ptimer->file->wpos);
 
-		pfirst = list_first_entry(&ptimer->list, tfragment_t, head);
-		list_del(&pfirst->head);
-		pnext = list_first_entry(&ptimer->list, tfragment_t, head);
+		if (ptimer->count) {
+			pfirst = timer_frag(ptimer, 0);
+			pfirst->start = write;
+		}
+		return write;
+	}
 
-		if (next)
-			*next = pnext->start;
+	pfirst = timer_frag(ptimer, 0);
 
-		size = (pfirst->end >= pfirst->start) ? (pfirst->end - pfirst->start) : (ptimer->file->size - pfirst->start);
+	AM_DEBUG(3, "[tfile] del fragment [time:%d start:%lld end:%lld]",
+		pfirst->time, (long long)pfirst->start, (long long)pfirst->end);
 
-		AM_DEBUG(3, "[tfile] del fragment %p[time:%d start:%lld end:%lld size:%lld]",
-			pfirst, pfirst->time, pfirst->start, pfirst->end, size);
+	ptimer->head = (ptimer->head + 1) % ptimer->cap;
+	ptimer->count--;
 
-		free(pfirst);
+	pnext = timer_frag(ptimer, 0);
 
-		ptimer->wrap = 1;
-		AM_EVT_Signal((long)ptimer->file, AM_TFILE_EVT_START_TIME_CHANGED, (void *)(long)pnext->time);
+	ptimer->wrap = 1;
+	__atomic_store_n(&ptimer->file->start_time, pnext->time, __ATOMIC_RELEASE);
+	AM_EVT_Signal((long)ptimer->file, AM_TFILE_EVT_START_TIME_CHANGED, (void *)(long)pnext->time);
 
-	}
-	return size;
+	return pnext->start;
 }
 
 static int aml_tfile_attach_timer(AM_TFile_t tfile)
 {
 	tfile_timer_t *timer = malloc(sizeof(tfile_timer_t));
-	tfragment_t *frag = malloc(sizeof(tfragment_t));
+	int cap = AM_MIN(AM_MAX(tfile->duration, 0), TFILE_TIMER_MAX_FRAGS) + TFILE_TIMER_MIN_FRAGS;
+	tfragment_t *frags = malloc(sizeof(tfragment_t) * cap);
 	int err = 0;
 
-	if (!timer || !frag) {
+	if (!timer || !frags) {
 		AM_DEBUG(0, "[tfile] FATAL: no mem for tfile");
 		err = -1;
 		goto end;
 	}
 
 	memset(timer, 0, sizeof(tfile_timer_t));
-	INIT_LIST_HEAD(&timer->list);
-
-	memset(frag, 0, sizeof(tfragment_t));
+	timer->frags = frags;
+	timer->cap = cap;
 
 	pthread_mutex_lock(&tfile->lock);
 	if (!tfile->timer) {
 		AM_TIME_GetClock(&timer->wstart);
 		timer->now = timer->last = 0;
 
-		frag->time = 0;
-		frag->end = 0;
-		frag->start = tfile->write;
-		list_add_tail(&frag->head, &timer->list);
+		frags[0].time = 0;
+		frags[0].end = 0;
+		frags[0].start = tfile_offset(tfile, __atomic_load_n(&tfile->wpos, __ATOMIC_ACQUIRE));
+		timer->head = 0;
+		timer->count = 1;
 
-		AM_DEBUG(3, "[tfile] add fragment %p[time:%d start:%lld]",
-				frag, frag->time, frag->start);
+		AM_DEBUG(3, "[tfile] add fragment [time:%d start:%lld], %d preallocated",
+				frags[0].time, (long long)frags[0].start, cap);
 
 		timer->file = tfile;
 		timer->wrap = 0;
 
-		tfile->timer = timer;
+		__atomic_store_n(&tfile->start_time, 0, __ATOMIC_RELEASE);
+		__atomic_store_n(&tfile->end_time, 0, __ATOMIC_RELEASE);
+		__atomic_store_n(&tfile->timer, timer, __ATOMIC_RELEASE);
 	} else {
 		err = 1;
 	}
@@ -230,8 +370,8 @@ end:
 	if (err) {
 		if (timer)
 			free(timer);
-		if (frag)
-			free(frag);
+		if (frags)
+			free(frags);
 	}
 	return (err < 0) ? err : 0;
 }
@@ -239,21 +379,18 @@ end:
 static int aml_tfile_detach_timer(AM_TFile_t tfile)
 {
 	tfile_timer_t *timer = NULL;
-	struct list_head *pos = NULL, *n = NULL;
 
 	if (!tfile->timer)
 		return 0;
 
 	pthread_mutex_lock(&tfile->lock);
 	timer = tfile->timer;
-	tfile->timer = NULL;
+	__atomic_store_n(&tfile->timer, NULL, __ATOMIC_RELEASE);
+	__atomic_store_n(&tfile->start_time, 0, __ATOMIC_RELEASE);
+	__atomic_store_n(&tfile->end_time, 0, __ATOMIC_RELEASE);
 	pthread_mutex_unlock(&tfile->lock);
 
-	list_for_each_safe(pos, n, &timer->list)
-	{
-		list_del(pos);
-		free(list_entry(pos, tfragment_t, head));
-	}
+	free(timer->frags);
 	free(timer);
 	return 0;
 }
@@ -439,10 +576,17 @@ static ssize_t aml_timeshift_subfile_write(AM_TFile_t tfile, uint8_t *buf, size_
 		}
 		else
 		{
-			AM_TFile_Sub_t *sub_file = aml_timeshift_new_subfile(tfile);
+			AM_TFile_Sub_t *sub_file;
+
+			/*the reader walks the list without the lock*/
+			pthread_mutex_lock(&tfile->lock);
+			sub_file = aml_timeshift_new_subfile(tfile);
+			if (sub_file != NULL)
+				__atomic_store_n(&tfile->cur_wsub_file->next, sub_file, __ATOMIC_RELEASE);
+			pthread_mutex_unlock(&tfile->lock);
+
 			if (sub_file != NULL)
 			{
-				tfile->cur_wsub_file->next = sub_file;
 				tfile->cur_wsub_file = sub_file;
 				start_new = AM_TRUE;
 			}
@@ -458,12 +602,110 @@ static ssize_t aml_timeshift_subfile_write(AM_TFile_t tfile, uint8_t *buf, size_
 	}
 	else
 	{
-		ret = aml_timeshift_data_write(tfile->cur_wsub_file->wfd, buf, size, err);
+		/*do not cross the sub file end, the reader maps offsets to sub files by the size*/
+		size_t len = AM_MIN((loff_t)size, tfile->sub_file_size - fsize);
+
+		ret = aml_timeshift_data_write(tfile->cur_wsub_file->wfd, buf, len, err);
+		if ((ret == (ssize_t)len) && (len < size))
+		{
+			ssize_t ret2 = aml_timeshift_subfile_write(tfile, buf + len, size - len, err);
+			if (ret2 > 0)
+				ret += ret2;
+		}
 	}
 
 	return ret;
 }
 
+//read the data at a file offset, not changing the sub files' read position
+static ssize_t aml_timeshift_subfile_pread(AM_TFile_t tfile, uint8_t *buf, size_t size, loff_t offset)
+{
+	int sub_index = offset/tfile->sub_file_size;
+	loff_t sub_offset = offset%tfile->sub_file_size;
+	AM_TFile_Sub_t *sub_file = tfile->sub_files;
+	size_t done = 0;
+
+	while (sub_file != NULL && sub_file->findex != sub_index)
+		sub_file = __atomic_load_n(&sub_file->next, __ATOMIC_ACQUIRE);
+
+	while (sub_file != NULL && done < size)
+	{
+		size_t len = AM_MIN((loff_t)(size - done), tfile->sub_file_size - sub_offset);
+		ssize_t ret = pread64(sub_file->rfd, buf + done, len, sub_offset);
+
+		if (ret < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			AM_DEBUG(0, "[tfile] read data failed: %s", strerror(errno));
+			return done ? (ssize_t)done : -1;
+		}
+
+		done += ret;
+		if ((size_t)ret != len)
+			break;
+
+		sub_offset = 0;
+		sub_file = __atomic_load_n(&sub_file->next, __ATOMIC_ACQUIRE);
+	}
+
+	return done;
+}
+
+//read the data at a stream position in loop mode, wrap at the end of the file
+static ssize_t aml_timeshift_ring_read(AM_TFile_t tfile, uint8_t *buf, size_t size, loff_t pos)
+{
+	loff_t fsize = __atomic_load_n(&tfile->size, __ATOMIC_ACQUIRE);
+	loff_t offset = pos % fsize;
+	size_t len = AM_MIN((loff_t)size, fsize - offset);
+	ssize_t ret, ret2;
+
+	ret = aml_timeshift_subfile_pread(tfile, buf, len, offset);
+	if ((ret == (ssize_t)len) && (len < size))
+	{
+		ret2 = aml_timeshift_subfile_pread(tfile, buf + len, size - len, 0);
+		if (ret2 > 0)
+			ret += ret2;
+	}
+
+	return ret;
+}
+
+//stream position of a file offset written in loop mode, in (wpos-size, wpos]
+//called by the writer
+static loff_t aml_timeshift_ring_pos(AM_TFile_t tfile, loff_t offset)
+{
+	loff_t wpos = tfile->wpos;
+
+	return wpos - (wpos % tfile->size - offset + tfile->size) % tfile->size;
+}
+
+//move the start position to pos at least before the data there is overwritten,
+//so the reader can find out the data it read has been changed
+//called by the writer
+static void aml_timeshift_ring_drop(AM_TFile_t tfile, loff_t pos)
+{
+	loff_t spos = tfile->spos;
+
+	if (pos <= spos)
+		return;
+
+	pthread_mutex_lock(&tfile->lock);
+	if (tfile->timer) {
+		/*the start is always at a fragment*/
+		while (spos < pos)
+			spos = aml_timeshift_ring_pos(tfile, timer_remove_earliest_fragment(tfile->timer));
+		timer_get_total(tfile->timer);
+	} else {
+		spos = pos;
+	}
+	__atomic_store_n(&tfile->spos, spos, __ATOMIC_SEQ_CST);
+	pthread_mutex_unlock(&tfile->lock);
+
+	AM_DEBUG(3, "[tfile] drop to %lld, s:%lld w:%lld",
+		(long long)pos, (long long)spos, (long long)tfile->wpos);
+}
+
 static int aml_timeshift_subfile_close(AM_TFile_t tfile)
 {
 	AM_TFile_Sub_t *sub_file, *next;
@@ -596,24 +838,21 @@ AM_ErrorCode_t AM_TFile_Open(AM_TFile_t *tfile, const char *file_name, AM_Bool_t
 		if (aml_timeshift_subfile_open(pfile) < 0)
 			return AM_FAILURE;
 
-		pfile->avail = 0;
-		pfile->total = 0;
+		pfile->wpos = 0;
 	}
 	else
 	{
 		if (aml_timeshift_subfile_open(pfile) < 0)
 			return AM_FAILURE;
 
-		pfile->avail = pfile->size;
-		pfile->total = pfile->size;
+		pfile->wpos = pfile->size;
 		AM_DEBUG(1, "[tfile] total subfiles size %lld", pfile->size);
 	}
 
-	pfile->start = 0;
-	pfile->read = pfile->write = 0;
+	pfile->spos = 0;
+	pfile->rpos = 0;
 
 	pthread_mutex_init(&pfile->lock, NULL);
-	pthread_cond_init(&pfile->cond, NULL);
 
 	pfile->opened = 1;
 
@@ -629,7 +868,15 @@ AM_ErrorCode_t AM_TFile_Close(AM_TFile_t tfile)
 		return AM_FAILURE;
 	}
 
-	tfile->opened = 0;
+	__atomic_store_n(&tfile->opened, 0, __ATOMIC_SEQ_CST);
+	tfile_wake(tfile);
+
+	/*the readers use the sub files without the lock, wait for them to leave*/
+	while (__atomic_load_n(&tfile->readers, __ATOMIC_SEQ_CST))
+	{
+		tfile_wake(tfile);
+		usleep(TFILE_POLL_MS * 1000);
+	}
 
 	pthread_mutex_lock(&tfile->lock);
 	aml_timeshift_subfile_close(tfile);
@@ -864,84 +1111,98 @@ AM_ErrorCode_t AM_TFile_CasDump()
 }
 #endif
 
-ssize_t AM_TFile_Read(AM_TFile_t tfile, uint8_t *buf, size_t size, int timeout)
+static ssize_t tfile_read(AM_TFile_t tfile, uint8_t *buf, size_t size, int timeout)
 {
 	ssize_t ret = -1;
-	size_t todo, split;
-	struct timespec rt;
-
-	if (! tfile->opened)
-	{
-		AM_DEBUG(0, "[tfile] has not opened");
-		return AM_FAILURE;
-	}
+	loff_t rpos, from, spos, wpos;
+	uint32_t seq;
+	int now, end = 0;
 
 	if (! tfile->loop)
 	{
 		ret = aml_timeshift_subfile_read(tfile, buf, size);
 		if (ret > 0)
-		{
-			tfile->avail -= ret;
-			tfile->read += ret;
-			if (tfile->avail < 0)
-				tfile->avail = 0;
-		}
+			__atomic_store_n(&tfile->rpos, tfile->rpos + ret, __ATOMIC_RELEASE);
 		return ret;
 	}
 
-	pthread_mutex_lock(&tfile->lock);
-	if (tfile->avail <= 0)
-	{
-		AM_TIME_GetTimeSpecTimeout(timeout, &rt);
-		pthread_cond_timedwait(&tfile->cond, &tfile->lock, &rt);
-	}
-	if (tfile->avail <= 0)
+	if (timeout > 0)
 	{
-		tfile->avail = 0;
-		goto read_done;
+		AM_TIME_GetClock(&now);
+		end = now + timeout;
 	}
-	todo = (size < tfile->avail) ? size : tfile->avail;
-	size = todo;
-	split = ((tfile->read+size) > tfile->size) ? (tfile->size - tfile->read) : 0;
-	if (split > 0)
+
+	/*no lock here, the writer is never blocked by the reader*/
+	while (1)
 	{
-		/*read -> end*/
-		ret = aml_timeshift_subfile_read(tfile, buf, split);
-		if (ret < 0)
-			goto read_done;
-		if (ret != (ssize_t)split)
+		seq  = __atomic_load_n(&tfile->wseq, __ATOMIC_SEQ_CST);
+		from = __atomic_load_n(&tfile->rpos, __ATOMIC_ACQUIRE);
+		spos = __atomic_load_n(&tfile->spos, __ATOMIC_SEQ_CST);
+		wpos = __atomic_load_n(&tfile->wpos, __ATOMIC_ACQUIRE);
+
+		/*overrun by the writer, restart from the earliest data*/
+		rpos = AM_MAX(from, spos);
+
+		if (wpos > rpos)
 		{
-			tfile->read += ret;
-			goto read_done;
+			ret = aml_timeshift_ring_read(tfile, buf, AM_MIN((loff_t)size, wpos - rpos), rpos);
+			if (ret <= 0)
+				break;
+
+			/*the data may be overwritten while reading, read again*/
+			if (__atomic_load_n(&tfile->spos, __ATOMIC_SEQ_CST) > rpos)
+			{
+				AM_DEBUG(3, "[tfile] read %lld overrun", (long long)rpos);
+				ret = -1;
+				continue;
+			}
+
+			/*a seek during the read moves rpos, keep it*/
+			__atomic_compare_exchange_n(&tfile->rpos, &from, rpos + ret, 0,
+					__ATOMIC_RELEASE, __ATOMIC_RELAXED);
+			break;
 		}
 
-		tfile->read = 0;
-		todo -= ret;
-		buf += ret;
-	}
-	/*rewind the file*/
-	if (split > 0)
-		aml_timeshift_subfile_seek(tfile, 0, AM_TRUE);
-	ret = aml_timeshift_subfile_read(tfile, buf, todo);
-	if (ret > 0)
-	{
-		todo -= ret;
-		tfile->read += ret;
-		tfile->read %= tfile->size;
-		ret = size - todo;
-	}
-	if (tfile->read == 0) {
-		AM_DEBUG(0, "[tfile] reed is set 0 need to seek 0");
-		aml_timeshift_subfile_seek(tfile, 0, AM_TRUE);
+		if (! __atomic_load_n(&tfile->opened, __ATOMIC_SEQ_CST))
+			break;
+
+		if (timeout > 0)
+		{
+			AM_TIME_GetClock(&now);
+			if (now >= end)
+				break;
+			tfile_wait(tfile, seq, end - now);
+		}
+		else if (timeout < 0)
+		{
+			tfile_wait(tfile, seq, -1);
+		}
+		else
+		{
+			break;
+		}
 	}
-read_done:
-	if (ret > 0)
+
+	return ret;
+}
+
+ssize_t AM_TFile_Read(AM_TFile_t tfile, uint8_t *buf, size_t size, int timeout)
+{
+	ssize_t ret;
+
+	/*counted before checking opened, so AM_TFile_Close either sees the reader
+	 *and waits for it, or the reader sees the file closed*/
+	__atomic_add_fetch(&tfile->readers, 1, __ATOMIC_SEQ_CST);
+	if (! __atomic_load_n(&tfile->opened, __ATOMIC_SEQ_CST))
 	{
-		tfile->avail -= ret;
-		if (tfile->avail < 0)
-			tfile->avail = 0;
+		__atomic_sub_fetch(&tfile->readers, 1, __ATOMIC_SEQ_CST);
+		AM_DEBUG(0, "[tfile] has not opened");
+		return AM_FAILURE;
 	}
-	pthread_mutex_unlock(&tfile->lock);
+
+	ret = tfile_read(tfile, buf, size, timeout);
+
+	__atomic_sub_fetch(&tfile->readers, 1, __ATOMIC_SEQ_CST);
 	return ret;
 }
 
@@ -949,7 +1210,7 @@ ssize_t AM_TFile_Write(AM_TFile_t tfile, uint8_t *buf, size_t size, int *sys_err
 {
 	ssize_t ret = 0, ret2 = 0;
 	size_t len1 = 0, len2 = 0;
-	loff_t fsize, wpos;
+	loff_t fsize, wpos, woff;
 	int now;
 	size_t size_act = 0;
 	int wrap = 0;
@@ -967,24 +1228,20 @@ ssize_t AM_TFile_Write(AM_TFile_t tfile, uint8_t *buf, size_t size, int *sys_err
 		ret = aml_timeshift_subfile_write(tfile, buf, size, sys_err);
 		if (ret > 0)
 		{
-			pthread_mutex_lock(&tfile->lock);
-			tfile->size += ret;
-			tfile->write += ret;
-			tfile->total += ret;
-			tfile->avail += ret;
-			pthread_mutex_unlock(&tfile->lock);
+			__atomic_store_n(&tfile->size, tfile->size + ret, __ATOMIC_RELEASE);
+			__atomic_store_n(&tfile->wpos, tfile->wpos + ret, __ATOMIC_RELEASE);
+			tfile_wake(tfile);
 		}
 
 		if (tfile->timer)
-			timer_try_add_fragment_continuous(tfile->timer, tfile->write, 0);
+			timer_try_add_fragment_continuous(tfile->timer, tfile->wpos, 0);
 
 		goto write_done;
 	}
 
-	pthread_mutex_lock(&tfile->lock);
 	fsize = tfile->size;
-	wpos = tfile->write;
-	pthread_mutex_unlock(&tfile->lock);
+	wpos = tfile->wpos;
+	woff = wpos % fsize;
 
 	/*is the size exceed the file size?*/
 	if (size > fsize)
@@ -994,13 +1251,17 @@ ssize_t AM_TFile_Write(AM_TFile_t tfile, uint8_t *buf, size_t size, int *sys_err
 	}
 
 	len1 = size;
-	if ((wpos+len1) >= fsize)
+	if ((woff+len1) >= fsize)
 	{
-		len1 = (fsize - wpos);
+		len1 = (fsize - woff);
 		len2 = size - len1;
 		wrap = 1;
 		AM_DEBUG(2, "[tfile] wrap here, len[%d]=len1[%d]+len2[%d]", size, len1, len2);
 	}
+
+	/*the earliest data will be overwritten*/
+	aml_timeshift_ring_drop(tfile, wpos + size - fsize);
+
 	if (len1 > 0)
 	{
 		/*write -> end*/
@@ -1010,8 +1271,8 @@ ssize_t AM_TFile_Write(AM_TFile_t tfile, uint8_t *buf, size_t size, int *sys_err
 
 		if (tfile->timer)
 			timer_try_add_fragment(tfile->timer,
-					tfile->write + ret,
-					(wrap && !write_fail)? 0 : tfile->write+ret,
+					woff + ret,
+					(wrap && !write_fail)? 0 : woff+ret,
 					(wrap || (write_fail && ret))? 1 : 0);
 
 		if (write_fail) {
@@ -1044,75 +1305,20 @@ adjust_pos:
 
 	if (size_act > 0)
 	{
-		pthread_mutex_lock(&tfile->lock);
-
-		int debug = 0;
-		/*now, ret bytes actually written*/
-		off_t rleft = tfile->size - tfile->avail;
-		off_t sleft = tfile->size - tfile->total;
-
-		tfile->write = (tfile->write + size_act) % tfile->size;
-		if (tfile->write == 0) {
+		/*now, size_act bytes actually written*/
+		wpos += size_act;
+		if (wpos % fsize == 0) {
 			/*rewind the file*/
-			AM_DEBUG(0, "[tfile] write == 0, need seek write(0)read(%lld)", tfile->read);
+			AM_DEBUG(0, "[tfile] write == 0, need seek write(0)read(%lld)",
+				(long long)tfile_offset(tfile, tfile->rpos));
 			aml_timeshift_subfile_seek(tfile, 0, AM_FALSE);
 		}
-		//check the start pointer
-		if (size_act > sleft) {
-			if (tfile->timer) {
-				loff_t start;
-				loff_t remove = 0;
-				do {
-					remove += timer_remove_earliest_fragment(tfile->timer, &start);
-					} while(remove < size_act);
-				tfile->start = start;//tfile->write;
-				tfile->total -= remove;
-				//tfile->avail -= remove;
-				AM_DEBUG(3, "[tfile] size:%zu w >> s, s:%lld, t:%lld", size_act, tfile->start, tfile->total);
-				debug = 1;
-			} else {
-				tfile->start = tfile->write;
-				tfile->total -= size_act;
-			}
-		}
-
-		//check the read pointer
-		if (size_act > rleft) {
-			tfile->read = tfile->start;
-			tfile->avail -= size_act - rleft;
-			//AM_DEBUG(3, "ttt size:%zu w >> r, r:%lld, a:%lld",
-			//    size_act, tfile->read, tfile->avail);
-			//debug = 1;
-		}
-
-		if (tfile->avail < tfile->size)
-		{
-			tfile->avail += size_act;
-			if (tfile->avail > tfile->size)
-				tfile->avail = tfile->size;
-			pthread_cond_signal(&tfile->cond);
-		}
-		if (tfile->total < tfile->size)
-		{
-			tfile->total += size_act;
-			if (tfile->total > tfile->size)
-				tfile->total = tfile->size;
-		}
-
-		if (tfile->avail > tfile->total) {
-			tfile->read = tfile->start;
-			tfile->avail = tfile->total;
-		}
 
-		if (debug) {
-			AM_DEBUG(3, "[tfile] size:%zu now -> s:%lld, r:%lld, w:%lld, t:%lld, a:%lld",
-				size_act,
-				tfile->start, tfile->read, tfile->write, tfile->total, tfile->avail);
+		__atomic_store_n(&tfile->wpos, wpos, __ATOMIC_RELEASE);
+		tfile_wake(tfile);
 
-			if (tfile->timer)
-				timer_get_total(tfile->timer);
-		}
-		pthread_mutex_unlock(&tfile->lock);
+		AM_DEBUG(4, "[tfile] size:%zu now -> s:%lld, r:%lld, w:%lld",
+			size_act, (long long)tfile->spos, (long long)tfile->rpos, (long long)tfile->wpos);
 	}
 
 write_done:
@@ -1135,8 +1341,9 @@ write_done:
 					if (tfile->loop) {
 						if (tfile->duration >= 0) {
 							loff_t size = (loff_t)tfile->rate * (loff_t)tfile->duration;
-							if (size < tfile->size) {
-								tfile->size = size;
+							/*shrink only before the file wraps, the positions map to the same offsets*/
+							if (size < tfile->size && tfile->wpos <= size) {
+								__atomic_store_n(&tfile->size, size, __ATOMIC_RELEASE);
 								AM_DEBUG(1, "[tfile] file size -> %lld", tfile->size);
 								AM_EVT_Signal((long)tfile, AM_TFILE_EVT_SIZE_CHANGED, (void*)(long)tfile->size);
 							}
@@ -1162,66 +1369,64 @@ write_done:
 int AM_TFile_Seek(AM_TFile_t tfile, loff_t offset)
 {
 	int ret = 1;
+	loff_t spos, total;
+
 	if (! tfile->opened)
 	{
 		AM_DEBUG(0, "[tfile] has not opened");
 		return AM_FAILURE;
 	}
 
-	pthread_mutex_lock(&tfile->lock);
-	if (tfile->size <= 0)
-	{
-		pthread_mutex_unlock(&tfile->lock);
+	if (__atomic_load_n(&tfile->size, __ATOMIC_ACQUIRE) <= 0)
 		return ret;
-	}
-	if (offset > tfile->total)
-		offset = tfile->total - 1;
+
+	spos = __atomic_load_n(&tfile->spos, __ATOMIC_ACQUIRE);
+	total = __atomic_load_n(&tfile->wpos, __ATOMIC_ACQUIRE) - spos;
+
+	if (offset > total)
+		offset = AM_MAX(total - 1, 0);
 	else if (offset < 0)
 		offset = 0;
 	else
 		ret = 0;
 
-	tfile->read = (tfile->start + offset)%tfile->size;
-	tfile->avail = tfile->total - offset;
-	if (tfile->avail > 0)
-		pthread_cond_signal(&tfile->cond);
+	if (! tfile->loop)
+		aml_timeshift_subfile_seek(tfile, spos + offset, AM_TRUE);
 
-	aml_timeshift_subfile_seek(tfile, tfile->read, AM_TRUE);
+	__atomic_store_n(&tfile->rpos, spos + offset, __ATOMIC_RELEASE);
+	tfile_wake(tfile);
 
-	AM_DEBUG(3, "[tfile] Seek: start %lld, read %lld, write %lld, avail %lld, total %lld",
-				tfile->start, tfile->read, tfile->write, tfile->avail, tfile->total);
-	pthread_mutex_unlock(&tfile->lock);
+	AM_DEBUG(3, "[tfile] Seek: start %lld, read %lld, total %lld",
+				(long long)spos, (long long)(spos + offset), (long long)total);
 	return ret;
 }
 
 loff_t AM_TFile_Tell(AM_TFile_t tfile)
 {
-	loff_t ret = 0;
+	loff_t rpos;
 	if (! tfile->opened)
 	{
 		AM_DEBUG(0, "[tfile] has not opened");
 		return AM_FAILURE;
 	}
 
-	pthread_mutex_lock(&tfile->lock);
-	ret = tfile->read;
-	pthread_mutex_unlock(&tfile->lock);
-	return ret;
+	rpos = AM_MAX(__atomic_load_n(&tfile->rpos, __ATOMIC_ACQUIRE),
+			__atomic_load_n(&tfile->spos, __ATOMIC_ACQUIRE));
+	return tfile_offset(tfile, rpos);
 }
 
 loff_t AM_TFile_GetAvailable(AM_TFile_t tfile)
 {
-	loff_t ret = 0;
+	loff_t rpos;
 	if (! tfile->opened)
 	{
 		AM_DEBUG(0, "[tfile] has not opened");
 		return AM_FAILURE;
 	}
 
-	pthread_mutex_lock(&tfile->lock);
-	ret = tfile->avail;
-	pthread_mutex_unlock(&tfile->lock);
-	return ret;
+	rpos = AM_MAX(__atomic_load_n(&tfile->rpos, __ATOMIC_ACQUIRE),
+			__atomic_load_n(&tfile->spos, __ATOMIC_ACQUIRE));
+	return __atomic_load_n(&tfile->wpos, __ATOMIC_ACQUIRE) - rpos;
 }
 
 int AM_TFile_TimeStart(AM_TFile_t tfile)
@@ -1235,11 +1440,6 @@ int AM_TFile_TimeStart(AM_TFile_t tfile)
 	return aml_tfile_attach_timer(tfile);
 }
 
-//one node for guard time //need more research, fatal exists
-//#define get_list_start(_ptimer_) ((_ptimer_)->wrap? (_ptimer_)->list.next : &(_ptimer_)->list)
-#define get_list_start(_ptimer_)  (&(_ptimer_)->list)
-
-
 int AM_TFile_TimeSeek(AM_TFile_t tfile, int offset_ms/*offset from time start*/)
 {
 	int ret = -1;
@@ -1251,27 +1451,27 @@ int AM_TFile_TimeSeek(AM_TFile_t tfile, int offset_ms/*offset from time start*/)
 	pthread_mutex_lock(&tfile->lock);
 	if (tfile->timer) {
 		tfile_timer_t *timer = (tfile_timer_t*)tfile->timer;
-		tfragment_t *pstart = list_first_entry(get_list_start(timer), tfragment_t, head);
-		loff_t from = pstart->start;
-		tfragment_t *p;
-		list_for_each_entry(p, get_list_start(timer), head)
-		{
-			if (p->time > offset_ms)
-				break;
-			from = p->start;
-		}
-		tfile->read = from;
-
-		aml_timeshift_subfile_seek(tfile, tfile->read, AM_TRUE);
-        tfile->avail = (tfile->write >= from) ? tfile->write - from : (tfile->size - from) + tfile->write;
-		//tfile->avail = (tfile->write >= pstart->start) ? tfile->write - pstart->start : (tfile->size - pstart->start) + tfile->write;
-		if (tfile->avail > 0)
-			pthread_cond_signal(&tfile->cond);
-
-		AM_DEBUG(3, "[tfile] >>timeseek: pstart: %p[time:%d offset:%d - %d]", pstart, pstart->time, pstart->start, pstart->end);
-		AM_DEBUG(3, "[tfile] >>timeseek: got block: next%p[time:%d offset:%d - %d]", p, p->time, p->start, p->end);
-		AM_DEBUG(3, "[tfile] >>timeseek: start %lld, read %lld, write %lld, avail %lld, total %lld",
-				tfile->start, tfile->read, tfile->write, tfile->avail, tfile->total);
+		tfragment_t *p = timer_frag(timer, timer_find_time(timer, offset_ms));
+		loff_t from = p->start;
+		loff_t spos = tfile->spos;
+		loff_t rpos = spos;
+
+		/*the spos is moved with the lock held, the fragment is after it*/
+		if (tfile->loop)
+			rpos += (from - spos % tfile->size + tfile->size) % tfile->size;
+		else
+			rpos = from;
+
+		if (! tfile->loop)
+			aml_timeshift_subfile_seek(tfile, rpos, AM_TRUE);
+
+		__atomic_store_n(&tfile->rpos, rpos, __ATOMIC_RELEASE);
+		tfile_wake(tfile);
+
+		AM_DEBUG(3, "[tfile] >>timeseek: got block: [time:%d offset:%lld - %lld]",
+				p->time, (long long)p->start, (long long)p->end);
+		AM_DEBUG(3, "[tfile] >>timeseek: start %lld, read %lld, write %lld",
+				(long long)spos, (long long)rpos, (long long)tfile->wpos);
 		ret = 0;
 	}
 	pthread_mutex_unlock(&tfile->lock);
@@ -1289,10 +1489,11 @@ int AM_TFile_TimeGetReadNow(AM_TFile_t tfile)
 
 	pthread_mutex_lock(&tfile->lock);
 	if (tfile->timer) {
-		loff_t r = tfile->read;
+		loff_t r = tfile_offset(tfile, AM_MAX(tfile->rpos, tfile->spos));
 		tfile_timer_t *timer = (tfile_timer_t*)tfile->timer;
-		tfragment_t *pstart = list_first_entry(get_list_start(timer), tfragment_t, head);
-		tfragment_t *pend = list_entry(timer->list.prev, tfragment_t, head);
+		tfragment_t *pstart = timer_frag(timer, 0);
+		int wrap, i;
+
 		if (r > pstart->start) {
 			/*
 				| s--i--e |
@@ -1300,33 +1501,22 @@ int AM_TFile_TimeGetReadNow(AM_TFile_t tfile)
 				|       s---i--|
 				|--e           |
 			*/
-			now = pstart->time;
-			tfragment_t *p;
-			list_for_each_entry(p, get_list_start(timer), head)
-			{
-				if (p->start > r)
-					break;
-				now = p->time;
-			}
+			wrap = timer_find_wrap(timer);
+			i = timer_find_offset(timer, 0, wrap - 1, r);
 		} else if (r < pstart->start) {
 			/*
 				|           s---|
 				|--i-e          |
 			*/
-			now = pend->time;
-			struct list_head *pos;
-			list_for_each_prev(pos, &timer->list)
-			{
-				tfragment_t *p = list_entry(pos, tfragment_t, head);
-				if (p->start <= r) {
-					now = p->time;
-					break;
-				}
-			}
+			wrap = timer_find_wrap(timer);
+			i = timer_find_offset(timer, wrap, timer->count - 1, r);
+			if (i < 0)
+				i = timer->count - 1;
 		} else {
-			now = pstart->time;
+			i = 0;
 		}
-		AM_DEBUG(3, "[tfile] >>read:\ttime[%d]\toffset[%lld]", now, tfile->read);
+		now = timer_frag(timer, i)->time;
+		AM_DEBUG(3, "[tfile] >>read:\ttime[%d]\toffset[%lld]", now, (long long)r);
 	}
 	pthread_mutex_unlock(&tfile->lock);
 	return now;
@@ -1334,41 +1524,30 @@ int AM_TFile_TimeGetReadNow(AM_TFile_t tfile)
 
 int AM_TFile_TimeGetStart(AM_TFile_t tfile)
 {
-	int time = 0;
+	int time;
 	if (!tfile->opened)
 	{
 		AM_DEBUG(0, "[tfile] has not opened");
 		return -1;
 	}
 
-	pthread_mutex_lock(&tfile->lock);
-	if (tfile->timer) {
-		tfile_timer_t *timer = (tfile_timer_t*)tfile->timer;
-		tfragment_t *pstart = list_first_entry(get_list_start(timer), tfragment_t, head);
-		time = pstart->time;
-		AM_DEBUG(3, "[tfile] >>start:\ttime[%d]\toffset[%lld]", pstart->time, pstart->start);
-	}
-	pthread_mutex_unlock(&tfile->lock);
+	/*no lock, not blocked by the writer; read from tfile as the timer may be freed*/
+	time = __atomic_load_n(&tfile->start_time, __ATOMIC_ACQUIRE);
+	AM_DEBUG(3, "[tfile] >>start:\ttime[%d]", time);
 	return time;
 }
 
 int AM_TFile_TimeGetEnd(AM_TFile_t tfile)
 {
-	int time = 0;
+	int time;
 	if (!tfile->opened)
 	{
 		AM_DEBUG(0, "[tfile] has not opened");
 		return -1;
 	}
 
-	pthread_mutex_lock(&tfile->lock);
-	if (tfile->timer) {
-		tfile_timer_t *timer = (tfile_timer_t*)tfile->timer;
-		tfragment_t *pend = list_entry(timer->list.prev, tfragment_t, head);
-		time = pend->time;
-		AM_DEBUG(3, "[tfile] >>end:\ttime[%d]\toffset[%lld]", pend->time, pend->start);
-	}
-	pthread_mutex_unlock(&tfile->lock);
+	/*no lock, not blocked by the writer; read from tfile as the timer may be freed*/
+	time = __atomic_load_n(&tfile->end_time, __ATOMIC_ACQUIRE);
+	AM_DEBUG(3, "[tfile] >>end:\ttime[%d]", time);
 	return time;
 }
-
@@ -0,0 +1,518 @@
+#ifdef _FORTIFY_SOURCE
+#undef _FORTIFY_SOURCE
+#endif
+/***************************************************************************
+ * Copyright (c) 2014 Amlogic, Inc. All rights reserved.
+ *
+ * This source code is subject to the terms and conditions defined in the
+ * file 'LICENSE' which is part of this source code package.
+ *
+ * Description:
+ */
+/**\file
+ * \brief recording index file
+ *
+ * File layout (all values little endian):
+ *   header: magic "AMTI", version, entry size, reserved
+ *   entry:  offset(64), pts(64), time(32), flags(32)
+ ***************************************************************************/
+
+#ifndef ANDROID
+#define _LARGEFILE64_SOURCE
+#endif
+#define AM_DEBUG_LEVEL 5
+
+#include <unistd.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <am_types.h>
+#include <am_debug.h>
+#include <am_util.h>
+#include "am_av.h"
+#include "am_tindex.h"
+
+/****************************************************************************
+ * Macro definitions
+ ***************************************************************************/
+
+#define TINDEX_MAGIC		"AMTI"
+#define TINDEX_VERSION		(1)
+#define TINDEX_HEADER_SIZE	(16)
+#define TINDEX_ENTRY_SIZE	(24)
+
+#define TINDEX_TS_PKT_SIZE	(188)
+#define TINDEX_PTS_MASK		(0x1FFFFFFFFULL)
+/*PTS gaps larger than this are treated as discontinuity*/
+#define TINDEX_MAX_GAP		(10*90000)
+/*min interval between audio entries*/
+#define TINDEX_AUDIO_INTERVAL	(500)
+/*payload bytes of a video frame scanned for the picture type*/
+#define TINDEX_SCAN_SIZE	(2048)
+
+typedef struct {
+	int		fd;
+	AM_Bool_t	writable;
+
+	/*stream*/
+	int		vpid;
+	int		vfmt;
+	int		apid;
+
+	/*TS packet reassembly*/
+	uint8_t	pkt[TINDEX_TS_PKT_SIZE];
+	int		pkt_len;
+	loff_t	next;
+
+	/*the video frame being checked*/
+	AM_Bool_t	searching;
+	loff_t	frame_off;
+	uint64_t	frame_pts;
+	uint8_t	scan[TINDEX_SCAN_SIZE];
+	int		scan_len;
+
+	/*time base*/
+	AM_Bool_t	started;
+	uint64_t	last_pts;
+	int		last_delta;
+	int		time;
+	int		last_time;
+	int		entries;
+} AM_TIndexData_t;
+
+/****************************************************************************
+ * Static functions
+ ***************************************************************************/
+
+static void tindex_put32(uint8_t *p, uint32_t v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+	p[2] = v >> 16;
+	p[3] = v >> 24;
+}
+
+static uint32_t tindex_get32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void tindex_put64(uint8_t *p, uint64_t v)
+{
+	tindex_put32(p, (uint32_t)v);
+	tindex_put32(p + 4, (uint32_t)(v >> 32));
+}
+
+static uint64_t tindex_get64(const uint8_t *p)
+{
+	return tindex_get32(p) | ((uint64_t)tindex_get32(p + 4) << 32);
+}
+
+static int tindex_count(AM_TIndexData_t *idx)
+{
+	struct stat st;
+
+	if (fstat(idx->fd, &st) || st.st_size < TINDEX_HEADER_SIZE)
+		return 0;
+
+	return (st.st_size - TINDEX_HEADER_SIZE) / TINDEX_ENTRY_SIZE;
+}
+
+static int tindex_read(AM_TIndexData_t *idx, int i, AM_TIndex_Entry_t *entry)
+{
+	uint8_t buf[TINDEX_ENTRY_SIZE];
+
+	if (pread64(idx->fd, buf, sizeof(buf), TINDEX_HEADER_SIZE + (loff_t)i * TINDEX_ENTRY_SIZE) != sizeof(buf))
+		return -1;
+
+	entry->offset = tindex_get64(buf);
+	entry->pts    = tindex_get64(buf + 8);
+	entry->time   = tindex_get32(buf + 16);
+	entry->flags  = tindex_get32(buf + 20);
+
+	return 0;
+}
+
+static void tindex_add(AM_TIndexData_t *idx, loff_t offset, uint64_t pts, int flags)
+{
+	uint8_t buf[TINDEX_ENTRY_SIZE];
+	uint64_t delta;
+
+	if (!idx->started) {
+		idx->started = AM_TRUE;
+		idx->time = 0;
+	} else {
+		delta = (pts - idx->last_pts) & TINDEX_PTS_MASK;
+		if (delta > TINDEX_MAX_GAP) {
+			/*new time base, assume the same interval as before*/
+			AM_DEBUG(2, "[tindex] pts discontinuity %llx -> %llx", (unsigned long long)idx->last_pts, (unsigned long long)pts);
+			delta = idx->last_delta;
+			flags |= AM_TINDEX_FL_DISCONT;
+		}
+		idx->last_delta = (int)delta;
+		idx->time += (int)(delta / 90);
+	}
+	idx->last_pts = pts;
+
+	if ((flags & AM_TINDEX_FL_AUDIO) && idx->entries && (idx->time - idx->last_time < TINDEX_AUDIO_INTERVAL))
+		return;
+	idx->last_time = idx->time;
+	idx->entries++;
+
+	tindex_put64(buf, offset);
+	tindex_put64(buf + 8, pts);
+	tindex_put32(buf + 16, idx->time);
+	tindex_put32(buf + 20, flags);
+
+	if (write(idx->fd, buf, sizeof(buf)) != sizeof(buf))
+		AM_DEBUG(1, "[tindex] write index failed: %s", strerror(errno));
+}
+
+/*check the start of a video frame, return 1 if it is a key frame,
+ *0 if it is not, -1 if more data is needed*/
+static int tindex_check_key(AM_TIndexData_t *idx)
+{
+	const uint8_t *p = idx->scan;
+	int i, type;
+
+	for (i = 0; i + 3 < idx->scan_len; i++) {
+		if (p[i] || p[i + 1] || p[i + 2] != 1)
+			continue;
+
+		switch (idx->vfmt) {
+			case VFORMAT_MPEG12:
+				if (p[i + 3] == 0xB3)
+					return 1;
+				if (p[i + 3] == 0x00) {
+					if (i + 5 >= idx->scan_len)
+						return -1;
+					return (((p[i + 5] >> 3) & 7) == 1) ? 1 : 0;
+				}
+				break;
+			case VFORMAT_H264:
+			case VFORMAT_H264MVC:
+			case VFORMAT_H264_4K2K:
+				type = p[i + 3] & 0x1f;
+				if (type == 5 || type == 7)
+					return 1;
+				if (type == 1)
+					return 0;
+				break;
+			case VFORMAT_HEVC:
+				type = (p[i + 3] >> 1) & 0x3f;
+				if ((type >= 16 && type <= 21) || type == 32 || type == 33)
+					return 1;
+				if (type <= 9)
+					return 0;
+				break;
+			default:
+				/*only the random access indicator is used*/
+				return 0;
+		}
+	}
+
+	return (idx->scan_len < TINDEX_SCAN_SIZE) ? -1 : 0;
+}
+
+static void tindex_scan(AM_TIndexData_t *idx, const uint8_t *data, int len)
+{
+	int ret;
+
+	len = AM_MIN(len, TINDEX_SCAN_SIZE - idx->scan_len);
+	memcpy(idx->scan + idx->scan_len, data, len);
+	idx->scan_len += len;
+
+	ret = tindex_check_key(idx);
+	if (ret == -1)
+		return;
+
+	if (ret == 1)
+		tindex_add(idx, idx->frame_off, idx->frame_pts, AM_TINDEX_FL_VIDEO_KEY);
+	idx->searching = AM_FALSE;
+}
+
+/*get the PTS from the PES header, return the header length or -1*/
+static int tindex_parse_pes(const uint8_t *p, int len, uint64_t *pts)
+{
+	int hlen;
+
+	if (len < 9 || p[0] || p[1] || p[2] != 1)
+		return -1;
+
+	hlen = 9 + p[8];
+	if (!(p[7] & 0x80) || len < 14 || hlen > len)
+		return -1;
+
+	*pts = ((uint64_t)(p[9] & 0x0e) << 29) | (p[10] << 22) | ((p[11] & 0xfe) << 14) |
+		(p[12] << 7) | (p[13] >> 1);
+
+	return hlen;
+}
+
+static void tindex_parse_packet(AM_TIndexData_t *idx, const uint8_t *p, loff_t offset)
+{
+	int pid = ((p[1] & 0x1f) << 8) | p[2];
+	AM_Bool_t pusi = (p[1] & 0x40) ? AM_TRUE : AM_FALSE;
+	AM_Bool_t rai = AM_FALSE;
+	int afc = (p[3] >> 4) & 3;
+	int pos = 4, hlen;
+	uint64_t pts;
+
+	if (pid == 0x1fff || (pid != idx->vpid && pid != idx->apid))
+		return;
+	if (pid == idx->apid && idx->vpid < 0x1fff)
+		return;
+
+	if (afc & 2) {
+		if (p[4] && (p[5] & 0x40))
+			rai = AM_TRUE;
+		pos += 1 + p[4];
+	}
+	if (!(afc & 1) || pos >= TINDEX_TS_PKT_SIZE)
+		return;
+
+	if (pid == idx->apid) {
+		if (pusi && tindex_parse_pes(p + pos, TINDEX_TS_PKT_SIZE - pos, &pts) > 0)
+			tindex_add(idx, offset, pts, AM_TINDEX_FL_AUDIO);
+		return;
+	}
+
+	if (pusi) {
+		idx->searching = AM_FALSE;
+
+		hlen = tindex_parse_pes(p + pos, TINDEX_TS_PKT_SIZE - pos, &pts);
+		if (hlen < 0)
+			return;
+
+		if (rai) {
+			tindex_add(idx, offset, pts, AM_TINDEX_FL_VIDEO_KEY);
+			return;
+		}
+
+		idx->searching = AM_TRUE;
+		idx->frame_off = offset;
+		idx->frame_pts = pts;
+		idx->scan_len  = 0;
+		pos += hlen;
+	}
+
+	if (idx->searching && pos < TINDEX_TS_PKT_SIZE)
+		tindex_scan(idx, p + pos, TINDEX_TS_PKT_SIZE - pos);
+}
+
+/****************************************************************************
+ * API functions
+ ***************************************************************************/
+
+AM_ErrorCode_t AM_TIndex_Create(AM_TIndex_t *index, const char *file_name, int vpid, int vfmt, int apid)
+{
+	AM_TIndexData_t *idx;
+	uint8_t hdr[TINDEX_HEADER_SIZE];
+
+	assert(index && file_name);
+
+	idx = malloc(sizeof(AM_TIndexData_t));
+	if (!idx)
+		return AM_FAILURE;
+	memset(idx, 0, sizeof(AM_TIndexData_t));
+
+	idx->fd = open(file_name, O_TRUNC|O_CREAT|O_RDWR, 0666);
+	if (idx->fd == -1) {
+		AM_DEBUG(1, "[tindex] cannot create '%s': %s", file_name, strerror(errno));
+		free(idx);
+		return AM_FAILURE;
+	}
+
+	memset(hdr, 0, sizeof(hdr));
+	memcpy(hdr, TINDEX_MAGIC, 4);
+	tindex_put32(hdr + 4, TINDEX_VERSION);
+	tindex_put32(hdr + 8, TINDEX_ENTRY_SIZE);
+	if (write(idx->fd, hdr, sizeof(hdr)) != sizeof(hdr)) {
+		AM_DEBUG(1, "[tindex] cannot write '%s': %s", file_name, strerror(errno));
+		close(idx->fd);
+		free(idx);
+		return AM_FAILURE;
+	}
+
+	idx->writable = AM_TRUE;
+	idx->vpid = (vpid > 0 && vpid < 0x1fff) ? vpid : 0x1fff;
+	idx->vfmt = vfmt;
+	idx->apid = (apid > 0 && apid < 0x1fff) ? apid : 0x1fff;
+
+	AM_DEBUG(1, "[tindex] create '%s' vpid %d vfmt %d apid %d", file_name, idx->vpid, vfmt, idx->apid);
+
+	*index = idx;
+	return AM_SUCCESS;
+}
+
+AM_ErrorCode_t AM_TIndex_Parse(AM_TIndex_t index, const uint8_t *data, int size, loff_t offset)
+{
+	AM_TIndexData_t *idx = (AM_TIndexData_t *)index;
+	const uint8_t *p = data, *end = data + size;
+
+	assert(idx && data);
+
+	if (!idx->writable)
+		return AM_FAILURE;
+
+	/*drop the partial packet if the data is not continuous*/
+	if (idx->pkt_len && offset != idx->next)
+		idx->pkt_len = 0;
+	idx->next = offset + size;
+
+	if (idx->pkt_len) {
+		int len = AM_MIN(size, TINDEX_TS_PKT_SIZE - idx->pkt_len);
+
+		memcpy(idx->pkt + idx->pkt_len, p, len);
+		idx->pkt_len += len;
+		p += len;
+
+		if (idx->pkt_len < TINDEX_TS_PKT_SIZE)
+			return AM_SUCCESS;
+
+		tindex_parse_packet(idx, idx->pkt, offset - (idx->pkt_len - len));
+		idx->pkt_len = 0;
+	}
+
+	while (p < end) {
+		if (p[0] != 0x47) {
+			const uint8_t *s = memchr(p + 1, 0x47, end - p - 1);
+
+			p = s ? s : end;
+			continue;
+		}
+
+		if (end - p < TINDEX_TS_PKT_SIZE) {
+			idx->pkt_len = end - p;
+			memcpy(idx->pkt, p, idx->pkt_len);
+			break;
+		}
+
+		tindex_parse_packet(idx, p, offset + (p - data));
+		p += TINDEX_TS_PKT_SIZE;
+	}
+
+	return AM_SUCCESS;
+}
+
+AM_ErrorCode_t AM_TIndex_Open(AM_TIndex_t *index, const char *file_name)
+{
+	AM_TIndexData_t *idx;
+	uint8_t hdr[TINDEX_HEADER_SIZE];
+	int fd;
+
+	assert(index && file_name);
+
+	fd = open(file_name, O_RDONLY);
+	if (fd == -1)
+		return AM_FAILURE;
+
+	if (read(fd, hdr, sizeof(hdr)) != sizeof(hdr) || memcmp(hdr, TINDEX_MAGIC, 4)
+		|| tindex_get32(hdr + 4) != TINDEX_VERSION || tindex_get32(hdr + 8) != TINDEX_ENTRY_SIZE) {
+		AM_DEBUG(1, "[tindex] '%s' is not a valid index file", file_name);
+		close(fd);
+		return AM_FAILURE;
+	}
+
+	idx = malloc(sizeof(AM_TIndexData_t));
+	if (!idx) {
+		close(fd);
+		return AM_FAILURE;
+	}
+	memset(idx, 0, sizeof(AM_TIndexData_t));
+	idx->fd = fd;
+
+	AM_DEBUG(1, "[tindex] open '%s', %d entries", file_name, tindex_count(idx));
+
+	*index = idx;
+	return AM_SUCCESS;
+}
+
+AM_ErrorCode_t AM_TIndex_Close(AM_TIndex_t index)
+{
+	AM_TIndexData_t *idx = (AM_TIndexData_t *)index;
+
+	if (!idx)
+		return AM_FAILURE;
+
+	close(idx->fd);
+	free(idx);
+
+	return AM_SUCCESS;
+}
+
+AM_ErrorCode_t AM_TIndex_TimeSeek(AM_TIndex_t index, int time_ms, AM_TIndex_Entry_t *entry)
+{
+	AM_TIndexData_t *idx = (AM_TIndexData_t *)index;
+	AM_TIndex_Entry_t e;
+	int lo = 0, hi, mid;
+
+	assert(idx && entry);
+
+	/*find the last entry with time <= time_ms*/
+	hi = tindex_count(idx) - 1;
+	if (hi < 0 || tindex_read(idx, 0, entry))
+		return AM_FAILURE;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo + 1) / 2;
+		if (tindex_read(idx, mid, &e))
+			return AM_FAILURE;
+		if (e.time <= time_ms) {
+			lo = mid;
+			*entry = e;
+		} else {
+			hi = mid - 1;
+		}
+	}
+
+	return AM_SUCCESS;
+}
+
+AM_ErrorCode_t AM_TIndex_OffsetSeek(AM_TIndex_t index, loff_t offset, AM_TIndex_Entry_t *entry)
+{
+	AM_TIndexData_t *idx = (AM_TIndexData_t *)index;
+	AM_TIndex_Entry_t e;
+	int lo = 0, hi, mid;
+
+	assert(idx && entry);
+
+	/*find the last entry with offset <= offset*/
+	hi = tindex_count(idx) - 1;
+	if (hi < 0 || tindex_read(idx, 0, entry))
+		return AM_FAILURE;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo + 1) / 2;
+		if (tindex_read(idx, mid, &e))
+			return AM_FAILURE;
+		if (e.offset <= offset) {
+			lo = mid;
+			*entry = e;
+		} else {
+			hi = mid - 1;
+		}
+	}
+
+	return AM_SUCCESS;
+}
+
+AM_ErrorCode_t AM_TIndex_GetInfo(AM_TIndex_t index, int *count, int *duration)
+{
+	AM_TIndexData_t *idx = (AM_TIndexData_t *)index;
+	AM_TIndex_Entry_t e;
+	int cnt;
+
+	assert(idx);
+
+	cnt = tindex_count(idx);
+	if (count)
+		*count = cnt;
+	if (duration)
+		*duration = (cnt && !tindex_read(idx, cnt - 1, &e)) ? e.time : 0;
+
+	return AM_SUCCESS;
+}
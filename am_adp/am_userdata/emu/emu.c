@@ -26,6 +26,7 @@
 #include "../am_userdata_internal.h"
 #include <am_dvr.h>
 #include <am_dmx.h>
+#include <am_crc.h>
 #include "../../am_adp_internal.h"
 #include <limits.h>
 #include <stddef.h>
@@ -441,38 +442,8 @@ static unsigned int
 mpeg2_crc			(const uint8_t *	buf,
 				 unsigned int		n_bytes)
 {
-	static uint32_t crc_table[256];
-	unsigned int crc;
-	unsigned int i;
-
 	/* ISO 13818-1 Annex B. */
-
-	if (unlikely (0 == crc_table[255])) {
-		const unsigned int poly = 
-			((1 << 26) | (1 << 23) | (1 << 22) | (1 << 16) |
-			 (1 << 12) | (1 << 11) | (1 << 10) | (1 << 8) |
-			 (1 << 7) | (1 << 5) | (1 << 4) | (1 << 2) |
-			 (1 << 1) | 1);
-		unsigned int c, j;
-
-		for (i = 0; i < 256; ++i) {
-			c = i << 24;
-			for (j = 0; j < 8; ++j) {
-				if (c & (1 << 31))
-					c = (c << 1) ^ poly;
-				else
-					c <<= 1;
-			}
-			crc_table[i] = c;
-		}
-		assert (0 != crc_table[255]);
-	}
-
-	crc = -1;
-	for (i = 0; i < n_bytes; ++i)
-		crc = crc_table[(buf[i] ^ (crc >> 24)) & 0xFF] ^ (crc << 8);
-
-	return crc & 0xFFFFFFFFUL;
+	return AM_CRC32_Calc (AM_CRC32_INIT, buf, n_bytes);
 }
 
 
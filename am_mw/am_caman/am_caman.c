@@ -1167,7 +1167,7 @@ static int on_new_pmt(_ts_t *ts)
 				dvbpsi_descriptor_t *descr;
 				LIST_FOR_EACH(pmt->p_first_descriptor, descr)
 				{
-					if (descr->p_decoded && descr->i_tag == AM_SI_DESCR_CA)
+					if (descr->i_tag == AM_SI_DESCR_CA && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT))
 					{
 						dvbpsi_ca_dr_t *pca = (dvbpsi_ca_dr_t*)descr->p_decoded;
 
@@ -1251,7 +1251,7 @@ static int on_new_cat(_ts_t *ts)
 				dvbpsi_descriptor_t *descr;
 				LIST_FOR_EACH(cat->p_first_descriptor, descr)
 				{
-					if (descr->p_decoded && descr->i_tag == AM_SI_DESCR_CA)
+					if (descr->i_tag == AM_SI_DESCR_CA && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT))
 					{
 						dvbpsi_ca_dr_t *pca = (dvbpsi_ca_dr_t*)descr->p_decoded;
 
@@ -44,6 +44,7 @@
 #define VBI_DEV_FILE "/dev/vbi"
 #define VIDEO_WIDTH_FILE "/sys/class/video/frame_width"
 #define VIDEO_HEIGHT_FILE "/sys/class/video/frame_height"
+#define VIDEO_SIZE_MAX_AGE 500 /*视频尺寸缓存时间(毫秒)*/
 
 #define _TM_T 'V'
 struct vout_CCparam_s {
@@ -106,8 +107,8 @@ static AM_ErrorCode_t am_cc_calc_caption_size(int *w, int *h)
 #if 1
 	vw = 0;
 	vh = 0;
-	ret  = AM_FileRead(VIDEO_WIDTH_FILE, wbuf, sizeof(wbuf));
-	ret |= AM_FileRead(VIDEO_HEIGHT_FILE, hbuf, sizeof(hbuf));
+	ret  = AM_FileReadCached(VIDEO_WIDTH_FILE, wbuf, sizeof(wbuf), VIDEO_SIZE_MAX_AGE);
+	ret |= AM_FileReadCached(VIDEO_HEIGHT_FILE, hbuf, sizeof(hbuf), VIDEO_SIZE_MAX_AGE);
 	if (ret != AM_SUCCESS ||
 		sscanf(wbuf, "%d", &vw) != 1 ||
 		sscanf(hbuf, "%d", &vh) != 1)
@@ -75,6 +75,8 @@
 #define EPG_SUB_CHECK_TIME (10*1000)
 /*预约播放提前通知时间*/
 #define EPG_PRE_NOTIFY_TIME (60*1000)
+/*EIT section解析数据内存池每次分配的大小*/
+#define EPG_SEC_POOL_SIZE (16*1024)
 
 /*并行接收ATSC EIT的个数*/
 //#define PARALLEL_PSIP_EIT_CNT 4
@@ -125,11 +127,18 @@
 		(_l) = NULL;\
 	AM_MACRO_END
 
-/*解析section并添加到列表*/
+/*解析section并添加到列表，通知后立即释放的EIT/ETT从内存池中分配*/
 #define COLLECT_SECTION(type, list)\
 	AM_MACRO_BEGIN\
 		type *p_table;\
-		if (AM_SI_DecodeSection(mon->hsi, sec_ctrl->pid, (uint8_t*)data, len, (void**)&p_table) == AM_SUCCESS){\
+		AM_ErrorCode_t dec_ret;\
+		if (sec_ctrl->pid == AM_SI_PID_EIT || data[0] == AM_SI_TID_PSIP_EIT || data[0] == AM_SI_TID_PSIP_ETT){\
+			AM_MEM_PoolClear(&mon->sec_pool);\
+			dec_ret = AM_SI_DecodeSectionInPool(mon->hsi, sec_ctrl->pid, (uint8_t*)data, len, &mon->sec_pool, (void**)&p_table);\
+		} else {\
+			dec_ret = AM_SI_DecodeSection(mon->hsi, sec_ctrl->pid, (uint8_t*)data, len, (void**)&p_table);\
+		}\
+		if (dec_ret == AM_SUCCESS){\
 			/* process this section */\
 			if (sec_ctrl->proc_sec) {\
 				mon->current_fid = sec_ctrl->fid; \
@@ -139,7 +148,7 @@
 				/* notify dvb eit */\
 				am_epg_tablectl_mark_section_eit(sec_ctrl, &header, data[12]);\
 				SIGNAL_EVENT(AM_EPG_EVT_NEW_EIT, (void*)p_table);\
-				AM_SI_ReleaseSection(mon->hsi, data[0], (void*)p_table);\
+				AM_MEM_PoolClear(&mon->sec_pool);\
 			} else if (sec_ctrl->pid == AM_SI_PID_TOT || data[0] == AM_SI_TID_PSIP_STT) {\
 				/* dvb tdt/tot, atsc stt, TDT/TOT/STT has only 1 section */\
 				p_table->p_next = NULL;\
@@ -149,12 +158,12 @@
 				/* notify atsc eit */\
 				am_epg_tablectl_mark_section(sec_ctrl, &header); \
 				SIGNAL_EVENT(AM_EPG_EVT_NEW_PSIP_EIT, (void*)p_table);\
-				AM_SI_ReleaseSection(mon->hsi, data[0], (void*)p_table);\
+				AM_MEM_PoolClear(&mon->sec_pool);\
 			} else if (data[0] == AM_SI_TID_PSIP_ETT){\
 				/* notify atsc ett */\
 				am_epg_tablectl_mark_section(sec_ctrl, &header); \
 				SIGNAL_EVENT(AM_EPG_EVT_NEW_PSIP_ETT, (void*)p_table);\
-				AM_SI_ReleaseSection(mon->hsi, data[0], (void*)p_table);\
+				AM_MEM_PoolClear(&mon->sec_pool);\
 			} else {\
 				/*For non-eit/tot/stt sections, store to table list*/\
 				p_table->p_next = NULL;\
@@ -1111,7 +1120,7 @@ static void am_epg_eit_get_event_list(AM_EPG_Monitor_t *mon, void *eit_section,
 		memset(ext_langs, 0, sizeof(ext_langs));
 		
 		AM_SI_LIST_BEGIN(event->p_first_descriptor, descr)
-			if (descr->i_tag == AM_SI_DESCR_SHORT_EVENT && descr->p_decoded)
+			if (descr->i_tag == AM_SI_DESCR_SHORT_EVENT && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_EIT_PF_ACT))
 			{
 				int ishort;
 				dvbpsi_short_event_dr_t *pse = (dvbpsi_short_event_dr_t*)descr->p_decoded;
@@ -1131,7 +1140,7 @@ static void am_epg_eit_get_event_list(AM_EPG_Monitor_t *mon, void *eit_section,
 				memcpy(short_langs[short_lang_cnt].lang, pse->i_iso_639_code, 3);
 				short_langs[short_lang_cnt++].descr = pse;
 			}
-			else if (descr->i_tag == AM_SI_DESCR_EXTENDED_EVENT && descr->p_decoded)
+			else if (descr->i_tag == AM_SI_DESCR_EXTENDED_EVENT && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_EIT_PF_ACT))
 			{
 				int iext;
 				dvbpsi_extended_event_dr_t *pee = (dvbpsi_extended_event_dr_t*)descr->p_decoded;
@@ -1155,14 +1164,14 @@ static void am_epg_eit_get_event_list(AM_EPG_Monitor_t *mon, void *eit_section,
 				memcpy(ext_langs[ext_lang_cnt].lang, pee->i_iso_639_code, 3);
 				ext_langs[ext_lang_cnt++].descrs[pee->i_descriptor_number] = pee;
 			}
-			else if (descr->i_tag == AM_SI_DESCR_CONTENT && descr->p_decoded)
+			else if (descr->i_tag == AM_SI_DESCR_CONTENT && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_EIT_PF_ACT))
 			{
 				dvbpsi_content_dr_t *pcd = (dvbpsi_content_dr_t*)descr->p_decoded;
 
 				nibble = pcd->i_nibble_level;
 				//AM_DEBUG(1, "content_nibble_level is 0x%x", nibble);
 			}
-			else if (descr->i_tag == AM_SI_DESCR_PARENTAL_RATING && descr->p_decoded)
+			else if (descr->i_tag == AM_SI_DESCR_PARENTAL_RATING && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_EIT_PF_ACT))
 			{
 				dvbpsi_parental_rating_dr_t *prd = (dvbpsi_parental_rating_dr_t*)descr->p_decoded;
 				dvbpsi_parental_rating_t *pr = prd->p_parental_rating;
@@ -1666,7 +1675,7 @@ static void am_epg_proc_psip_eit_section_def(AM_EPG_Monitor_t *mon, void *eit_se
 		values[0] = 0;
 		/*取级别控制信息*/
 		AM_SI_LIST_BEGIN(event->p_first_descriptor, descr)
-			if (descr->p_decoded && descr->i_tag == AM_SI_DESCR_CONTENT_ADVISORY)
+			if (descr->i_tag == AM_SI_DESCR_CONTENT_ADVISORY && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PSIP_EIT))
 			{
 				int i, j, dmn_dbid; 
 				dvbpsi_atsc_content_advisory_dr_t *pcad = (dvbpsi_atsc_content_advisory_dr_t*)descr->p_decoded;
@@ -2446,7 +2455,7 @@ static void am_epg_check_pmt_update_def(AM_EPG_Monitor_t *mon)
 			AM_SI_LIST_BEGIN(pmt->p_first_es, es)
 				/*查找Subtilte和Teletext描述符，并添加相关记录*/
 				AM_SI_LIST_BEGIN(es->p_first_descriptor, descr)
-				if (descr->p_decoded && descr->i_tag == AM_SI_DESCR_SUBTITLING)
+				if (descr->i_tag == AM_SI_DESCR_SUBTITLING && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT))
 				{
 					int isub;
 					dvbpsi_subtitling_dr_t *psd = (dvbpsi_subtitling_dr_t*)descr->p_decoded;
@@ -2457,7 +2466,7 @@ static void am_epg_check_pmt_update_def(AM_EPG_Monitor_t *mon)
 						insert_subtitle(hdb, mon->mon_service, es->i_pid, &psd->p_subtitle[isub]);
 					}
 				}
-				else if (descr->i_tag == AM_SI_DESCR_TELETEXT)
+				else if (descr->i_tag == AM_SI_DESCR_TELETEXT && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT))
 				{
 					int itel;
 					dvbpsi_teletext_dr_t *ptd = (dvbpsi_teletext_dr_t*)descr->p_decoded;
@@ -2656,7 +2665,7 @@ static void am_epg_check_sdt_update_def(AM_EPG_Monitor_t *mon)
 		AM_SI_LIST_BEGIN(sdt->p_first_service, srv)
 			/*从SDT表中查找该service名称*/
 			AM_SI_LIST_BEGIN(srv->p_first_descriptor, descr)
-			if (descr->p_decoded && descr->i_tag == AM_SI_DESCR_SERVICE)
+			if (descr->i_tag == AM_SI_DESCR_SERVICE && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_SDT_ACT))
 			{
 				dvbpsi_service_dr_t *psd = (dvbpsi_service_dr_t*)descr->p_decoded;
 				char name[AM_DB_MAX_SRV_NAME_LEN + 4];
@@ -3846,6 +3855,7 @@ handle_events:
 
 	pthread_mutex_lock(&mon->lock);
 	AM_SI_Destroy(mon->hsi);
+	AM_MEM_PoolFree(&mon->sec_pool);
 
 	am_epg_tablectl_deinit(&mon->patctl);
 	am_epg_tablectl_deinit(&mon->pmtctl);
@@ -3941,6 +3951,8 @@ AM_ErrorCode_t AM_EPG_Create(AM_EPG_CreatePara_t *para, AM_EPG_Handle_t *handle)
 		return AM_EPG_ERR_CANNOT_CREATE_SI;
 	}
 
+	AM_MEM_PoolInit(&mon->sec_pool, EPG_SEC_POOL_SIZE);
+
 	pthread_mutexattr_init(&mta);
 	pthread_mutexattr_settype(&mta, PTHREAD_MUTEX_RECURSIVE_NP);
 	pthread_mutex_init(&mon->lock, &mta);
@@ -3954,6 +3966,7 @@ AM_ErrorCode_t AM_EPG_Create(AM_EPG_CreatePara_t *para, AM_EPG_Handle_t *handle)
 		pthread_mutex_destroy(&mon->lock);
 		pthread_cond_destroy(&mon->cond);
 		AM_SI_Destroy(mon->hsi);
+		AM_MEM_PoolFree(&mon->sec_pool);
 		free(mon);
 		return AM_EPG_ERR_CANNOT_CREATE_THREAD;
 	}
@@ -4390,3 +4403,17 @@ AM_ErrorCode_t AM_EPG_DisableDefProc(AM_EPG_Handle_t handle, AM_Bool_t disable)
 	return AM_SUCCESS;
 }
 
+AM_ErrorCode_t AM_EPG_SetLazyDescriptorDecode(AM_EPG_Handle_t handle, AM_Bool_t enable)
+{
+	AM_EPG_Monitor_t *mon = (AM_EPG_Monitor_t*)handle;
+	AM_ErrorCode_t ret;
+
+	assert(mon);
+
+	pthread_mutex_lock(&mon->lock);
+	ret = AM_SI_SetLazyDescriptorDecode(mon->hsi, enable);
+	pthread_mutex_unlock(&mon->lock);
+
+	return ret;
+}
+
@@ -24,6 +24,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <ctype.h>
 #include <sys/stat.h>
 #include <pthread.h>
 #include <assert.h>
@@ -35,6 +36,7 @@
 #include <am_db.h>
 #include <am_epg.h>
 #include <am_rec.h>
+#include <am_tindex.h>
 #include "am_rec_internal.h"
 #include "am_misc.h"
 #ifdef SUPPORT_CAS
@@ -56,6 +58,33 @@
 
 #define DVB_STB_ASYNCFIFO_FLUSHSIZE_FILE "/sys/class/stb/asyncfifo0_flush_size"
 
+/**\brief 元数据文件格式版本*/
+#define REC_META_VERSION	1
+/**\brief 元数据文件的最大行长度*/
+#define REC_META_LINE_MAX	256
+
+/**\brief 写文件线程缺省的缓冲区大小*/
+#define REC_WRITER_BUF_SIZE	(1024*1024)
+/**\brief 写文件线程缺省的缓冲区数*/
+#define REC_WRITER_BUF_COUNT	(2)
+/**\brief 数据在缓冲区中的最长停留时间(毫秒)*/
+#define REC_WRITER_FLUSH_TIME	(1000)
+/**\brief O_DIRECT写入的对齐长度*/
+#define REC_WRITER_ALIGN	(4096)
+
+/**\brief 共享DVR时每个录像的接收缓冲区大小，为TS包长度的整数倍*/
+#define REC_SOURCE_BUF_SIZE	(188*8192)
+/**\brief 共享DVR时每次从DVR读取的数据长度*/
+#define REC_SOURCE_READ_SIZE	(256*1024)
+
+/****************************************************************************
+ * Static data
+ ***************************************************************************/
+
+/**\brief 共享DVR的数据源*/
+static AM_REC_Source_t *rec_sources = NULL;
+static pthread_mutex_t rec_source_lock = PTHREAD_MUTEX_INITIALIZER;
+
 /****************************************************************************
  * Type definitions
  ***************************************************************************/
@@ -211,198 +240,1281 @@ static AM_ErrorCode_t am_rec_insert_file_header(AM_REC_Recorder_t *rec)
 	WRITE_INT(pp->ttx_cnt);
 	for (i=0; i<pp->ttx_cnt; i++)
 	{
-		WRITE_INT(pp->teletexts[i].pid);
-		WRITE_INT(pp->teletexts[i].magzine_no);
-		WRITE_INT(pp->teletexts[i].page_no);
-		memcpy(stream+pos, pp->teletexts[i].lang, sizeof(pp->teletexts[i].lang));
-		pos += sizeof(pp->teletexts[i].lang);
+		WRITE_INT(pp->teletexts[i].pid);
+		WRITE_INT(pp->teletexts[i].magzine_no);
+		WRITE_INT(pp->teletexts[i].page_no);
+		memcpy(stream+pos, pp->teletexts[i].lang, sizeof(pp->teletexts[i].lang));
+		pos += sizeof(pp->teletexts[i].lang);
+	}
+	
+    /* In order to be compatible with libplayer, we pack it as a ts packet */
+	lseek64(rec->rec_fd, 0, SEEK_SET);
+	am_rec_packet_data(rec->rec_fd, header_pid, stream, pos, 1);
+	
+	return AM_SUCCESS;
+}
+
+static AM_ErrorCode_t am_rec_gen_next_file_name(AM_REC_Recorder_t *rec, const char *prefix, const char *suffix)
+{	
+	struct stat st;
+	
+	do
+	{
+		if (rec->rec_file_index <= 1)
+		{
+			snprintf(rec->rec_file_name, sizeof(rec->rec_file_name), 
+				"%s/%s.%s", rec->create_para.store_dir, prefix, suffix);
+		}
+		else
+		{
+			snprintf(rec->rec_file_name, sizeof(rec->rec_file_name), 
+				"%s/%s-%d.%s", rec->create_para.store_dir, prefix, 
+				rec->rec_file_index, suffix);
+		}
+		
+		if (!stat(rec->rec_file_name, &st))
+		{
+			AM_DEBUG(1, "PVR file '%s' already exist.", rec->rec_file_name);
+			rec->rec_file_index++;
+			
+			continue;
+		}
+		else if (errno == ENOENT)
+		{
+			AM_DEBUG(1, "PVR file is assigned to '%s'", rec->rec_file_name);
+			break;
+		}
+		else
+		{
+			AM_DEBUG(1, "Searching PVR files failed, error: %s", strerror(errno));
+			if (errno == EACCES)
+				return AM_REC_ERR_CANNOT_ACCESS_FILE;
+			
+			return AM_REC_ERR_CANNOT_OPEN_FILE;
+		}	
+
+		if (rec->rec_file_index == INT_MAX)
+		{
+			/* Is this possible? */
+			AM_DEBUG(1, "Too many sub-files!");
+			return AM_REC_ERR_CANNOT_OPEN_FILE;
+		}
+		
+		rec->rec_file_index++;
+	}while(1);
+
+	return AM_SUCCESS;
+}
+
+/**\brief 取得当前录像文件的索引文件名*/
+static void am_rec_index_name(AM_REC_Recorder_t *rec, char *name, int size)
+{
+	snprintf(name, size, "%s"AM_TINDEX_SUFFIX, rec->rec_file_name);
+}
+
+/**\brief 关闭索引文件*/
+static void am_rec_index_close(AM_REC_Recorder_t *rec)
+{
+	if (rec->index)
+	{
+		AM_TIndex_Close(rec->index);
+		rec->index = NULL;
+	}
+}
+
+/**\brief 为当前录像文件创建索引文件，记录关键帧的时间和文件偏移*/
+static void am_rec_index_open(AM_REC_Recorder_t *rec)
+{
+	AM_REC_MediaInfo_t *minfo = &rec->rec_para.media_info;
+	char name[sizeof(rec->rec_file_name) + sizeof(AM_TINDEX_SUFFIX)];
+	int apid = (minfo->aud_cnt > 0) ? minfo->audios[0].pid : 0x1fff;
+
+	am_rec_index_close(rec);
+
+	/*加密后的数据无法分析*/
+	if (CRYPT_SET(rec->rec_para.crypt_ops))
+		return;
+#ifdef SUPPORT_CAS
+	if (rec->create_para.is_smp && rec->rec_para.enc_cb)
+		return;
+#endif
+
+	am_rec_index_name(rec, name, sizeof(name));
+	if (AM_TIndex_Create(&rec->index, name, minfo->vid_pid, minfo->vid_fmt, apid) != AM_SUCCESS)
+	{
+		AM_DEBUG(1, "Cannot create index file '%s', record without index", name);
+		rec->index = NULL;
+	}
+}
+
+/**\brief 切换到新的录像文件，由写文件线程调用，在rec->lock保护下替换rec_fd*/
+static AM_ErrorCode_t am_rec_auto_switch_file(AM_REC_Recorder_t *rec)
+{
+	AM_ErrorCode_t ret = AM_SUCCESS;
+
+	pthread_mutex_lock(&rec->lock);
+
+	if (rec->rec_fd >= 0)
+	{
+		close(rec->rec_fd);
+		rec->rec_fd = -1;
+	}
+
+	/* try to create the new record sub-file */
+	ret = am_rec_gen_next_file_name(rec, rec->rec_para.prefix_name, rec->rec_para.suffix_name);
+	if (ret != AM_SUCCESS)
+		goto end;
+
+	rec->rec_fd = open(rec->rec_file_name, O_TRUNC|O_CREAT|O_RDWR, 0666);
+	if (rec->rec_fd == -1)
+	{
+		AM_DEBUG(1, "Cannot open new file '%s', record aborted.", rec->rec_file_name);
+		ret = AM_REC_ERR_CANNOT_OPEN_FILE;
+		goto end;
+	}
+
+	am_rec_insert_file_header(rec);
+
+	am_rec_insert_pat(rec);
+
+	am_rec_index_open(rec);
+
+end:
+	pthread_mutex_unlock(&rec->lock);
+	return ret;
+}
+
+/**\brief 取得录像需要的PID*/
+static void am_rec_get_pids(AM_REC_Recorder_t *rec, AM_DVR_StartRecPara_t *spara)
+{
+	int i;
+	AM_REC_MediaInfo_t *minfo = &rec->rec_para.media_info;
+
+#define ADD_PID(_pid)\
+	AM_MACRO_BEGIN\
+		if ((_pid) < 0x1fff && spara->pid_count < AM_DVR_MAX_PID_COUNT)\
+			spara->pids[spara->pid_count++] = (_pid);\
+	AM_MACRO_END
+
+	spara->pid_count = 0;
+	ADD_PID(minfo->vid_pid);
+	for (i=0; i<minfo->aud_cnt; i++)
+	{
+		ADD_PID(minfo->audios[i].pid);
+	}
+	for (i=0; i<minfo->sub_cnt; i++)
+	{
+		ADD_PID(minfo->subtitles[i].pid);
+	}
+	for (i=0; i<minfo->ttx_cnt; i++)
+	{
+		ADD_PID(minfo->teletexts[i].pid);
+	}
+
+	if (rec->rec_para.program.i_pid != 0)
+		ADD_PID(rec->rec_para.program.i_pid);
+
+	for (i = 0; i < rec->rec_para.ext_pids.count; i++) {
+		if (rec->rec_para.ext_pids.pids[i] != 0)
+			ADD_PID(rec->rec_para.ext_pids.pids[i]);
+	}
+}
+
+static AM_ErrorCode_t am_rec_start_dvr(AM_REC_Recorder_t *rec)
+{
+	AM_DVR_StartRecPara_t spara;
+
+	am_rec_get_pids(rec, &spara);
+
+	return AM_DVR_StartRecord(rec->create_para.dvr_dev, &spara);
+}
+
+#define REC_PID_SET(_pids, _pid)	((_pids)[(_pid) >> 3] |= (1 << ((_pid) & 7)))
+#define REC_PID_TEST(_pids, _pid)	((_pids)[(_pid) >> 3] & (1 << ((_pid) & 7)))
+
+/**\brief 计算数据源中所有录像和新加入的录像rec共需要的PID数，需在数据源锁保护下调用*/
+static int am_rec_source_count_pids(AM_REC_Source_t *src, AM_REC_Recorder_t *add)
+{
+	AM_REC_Recorder_t *rec;
+	int pid, cnt = 0;
+
+	for (pid = 0; pid < 0x1fff; pid++)
+	{
+		if (REC_PID_TEST(add->src_pids, pid))
+		{
+			cnt++;
+			continue;
+		}
+
+		for (rec = src->outputs; rec; rec = rec->src_next)
+		{
+			if (REC_PID_TEST(rec->src_pids, pid))
+			{
+				cnt++;
+				break;
+			}
+		}
+	}
+
+	return cnt;
+}
+
+/**\brief 按数据源中所有录像需要的PID设置DVR，需在数据源锁保护下调用*/
+static AM_ErrorCode_t am_rec_source_update_pids(AM_REC_Source_t *src)
+{
+	AM_REC_Recorder_t *rec;
+	AM_DVR_StartRecPara_t spara;
+	int pid;
+
+	spara.pid_count = 0;
+	for (pid = 0; pid < 0x1fff; pid++)
+	{
+		for (rec = src->outputs; rec; rec = rec->src_next)
+		{
+			if (REC_PID_TEST(rec->src_pids, pid))
+				break;
+		}
+
+		if (!rec)
+			continue;
+
+		if (spara.pid_count == AM_DVR_MAX_PID_COUNT)
+		{
+			AM_DEBUG(1, "DVR%d: too many PIDs, PID %d is not recorded", src->dvr_dev, pid);
+			continue;
+		}
+		spara.pids[spara.pid_count++] = pid;
+	}
+
+	if (!spara.pid_count)
+		return AM_DVR_StopRecord(src->dvr_dev);
+
+	return AM_DVR_ChangeRecordPids(src->dvr_dev, &spara);
+}
+
+/**\brief 将一个TS包放入使用它的录像的接收缓冲区，需在数据源锁保护下调用*/
+static void am_rec_source_dispatch(AM_REC_Source_t *src, const uint8_t *pkt)
+{
+	AM_REC_Recorder_t *rec;
+	int pid = ((pkt[1] & 0x1f) << 8) | pkt[2];
+
+	for (rec = src->outputs; rec; rec = rec->src_next)
+	{
+		int pos;
+
+		if (!REC_PID_TEST(rec->src_pids, pid))
+			continue;
+
+		/*缓冲区长度为TS包长度的整数倍，包不会跨过缓冲区末尾*/
+		if (rec->src_len + 188 > REC_SOURCE_BUF_SIZE)
+		{
+			if (!(rec->src_lost++ % 1000))
+				AM_DEBUG(1, "DVR%d: record buffer full, %d packets lost", src->dvr_dev, rec->src_lost);
+			continue;
+		}
+
+		pos = (rec->src_head + rec->src_len) % REC_SOURCE_BUF_SIZE;
+		memcpy(rec->src_buf + pos, pkt, 188);
+		rec->src_len += 188;
+	}
+}
+
+/**\brief 数据源线程，读取DVR数据并分发给各个录像*/
+static void *am_rec_source_thread(void *arg)
+{
+	AM_REC_Source_t *src = (AM_REC_Source_t *)arg;
+	uint8_t *buf;
+	int cnt, pos, left = 0;
+
+	buf = (uint8_t *)malloc(REC_SOURCE_READ_SIZE);
+	if (!buf)
+	{
+		AM_DEBUG(0, "no enough memory for DVR%d", src->dvr_dev);
+		return NULL;
+	}
+
+	while (1)
+	{
+		cnt = AM_DVR_Read(src->dvr_dev, buf + left, REC_SOURCE_READ_SIZE - left, 50);
+
+		pthread_mutex_lock(&src->lock);
+		if (src->quit)
+		{
+			pthread_mutex_unlock(&src->lock);
+			break;
+		}
+		if (cnt <= 0)
+		{
+			pthread_mutex_unlock(&src->lock);
+			usleep(10*1000);
+			continue;
+		}
+
+		cnt += left;
+		pos = 0;
+		while (pos + 188 <= cnt)
+		{
+			if (buf[pos] != 0x47)
+			{
+				pos++;
+				continue;
+			}
+
+			am_rec_source_dispatch(src, buf + pos);
+			pos += 188;
+		}
+		pthread_cond_broadcast(&src->cond);
+		pthread_mutex_unlock(&src->lock);
+
+		/*保留不完整的包*/
+		left = cnt - pos;
+		if (left)
+			memmove(buf, buf + pos, left);
+	}
+
+	free(buf);
+
+	return NULL;
+}
+
+/**\brief 设置录像在数据源中接收的PID*/
+static void am_rec_set_source_pids(AM_REC_Recorder_t *rec, AM_DVR_StartRecPara_t *spara)
+{
+	int i;
+
+	memset(rec->src_pids, 0, sizeof(rec->src_pids));
+	am_rec_get_pids(rec, spara);
+	for (i = 0; i < spara->pid_count; i++)
+	{
+		if (spara->pids[i] >= 0)
+			REC_PID_SET(rec->src_pids, spara->pids[i]);
+	}
+}
+
+/**\brief 开始录像前检查加入数据源后DVR设备需要的PID数是否超出限制*/
+static AM_ErrorCode_t am_rec_source_check_pids(AM_REC_Recorder_t *rec)
+{
+	AM_REC_Source_t *src;
+	AM_DVR_StartRecPara_t spara;
+	AM_ErrorCode_t ret = AM_SUCCESS;
+	int cnt;
+
+	am_rec_set_source_pids(rec, &spara);
+
+	pthread_mutex_lock(&rec_source_lock);
+	for (src = rec_sources; src; src = src->next)
+	{
+		if (src->dvr_dev == rec->create_para.dvr_dev)
+			break;
+	}
+	if (src)
+	{
+		pthread_mutex_lock(&src->lock);
+		if ((cnt = am_rec_source_count_pids(src, rec)) > AM_DVR_MAX_PID_COUNT)
+		{
+			AM_DEBUG(0, "DVR%d: the recordings need %d PIDs, only %d supported",
+					src->dvr_dev, cnt, AM_DVR_MAX_PID_COUNT);
+			ret = AM_REC_ERR_TOO_MANY_STREAMS;
+		}
+		pthread_mutex_unlock(&src->lock);
+	}
+	pthread_mutex_unlock(&rec_source_lock);
+
+	return ret;
+}
+
+/**\brief 加入DVR设备的数据源，没有数据源时打开DVR设备并创建数据源*/
+static AM_ErrorCode_t am_rec_source_attach(AM_REC_Recorder_t *rec)
+{
+	AM_REC_Source_t *src;
+	AM_DVR_StartRecPara_t spara;
+	AM_DVR_OpenPara_t para;
+	pthread_condattr_t attr;
+	AM_ErrorCode_t ret = AM_SUCCESS;
+	AM_Bool_t created = AM_FALSE;
+	int rc;
+
+	rec->src_buf = (uint8_t *)malloc(REC_SOURCE_BUF_SIZE);
+	if (!rec->src_buf)
+	{
+		AM_DEBUG(0, "no enough memory for record buffer");
+		return AM_REC_ERR_NO_MEM;
+	}
+	rec->src_head = 0;
+	rec->src_len  = 0;
+	rec->src_lost = 0;
+
+	am_rec_set_source_pids(rec, &spara);
+
+	pthread_mutex_lock(&rec_source_lock);
+
+	for (src = rec_sources; src; src = src->next)
+	{
+		if (src->dvr_dev == rec->create_para.dvr_dev)
+			break;
+	}
+
+	if (!src)
+	{
+		src = (AM_REC_Source_t *)malloc(sizeof(AM_REC_Source_t));
+		if (!src)
+		{
+			AM_DEBUG(0, "no enough memory for DVR source");
+			ret = AM_REC_ERR_NO_MEM;
+			goto end;
+		}
+		memset(src, 0, sizeof(AM_REC_Source_t));
+		src->dvr_dev = rec->create_para.dvr_dev;
+
+		memset(&para, 0, sizeof(para));
+		if (AM_DVR_Open(src->dvr_dev, &para) != AM_SUCCESS)
+		{
+			AM_DEBUG(0, "Open DVR%d failed", src->dvr_dev);
+			free(src);
+			ret = AM_REC_ERR_DVR;
+			goto end;
+		}
+		AM_DVR_SetSource(src->dvr_dev, rec->create_para.async_fifo_id);
+
+		pthread_mutex_init(&src->lock, NULL);
+		pthread_condattr_init(&attr);
+		pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+		pthread_cond_init(&src->cond, &attr);
+		pthread_condattr_destroy(&attr);
+		created = AM_TRUE;
+	}
+
+	pthread_mutex_lock(&src->lock);
+	/*DVR设备能过滤的PID数有限，超出时不加入，避免其他录像的PID被丢弃
+	 *开始录像时已检查过，这里防止检查后又有录像加入*/
+	if ((rc = am_rec_source_count_pids(src, rec)) > AM_DVR_MAX_PID_COUNT)
+	{
+		AM_DEBUG(0, "DVR%d: the recordings need %d PIDs, only %d supported",
+				src->dvr_dev, rc, AM_DVR_MAX_PID_COUNT);
+		ret = AM_REC_ERR_TOO_MANY_STREAMS;
+	}
+	else
+	{
+		rec->src_next = src->outputs;
+		src->outputs = rec;
+		rec->source = src;
+	}
+	if ((ret == AM_SUCCESS) && (am_rec_source_update_pids(src) != AM_SUCCESS))
+	{
+		AM_DEBUG(0, "Start DVR%d failed", src->dvr_dev);
+		src->outputs = rec->src_next;
+		rec->source = NULL;
+		am_rec_source_update_pids(src);
+		ret = AM_REC_ERR_DVR;
+	}
+	pthread_mutex_unlock(&src->lock);
+
+	if (created && (ret == AM_SUCCESS))
+	{
+		rc = pthread_create(&src->thread, NULL, am_rec_source_thread, (void*)src);
+		if (rc)
+		{
+			AM_DEBUG(0, "Create DVR%d source thread failed: %s", src->dvr_dev, strerror(rc));
+			rec->source = NULL;
+			ret = AM_REC_ERR_CANNOT_CREATE_THREAD;
+		}
+	}
+
+	if (created)
+	{
+		if (ret == AM_SUCCESS)
+		{
+			src->next = rec_sources;
+			rec_sources = src;
+		}
+		else
+		{
+			AM_DVR_StopRecord(src->dvr_dev);
+			AM_DVR_Close(src->dvr_dev);
+			pthread_mutex_destroy(&src->lock);
+			pthread_cond_destroy(&src->cond);
+			free(src);
+		}
+	}
+
+	if (ret == AM_SUCCESS)
+		AM_DEBUG(1, "Record joined DVR%d source, %d PIDs", rec->create_para.dvr_dev, spara.pid_count);
+
+end:
+	pthread_mutex_unlock(&rec_source_lock);
+
+	if (ret != AM_SUCCESS)
+	{
+		free(rec->src_buf);
+		rec->src_buf = NULL;
+	}
+
+	return ret;
+}
+
+/**\brief 离开数据源，最后一个录像离开时关闭DVR设备*/
+static void am_rec_source_detach(AM_REC_Recorder_t *rec)
+{
+	AM_REC_Source_t *src = rec->source;
+	AM_REC_Recorder_t **prec;
+	AM_REC_Source_t **psrc;
+	AM_Bool_t last;
+
+	pthread_mutex_lock(&rec_source_lock);
+
+	pthread_mutex_lock(&src->lock);
+	for (prec = &src->outputs; *prec; prec = &(*prec)->src_next)
+	{
+		if (*prec == rec)
+		{
+			*prec = rec->src_next;
+			break;
+		}
+	}
+	if (src->outputs)
+		am_rec_source_update_pids(src);
+	else
+		src->quit = AM_TRUE;
+	last = src->quit;
+	pthread_mutex_unlock(&src->lock);
+
+	if (last)
+	{
+		pthread_join(src->thread, NULL);
+		AM_DVR_StopRecord(src->dvr_dev);
+		AM_DVR_Close(src->dvr_dev);
+
+		for (psrc = &rec_sources; *psrc; psrc = &(*psrc)->next)
+		{
+			if (*psrc == src)
+			{
+				*psrc = src->next;
+				break;
+			}
+		}
+
+		pthread_mutex_destroy(&src->lock);
+		pthread_cond_destroy(&src->cond);
+		free(src);
+	}
+
+	pthread_mutex_unlock(&rec_source_lock);
+
+	if (rec->src_lost)
+		AM_DEBUG(1, "%d packets lost in record buffer", rec->src_lost);
+
+	free(rec->src_buf);
+	rec->src_buf = NULL;
+	rec->source = NULL;
+}
+
+/**\brief 从数据源读取本录像的TS包，返回读取的字节数*/
+static int am_rec_source_read(AM_REC_Recorder_t *rec, uint8_t *buf, int size, int timeout_ms)
+{
+	AM_REC_Source_t *src = rec->source;
+	struct timespec ts;
+	int cnt, n;
+
+	pthread_mutex_lock(&src->lock);
+
+	/*其他录像的数据也会唤醒等待*/
+	AM_TIME_GetTimeSpecTimeout(timeout_ms, &ts);
+	while (!rec->src_len && (rec->stat_flag & REC_STAT_FL_RECORDING))
+	{
+		if (pthread_cond_timedwait(&src->cond, &src->lock, &ts) == ETIMEDOUT)
+			break;
+	}
+
+	cnt = AM_MIN(size, rec->src_len);
+	n = AM_MIN(cnt, REC_SOURCE_BUF_SIZE - rec->src_head);
+	memcpy(buf, rec->src_buf + rec->src_head, n);
+	memcpy(buf + n, rec->src_buf, cnt - n);
+	rec->src_head = (rec->src_head + cnt) % REC_SOURCE_BUF_SIZE;
+	rec->src_len -= cnt;
+
+	pthread_mutex_unlock(&src->lock);
+
+	return cnt;
+}
+
+/**\brief 在指定位置写入数据，返回写入的字节数*/
+static int am_rec_file_write(int fd, const uint8_t *buf, int size, off64_t off, int *err)
+{
+	int ret;
+	int left = size;
+	const uint8_t *p = buf;
+
+	while (left > 0)
+	{
+		ret = pwrite64(fd, p, left, off);
+		if (ret == -1)
+		{
+			if (err)
+				*err = errno;
+			if (errno != EINTR)
+			{
+				AM_DEBUG(0, "Write record data failed: %s", strerror(errno));
+				break;
+			}
+			ret = 0;
+		}
+
+		left -= ret;
+		p += ret;
+		off += ret;
+	}
+
+	return (size - left);
+}
+
+/**\brief 将录像时间写入文件头*/
+static void am_rec_write_record_time(AM_REC_Recorder_t *rec, int rec_time)
+{
+	uint8_t buf[4];
+
+	buf[0] = (uint8_t)(((rec_time)&0xff000000) >> 24);
+	buf[1] = (uint8_t)(((rec_time)&0x00ff0000) >> 16);
+	buf[2] = (uint8_t)(((rec_time)&0x0000ff00) >> 8);
+	buf[3] = (uint8_t)((rec_time)&0x000000ff);
+
+	am_rec_file_write(rec->rec_fd, buf, sizeof(buf), 4, NULL);
+}
+
+/**\brief 将缓冲区中已写入文件的新数据加入索引*/
+static void am_rec_writer_index(AM_REC_Recorder_t *rec, AM_REC_WriteBuf_t *wb, int *done, int end, off64_t shift)
+{
+	if (rec->index && (end > *done))
+		AM_TIndex_Parse(rec->index, wb->data + *done, end - *done, wb->off + *done + shift);
+
+	*done = AM_MAX(*done, end);
+}
+
+/**\brief 以十六进制写入一段数据*/
+static void am_rec_meta_put_hex(FILE *fp, const uint8_t *data, int len)
+{
+	int i;
+
+	for (i = 0; i < len; i++)
+		fprintf(fp, "%02x", data[i]);
+}
+
+/**\brief 解析十六进制数据，返回AM_TRUE表示正好解析了len字节*/
+static AM_Bool_t am_rec_meta_get_hex(const char *str, uint8_t *data, int len)
+{
+	unsigned int v;
+	int i;
+
+	for (i = 0; i < len; i++)
+	{
+		if (!isxdigit((unsigned char)str[0]) || !isxdigit((unsigned char)str[1]))
+			return AM_FALSE;
+		sscanf(str, "%2x", &v);
+		data[i] = (uint8_t)v;
+		str += 2;
+	}
+
+	return (*str == 0) ? AM_TRUE : AM_FALSE;
+}
+
+/**\brief 写元数据文件，先写入临时文件再改名，读取者不会看到不完整的文件*/
+static void am_rec_write_meta(AM_REC_Recorder_t *rec, const AM_REC_Meta_t *meta)
+{
+	AM_REC_MediaInfo_t *pp = &rec->rec_para.media_info;
+	char tmp[sizeof(rec->meta_file_name) + 4];
+	FILE *fp;
+	int i, cnt;
+
+	snprintf(tmp, sizeof(tmp), "%s.tmp", rec->meta_file_name);
+	fp = fopen(tmp, "w");
+	if (!fp)
+	{
+		AM_DEBUG(1, "Cannot open metadata file '%s', %s", tmp, strerror(errno));
+		return;
+	}
+
+	fprintf(fp, "version=%d\n", REC_META_VERSION);
+	fprintf(fp, "complete=%d\n", meta->complete ? 1 : 0);
+	fprintf(fp, "duration=%d\n", meta->duration);
+	fprintf(fp, "size=%lld\n", (long long)meta->size);
+	fprintf(fp, "packets=%lld\n", (long long)(meta->size / 188));
+	fprintf(fp, "dropped=%lld\n", (long long)meta->dropped);
+
+	/*名称和语言可能不以0结尾，以十六进制保存*/
+	fprintf(fp, "program_name=");
+	am_rec_meta_put_hex(fp, (const uint8_t *)pp->program_name, sizeof(pp->program_name));
+	fprintf(fp, "\nvideo=%d,%d\n", pp->vid_pid, pp->vid_fmt);
+
+	cnt = AM_MIN(pp->aud_cnt, (int)AM_ARRAY_SIZE(pp->audios));
+	for (i = 0; i < cnt; i++)
+	{
+		fprintf(fp, "audio=%d,%d,", pp->audios[i].pid, pp->audios[i].fmt);
+		am_rec_meta_put_hex(fp, (const uint8_t *)pp->audios[i].lang, sizeof(pp->audios[i].lang));
+		fprintf(fp, "\n");
+	}
+	cnt = AM_MIN(pp->sub_cnt, (int)AM_ARRAY_SIZE(pp->subtitles));
+	for (i = 0; i < cnt; i++)
+	{
+		fprintf(fp, "subtitle=%d,%d,%d,%d,%d,%d,", pp->subtitles[i].pid, pp->subtitles[i].type,
+			pp->subtitles[i].composition_page, pp->subtitles[i].ancillary_page,
+			pp->subtitles[i].magzine_no, pp->subtitles[i].page_no);
+		am_rec_meta_put_hex(fp, (const uint8_t *)pp->subtitles[i].lang, sizeof(pp->subtitles[i].lang));
+		fprintf(fp, "\n");
+	}
+	cnt = AM_MIN(pp->ttx_cnt, (int)AM_ARRAY_SIZE(pp->teletexts));
+	for (i = 0; i < cnt; i++)
+	{
+		fprintf(fp, "teletext=%d,%d,%d,", pp->teletexts[i].pid,
+			pp->teletexts[i].magzine_no, pp->teletexts[i].page_no);
+		am_rec_meta_put_hex(fp, (const uint8_t *)pp->teletexts[i].lang, sizeof(pp->teletexts[i].lang));
+		fprintf(fp, "\n");
+	}
+#ifdef SUPPORT_CAS
+	if (rec->cas_info_len > 0)
+	{
+		fprintf(fp, "cas_block_size=%u\ncas_info=", rec->cas_blk_size);
+		am_rec_meta_put_hex(fp, rec->cas_info, rec->cas_info_len);
+		fprintf(fp, "\n");
+	}
+#endif
+
+	if (fflush(fp) || fdatasync(fileno(fp)))
+	{
+		AM_DEBUG(1, "Cannot write metadata file '%s', %s", tmp, strerror(errno));
+		fclose(fp);
+		unlink(tmp);
+		return;
+	}
+	fclose(fp);
+
+	if (rename(tmp, rec->meta_file_name))
+	{
+		AM_DEBUG(1, "Cannot rename metadata file '%s', %s", tmp, strerror(errno));
+		unlink(tmp);
+	}
+}
+
+/**\brief 从元数据文件读取媒体信息*/
+static AM_ErrorCode_t am_rec_read_meta(const char *file_path, AM_REC_MediaInfo_t *info)
+{
+	char name[AM_REC_PATH_MAX + sizeof(AM_REC_META_SUFFIX)];
+	char line[REC_META_LINE_MAX];
+	char hex[REC_META_LINE_MAX];
+	AM_Bool_t valid = AM_FALSE;
+	FILE *fp;
+	char *val;
+
+	snprintf(name, sizeof(name), "%s"AM_REC_META_SUFFIX, file_path);
+	fp = fopen(name, "r");
+	if (!fp)
+		return AM_REC_ERR_CANNOT_OPEN_FILE;
+
+	memset(info, 0, sizeof(AM_REC_MediaInfo_t));
+
+	/*不认识的项忽略，新版本可以增加新的项*/
+	while (fgets(line, sizeof(line), fp))
+	{
+		line[strcspn(line, "\r\n")] = 0;
+		val = strchr(line, '=');
+		if (!val)
+			continue;
+		*val++ = 0;
+
+		if (!strcmp(line, "version"))
+		{
+			valid = AM_TRUE;
+		}
+		else if (!strcmp(line, "duration"))
+		{
+			sscanf(val, "%d", &info->duration);
+		}
+		else if (!strcmp(line, "program_name"))
+		{
+			am_rec_meta_get_hex(val, (uint8_t *)info->program_name, sizeof(info->program_name));
+			info->program_name[sizeof(info->program_name) - 1] = 0;
+		}
+		else if (!strcmp(line, "video"))
+		{
+			sscanf(val, "%d,%d", &info->vid_pid, &info->vid_fmt);
+		}
+		else if (!strcmp(line, "audio") && (info->aud_cnt < (int)AM_ARRAY_SIZE(info->audios)))
+		{
+			AM_REC_MediaInfo_t *pp = info;
+			int i = pp->aud_cnt;
+
+			if ((sscanf(val, "%d,%d,%s", &pp->audios[i].pid, &pp->audios[i].fmt, hex) == 3) &&
+				am_rec_meta_get_hex(hex, (uint8_t *)pp->audios[i].lang, sizeof(pp->audios[i].lang)))
+				pp->aud_cnt++;
+		}
+		else if (!strcmp(line, "subtitle") && (info->sub_cnt < (int)AM_ARRAY_SIZE(info->subtitles)))
+		{
+			AM_REC_MediaInfo_t *pp = info;
+			int i = pp->sub_cnt;
+
+			if ((sscanf(val, "%d,%d,%d,%d,%d,%d,%s", &pp->subtitles[i].pid, &pp->subtitles[i].type,
+					&pp->subtitles[i].composition_page, &pp->subtitles[i].ancillary_page,
+					&pp->subtitles[i].magzine_no, &pp->subtitles[i].page_no, hex) == 7) &&
+				am_rec_meta_get_hex(hex, (uint8_t *)pp->subtitles[i].lang, sizeof(pp->subtitles[i].lang)))
+				pp->sub_cnt++;
+		}
+		else if (!strcmp(line, "teletext") && (info->ttx_cnt < (int)AM_ARRAY_SIZE(info->teletexts)))
+		{
+			AM_REC_MediaInfo_t *pp = info;
+			int i = pp->ttx_cnt;
+
+			if ((sscanf(val, "%d,%d,%d,%s", &pp->teletexts[i].pid, &pp->teletexts[i].magzine_no,
+					&pp->teletexts[i].page_no, hex) == 4) &&
+				am_rec_meta_get_hex(hex, (uint8_t *)pp->teletexts[i].lang, sizeof(pp->teletexts[i].lang)))
+				pp->ttx_cnt++;
+		}
+	}
+
+	fclose(fp);
+
+	if (!valid)
+	{
+		AM_DEBUG(1, "Invalid metadata file '%s'", name);
+		return AM_REC_ERR_INVALID_PARAM;
+	}
+
+	return AM_SUCCESS;
+}
+
+/**\brief 取得当前的元数据*/
+static void am_rec_get_meta(AM_REC_Recorder_t *rec, AM_REC_Meta_t *meta)
+{
+	int now;
+
+	memset(meta, 0, sizeof(AM_REC_Meta_t));
+
+	if (rec->rec_start_time != 0)
+	{
+		AM_TIME_GetClock(&now);
+		meta->duration = (now - rec->rec_start_time)/1000;
+	}
+
+	meta->size = rec->rec_size;
+
+	if (rec->source)
+	{
+		pthread_mutex_lock(&rec->source->lock);
+		meta->dropped = rec->src_lost;
+		pthread_mutex_unlock(&rec->source->lock);
+	}
+	else
+	{
+		meta->dropped = rec->src_lost;
+	}
+}
+
+/**\brief 将一个缓冲区中的数据写入文件，返回错误码(errno)*/
+static int am_rec_writer_output(AM_REC_Recorder_t *rec, AM_REC_WriteBuf_t *wb)
+{
+	AM_REC_Writer_t *w = &rec->writer;
+	uint8_t *p = wb->data;
+	off64_t off = wb->off;
+	int len = wb->len;
+	int done = wb->start;
+	int cnt, err = 0;
+
+	if (w->direct_fd != -1)
+	{
+		/*对齐的部分绕过页缓存写入，末尾不对齐的部分先普通写入，下一个缓冲区会重新对齐写入*/
+		int alen = len & ~(w->align - 1);
+
+		cnt = am_rec_file_write(w->direct_fd, p, alen, off, &err);
+		am_rec_writer_index(rec, wb, &done, cnt, 0);
+		if (cnt != alen)
+		{
+			AM_DEBUG(1, "O_DIRECT write failed (%s), use buffered write", strerror(err));
+			close(w->direct_fd);
+			w->direct_fd = -1;
+		}
+		p   += cnt;
+		off += cnt;
+		len -= cnt;
+	}
+	else
+	{
+		p   += wb->start;
+		off += wb->start;
+		len -= wb->start;
+	}
+
+	while (len > 0)
+	{
+		cnt = am_rec_file_write(rec->rec_fd, p, len, off + w->shift, &err);
+		p   += cnt;
+		off += cnt;
+		len -= cnt;
+		am_rec_writer_index(rec, wb, &done, p - wb->data, w->shift);
+
+		if (!len)
+			break;
+
+		if (err != EFBIG)
+			return err;
+
+		AM_DEBUG(1, "EFBIG detected, automatically write to a new file!");
+		if (w->direct_fd != -1)
+		{
+			close(w->direct_fd);
+			w->direct_fd = -1;
+		}
+		if (am_rec_auto_switch_file(rec) != AM_SUCCESS)
+			return err;
+
+		w->shift = lseek64(rec->rec_fd, 0, SEEK_END) - off;
+	}
+
+	w->unsynced += wb->len - wb->start;
+	if ((w->para.sync_size > 0) && (w->unsynced >= w->para.sync_size))
+	{
+		fdatasync(rec->rec_fd);
+		w->unsynced = 0;
 	}
-	
-    /* In order to be compatible with libplayer, we pack it as a ts packet */
-	lseek64(rec->rec_fd, 0, SEEK_SET);
-	am_rec_packet_data(rec->rec_fd, header_pid, stream, pos, 1);
-	
-	return AM_SUCCESS;
+
+	return 0;
 }
 
-static AM_ErrorCode_t am_rec_update_record_time(AM_REC_Recorder_t *rec)
+/**\brief 将正在填充的缓冲区交给写文件线程，需在writer锁保护下调用*/
+static void am_rec_writer_queue(AM_REC_Writer_t *w)
 {
-	int now, rec_time;
-	off64_t cur_pos;
-	uint8_t buf[4];
+	w->full++;
+	w->fill = -1;
+	w->has_prev = AM_TRUE;
+	pthread_cond_broadcast(&w->cond);
+}
 
-	if (rec->rec_start_time != 0)
-	{
-		cur_pos = lseek64(rec->rec_fd, 0, SEEK_CUR);
-		
-		AM_TIME_GetClock(&now);
-		rec_time = (now - rec->rec_start_time)/1000;
-		lseek64(rec->rec_fd, 4, SEEK_SET);
+/**\brief 开始填充一个新的缓冲区，需在writer锁保护下调用
+ * 使用O_DIRECT时缓冲区从对齐的文件偏移开始，之前的数据从上一个缓冲区或文件中复制*/
+static void am_rec_writer_prime(AM_REC_Recorder_t *rec, int idx)
+{
+	AM_REC_Writer_t *w = &rec->writer;
+	AM_REC_WriteBuf_t *wb = &w->bufs[idx];
 
-		buf[0] = (uint8_t)(((rec_time)&0xff000000) >> 24);
-		buf[1] = (uint8_t)(((rec_time)&0x00ff0000) >> 16);
-		buf[2] = (uint8_t)(((rec_time)&0x0000ff00) >> 8);
-		buf[3] = (uint8_t)((rec_time)&0x000000ff);
+	wb->start = (int)(w->next_off % w->align);
+	wb->off   = w->next_off - wb->start;
+	wb->len   = wb->start;
 
-		write(rec->rec_fd, buf, sizeof(buf));
+	if (!wb->start)
+		return;
 
-		lseek64(rec->rec_fd, cur_pos, SEEK_SET);
-	}	
+	if (w->has_prev)
+	{
+		AM_REC_WriteBuf_t *prev = &w->bufs[(idx + w->para.buf_count - 1) % w->para.buf_count];
 
-	return AM_SUCCESS;
+		memcpy(wb->data, prev->data + prev->len - wb->start, wb->start);
+	}
+	else if (pread64(rec->rec_fd, wb->data, wb->start, wb->off) != wb->start)
+	{
+		/*无法读出文件头，这个缓冲区不使用O_DIRECT*/
+		wb->off  += wb->start;
+		wb->start = 0;
+		wb->len   = 0;
+	}
 }
 
-static AM_ErrorCode_t am_rec_gen_next_file_name(AM_REC_Recorder_t *rec, const char *prefix, const char *suffix)
-{	
-	struct stat st;
-	
-	do
+/**\brief 写文件线程*/
+static void *am_rec_writer_thread(void *arg)
+{
+	AM_REC_Recorder_t *rec = (AM_REC_Recorder_t *)arg;
+	AM_REC_Writer_t *w = &rec->writer;
+	struct timespec ts;
+	int now, err, rec_time;
+	AM_REC_Meta_t meta;
+
+	pthread_mutex_lock(&w->lock);
+
+	while (1)
 	{
-		if (rec->rec_file_index <= 1)
+		/*超时或退出时写出未满的缓冲区*/
+		if (!w->full && (w->fill != -1))
 		{
-			snprintf(rec->rec_file_name, sizeof(rec->rec_file_name), 
-				"%s/%s.%s", rec->create_para.store_dir, prefix, suffix);
+			AM_REC_WriteBuf_t *wb = &w->bufs[w->fill];
+
+			AM_TIME_GetClock(&now);
+			if ((wb->len > wb->start) && (w->quit || (now - wb->fill_time >= w->para.flush_time)))
+				am_rec_writer_queue(w);
 		}
-		else
+
+		if (w->full)
 		{
-			snprintf(rec->rec_file_name, sizeof(rec->rec_file_name), 
-				"%s/%s-%d.%s", rec->create_para.store_dir, prefix, 
-				rec->rec_file_index, suffix);
+			AM_REC_WriteBuf_t *wb = &w->bufs[w->head];
+
+			if (!w->err)
+			{
+				pthread_mutex_unlock(&w->lock);
+				err = am_rec_writer_output(rec, wb);
+				pthread_mutex_lock(&w->lock);
+
+				if (err)
+					w->err = err;
+				if (w->direct_fd == -1)
+					w->align = 1;
+			}
+
+			w->head = (w->head + 1) % w->para.buf_count;
+			w->full--;
+			pthread_cond_broadcast(&w->cond);
+			continue;
 		}
-		
-		if (!stat(rec->rec_file_name, &st))
+
+		/*文件头的更新合并到数据写入之后*/
+		if (w->rec_time != -1)
 		{
-			AM_DEBUG(1, "PVR file '%s' already exist.", rec->rec_file_name);
-			rec->rec_file_index++;
-			
+			rec_time = w->rec_time;
+			w->rec_time = -1;
+
+			pthread_mutex_unlock(&w->lock);
+			am_rec_write_record_time(rec, rec_time);
+			pthread_mutex_lock(&w->lock);
 			continue;
 		}
-		else if (errno == ENOENT)
+
+		if (w->meta_dirty)
 		{
-			AM_DEBUG(1, "PVR file is assigned to '%s'", rec->rec_file_name);
-			break;
+			meta = w->meta;
+			w->meta_dirty = AM_FALSE;
+
+			pthread_mutex_unlock(&w->lock);
+			am_rec_write_meta(rec, &meta);
+			pthread_mutex_lock(&w->lock);
+			continue;
 		}
-		else
-		{
-			AM_DEBUG(1, "Searching PVR files failed, error: %s", strerror(errno));
-			if (errno == EACCES)
-				return AM_REC_ERR_CANNOT_ACCESS_FILE;
-			
-			return AM_REC_ERR_CANNOT_OPEN_FILE;
-		}	
 
-		if (rec->rec_file_index == INT_MAX)
+		if (w->quit)
+			break;
+
+		AM_TIME_GetTimeSpecTimeout(w->para.flush_time, &ts);
+		pthread_cond_timedwait(&w->cond, &w->lock, &ts);
+	}
+
+	pthread_mutex_unlock(&w->lock);
+
+	return NULL;
+}
+
+/**\brief 释放写文件线程的缓冲区*/
+static void am_rec_writer_free(AM_REC_Writer_t *w)
+{
+	int i;
+
+	for (i = 0; i < REC_WRITER_MAX_BUFS; i++)
+	{
+		if (w->bufs[i].data)
 		{
-			/* Is this possible? */
-			AM_DEBUG(1, "Too many sub-files!");
-			return AM_REC_ERR_CANNOT_OPEN_FILE;
+			free(w->bufs[i].data);
+			w->bufs[i].data = NULL;
 		}
-		
-		rec->rec_file_index++;
-	}while(1);
+	}
 
-	return AM_SUCCESS;
+	if (w->direct_fd != -1)
+	{
+		close(w->direct_fd);
+		w->direct_fd = -1;
+	}
 }
 
-static AM_ErrorCode_t am_rec_auto_switch_file(AM_REC_Recorder_t *rec)
+/**\brief 启动写文件线程*/
+static AM_ErrorCode_t am_rec_writer_start(AM_REC_Recorder_t *rec)
 {
-	if (rec->rec_fd >= 0)
+	AM_REC_Writer_t *w = &rec->writer;
+	pthread_condattr_t attr;
+	int i, rc;
+
+	memset(w, 0, sizeof(AM_REC_Writer_t));
+	w->para = rec->writer_para;
+	w->fill = -1;
+	w->rec_time = -1;
+	w->direct_fd = -1;
+	w->align = 1;
+
+	if (w->para.buf_size <= 0)
+		w->para.buf_size = REC_WRITER_BUF_SIZE;
+	w->para.buf_size = (w->para.buf_size + REC_WRITER_ALIGN - 1) & ~(REC_WRITER_ALIGN - 1);
+	if (w->para.buf_count <= 0)
+		w->para.buf_count = REC_WRITER_BUF_COUNT;
+	w->para.buf_count = AM_MAX(w->para.buf_count, 2);
+	w->para.buf_count = AM_MIN(w->para.buf_count, REC_WRITER_MAX_BUFS);
+	if (w->para.flush_time <= 0)
+		w->para.flush_time = REC_WRITER_FLUSH_TIME;
+
+	for (i = 0; i < w->para.buf_count; i++)
 	{
-		close(rec->rec_fd);
-		rec->rec_fd = -1;
+		if (posix_memalign((void**)&w->bufs[i].data, REC_WRITER_ALIGN, w->para.buf_size))
+		{
+			w->bufs[i].data = NULL;
+			AM_DEBUG(0, "no enough memory for record writer");
+			am_rec_writer_free(w);
+			return AM_REC_ERR_NO_MEM;
+		}
 	}
 
-	/* try to create the new record sub-file */
-	AM_TRY(am_rec_gen_next_file_name(rec, rec->rec_para.prefix_name, rec->rec_para.suffix_name));
+	w->next_off = lseek64(rec->rec_fd, 0, SEEK_END);
 
-	rec->rec_fd = open(rec->rec_file_name, O_TRUNC|O_CREAT|O_WRONLY, 0666);
-	if (rec->rec_fd == -1)
+	am_rec_index_open(rec);
+
+#ifdef O_DIRECT
+	if (w->para.direct_io)
 	{
-		AM_DEBUG(1, "Cannot open new file '%s', record aborted.", rec->rec_file_name);
-		return AM_REC_ERR_CANNOT_OPEN_FILE;
+		w->direct_fd = open(rec->rec_file_name, O_WRONLY|O_DIRECT);
+		if (w->direct_fd == -1)
+			AM_DEBUG(1, "Cannot open '%s' with O_DIRECT (%s), use buffered write", rec->rec_file_name, strerror(errno));
+		else
+			w->align = REC_WRITER_ALIGN;
 	}
+#endif
 
-	am_rec_insert_file_header(rec);
+	pthread_mutex_init(&w->lock, NULL);
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&w->cond, &attr);
+	pthread_condattr_destroy(&attr);
 
-	am_rec_insert_pat(rec);
+	rc = pthread_create(&w->thread, NULL, am_rec_writer_thread, (void*)rec);
+	if (rc)
+	{
+		AM_DEBUG(0, "Create record writer thread failed: %s", strerror(rc));
+		pthread_mutex_destroy(&w->lock);
+		pthread_cond_destroy(&w->cond);
+		am_rec_writer_free(w);
+		am_rec_index_close(rec);
+		return AM_REC_ERR_CANNOT_CREATE_THREAD;
+	}
+
+	w->running = AM_TRUE;
 
 	return AM_SUCCESS;
 }
 
-static AM_ErrorCode_t am_rec_start_dvr(AM_REC_Recorder_t *rec)
+/**\brief 写出所有数据并停止写文件线程*/
+static void am_rec_writer_stop(AM_REC_Recorder_t *rec)
 {
-	int i;
-	AM_DVR_StartRecPara_t spara;
-	AM_REC_MediaInfo_t *minfo = &rec->rec_para.media_info;
+	AM_REC_Writer_t *w = &rec->writer;
 
-#define ADD_PID(_pid)\
-	AM_MACRO_BEGIN\
-		if ((_pid) < 0x1fff && spara.pid_count < AM_DVR_MAX_PID_COUNT)\
-			spara.pids[spara.pid_count++] = (_pid);\
-	AM_MACRO_END
+	if (!w->running)
+		return;
 
-	spara.pid_count = 0;
-	ADD_PID(minfo->vid_pid);
-	for (i=0; i<minfo->aud_cnt; i++)
-	{
-		ADD_PID(minfo->audios[i].pid);
-	}
-	for (i=0; i<minfo->sub_cnt; i++)
-	{
-		ADD_PID(minfo->subtitles[i].pid);
-	}
-	for (i=0; i<minfo->ttx_cnt; i++)
-	{
-		ADD_PID(minfo->teletexts[i].pid);
-	}
+	pthread_mutex_lock(&w->lock);
+	w->quit = AM_TRUE;
+	pthread_cond_broadcast(&w->cond);
+	pthread_mutex_unlock(&w->lock);
 
-	if (rec->rec_para.program.i_pid != 0)
-		ADD_PID(rec->rec_para.program.i_pid);
+	pthread_join(w->thread, NULL);
 
-	for (i = 0; i < rec->rec_para.ext_pids.count; i++) {
-		if (rec->rec_para.ext_pids.pids[i] != 0)
-			ADD_PID(rec->rec_para.ext_pids.pids[i]);
-	}
+	pthread_mutex_destroy(&w->lock);
+	pthread_cond_destroy(&w->cond);
+	am_rec_writer_free(w);
+	am_rec_index_close(rec);
+	w->running = AM_FALSE;
+}
 
-	return AM_DVR_StartRecord(rec->create_para.dvr_dev, &spara);
+/**\brief 取得下一个录像数据在文件中的位置*/
+static AM_INLINE off64_t am_rec_writer_tell(AM_REC_Recorder_t *rec)
+{
+	AM_REC_Writer_t *w = &rec->writer;
+	off64_t pos;
+
+	pthread_mutex_lock(&w->lock);
+	pos = w->next_off + w->shift;
+	pthread_mutex_unlock(&w->lock);
+
+	return pos;
 }
 
-/**\brief 写录像数据到文件*/
+/**\brief 写录像数据到文件，数据复制到缓冲区后由写文件线程写入*/
 static int am_rec_data_write(AM_REC_Recorder_t *rec, uint8_t *buf, int size, int *err)
 {
-	int ret;
+	AM_REC_Writer_t *w = &rec->writer;
 	int left = size;
 	uint8_t *p = buf;
 
-	while (left > 0)
+	pthread_mutex_lock(&w->lock);
+
+	while ((left > 0) && !w->err)
 	{
-		ret = write(rec->rec_fd, p, left);
-		if (err)
-			*err = errno;
-		if (ret == -1)
+		AM_REC_WriteBuf_t *wb;
+		int cnt;
+
+		if (w->fill == -1)
 		{
-			if (errno == EFBIG)
-			{
-				AM_DEBUG(1, "EFBIG detected, automatically write to a new file!");
-				
-				if (am_rec_auto_switch_file(rec) != AM_SUCCESS)
-					break;
-			}
-			else if (errno != EINTR)
-			{
-				AM_DEBUG(0, "Write record data failed: %s", strerror(errno));
+			/*所有缓冲区都在等待写入，存储设备跟不上*/
+			while ((w->full >= w->para.buf_count) && !w->err)
+				pthread_cond_wait(&w->cond, &w->lock);
+			if (w->err)
 				break;
-			}
-			ret = 0;
+
+			w->fill = (w->head + w->full) % w->para.buf_count;
+			am_rec_writer_prime(rec, w->fill);
 		}
-		
-		left -= ret;
-		p += ret;
+
+		wb = &w->bufs[w->fill];
+		if (wb->len == wb->start)
+			AM_TIME_GetClock(&wb->fill_time);
+
+		cnt = AM_MIN(left, w->para.buf_size - wb->len);
+		memcpy(wb->data + wb->len, p, cnt);
+		wb->len     += cnt;
+		w->next_off += cnt;
+		p    += cnt;
+		left -= cnt;
+
+		if (wb->len == w->para.buf_size)
+			am_rec_writer_queue(w);
 	}
 
+	if (err)
+		*err = w->err;
+
+	pthread_mutex_unlock(&w->lock);
+
 	return (size - left);
 }
 
+/**\brief 更新文件头中的录像时间，使用元数据文件时定期更新元数据文件*/
+static AM_ErrorCode_t am_rec_update_record_time(AM_REC_Recorder_t *rec)
+{
+	AM_REC_Writer_t *w = &rec->writer;
+	AM_REC_Meta_t meta;
+	int now, rec_time;
+
+	if (rec->rec_start_time != 0)
+	{
+		AM_TIME_GetClock(&now);
+		rec_time = (now - rec->rec_start_time)/1000;
+
+		if (w->running && rec->meta_file_name[0])
+		{
+			/*不再改写文件头，录像文件只顺序写入*/
+			if (now - w->meta_clock < w->para.meta_time)
+				return AM_SUCCESS;
+
+			am_rec_get_meta(rec, &meta);
+
+			pthread_mutex_lock(&w->lock);
+			w->meta = meta;
+			w->meta_dirty = AM_TRUE;
+			w->meta_clock = now;
+			pthread_cond_broadcast(&w->cond);
+			pthread_mutex_unlock(&w->lock);
+		}
+		else if (w->running)
+		{
+			/*由写文件线程写入，避免和数据写入竞争*/
+			pthread_mutex_lock(&w->lock);
+			w->rec_time = rec_time;
+			pthread_cond_broadcast(&w->cond);
+			pthread_mutex_unlock(&w->lock);
+		}
+		else
+		{
+			am_rec_write_record_time(rec, rec_time);
+		}
+	}
+
+	return AM_SUCCESS;
+}
+
 #ifdef SUPPORT_CAS
 static int am_rec_save_cas_dat(AM_REC_Recorder_t *rec, AM_CAS_CryptPara_t *param)
 {
@@ -429,6 +1541,11 @@ static int am_rec_save_cas_dat(AM_REC_Recorder_t *rec, AM_CAS_CryptPara_t *param
 		}
 		AM_DEBUG(3, "%s save rec info success, blk_size:%d, info_len:%d\n", __func__, block_size, info_len);
 		rec->cas_dat_write = 1;
+
+		/*同时写入元数据文件*/
+		rec->cas_blk_size = param->rec_info.blk_size;
+		rec->cas_info_len = AM_MIN(param->rec_info.len, sizeof(rec->cas_info));
+		memcpy(rec->cas_info, param->rec_info.data, rec->cas_info_len);
 	}
 
 	pos = bswap_64(param->store_info.pos);
@@ -483,22 +1600,40 @@ static void *am_rec_record_thread(void* arg)
 
 	memset(&epara, 0, sizeof(epara));
 	epara.hrec = rec;
-	/*设置DVR设备参数*/
-	memset(&para, 0, sizeof(para));
-	if (AM_DVR_Open(rec->create_para.dvr_dev, &para) != AM_SUCCESS)
+	if (rec->rec_para.share_dvr)
+	{
+		/*和其他录像共用DVR设备，数据由数据源线程按PID分发*/
+		err = am_rec_source_attach(rec);
+		if (err != AM_SUCCESS)
+			goto close_file;
+	}
+	else
 	{
-		AM_DEBUG(0, "Open DVR%d failed", rec->create_para.dvr_dev);
-		err = AM_REC_ERR_DVR;
-		goto close_file;
+		/*设置DVR设备参数*/
+		memset(&para, 0, sizeof(para));
+		if (AM_DVR_Open(rec->create_para.dvr_dev, &para) != AM_SUCCESS)
+		{
+			AM_DEBUG(0, "Open DVR%d failed", rec->create_para.dvr_dev);
+			err = AM_REC_ERR_DVR;
+			goto close_file;
+		}
+
+		AM_DVR_SetSource(rec->create_para.dvr_dev, rec->create_para.async_fifo_id);
+
+		if (am_rec_start_dvr(rec) != AM_SUCCESS)
+		{
+			AM_DEBUG(0, "Start DVR%d failed", rec->create_para.dvr_dev);
+			err = AM_REC_ERR_DVR;
+			goto close_dvr;
+		}
 	}
 
-	AM_DVR_SetSource(rec->create_para.dvr_dev, rec->create_para.async_fifo_id);
-	
-	if (am_rec_start_dvr(rec) != AM_SUCCESS)
+	/*普通录像通过写文件线程写入，存储设备较慢时不阻塞DVR读取*/
+	if (!rec->rec_para.is_timeshift && (rec->rec_fd != -1))
 	{
-		AM_DEBUG(0, "Start DVR%d failed", rec->create_para.dvr_dev);
-		err = AM_REC_ERR_DVR;
-		goto close_dvr;
+		err = am_rec_writer_start(rec);
+		if (err != AM_SUCCESS)
+			goto close_dvr;
 	}
 
 	AM_EVT_Signal((long)rec, AM_REC_EVT_RECORD_START, NULL);
@@ -544,9 +1679,15 @@ static void *am_rec_record_thread(void* arg)
 			buf_in = buf;
 			size = sizeof(buf);
 		}
-		cnt = AM_DVR_Read(rec->create_para.dvr_dev, buf_in, size, -1);
+		if (rec->source)
+			cnt = am_rec_source_read(rec, buf, sizeof(buf), 50);
+		else
+			cnt = AM_DVR_Read(rec->create_para.dvr_dev, buf_in, size, -1);
 #else
-		cnt = AM_DVR_Read(rec->create_para.dvr_dev, buf, sizeof(buf), 50);
+		if (rec->source)
+			cnt = am_rec_source_read(rec, buf, sizeof(buf), 50);
+		else
+			cnt = AM_DVR_Read(rec->create_para.dvr_dev, buf, sizeof(buf), 50);
 #endif
 		if (cnt <= 0)
 		{
@@ -579,7 +1720,7 @@ static void *am_rec_record_thread(void* arg)
 				}
 			} else {
 				if (cpara.store_info.len) {
-					cpara.store_info.pos = lseek(rec->rec_fd, 0, SEEK_CUR);
+					cpara.store_info.pos = am_rec_writer_tell(rec);
 					am_rec_save_cas_dat(rec, &cpara);
 				}
 			}
@@ -618,19 +1759,23 @@ static void *am_rec_record_thread(void* arg)
 			}
 
 			while ((ib + 188) <= cnt) {
+				int n;
+
 				if (buf[ib] != 0x47) {
 					ib++;
 					lost++;
 					continue;
 				}
-				if (rec->rec_para.crypt_ops && rec->rec_para.crypt_ops->crypt)
-					rec->rec_para.crypt_ops->crypt(rec->cryptor,
-						crypt_buf+left, buf+ib, 188, 0);
-				else
-					memcpy(crypt_buf+left, buf+ib, 188);
 
-				ib += 188;
-				left += 188;
+				/*同步的包一次加密*/
+				for (n = 1; (ib + (n + 1) * 188 <= cnt) && (buf[ib + n * 188] == 0x47); n++)
+					;
+
+				AM_CRYPT_crypt_pkts(rec->rec_para.crypt_ops, rec->cryptor,
+					crypt_buf+left, buf+ib, n, 0);
+
+				ib += n * 188;
+				left += n * 188;
 
 				do_write = 1;
 			}
@@ -697,6 +1842,7 @@ static void *am_rec_record_thread(void* arg)
 				/*已有数据写入文件，记录开始时间*/
 				AM_TIME_GetClock(&rec->rec_start_time);
 			}
+			rec->rec_size += ldata;
 		}
 
 		if (CRYPT_SET(rec->rec_para.crypt_ops)) {
@@ -724,9 +1870,33 @@ static void *am_rec_record_thread(void* arg)
 		free(crypt_buf);
 
 close_dvr:
-	AM_DVR_StopRecord(rec->create_para.dvr_dev);
-	AM_DVR_Close(rec->create_para.dvr_dev);
+	if (rec->source)
+	{
+		am_rec_source_detach(rec);
+	}
+	else
+	{
+		AM_DVR_StopRecord(rec->create_para.dvr_dev);
+		AM_DVR_Close(rec->create_para.dvr_dev);
+	}
 close_file:
+	am_rec_writer_stop(rec);
+	if (!err && rec->writer.err)
+	{
+		err = AM_REC_ERR_CANNOT_WRITE_FILE;
+		if (rec->writer.err == ENOSPC)
+			err = AM_REC_ERR_CANNOT_WRITE_FILE_NO_SPACE;
+	}
+	if (rec->meta_file_name[0] && (rec->rec_fd != -1))
+	{
+		AM_REC_Meta_t meta;
+
+		/*录像结束，文件头也写入录像时间，兼容不读取元数据文件的播放器*/
+		am_rec_get_meta(rec, &meta);
+		meta.complete = AM_TRUE;
+		am_rec_write_record_time(rec, meta.duration);
+		am_rec_write_meta(rec, &meta);
+	}
 	if (rec->rec_fd != -1)
 	{
 		close(rec->rec_fd);
@@ -745,8 +1915,14 @@ close_file:
 		&&
 		am_rec_get_file_size(rec) <= 0)
 	{
+		char name[sizeof(rec->rec_file_name) + sizeof(AM_TINDEX_SUFFIX)];
+
 		AM_DEBUG(1, "unliking empty file: %s", rec->rec_file_name);
 		unlink(rec->rec_file_name);
+		am_rec_index_name(rec, name, sizeof(name));
+		unlink(name);
+		if (rec->meta_file_name[0])
+			unlink(rec->meta_file_name);
 	}
 
 	if (! rec->rec_para.is_timeshift)
@@ -826,6 +2002,14 @@ static int am_rec_start_record(AM_REC_Recorder_t *rec, AM_REC_RecPara_t *start_p
 		ret = AM_REC_ERR_BUSY;
 		goto start_end;
 	}
+#ifdef SUPPORT_CAS
+	if (start_para->share_dvr && rec->create_para.is_smp)
+	{
+		AM_DEBUG(1, "Secure media path cannot share the DVR device");
+		ret = AM_REC_ERR_INVALID_PARAM;
+		goto start_end;
+	}
+#endif
 	/*取录像相关参数*/
 	if ((ret = am_rec_fill_rec_param(rec, start_para)) != 0)
 		goto start_end;
@@ -834,10 +2018,20 @@ static int am_rec_start_record(AM_REC_Recorder_t *rec, AM_REC_RecPara_t *start_p
 	rec->rec_fd = -1;
 	rec->rec_para = *start_para;
 
+	/*共用DVR设备时PID总数超出限制则不开始录像*/
+	if (rec->rec_para.share_dvr && ((ret = am_rec_source_check_pids(rec)) != AM_SUCCESS))
+		goto start_end;
+
 	if (rec->rec_para.crypt_ops && rec->rec_para.crypt_ops->open)
 		rec->cryptor = rec->rec_para.crypt_ops->open();
 	AM_DEBUG(1, "rec crypt mode : %d", (rec->cryptor)? 1 : 0);
 
+	rec->meta_file_name[0] = 0;
+	rec->rec_size = 0;
+#ifdef SUPPORT_CAS
+	rec->cas_info_len = 0;
+#endif
+
 	if (! rec->rec_para.is_timeshift)
 	{
 #ifdef SUPPORT_CAS
@@ -853,7 +2047,7 @@ static int am_rec_start_record(AM_REC_Recorder_t *rec, AM_REC_RecPara_t *start_p
 		}
 	AM_DEBUG(1, "%s %d", __FUNC__, __LINE__);
 #endif
-		rec->rec_fd = open(rec->rec_file_name, O_TRUNC|O_CREAT|O_WRONLY, 0666);
+		rec->rec_fd = open(rec->rec_file_name, O_TRUNC|O_CREAT|O_RDWR, 0666);
 		if (rec->rec_fd == -1)
 		{
 			AM_DEBUG(1, "Cannot open record file '%s', cannot start", rec->rec_file_name);
@@ -872,6 +2066,16 @@ static int am_rec_start_record(AM_REC_Recorder_t *rec, AM_REC_RecPara_t *start_p
 
 		am_rec_insert_file_header(rec);
 		am_rec_insert_pat(rec);
+
+		/*元数据文件以第一个录像文件命名，先写入媒体信息*/
+		if (rec->writer_para.meta_time > 0)
+		{
+			AM_REC_Meta_t meta;
+
+			snprintf(rec->meta_file_name, sizeof(rec->meta_file_name), "%s"AM_REC_META_SUFFIX, rec->rec_file_name);
+			memset(&meta, 0, sizeof(meta));
+			am_rec_write_meta(rec, &meta);
+		}
 	}
 	else if ((rec->tfile_flag & REC_TFILE_FLAG_AUTO_CREATE) && !rec->tfile)
 	{
@@ -1142,6 +2346,32 @@ AM_ErrorCode_t AM_REC_SetRecordPath(AM_REC_Handle_t handle, const char *path)
 	return AM_SUCCESS;
 }
 
+/**\brief 设置录像文件写入参数，下次开始录像时生效
+ * \param handle 录像管理器句柄
+ * \param [in] para 写入参数
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码(见am_rec.h)
+ */
+AM_ErrorCode_t AM_REC_SetWriterPara(AM_REC_Handle_t handle, const AM_REC_WriterPara_t *para)
+{
+	AM_REC_Recorder_t *rec = (AM_REC_Recorder_t *)handle;
+
+	assert(rec && para);
+
+	if (para->buf_count > REC_WRITER_MAX_BUFS)
+	{
+		AM_DEBUG(1, "Invalid writer buffer count %d, must <= %d", para->buf_count, REC_WRITER_MAX_BUFS);
+		return AM_REC_ERR_INVALID_PARAM;
+	}
+
+	pthread_mutex_lock(&rec->lock);
+	rec->writer_para = *para;
+	pthread_mutex_unlock(&rec->lock);
+
+	return AM_SUCCESS;
+}
+
 /**\brief 获取当前录像信息
  * \param handle 录像管理器句柄
  * \param [out] info 当前录像信息
@@ -1223,6 +2453,10 @@ AM_ErrorCode_t AM_REC_GetMediaInfoFromFile(const char *file_path, AM_REC_MediaIn
 	}\
 	AM_MACRO_END
 
+	/*有元数据文件时不需要解析录像文件*/
+	if (am_rec_read_meta(file_path, info) == AM_SUCCESS)
+		return AM_SUCCESS;
+
 	fd = open(file_path, O_RDONLY, 0666);
 	if (fd < 0) {
 		AM_DEBUG(0, "Cannot open file '%s'", file_path);
@@ -25,6 +25,9 @@ extern "C"
  * Macro definitions
  ***************************************************************************/
 
+/**\brief 写文件线程最多使用的缓冲区数*/
+#define REC_WRITER_MAX_BUFS	(8)
+
 
 /****************************************************************************
  * Type definitions
@@ -55,8 +58,67 @@ enum
 	REC_EVT_QUIT
 };
 
-/**\brief 录像管理数据*/
+/**\brief 写文件缓冲区*/
+typedef struct
+{
+	uint8_t		*data;		/**< 缓冲区，按REC_WRITER_ALIGN对齐*/
+	int			start;		/**< 新数据的起始位置，之前为对齐所需的已写入数据*/
+	int			len;		/**< 缓冲区中数据的结束位置*/
+	off64_t		off;		/**< data[0]对应的文件偏移*/
+	int			fill_time;	/**< 开始填充新数据的时间*/
+}AM_REC_WriteBuf_t;
+
+/**\brief 录像过程中变化的元数据，写入元数据文件*/
+typedef struct
+{
+	int			duration;	/**< 录像时长(秒)*/
+	int64_t		size;		/**< 写入的录像数据长度*/
+	int64_t		dropped;	/**< 共享DVR时缓冲区满丢弃的TS包数*/
+	AM_Bool_t	complete;	/**< 录像已经结束*/
+}AM_REC_Meta_t;
+
+/**\brief 异步写文件线程*/
 typedef struct
+{
+	pthread_t		thread;
+	pthread_mutex_t	lock;
+	pthread_cond_t	cond;
+	AM_REC_WriterPara_t	para;
+	AM_REC_WriteBuf_t	bufs[REC_WRITER_MAX_BUFS];
+	int				head;		/**< 下一个待写入的缓冲区*/
+	int				full;		/**< 待写入的缓冲区数*/
+	int				fill;		/**< 正在填充的缓冲区，-1表示需要取新的缓冲区*/
+	AM_Bool_t		has_prev;	/**< 之前已经填充过缓冲区*/
+	off64_t			next_off;	/**< 下一个数据对应的文件偏移*/
+	off64_t			shift;		/**< 切换文件后的偏移修正*/
+	int				align;		/**< 写入对齐长度*/
+	int				direct_fd;	/**< O_DIRECT句柄，-1表示不使用*/
+	int				rec_time;	/**< 待写入文件头的录像时间，-1表示无*/
+	AM_REC_Meta_t	meta;		/**< 待写入元数据文件的数据*/
+	AM_Bool_t		meta_dirty;	/**< meta需要写入元数据文件*/
+	int				meta_clock;	/**< 上次更新元数据的时间*/
+	int				err;		/**< 写入失败的错误码(errno)*/
+	int64_t			unsynced;	/**< 上次同步后写入的字节数*/
+	AM_Bool_t		quit;		/**< 线程退出标志*/
+	AM_Bool_t		running;	/**< 线程正在运行*/
+}AM_REC_Writer_t;
+
+struct AM_REC_Recorder;
+
+/**\brief 共享DVR的数据源，一个线程读取DVR数据并按PID分发给使用该DVR的所有录像*/
+typedef struct AM_REC_Source
+{
+	int				dvr_dev;	/**< DVR设备号*/
+	pthread_t		thread;
+	pthread_mutex_t	lock;		/**< 保护录像链表和录像的接收缓冲区*/
+	pthread_cond_t	cond;		/**< 接收缓冲区有新数据*/
+	struct AM_REC_Recorder	*outputs;	/**< 使用该数据源的录像链表*/
+	struct AM_REC_Source	*next;
+	AM_Bool_t		quit;		/**< 线程退出标志*/
+}AM_REC_Source_t;
+
+/**\brief 录像管理数据*/
+typedef struct AM_REC_Recorder
 {
 	AM_REC_CreatePara_t	create_para;
 	AM_REC_RecPara_t	rec_para;
@@ -71,9 +133,24 @@ typedef struct
     int       tfile_flag;
     AM_TFile_t      tfile;
 	void                    *cryptor;
+	AM_REC_WriterPara_t	writer_para;
+	AM_REC_Writer_t	writer;
+	AM_TIndex_t		index;		/**< 录像索引文件*/
+	char			meta_file_name[AM_REC_PATH_MAX + sizeof(AM_REC_META_SUFFIX)];	/**< 元数据文件名，空表示不使用*/
+	int64_t			rec_size;	/**< 写入的录像数据长度*/
+	AM_REC_Source_t	*source;	/**< 共享的DVR数据源，NULL表示独占DVR设备*/
+	struct AM_REC_Recorder	*src_next;	/**< 数据源中的下一个录像*/
+	uint8_t			*src_buf;	/**< 从数据源接收TS包的环形缓冲区*/
+	int				src_head;	/**< 缓冲区中第一个数据的位置*/
+	int				src_len;	/**< 缓冲区中的数据长度*/
+	int				src_lost;	/**< 缓冲区满时丢弃的TS包数*/
+	uint8_t			src_pids[0x2000/8];	/**< 本录像需要的PID，每个PID一位*/
 #ifdef SUPPORT_CAS
 	int				cas_dat_fd;
 	int				cas_dat_write;
+	uint32_t		cas_blk_size;	/**< CAS块大小，写入元数据文件*/
+	int				cas_info_len;
+	uint8_t			cas_info[16];	/**< CAS录像信息，写入元数据文件*/
 #endif
 }AM_REC_Recorder_t;
 
@@ -810,7 +810,7 @@ static int am_scan_get_ts_network(sqlite3_stmt **stmts, int src, dvbpsi_nit_t *n
 			{
 				AM_SI_LIST_BEGIN(nits, nit)
 				AM_SI_LIST_BEGIN(nit->p_first_descriptor, descr)
-				if (descr->p_decoded && descr->i_tag == AM_SI_DESCR_NETWORK_NAME)
+				if (descr->i_tag == AM_SI_DESCR_NETWORK_NAME && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_NIT_ACT))
 				{
 					dvbpsi_network_name_dr_t *pnn = (dvbpsi_network_name_dr_t*)descr->p_decoded;
 
@@ -1315,7 +1315,7 @@ static void am_scan_extract_srv_info_from_sdt(AM_SCAN_Result_t *result, dvbpsi_s
 			srv_info->sdt_version = sdt->i_version;
 
 			AM_SI_LIST_BEGIN(srv->p_first_descriptor, descr)
-			if (descr->p_decoded && descr->i_tag == AM_SI_DESCR_SERVICE)
+			if (descr->i_tag == AM_SI_DESCR_SERVICE && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_SDT_ACT))
 			{
 				dvbpsi_service_dr_t *psd = (dvbpsi_service_dr_t*)descr->p_decoded;
 
@@ -1347,7 +1347,7 @@ static void am_scan_extract_srv_info_from_sdt(AM_SCAN_Result_t *result, dvbpsi_s
 #if 0       //The upper layer don't have the logic of parse multi service names according to 0x80, Use only one for the time being.
 			/* store multilingual service name */
 			AM_SI_LIST_BEGIN(srv->p_first_descriptor, descr)
-			if (descr->p_decoded && descr->i_tag == AM_SI_DESCR_MULTI_SERVICE_NAME)
+			if (descr->i_tag == AM_SI_DESCR_MULTI_SERVICE_NAME && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_SDT_ACT))
 			{
 				int i;
 				dvbpsi_multi_service_name_dr_t *pmsnd = (dvbpsi_multi_service_name_dr_t*)descr->p_decoded;
@@ -2049,7 +2049,7 @@ int *sd_lcn, int *sd_visible, int *hd_lcn, int *hd_visible)
 		AM_SI_LIST_BEGIN(nit->p_first_ts, ts)
 			if(ts->i_ts_id==ts_id && ts->i_orig_network_id==org_net_id){
 				AM_SI_LIST_BEGIN(ts->p_first_descriptor, dr)
-					if(dr->p_decoded && ((dr->i_tag == AM_SI_DESCR_LCN_83))){
+					if(dr->i_tag == AM_SI_DESCR_LCN_83 && AM_SI_GetDecodedDescriptor(dr, AM_SI_TID_NIT_ACT)){
 						if(dr->i_tag==AM_SI_DESCR_LCN_83)
 						{
 							dvbpsi_logical_channel_number_83_dr_t *lcn_dr = (dvbpsi_logical_channel_number_83_dr_t*)dr->p_decoded;
@@ -2072,7 +2072,7 @@ int *sd_lcn, int *sd_visible, int *hd_lcn, int *hd_visible)
 							}
 						}
 					}
-					else if (dr->i_tag==AM_SI_DESCR_LCN_88)
+					else if (dr->i_tag == AM_SI_DESCR_LCN_88 && AM_SI_GetDecodedDescriptor(dr, AM_SI_TID_NIT_ACT))
 					{
 						dvbpsi_logical_channel_number_88_dr_t *lcn_dr = (dvbpsi_logical_channel_number_88_dr_t*)dr->p_decoded;
 						dvbpsi_logical_channel_number_88_t *lcn = lcn_dr->p_logical_channel_number;
@@ -3249,7 +3249,7 @@ static void am_scan_nit_done(AM_SCAN_Scanner_t *scanner)
 		AM_SI_LIST_BEGIN(nit->p_first_ts, ts)
 			AM_SI_LIST_BEGIN(ts->p_first_descriptor, descr)
 			/*取DVBC频点信息*/
-			if (dtv_start_para.source == FE_QAM && descr->p_decoded && descr->i_tag == AM_SI_DESCR_CABLE_DELIVERY)
+			if (dtv_start_para.source == FE_QAM && descr->i_tag == AM_SI_DESCR_CABLE_DELIVERY && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_NIT_ACT))
 			{
 				dvbpsi_cable_delivery_dr_t *pcd = (dvbpsi_cable_delivery_dr_t*)descr->p_decoded;
 
@@ -3262,7 +3262,7 @@ static void am_scan_nit_done(AM_SCAN_Scanner_t *scanner)
 				AM_DEBUG(1, "Add frequency %u, symbol_rate %u, modulation %u, onid %d, ts_id %d", param->frequency,
 						param->u.qam.symbol_rate, param->u.qam.modulation, ts->i_orig_network_id, ts->i_ts_id);
 			}
-			else if (dtv_start_para.source == FE_OFDM && descr->p_decoded && descr->i_tag == AM_SI_DESCR_TERRESTRIAL_DELIVERY)
+			else if (dtv_start_para.source == FE_OFDM && descr->i_tag == AM_SI_DESCR_TERRESTRIAL_DELIVERY && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_NIT_ACT))
 			{
 				dvbpsi_terr_deliv_sys_dr_t *pcd = (dvbpsi_terr_deliv_sys_dr_t*)descr->p_decoded;
 
@@ -3274,7 +3274,7 @@ static void am_scan_nit_done(AM_SCAN_Scanner_t *scanner)
 				AM_DEBUG(1, "Add frequency %u, bw %u, onid %d, ts_id %d", param->frequency,
 						param->u.ofdm.bandwidth, ts->i_orig_network_id, ts->i_ts_id);
 			}
-			else if (dtv_start_para.source == FE_QPSK && descr->p_decoded && descr->i_tag == AM_SI_DESCR_SATELLITE_DELIVERY)
+			else if (dtv_start_para.source == FE_QPSK && descr->i_tag == AM_SI_DESCR_SATELLITE_DELIVERY && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_NIT_ACT))
 			{
 				dvbpsi_sat_deliv_sys_dr_t *pcd = (dvbpsi_sat_deliv_sys_dr_t*)descr->p_decoded;
 
@@ -4673,6 +4673,7 @@ static AM_ErrorCode_t am_scan_start_dtv(AM_SCAN_Scanner_t *scanner)
 
 	/*创建SI解析器*/
 	AM_TRY(AM_SI_Create(&scanner->dtvctl.hsi));
+	AM_SI_SetLazyDescriptorDecode(scanner->dtvctl.hsi, scanner->lazy_descr);
 
 	/*接收控制数据初始化*/
 	am_scan_tablectl_init(&scanner->dtvctl.patctl, AM_SCAN_RECVING_PAT, AM_SCAN_EVT_PAT_DONE, PAT_TIMEOUT,
@@ -6240,4 +6241,25 @@ AM_ErrorCode_t AM_SCAN_SetHelper(AM_SCAN_Handle_t handle, AM_SCAN_Helper_t *help
 	return AM_SUCCESS;
 }
 
+/**\brief 设置是否延迟解析描述符，在AM_SCAN_Start()之前调用
+ * \param handle Scan句柄
+ * \param enable 是否延迟解析
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码(见am_scan.h)
+ */
+AM_ErrorCode_t AM_SCAN_SetLazyDescriptorDecode(AM_SCAN_Handle_t handle, AM_Bool_t enable)
+{
+	AM_SCAN_Scanner_t *scanner = (AM_SCAN_Scanner_t*)handle;
+
+	if (scanner)
+	{
+		pthread_mutex_lock(&scanner->lock);
+		scanner->lazy_descr = enable;
+		pthread_mutex_unlock(&scanner->lock);
+	}
+
+	return AM_SUCCESS;
+}
+
 
@@ -333,6 +333,7 @@ struct AM_SCAN_Scanner_s
 
 	int                                     status;
 	int                                     proc_mode;
+	AM_Bool_t                               lazy_descr;	/**< 是否延迟解析描述符*/
 
 	AM_SCAN_Helper_t          helper[AM_SCAN_HELPER_ID_MAX];
 };
@@ -40,6 +40,7 @@
 #define SUB_NODE_DISPLAYING          1
 
 #define PTS_PER_SEC                  90000
+#define VIDEO_SIZE_MAX_AGE           500 //视频尺寸缓存时间(毫秒)
 
 #define BMP_OUTLINE_NONE             0
 #define BMP_OUTLINE_OUTLINE          1
@@ -876,9 +877,9 @@ int decode_message_body(AM_SCTE27_Parser_t *parser, const uint8_t *buf, int size
 	}
 
 	bitmap = &buf[12];
-	AM_FileRead("/sys/class/video/frame_height", read_buff, sizeof(read_buff));
+	AM_FileReadCached("/sys/class/video/frame_height", read_buff, sizeof(read_buff), VIDEO_SIZE_MAX_AGE);
 	video_height = strtoul(read_buff, NULL, 10);
-	AM_FileRead("/sys/class/video/frame_width", read_buff, sizeof(read_buff));
+	AM_FileReadCached("/sys/class/video/frame_width", read_buff, sizeof(read_buff), VIDEO_SIZE_MAX_AGE);
 	video_width = strtoul(read_buff, NULL, 10);
 
 	switch (sub_node.display_std)
@@ -29,6 +29,7 @@
 #include <am_iconv.h>
 #include "am_misc.h"
 #include <errno.h>
+#include <pthread.h>
 #include <freesat.h>
 #include <amports/vformat.h>
 
@@ -59,6 +60,27 @@
 		}\
 	AM_MACRO_END
 
+/*每个线程缓存的iconv转换器数目*/
+#define SI_ICONV_CACHE_SIZE 4
+
+/****************************************************************************
+ * Type definitions
+ ***************************************************************************/
+
+/**\brief 缓存的iconv转换器*/
+typedef struct
+{
+	char    coding[32];	/**< 源编码*/
+	iconv_t handle;		/**< 转换为UTF-8的句柄*/
+} SI_IConv_t;
+
+/**\brief 线程的iconv转换器缓存，最近使用的在前*/
+typedef struct
+{
+	int        count;
+	SI_IConv_t convs[SI_ICONV_CACHE_SIZE];
+} SI_IConvCache_t;
+
 /****************************************************************************
  * Static data
  ***************************************************************************/
@@ -96,6 +118,313 @@ static char forced_dvb_text_coding[32] = {0};
 
 static const char * const si_prv_data = "AM SI Decoder";
 
+/*当前线程正在解析的section是否只保留原始描述符*/
+static pthread_key_t  si_lazy_descr_key;
+/*当前线程的iconv转换器缓存*/
+static pthread_key_t  si_iconv_key;
+static pthread_once_t si_init_once = PTHREAD_ONCE_INIT;
+
+/**\brief ISO6937 0xA0~0xFF的单字节字符*/
+static const uint16_t iso6937_chars[96] = {
+	0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7,
+	0x00A4, 0x2018, 0x201C, 0x00AB, 0x2190, 0x2191, 0x2192, 0x2193,
+	0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00D7, 0x00B5, 0x00B6, 0x00B7,
+	0x00F7, 0x2019, 0x201D, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF,
+	0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7,
+	0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+	0x2014, 0x00B9, 0x00AE, 0x00A9, 0x2122, 0x266A, 0x00AC, 0x00A6,
+	0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x215B, 0x215C, 0x215D, 0x215E,
+	0x2126, 0x00C6, 0x00D0, 0x00AA, 0x0126, 0x00E5, 0x0132, 0x013F,
+	0x0141, 0x00D8, 0x0152, 0x00BA, 0x00DE, 0x0166, 0x014A, 0x0149,
+	0x0138, 0x00E6, 0x0111, 0x00F0, 0x0127, 0x0131, 0x0133, 0x0140,
+	0x0142, 0x00F8, 0x0153, 0x00DF, 0x00FE, 0x0167, 0x014B, 0x00AD,
+};
+
+/**\brief ISO6937带变音符号的字符: 变音符号, 基本字符, Unicode*/
+static const struct {
+	uint8_t  diacritic;
+	uint8_t  base;
+	uint16_t ch;
+} iso6937_combined_chars[] = {
+	{0xC1, 0x41, 0x00C0}, {0xC1, 0x45, 0x00C8}, {0xC1, 0x49, 0x00CC}, {0xC1, 0x4F, 0x00D2},
+	{0xC1, 0x55, 0x00D9}, {0xC1, 0x61, 0x00E0}, {0xC1, 0x65, 0x00E8}, {0xC1, 0x69, 0x00EC},
+	{0xC1, 0x6F, 0x00F2}, {0xC1, 0x75, 0x00F9}, {0xC2, 0x20, 0x00B4}, {0xC2, 0x41, 0x00C1},
+	{0xC2, 0x43, 0x0106}, {0xC2, 0x45, 0x00C9}, {0xC2, 0x49, 0x00CD}, {0xC2, 0x4C, 0x0139},
+	{0xC2, 0x4E, 0x0143}, {0xC2, 0x4F, 0x00D3}, {0xC2, 0x52, 0x0154}, {0xC2, 0x53, 0x015A},
+	{0xC2, 0x55, 0x00DA}, {0xC2, 0x59, 0x00DD}, {0xC2, 0x5A, 0x0179}, {0xC2, 0x61, 0x00E1},
+	{0xC2, 0x63, 0x0107}, {0xC2, 0x65, 0x00E9}, {0xC2, 0x69, 0x00ED}, {0xC2, 0x6C, 0x013A},
+	{0xC2, 0x6E, 0x0144}, {0xC2, 0x6F, 0x00F3}, {0xC2, 0x72, 0x0155}, {0xC2, 0x73, 0x015B},
+	{0xC2, 0x75, 0x00FA}, {0xC2, 0x79, 0x00FD}, {0xC2, 0x7A, 0x017A}, {0xC3, 0x41, 0x00C2},
+	{0xC3, 0x43, 0x0108}, {0xC3, 0x45, 0x00CA}, {0xC3, 0x47, 0x011C}, {0xC3, 0x48, 0x0124},
+	{0xC3, 0x49, 0x00CE}, {0xC3, 0x4A, 0x0134}, {0xC3, 0x4F, 0x00D4}, {0xC3, 0x53, 0x015C},
+	{0xC3, 0x55, 0x00DB}, {0xC3, 0x57, 0x0174}, {0xC3, 0x59, 0x0176}, {0xC3, 0x61, 0x00E2},
+	{0xC3, 0x63, 0x0109}, {0xC3, 0x65, 0x00EA}, {0xC3, 0x67, 0x011D}, {0xC3, 0x68, 0x0125},
+	{0xC3, 0x69, 0x00EE}, {0xC3, 0x6A, 0x0135}, {0xC3, 0x6F, 0x00F4}, {0xC3, 0x73, 0x015D},
+	{0xC3, 0x75, 0x00FB}, {0xC3, 0x77, 0x0175}, {0xC3, 0x79, 0x0177}, {0xC4, 0x41, 0x00C3},
+	{0xC4, 0x49, 0x0128}, {0xC4, 0x4E, 0x00D1}, {0xC4, 0x4F, 0x00D5}, {0xC4, 0x55, 0x0168},
+	{0xC4, 0x61, 0x00E3}, {0xC4, 0x69, 0x0129}, {0xC4, 0x6E, 0x00F1}, {0xC4, 0x6F, 0x00F5},
+	{0xC4, 0x75, 0x0169}, {0xC5, 0x20, 0x00AF}, {0xC5, 0x41, 0x0100}, {0xC5, 0x45, 0x0112},
+	{0xC5, 0x49, 0x012A}, {0xC5, 0x4F, 0x014C}, {0xC5, 0x55, 0x016A}, {0xC5, 0x61, 0x0101},
+	{0xC5, 0x65, 0x0113}, {0xC5, 0x69, 0x012B}, {0xC5, 0x6F, 0x014D}, {0xC5, 0x75, 0x016B},
+	{0xC6, 0x20, 0x02D8}, {0xC6, 0x41, 0x0102}, {0xC6, 0x47, 0x011E}, {0xC6, 0x55, 0x016C},
+	{0xC6, 0x61, 0x0103}, {0xC6, 0x67, 0x011F}, {0xC6, 0x75, 0x016D}, {0xC7, 0x20, 0x02D9},
+	{0xC7, 0x43, 0x010A}, {0xC7, 0x45, 0x0116}, {0xC7, 0x47, 0x0120}, {0xC7, 0x49, 0x0130},
+	{0xC7, 0x5A, 0x017B}, {0xC7, 0x63, 0x010B}, {0xC7, 0x65, 0x0117}, {0xC7, 0x67, 0x0121},
+	{0xC7, 0x7A, 0x017C}, {0xC8, 0x20, 0x00A8}, {0xC8, 0x41, 0x00C4}, {0xC8, 0x45, 0x00CB},
+	{0xC8, 0x49, 0x00CF}, {0xC8, 0x4F, 0x00D6}, {0xC8, 0x55, 0x00DC}, {0xC8, 0x59, 0x0178},
+	{0xC8, 0x61, 0x00E4}, {0xC8, 0x65, 0x00EB}, {0xC8, 0x69, 0x00EF}, {0xC8, 0x6F, 0x00F6},
+	{0xC8, 0x75, 0x00FC}, {0xC8, 0x79, 0x00FF}, {0xCA, 0x20, 0x02DA}, {0xCA, 0x41, 0x00C5},
+	{0xCA, 0x55, 0x016E}, {0xCA, 0x61, 0x00E5}, {0xCA, 0x75, 0x016F}, {0xCB, 0x20, 0x00B8},
+	{0xCB, 0x43, 0x00C7}, {0xCB, 0x47, 0x0122}, {0xCB, 0x4B, 0x0136}, {0xCB, 0x4C, 0x013B},
+	{0xCB, 0x4E, 0x0145}, {0xCB, 0x52, 0x0156}, {0xCB, 0x53, 0x015E}, {0xCB, 0x54, 0x0162},
+	{0xCB, 0x63, 0x00E7}, {0xCB, 0x67, 0x0123}, {0xCB, 0x6B, 0x0137}, {0xCB, 0x6C, 0x013C},
+	{0xCB, 0x6E, 0x0146}, {0xCB, 0x72, 0x0157}, {0xCB, 0x73, 0x015F}, {0xCB, 0x74, 0x0163},
+	{0xCD, 0x20, 0x02DD}, {0xCD, 0x4F, 0x0150}, {0xCD, 0x55, 0x0170}, {0xCD, 0x6F, 0x0151},
+	{0xCD, 0x75, 0x0171}, {0xCE, 0x20, 0x02DB}, {0xCE, 0x41, 0x0104}, {0xCE, 0x45, 0x0118},
+	{0xCE, 0x49, 0x012E}, {0xCE, 0x55, 0x0172}, {0xCE, 0x61, 0x0105}, {0xCE, 0x65, 0x0119},
+	{0xCE, 0x69, 0x012F}, {0xCE, 0x75, 0x0173}, {0xCF, 0x20, 0x02C7}, {0xCF, 0x43, 0x010C},
+	{0xCF, 0x44, 0x010E}, {0xCF, 0x45, 0x011A}, {0xCF, 0x4C, 0x013D}, {0xCF, 0x4E, 0x0147},
+	{0xCF, 0x52, 0x0158}, {0xCF, 0x53, 0x0160}, {0xCF, 0x54, 0x0164}, {0xCF, 0x5A, 0x017D},
+	{0xCF, 0x63, 0x010D}, {0xCF, 0x64, 0x010F}, {0xCF, 0x65, 0x011B}, {0xCF, 0x6C, 0x013E},
+	{0xCF, 0x6E, 0x0148}, {0xCF, 0x72, 0x0159}, {0xCF, 0x73, 0x0161}, {0xCF, 0x74, 0x0165},
+	{0xCF, 0x7A, 0x017E},
+};
+
+/**\brief ISO-8859-2~16 0xA0~0xFF的字符，0表示未定义*/
+static const uint16_t iso8859_2_chars[96] = {
+	0x00A0, 0x0104, 0x02D8, 0x0141, 0x00A4, 0x013D, 0x015A, 0x00A7,
+	0x00A8, 0x0160, 0x015E, 0x0164, 0x0179, 0x00AD, 0x017D, 0x017B,
+	0x00B0, 0x0105, 0x02DB, 0x0142, 0x00B4, 0x013E, 0x015B, 0x02C7,
+	0x00B8, 0x0161, 0x015F, 0x0165, 0x017A, 0x02DD, 0x017E, 0x017C,
+	0x0154, 0x00C1, 0x00C2, 0x0102, 0x00C4, 0x0139, 0x0106, 0x00C7,
+	0x010C, 0x00C9, 0x0118, 0x00CB, 0x011A, 0x00CD, 0x00CE, 0x010E,
+	0x0110, 0x0143, 0x0147, 0x00D3, 0x00D4, 0x0150, 0x00D6, 0x00D7,
+	0x0158, 0x016E, 0x00DA, 0x0170, 0x00DC, 0x00DD, 0x0162, 0x00DF,
+	0x0155, 0x00E1, 0x00E2, 0x0103, 0x00E4, 0x013A, 0x0107, 0x00E7,
+	0x010D, 0x00E9, 0x0119, 0x00EB, 0x011B, 0x00ED, 0x00EE, 0x010F,
+	0x0111, 0x0144, 0x0148, 0x00F3, 0x00F4, 0x0151, 0x00F6, 0x00F7,
+	0x0159, 0x016F, 0x00FA, 0x0171, 0x00FC, 0x00FD, 0x0163, 0x02D9,
+};
+
+static const uint16_t iso8859_3_chars[96] = {
+	0x00A0, 0x0126, 0x02D8, 0x00A3, 0x00A4, 0x0000, 0x0124, 0x00A7,
+	0x00A8, 0x0130, 0x015E, 0x011E, 0x0134, 0x00AD, 0x0000, 0x017B,
+	0x00B0, 0x0127, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x0125, 0x00B7,
+	0x00B8, 0x0131, 0x015F, 0x011F, 0x0135, 0x00BD, 0x0000, 0x017C,
+	0x00C0, 0x00C1, 0x00C2, 0x0000, 0x00C4, 0x010A, 0x0108, 0x00C7,
+	0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+	0x0000, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x0120, 0x00D6, 0x00D7,
+	0x011C, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x016C, 0x015C, 0x00DF,
+	0x00E0, 0x00E1, 0x00E2, 0x0000, 0x00E4, 0x010B, 0x0109, 0x00E7,
+	0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+	0x0000, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x0121, 0x00F6, 0x00F7,
+	0x011D, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x016D, 0x015D, 0x02D9,
+};
+
+static const uint16_t iso8859_4_chars[96] = {
+	0x00A0, 0x0104, 0x0138, 0x0156, 0x00A4, 0x0128, 0x013B, 0x00A7,
+	0x00A8, 0x0160, 0x0112, 0x0122, 0x0166, 0x00AD, 0x017D, 0x00AF,
+	0x00B0, 0x0105, 0x02DB, 0x0157, 0x00B4, 0x0129, 0x013C, 0x02C7,
+	0x00B8, 0x0161, 0x0113, 0x0123, 0x0167, 0x014A, 0x017E, 0x014B,
+	0x0100, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x012E,
+	0x010C, 0x00C9, 0x0118, 0x00CB, 0x0116, 0x00CD, 0x00CE, 0x012A,
+	0x0110, 0x0145, 0x014C, 0x0136, 0x00D4, 0x00D5, 0x00D6, 0x00D7,
+	0x00D8, 0x0172, 0x00DA, 0x00DB, 0x00DC, 0x0168, 0x016A, 0x00DF,
+	0x0101, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x012F,
+	0x010D, 0x00E9, 0x0119, 0x00EB, 0x0117, 0x00ED, 0x00EE, 0x012B,
+	0x0111, 0x0146, 0x014D, 0x0137, 0x00F4, 0x00F5, 0x00F6, 0x00F7,
+	0x00F8, 0x0173, 0x00FA, 0x00FB, 0x00FC, 0x0169, 0x016B, 0x02D9,
+};
+
+static const uint16_t iso8859_5_chars[96] = {
+	0x00A0, 0x0401, 0x0402, 0x0403, 0x0404, 0x0405, 0x0406, 0x0407,
+	0x0408, 0x0409, 0x040A, 0x040B, 0x040C, 0x00AD, 0x040E, 0x040F,
+	0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+	0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E, 0x041F,
+	0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427,
+	0x0428, 0x0429, 0x042A, 0x042B, 0x042C, 0x042D, 0x042E, 0x042F,
+	0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437,
+	0x0438, 0x0439, 0x043A, 0x043B, 0x043C, 0x043D, 0x043E, 0x043F,
+	0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+	0x0448, 0x0449, 0x044A, 0x044B, 0x044C, 0x044D, 0x044E, 0x044F,
+	0x2116, 0x0451, 0x0452, 0x0453, 0x0454, 0x0455, 0x0456, 0x0457,
+	0x0458, 0x0459, 0x045A, 0x045B, 0x045C, 0x00A7, 0x045E, 0x045F,
+};
+
+static const uint16_t iso8859_6_chars[96] = {
+	0x00A0, 0x0000, 0x0000, 0x0000, 0x00A4, 0x0000, 0x0000, 0x0000,
+	0x0000, 0x0000, 0x0000, 0x0000, 0x060C, 0x00AD, 0x0000, 0x0000,
+	0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	0x0000, 0x0000, 0x0000, 0x061B, 0x0000, 0x0000, 0x0000, 0x061F,
+	0x0000, 0x0621, 0x0622, 0x0623, 0x0624, 0x0625, 0x0626, 0x0627,
+	0x0628, 0x0629, 0x062A, 0x062B, 0x062C, 0x062D, 0x062E, 0x062F,
+	0x0630, 0x0631, 0x0632, 0x0633, 0x0634, 0x0635, 0x0636, 0x0637,
+	0x0638, 0x0639, 0x063A, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	0x0640, 0x0641, 0x0642, 0x0643, 0x0644, 0x0645, 0x0646, 0x0647,
+	0x0648, 0x0649, 0x064A, 0x064B, 0x064C, 0x064D, 0x064E, 0x064F,
+	0x0650, 0x0651, 0x0652, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+};
+
+static const uint16_t iso8859_7_chars[96] = {
+	0x00A0, 0x2018, 0x2019, 0x00A3, 0x20AC, 0x20AF, 0x00A6, 0x00A7,
+	0x00A8, 0x00A9, 0x037A, 0x00AB, 0x00AC, 0x00AD, 0x0000, 0x2015,
+	0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x0384, 0x0385, 0x0386, 0x00B7,
+	0x0388, 0x0389, 0x038A, 0x00BB, 0x038C, 0x00BD, 0x038E, 0x038F,
+	0x0390, 0x0391, 0x0392, 0x0393, 0x0394, 0x0395, 0x0396, 0x0397,
+	0x0398, 0x0399, 0x039A, 0x039B, 0x039C, 0x039D, 0x039E, 0x039F,
+	0x03A0, 0x03A1, 0x0000, 0x03A3, 0x03A4, 0x03A5, 0x03A6, 0x03A7,
+	0x03A8, 0x03A9, 0x03AA, 0x03AB, 0x03AC, 0x03AD, 0x03AE, 0x03AF,
+	0x03B0, 0x03B1, 0x03B2, 0x03B3, 0x03B4, 0x03B5, 0x03B6, 0x03B7,
+	0x03B8, 0x03B9, 0x03BA, 0x03BB, 0x03BC, 0x03BD, 0x03BE, 0x03BF,
+	0x03C0, 0x03C1, 0x03C2, 0x03C3, 0x03C4, 0x03C5, 0x03C6, 0x03C7,
+	0x03C8, 0x03C9, 0x03CA, 0x03CB, 0x03CC, 0x03CD, 0x03CE, 0x0000,
+};
+
+static const uint16_t iso8859_8_chars[96] = {
+	0x00A0, 0x0000, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7,
+	0x00A8, 0x00A9, 0x00D7, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF,
+	0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+	0x00B8, 0x00B9, 0x00F7, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x0000,
+	0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2017,
+	0x05D0, 0x05D1, 0x05D2, 0x05D3, 0x05D4, 0x05D5, 0x05D6, 0x05D7,
+	0x05D8, 0x05D9, 0x05DA, 0x05DB, 0x05DC, 0x05DD, 0x05DE, 0x05DF,
+	0x05E0, 0x05E1, 0x05E2, 0x05E3, 0x05E4, 0x05E5, 0x05E6, 0x05E7,
+	0x05E8, 0x05E9, 0x05EA, 0x0000, 0x0000, 0x200E, 0x200F, 0x0000,
+};
+
+static const uint16_t iso8859_9_chars[96] = {
+	0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7,
+	0x00A8, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF,
+	0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+	0x00B8, 0x00B9, 0x00BA, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF,
+	0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7,
+	0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+	0x011E, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7,
+	0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x0130, 0x015E, 0x00DF,
+	0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+	0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+	0x011F, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x00F7,
+	0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x0131, 0x015F, 0x00FF,
+};
+
+static const uint16_t iso8859_10_chars[96] = {
+	0x00A0, 0x0104, 0x0112, 0x0122, 0x012A, 0x0128, 0x0136, 0x00A7,
+	0x013B, 0x0110, 0x0160, 0x0166, 0x017D, 0x00AD, 0x016A, 0x014A,
+	0x00B0, 0x0105, 0x0113, 0x0123, 0x012B, 0x0129, 0x0137, 0x00B7,
+	0x013C, 0x0111, 0x0161, 0x0167, 0x017E, 0x2015, 0x016B, 0x014B,
+	0x0100, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x012E,
+	0x010C, 0x00C9, 0x0118, 0x00CB, 0x0116, 0x00CD, 0x00CE, 0x00CF,
+	0x00D0, 0x0145, 0x014C, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x0168,
+	0x00D8, 0x0172, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x00DF,
+	0x0101, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x012F,
+	0x010D, 0x00E9, 0x0119, 0x00EB, 0x0117, 0x00ED, 0x00EE, 0x00EF,
+	0x00F0, 0x0146, 0x014D, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x0169,
+	0x00F8, 0x0173, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x0138,
+};
+
+static const uint16_t iso8859_11_chars[96] = {
+	0x00A0, 0x0E01, 0x0E02, 0x0E03, 0x0E04, 0x0E05, 0x0E06, 0x0E07,
+	0x0E08, 0x0E09, 0x0E0A, 0x0E0B, 0x0E0C, 0x0E0D, 0x0E0E, 0x0E0F,
+	0x0E10, 0x0E11, 0x0E12, 0x0E13, 0x0E14, 0x0E15, 0x0E16, 0x0E17,
+	0x0E18, 0x0E19, 0x0E1A, 0x0E1B, 0x0E1C, 0x0E1D, 0x0E1E, 0x0E1F,
+	0x0E20, 0x0E21, 0x0E22, 0x0E23, 0x0E24, 0x0E25, 0x0E26, 0x0E27,
+	0x0E28, 0x0E29, 0x0E2A, 0x0E2B, 0x0E2C, 0x0E2D, 0x0E2E, 0x0E2F,
+	0x0E30, 0x0E31, 0x0E32, 0x0E33, 0x0E34, 0x0E35, 0x0E36, 0x0E37,
+	0x0E38, 0x0E39, 0x0E3A, 0x0000, 0x0000, 0x0000, 0x0000, 0x0E3F,
+	0x0E40, 0x0E41, 0x0E42, 0x0E43, 0x0E44, 0x0E45, 0x0E46, 0x0E47,
+	0x0E48, 0x0E49, 0x0E4A, 0x0E4B, 0x0E4C, 0x0E4D, 0x0E4E, 0x0E4F,
+	0x0E50, 0x0E51, 0x0E52, 0x0E53, 0x0E54, 0x0E55, 0x0E56, 0x0E57,
+	0x0E58, 0x0E59, 0x0E5A, 0x0E5B, 0x0000, 0x0000, 0x0000, 0x0000,
+};
+
+static const uint16_t iso8859_13_chars[96] = {
+	0x00A0, 0x201D, 0x00A2, 0x00A3, 0x00A4, 0x201E, 0x00A6, 0x00A7,
+	0x00D8, 0x00A9, 0x0156, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00C6,
+	0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x201C, 0x00B5, 0x00B6, 0x00B7,
+	0x00F8, 0x00B9, 0x0157, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00E6,
+	0x0104, 0x012E, 0x0100, 0x0106, 0x00C4, 0x00C5, 0x0118, 0x0112,
+	0x010C, 0x00C9, 0x0179, 0x0116, 0x0122, 0x0136, 0x012A, 0x013B,
+	0x0160, 0x0143, 0x0145, 0x00D3, 0x014C, 0x00D5, 0x00D6, 0x00D7,
+	0x0172, 0x0141, 0x015A, 0x016A, 0x00DC, 0x017B, 0x017D, 0x00DF,
+	0x0105, 0x012F, 0x0101, 0x0107, 0x00E4, 0x00E5, 0x0119, 0x0113,
+	0x010D, 0x00E9, 0x017A, 0x0117, 0x0123, 0x0137, 0x012B, 0x013C,
+	0x0161, 0x0144, 0x0146, 0x00F3, 0x014D, 0x00F5, 0x00F6, 0x00F7,
+	0x0173, 0x0142, 0x015B, 0x016B, 0x00FC, 0x017C, 0x017E, 0x2019,
+};
+
+static const uint16_t iso8859_14_chars[96] = {
+	0x00A0, 0x1E02, 0x1E03, 0x00A3, 0x010A, 0x010B, 0x1E0A, 0x00A7,
+	0x1E80, 0x00A9, 0x1E82, 0x1E0B, 0x1EF2, 0x00AD, 0x00AE, 0x0178,
+	0x1E1E, 0x1E1F, 0x0120, 0x0121, 0x1E40, 0x1E41, 0x00B6, 0x1E56,
+	0x1E81, 0x1E57, 0x1E83, 0x1E60, 0x1EF3, 0x1E84, 0x1E85, 0x1E61,
+	0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7,
+	0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+	0x0174, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x1E6A,
+	0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x0176, 0x00DF,
+	0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+	0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+	0x0175, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x1E6B,
+	0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x0177, 0x00FF,
+};
+
+static const uint16_t iso8859_15_chars[96] = {
+	0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x20AC, 0x00A5, 0x0160, 0x00A7,
+	0x0161, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF,
+	0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x017D, 0x00B5, 0x00B6, 0x00B7,
+	0x017E, 0x00B9, 0x00BA, 0x00BB, 0x0152, 0x0153, 0x0178, 0x00BF,
+	0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7,
+	0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+	0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7,
+	0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x00DF,
+	0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+	0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+	0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x00F7,
+	0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF,
+};
+
+static const uint16_t iso8859_16_chars[96] = {
+	0x00A0, 0x0104, 0x0105, 0x0141, 0x20AC, 0x201E, 0x0160, 0x00A7,
+	0x0161, 0x00A9, 0x0218, 0x00AB, 0x0179, 0x00AD, 0x017A, 0x017B,
+	0x00B0, 0x00B1, 0x010C, 0x0142, 0x017D, 0x201D, 0x00B6, 0x00B7,
+	0x017E, 0x010D, 0x0219, 0x00BB, 0x0152, 0x0153, 0x0178, 0x017C,
+	0x00C0, 0x00C1, 0x00C2, 0x0102, 0x00C4, 0x0106, 0x00C6, 0x00C7,
+	0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+	0x0110, 0x0143, 0x00D2, 0x00D3, 0x00D4, 0x0150, 0x00D6, 0x015A,
+	0x0170, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x0118, 0x021A, 0x00DF,
+	0x00E0, 0x00E1, 0x00E2, 0x0103, 0x00E4, 0x0107, 0x00E6, 0x00E7,
+	0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+	0x0111, 0x0144, 0x00F2, 0x00F3, 0x00F4, 0x0151, 0x00F6, 0x015B,
+	0x0171, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x0119, 0x021B, 0x00FF,
+};
+
+/**\brief ISO-8859各部分0xA0~0xFF的字符，0表示未定义，第1部分与Unicode相同*/
+static const uint16_t * const iso8859_tables[] = {
+	NULL,
+	NULL,
+	iso8859_2_chars,
+	iso8859_3_chars,
+	iso8859_4_chars,
+	iso8859_5_chars,
+	iso8859_6_chars,
+	iso8859_7_chars,
+	iso8859_8_chars,
+	iso8859_9_chars,
+	iso8859_10_chars,
+	iso8859_11_chars,
+	NULL,
+	iso8859_13_chars,
+	iso8859_14_chars,
+	iso8859_15_chars,
+	iso8859_16_chars,
+};
+
+/*由iso6937_combined_chars生成，[变音符号-0xC1][基本字符-0x20]*/
+static uint16_t iso6937_combined_map[15][96];
+
 
 /**\brief 从dvbpsi_psi_section_t结构创建PAT表*/
 static AM_ErrorCode_t si_decode_pat(void **p_table, dvbpsi_psi_section_t *p_section)
@@ -105,7 +434,7 @@ static AM_ErrorCode_t si_decode_pat(void **p_table, dvbpsi_psi_section_t *p_sect
 	assert(p_table && p_section);
 
 	/*Allocate a new table*/
-	p_pat = (dvbpsi_pat_t*)malloc(sizeof(dvbpsi_pat_t));
+	p_pat = (dvbpsi_pat_t*)dvbpsi_malloc(sizeof(dvbpsi_pat_t));
 	if (p_pat == NULL)
 	{
 		*p_table = NULL;
@@ -134,7 +463,7 @@ static AM_ErrorCode_t si_decode_pmt(void **p_table, dvbpsi_psi_section_t *p_sect
 	assert(p_table && p_section);
 
 	/*Allocate a new table*/
-	p_pmt = (dvbpsi_pmt_t*)malloc(sizeof(dvbpsi_pmt_t));
+	p_pmt = (dvbpsi_pmt_t*)dvbpsi_malloc(sizeof(dvbpsi_pmt_t));
 	/*need init p_pmt*/
 	memset(p_pmt, 0, sizeof(dvbpsi_pmt_t));
 	if (p_pmt == NULL)
@@ -167,7 +496,7 @@ static AM_ErrorCode_t si_decode_cat(void **p_table, dvbpsi_psi_section_t *p_sect
 	assert(p_table && p_section);
 
 	/*Allocate a new table*/
-	p_cat = (dvbpsi_cat_t*)malloc(sizeof(dvbpsi_cat_t));
+	p_cat = (dvbpsi_cat_t*)dvbpsi_malloc(sizeof(dvbpsi_cat_t));
 	if (p_cat == NULL)
 	{
 		*p_table = NULL;
@@ -195,7 +524,7 @@ static AM_ErrorCode_t si_decode_nit(void **p_table, dvbpsi_psi_section_t *p_sect
 	assert(p_table && p_section);
 
 	/*Allocate a new table*/
-	p_nit = (dvbpsi_nit_t*)malloc(sizeof(dvbpsi_nit_t));
+	p_nit = (dvbpsi_nit_t*)dvbpsi_malloc(sizeof(dvbpsi_nit_t));
 	if (p_nit == NULL)
 	{
 		*p_table = NULL;
@@ -224,7 +553,7 @@ static AM_ErrorCode_t si_decode_bat(void **p_table, dvbpsi_psi_section_t *p_sect
 	assert(p_table && p_section);
 
 	/*Allocate a new table*/
-	p_bat = (dvbpsi_bat_t*)malloc(sizeof(dvbpsi_bat_t));
+	p_bat = (dvbpsi_bat_t*)dvbpsi_malloc(sizeof(dvbpsi_bat_t));
 	if (p_bat == NULL)
 	{
 		*p_table = NULL;
@@ -254,7 +583,7 @@ static AM_ErrorCode_t si_decode_sdt(void **p_table, dvbpsi_psi_section_t *p_sect
 	assert(p_table && p_section);
 
 	/*Allocate a new table*/
-	p_sdt = (dvbpsi_sdt_t*)malloc(sizeof(dvbpsi_sdt_t));
+	p_sdt = (dvbpsi_sdt_t*)dvbpsi_malloc(sizeof(dvbpsi_sdt_t));
 	if (p_sdt == NULL)
 	{
 		*p_table = NULL;
@@ -285,7 +614,7 @@ static AM_ErrorCode_t si_decode_eit(void **p_table, dvbpsi_psi_section_t *p_sect
 	assert(p_table && p_section);
 
 	/*Allocate a new table*/
-	p_eit = (dvbpsi_eit_t*)malloc(sizeof(dvbpsi_eit_t));
+	p_eit = (dvbpsi_eit_t*)dvbpsi_malloc(sizeof(dvbpsi_eit_t));
 	if (p_eit == NULL)
 	{
 		*p_table = NULL;
@@ -320,7 +649,7 @@ static AM_ErrorCode_t si_decode_tot(void **p_table, dvbpsi_psi_section_t *p_sect
 	assert(p_table && p_section);
 
 	/*Allocate a new table*/
-	p_tot = (dvbpsi_tot_t*)malloc(sizeof(dvbpsi_tot_t));
+	p_tot = (dvbpsi_tot_t*)dvbpsi_malloc(sizeof(dvbpsi_tot_t));
 	if (p_tot == NULL)
 	{
 		*p_table = NULL;
@@ -350,7 +679,7 @@ static AM_ErrorCode_t si_decode_atsc_mgt(void **p_table, dvbpsi_psi_section_t *p
 	assert(p_table && p_section);
 
 	/*Allocate a new table*/
-	p_mgt = (dvbpsi_atsc_mgt_t*)malloc(sizeof(dvbpsi_atsc_mgt_t));
+	p_mgt = (dvbpsi_atsc_mgt_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_mgt_t));
 	if (p_mgt == NULL)
 	{
 		*p_table = NULL;
@@ -381,7 +710,7 @@ static AM_ErrorCode_t si_decode_atsc_vct(void **p_table, dvbpsi_psi_section_t *p
 	assert(p_table && p_section);
 
 	/*Allocate a new table*/
-	p_vct = (dvbpsi_atsc_vct_t*)malloc(sizeof(dvbpsi_atsc_vct_t));
+	p_vct = (dvbpsi_atsc_vct_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_vct_t));
 	if (p_vct == NULL)
 	{
 		*p_table = NULL;
@@ -413,7 +742,7 @@ static AM_ErrorCode_t si_decode_atsc_stt(void **p_table, dvbpsi_psi_section_t *p
 	assert(p_table && p_section);
 
 	/*Allocate a new table*/
-	p_stt = (dvbpsi_atsc_stt_t*)malloc(sizeof(dvbpsi_atsc_stt_t));
+	p_stt = (dvbpsi_atsc_stt_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_stt_t));
 	if (p_stt == NULL)
 	{
 		*p_table = NULL;
@@ -443,7 +772,7 @@ static AM_ErrorCode_t si_decode_atsc_eit(void **p_table, dvbpsi_psi_section_t *p
 	assert(p_table && p_section);
 
 	/*Allocate a new table*/
-	p_eit = (dvbpsi_atsc_eit_t*)malloc(sizeof(dvbpsi_atsc_eit_t));
+	p_eit = (dvbpsi_atsc_eit_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_eit_t));
 	if (p_eit == NULL)
 	{
 		*p_table = NULL;
@@ -475,7 +804,7 @@ static AM_ErrorCode_t si_decode_atsc_cea(void **p_table, dvbpsi_psi_section_t *p
 	assert(p_table && p_section);
 
 	/*Allocate a new table*/
-	p_cea = (dvbpsi_atsc_cea_t*)malloc(sizeof(dvbpsi_atsc_cea_t));
+	p_cea = (dvbpsi_atsc_cea_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_cea_t));
 	if (p_cea == NULL)
 	{
 		*p_table = NULL;
@@ -504,7 +833,7 @@ static AM_ErrorCode_t si_decode_atsc_ett(void **p_table, dvbpsi_psi_section_t *p
 	assert(p_table && p_section);
 
 	/*Allocate a new table*/
-	p_ett = (dvbpsi_atsc_ett_t*)malloc(sizeof(dvbpsi_atsc_ett_t));
+	p_ett = (dvbpsi_atsc_ett_t*)dvbpsi_malloc(sizeof(dvbpsi_atsc_ett_t));
 	if (p_ett == NULL)
 	{
 		*p_table = NULL;
@@ -564,13 +893,12 @@ static AM_ErrorCode_t si_get_section_header(uint8_t *buf, AM_SI_SectionHeader_t
 	return AM_SUCCESS;
 }
 
-/**\brief 从section原始数据生成dvbpsi_psi_section_t类型的数据*/
-static AM_ErrorCode_t si_gen_dvbpsi_section(uint8_t *buf, uint16_t len, dvbpsi_psi_section_t **psi_sec)
+/**\brief 从section原始数据生成dvbpsi_psi_section_t类型的数据，p_section只在解析过程中使用*/
+static AM_ErrorCode_t si_gen_dvbpsi_section(uint8_t *buf, uint16_t len, dvbpsi_psi_section_t *p_section)
 {
-	dvbpsi_psi_section_t * p_section;
 	AM_SI_SectionHeader_t header;
 
-	assert(buf && psi_sec);
+	assert(buf && p_section);
 
 	/*Check the section header*/
 	AM_TRY(si_get_section_header(buf, &header));
@@ -580,14 +908,6 @@ static AM_ErrorCode_t si_gen_dvbpsi_section(uint8_t *buf, uint16_t len, dvbpsi_p
 		return AM_SI_ERR_INVALID_SECTION_DATA;
 	}
 
-	/* Allocate the dvbpsi_psi_section_t structure */
-	p_section  = (dvbpsi_psi_section_t*)malloc(sizeof(dvbpsi_psi_section_t));
-	if (p_section == NULL)
-	{
-		AM_DEBUG(1, "Cannot alloc new psi section, no enough memory");
-		return AM_SI_ERR_NO_MEM;
-	}
-
 	/*Fill the p_section*/
 	p_section->i_table_id = header.table_id;
 	p_section->b_syntax_indicator = header.syntax_indicator;
@@ -611,8 +931,6 @@ static AM_ErrorCode_t si_gen_dvbpsi_section(uint8_t *buf, uint16_t len, dvbpsi_p
 	}
 	p_section->p_next = NULL;
 
- 	*psi_sec = p_section;
-
  	return AM_SUCCESS;
 }
 
@@ -706,430 +1024,274 @@ void si_decode_descriptor(dvbpsi_descriptor_t *descr, void *user)
 #endif
 	SI_Descriptor_Flag_t flag = (SI_Descriptor_Flag_t)(long)user;
 
+	/*延迟解析时由AM_SI_GetDecodedDescriptor()解析*/
+	if (pthread_getspecific(si_lazy_descr_key))
+		return;
+
 	si_decode_descriptor_ex(descr, flag);
 }
 
+static void si_iconv_cache_free(void *arg)
+{
+	SI_IConvCache_t *cache = (SI_IConvCache_t*)arg;
+	int i;
+
+	for (i = 0; i < cache->count; i++)
+		iconv_close(cache->convs[i].handle);
+
+	free(cache);
+}
+
+static void si_init(void)
+{
+	int i;
+
+	pthread_key_create(&si_lazy_descr_key, NULL);
+	pthread_key_create(&si_iconv_key, si_iconv_cache_free);
+
+	for (i = 0; i < (int)AM_ARRAY_SIZE(iso6937_combined_chars); i++)
+	{
+		iso6937_combined_map[iso6937_combined_chars[i].diacritic - 0xC1]
+			[iso6937_combined_chars[i].base - 0x20] = iso6937_combined_chars[i].ch;
+	}
+}
+
+/**\brief 取得当前线程中将coding转换为UTF-8的iconv句柄，用完后调用si_iconv_release*/
+static iconv_t si_iconv_acquire(const char *coding)
+{
+	SI_IConvCache_t *cache;
+	SI_IConv_t conv;
+	int i;
+
+	cache = (SI_IConvCache_t*)pthread_getspecific(si_iconv_key);
+	if (!cache)
+	{
+		cache = (SI_IConvCache_t*)calloc(1, sizeof(SI_IConvCache_t));
+		if (cache && pthread_setspecific(si_iconv_key, cache))
+		{
+			free(cache);
+			cache = NULL;
+		}
+	}
+
+	if (!cache || strlen(coding) >= sizeof(conv.coding))
+		return iconv_open("utf-8", coding);
+
+	for (i = 0; i < cache->count; i++)
+	{
+		if (!strcmp(cache->convs[i].coding, coding))
+			break;
+	}
+
+	if (i < cache->count)
+	{
+		conv = cache->convs[i];
+		/*复位转换状态*/
+		iconv(conv.handle, NULL, NULL, NULL, NULL);
+	}
+	else
+	{
+		conv.handle = iconv_open("utf-8", coding);
+		if (conv.handle == (iconv_t)-1)
+			return conv.handle;
+		strcpy(conv.coding, coding);
+
+		if (cache->count < SI_ICONV_CACHE_SIZE)
+		{
+			i = cache->count++;
+		}
+		else
+		{
+			i = cache->count - 1;
+			iconv_close(cache->convs[i].handle);
+		}
+	}
+
+	/*最近使用的放在最前*/
+	memmove(&cache->convs[1], &cache->convs[0], i * sizeof(SI_IConv_t));
+	cache->convs[0] = conv;
+
+	return conv.handle;
+}
+
+/**\brief 释放si_iconv_acquire取得的句柄，转换出错时句柄不再缓存*/
+static void si_iconv_release(iconv_t handle, AM_Bool_t ok)
+{
+	SI_IConvCache_t *cache;
+
+	cache = (SI_IConvCache_t*)pthread_getspecific(si_iconv_key);
+	if (cache && cache->count && (cache->convs[0].handle == handle))
+	{
+		if (ok)
+			return;
+
+		cache->count--;
+		memmove(&cache->convs[0], &cache->convs[1], cache->count * sizeof(SI_IConv_t));
+	}
+
+	iconv_close(handle);
+}
+
+/**\brief 将一个Unicode字符以UTF-8编码写入dest
+ * \return 写入的字节数，空间不足时返回0
+ */
+static AM_INLINE int si_put_utf8(uint16_t ch, uint8_t *dest, int left)
+{
+	if (ch < 0x80)
+	{
+		if (left < 1)
+			return 0;
+		dest[0] = ch;
+		return 1;
+	}
+	else if (ch < 0x800)
+	{
+		if (left < 2)
+			return 0;
+		dest[0] = (ch >> 6) | 0xC0;
+		dest[1] = (ch & 0x3F) | 0x80;
+		return 2;
+	}
 
-/**\brief 将ISO6937转换为UTF-8编码*/
+	if (left < 3)
+		return 0;
+	dest[0] = (ch >> 12) | 0xE0;
+	dest[1] = ((ch >> 6) & 0x3F) | 0x80;
+	dest[2] = (ch & 0x3F) | 0x80;
+	return 3;
+}
+
+/*C1控制字符，与AM_Check_UTF8一样在输出中去掉*/
+#define SI_IS_C1_CONTROL(ch) (((ch) >= 0x80) && ((ch) <= 0x9F))
+
+/**\brief 将ISO6937转换为UTF-8编码
+ * 查表得到Unicode后直接写入dest，遇到0结束，dest_len返回写入的字节数
+ */
 static AM_ErrorCode_t si_convert_iso6937_to_utf8(const char *src, int src_len, char *dest, int *dest_len)
 {
+	const uint8_t *s = (const uint8_t*)src;
+	uint8_t *d = (uint8_t*)dest;
+	int i = 0, dlen = 0, nchar = 0, n;
 	uint16_t ch;
-	long dlen, i;
 	uint8_t b;
-	char *ucs2 = NULL;
-
-#define READ_BYTE()\
-	({\
-		uint8_t ret;\
-		if (i >= src_len) ret=0;\
-		else ret = (uint8_t)src[i];\
-		i++;\
-		ret;\
-	})
 
 	if (!src || !dest || !dest_len || src_len <= 0)
-		return -1;
-
-	/* first covert to UCS-2, then iconv to utf8 */
-	ucs2 = (char *)malloc(src_len*2);
-	if (!ucs2)
-		return -1;
-	dlen = 0;
-	i=0;
-	b = READ_BYTE();
-	if (b < 0x20)
+		return AM_FAILURE;
+
+	if (s[0] < 0x20)
 	{
 		/* ISO 6937 encoding must start with character between 0x20 and 0xFF
 		 otherwise it is dfferent encoding table
 		 for example 0x05 means encoding table 8859-9 */
-		return -1;
+		return AM_FAILURE;
 	}
 
-	while (b != 0)
+	while (i < src_len)
 	{
-		ch = 0x00;
-		switch (b)
+		b = s[i++];
+		if (!b)
+			break;
+
+		if ((b >= 0xC1) && (b <= 0xCF) && (b != 0xC9) && (b != 0xCC))
 		{
-			/* at first single byte characters */
-			case 0xA8: ch = 0x00A4; break;
-			case 0xA9: ch = 0x2018; break;
-			case 0xAA: ch = 0x201C; break;
-			case 0xAC: ch = 0x2190; break;
-			case 0xAD: ch = 0x2191; break;
-			case 0xAE: ch = 0x2192; break;
-			case 0xAF: ch = 0x2193; break;
-			case 0xB4: ch = 0x00D7; break;
-			case 0xB8: ch = 0x00F7; break;
-			case 0xB9: ch = 0x2019; break;
-			case 0xBA: ch = 0x201D; break;
-			case 0xD0: ch = 0x2014; break;
-			case 0xD1: ch = 0xB9; break;
-			case 0xD2: ch = 0xAE; break;
-			case 0xD3: ch = 0xA9; break;
-			case 0xD4: ch = 0x2122; break;
-			case 0xD5: ch = 0x266A; break;
-			case 0xD6: ch = 0xAC; break;
-			case 0xD7: ch = 0xA6; break;
-			case 0xDC: ch = 0x215B; break;
-			case 0xDD: ch = 0x215C; break;
-			case 0xDE: ch = 0x215D; break;
-			case 0xDF: ch = 0x215E; break;
-			case 0xE0: ch = 0x2126; break;
-			case 0xE1: ch = 0xC6; break;
-			case 0xE2: ch = 0xD0; break;
-			case 0xE3: ch = 0xAA; break;
-			case 0xE4: ch = 0x126; break;
-			case 0xE6: ch = 0x132; break;
-			case 0xE7: ch = 0x013F; break;
-			case 0xE8: ch = 0x141; break;
-			case 0xE9: ch = 0xD8; break;
-			case 0xEA: ch = 0x152; break;
-			case 0xEB: ch = 0xBA; break;
-			case 0xEC: ch = 0xDE; break;
-			case 0xED: ch = 0x166; break;
-			case 0xEE: ch = 0x014A; break;
-			case 0xEF: ch = 0x149; break;
-			case 0xF0: ch = 0x138; break;
-			case 0xF1: ch = 0xE6; break;
-			case 0xF2: ch = 0x111; break;
-			case 0xF3: ch = 0xF0; break;
-			case 0xF4: ch = 0x127; break;
-			case 0xF5: ch = 0x131; break;
-			case 0xF6: ch = 0x133; break;
-			case 0xF7: ch = 0x140; break;
-			case 0xF8: ch = 0x142; break;
-			case 0xF9: ch = 0xF8; break;
-			case 0xFA: ch = 0x153; break;
-			case 0xFB: ch = 0xDF; break;
-			case 0xFC: ch = 0xFE; break;
-			case 0xFD: ch = 0x167; break;
-			case 0xFE: ch = 0x014B; break;
-			case 0xFF: ch = 0xAD; break;
-			/* multibyte */
-			case 0xC1:
-				b = READ_BYTE();
-				switch (b)
-				{
-					case 0x41: ch = 0xC0; break;
-					case 0x45: ch = 0xC8; break;
-					case 0x49: ch = 0xCC; break;
-					case 0x4F: ch = 0xD2; break;
-					case 0x55: ch = 0xD9; break;
-					case 0x61: ch = 0xE0; break;
-					case 0x65: ch = 0xE8; break;
-					case 0x69: ch = 0xEC; break;
-					case 0x6F: ch = 0xF2; break;
-					case 0x75: ch = 0xF9; break;
-					// unknown character --> fallback
-					default: ch = b; break;
-				}
-				break;
-			case 0xC2:
-				b = READ_BYTE();
-				switch (b)
-				{
-					case 0x20: ch = 0xB4; break;
-					case 0x41: ch = 0xC1; break;
-					case 0x43: ch = 0x106; break;
-					case 0x45: ch = 0xC9; break;
-					case 0x49: ch = 0xCD; break;
-					case 0x4C: ch = 0x139; break;
-					case 0x4E: ch = 0x143; break;
-					case 0x4F: ch = 0xD3; break;
-					case 0x52: ch = 0x154; break;
-					case 0x53: ch = 0x015A; break;
-					case 0x55: ch = 0xDA; break;
-					case 0x59: ch = 0xDD; break;
-					case 0x5A: ch = 0x179; break;
-					case 0x61: ch = 0xE1; break;
-					case 0x63: ch = 0x107; break;
-					case 0x65: ch = 0xE9; break;
-					case 0x69: ch = 0xED; break;
-					case 0x6C: ch = 0x013A; break;
-					case 0x6E: ch = 0x144; break;
-					case 0x6F: ch = 0xF3; break;
-					case 0x72: ch = 0x155; break;
-					case 0x73: ch = 0x015B; break;
-					case 0x75: ch = 0xFA; break;
-					case 0x79: ch = 0xFD; break;
-					case 0x7A: ch = 0x017A; break;
-					// unknown character --> fallback
-					default: ch = b; break;
-				}
-				break;
+			/*变音符号后跟基本字符，未知的组合只保留基本字符*/
+			uint8_t base = (i < src_len) ? s[i++] : 0;
 
-			case 0xC3:
-				b = READ_BYTE();
-				switch (b)
-				{
-					case 0x41: ch = 0xC2; break;
-					case 0x43: ch = 0x108; break;
-					case 0x45: ch = 0xCA; break;
-					case 0x47: ch = 0x011C; break;
-					case 0x48: ch = 0x124; break;
-					case 0x49: ch = 0xCE; break;
-					case 0x4A: ch = 0x134; break;
-					case 0x4F: ch = 0xD4; break;
-					case 0x53: ch = 0x015C; break;
-					case 0x55: ch = 0xDB; break;
-					case 0x57: ch = 0x174; break;
-					case 0x59: ch = 0x176; break;
-					case 0x61: ch = 0xE2; break;
-					case 0x63: ch = 0x109; break;
-					case 0x65: ch = 0xEA; break;
-					case 0x67: ch = 0x011D; break;
-					case 0x68: ch = 0x125; break;
-					case 0x69: ch = 0xEE; break;
-					case 0x6A: ch = 0x135; break;
-					case 0x6F: ch = 0xF4; break;
-					case 0x73: ch = 0x015D; break;
-					case 0x75: ch = 0xFB; break;
-					case 0x77: ch = 0x175; break;
-					case 0x79: ch = 0x177; break;
-					// unknown character --> fallback
-					default: ch = b; break;
-				}
-				break;
-			case 0xC4:
-				b = READ_BYTE();
-				switch (b)
-				{
-					case 0x41: ch = 0xC3; break;
-					case 0x49: ch = 0x128; break;
-					case 0x4E: ch = 0xD1; break;
-					case 0x4F: ch = 0xD5; break;
-					case 0x55: ch = 0x168; break;
-					case 0x61: ch = 0xE3; break;
-					case 0x69: ch = 0x129; break;
-					case 0x6E: ch = 0xF1; break;
-					case 0x6F: ch = 0xF5; break;
-					case 0x75: ch = 0x169; break;
-					// unknown character --> fallback
-					default: ch = b; break;
-				}
-				break;
-			case 0xC5:
-				b = READ_BYTE();
-				switch (b)
-				{
-					case 0x20: ch = 0xAF; break;
-					case 0x41: ch = 0x100; break;
-					case 0x45: ch = 0x112; break;
-					case 0x49: ch = 0x012A; break;
-					case 0x4F: ch = 0x014C; break;
-					case 0x55: ch = 0x016A; break;
-					case 0x61: ch = 0x101; break;
-					case 0x65: ch = 0x113; break;
-					case 0x69: ch = 0x012B; break;
-					case 0x6F: ch = 0x014D; break;
-					case 0x75: ch = 0x016B; break;
-					// unknown character --> fallback
-					default: ch = b; break;
-				}
-				break;
-			case 0xC6:
-				b = READ_BYTE();
-				switch (b)
-				{
-					case 0x20: ch = 0x02D8; break;
-					case 0x41: ch = 0x102; break;
-					case 0x47: ch = 0x011E; break;
-					case 0x55: ch = 0x016C; break;
-					case 0x61: ch = 0x103; break;
-					case 0x67: ch = 0x011F; break;
-					case 0x75: ch = 0x016D; break;
-					// unknown character --> fallback
-					default: ch = b; break;
-				}
-				break;
-			case 0xC7:
-				b = READ_BYTE();
-				switch (b)
-				{
-					case 0x20: ch = 0x02D9; break;
-					case 0x43: ch = 0x010A; break;
-					case 0x45: ch = 0x116; break;
-					case 0x47: ch = 0x120; break;
-					case 0x49: ch = 0x130; break;
-					case 0x5A: ch = 0x017B; break;
-					case 0x63: ch = 0x010B; break;
-					case 0x65: ch = 0x117; break;
-					case 0x67: ch = 0x121; break;
-					case 0x7A: ch = 0x017C; break;
-					// unknown character --> fallback
-					default: ch = b; break;
-				}
+			if (!base)
 				break;
-			case 0xC8:
-				b = READ_BYTE();
-				switch (b)
-				{
-					case 0x20: ch = 0xA8; break;
-					case 0x41: ch = 0xC4; break;
-					case 0x45: ch = 0xCB; break;
-					case 0x49: ch = 0xCF; break;
-					case 0x4F: ch = 0xD6; break;
-					case 0x55: ch = 0xDC; break;
-					case 0x59: ch = 0x178; break;
-					case 0x61: ch = 0xE4; break;
-					case 0x65: ch = 0xEB; break;
-					case 0x69: ch = 0xEF; break;
-					case 0x6F: ch = 0xF6; break;
-					case 0x75: ch = 0xFC; break;
-					case 0x79: ch = 0xFF; break;
-					// unknown character --> fallback
-					default: ch = b; break;
-				}
-				break;
-			case 0xCA:
-				b = READ_BYTE();
-				switch (b)
-				{
-					case 0x20: ch = 0x02DA; break;
-					case 0x41: ch = 0xC5; break;
-					case 0x55: ch = 0x016E; break;
-					case 0x61: ch = 0xE5; break;
-					case 0x75: ch = 0x016F; break;
-					// unknown character --> fallback
-					default: ch = b; break;
-				}
-				break;
-			case 0xCB:
-				b = READ_BYTE();
-				switch (b)
-				{
-					case 0x20: ch = 0xB8; break;
-					case 0x43: ch = 0xC7; break;
-					case 0x47: ch = 0x122; break;
-					case 0x4B: ch = 0x136; break;
-					case 0x4C: ch = 0x013B; break;
-					case 0x4E: ch = 0x145; break;
-					case 0x52: ch = 0x156; break;
-					case 0x53: ch = 0x015E; break;
-					case 0x54: ch = 0x162; break;
-					case 0x63: ch = 0xE7; break;
-					case 0x67: ch = 0x123; break;
-					case 0x6B: ch = 0x137; break;
-					case 0x6C: ch = 0x013C; break;
-					case 0x6E: ch = 0x146; break;
-					case 0x72: ch = 0x157; break;
-					case 0x73: ch = 0x015F; break;
-					case 0x74: ch = 0x163; break;
-					// unknown character --> fallback
-					default: ch = b; break;
-				}
-				break;
-			case 0xCD:
-				b = READ_BYTE();
-				switch (b)
-				{
-					case 0x20: ch = 0x02DD; break;
-					case 0x4F: ch = 0x150; break;
-					case 0x55: ch = 0x170; break;
-					case 0x6F: ch = 0x151; break;
-					case 0x75: ch = 0x171; break;
-					// unknown character --> fallback
-					default: ch = b; break;
-				}
-				break;
-			case 0xCE:
-				b = READ_BYTE();
-				switch (b)
-				{
-					case 0x20: ch = 0x02DB; break;
-					case 0x41: ch = 0x104; break;
-					case 0x45: ch = 0x118; break;
-					case 0x49: ch = 0x012E; break;
-					case 0x55: ch = 0x172; break;
-					case 0x61: ch = 0x105; break;
-					case 0x65: ch = 0x119; break;
-					case 0x69: ch = 0x012F; break;
-					case 0x75: ch = 0x173; break;
-					// unknown character --> fallback
-					default: ch = b; break;
-				}
-				break;
-			case 0xCF:
-				b = READ_BYTE();
-				switch (b)
-				{
-					case 0x20: ch = 0x02C7; break;
-					case 0x43: ch = 0x010C; break;
-					case 0x44: ch = 0x010E; break;
-					case 0x45: ch = 0x011A; break;
-					case 0x4C: ch = 0x013D; break;
-					case 0x4E: ch = 0x147; break;
-					case 0x52: ch = 0x158; break;
-					case 0x53: ch = 0x160; break;
-					case 0x54: ch = 0x164; break;
-					case 0x5A: ch = 0x017D; break;
-					case 0x63: ch = 0x010D; break;
-					case 0x64: ch = 0x010F; break;
-					case 0x65: ch = 0x011B; break;
-					case 0x6C: ch = 0x013E; break;
-					case 0x6E: ch = 0x148; break;
-					case 0x72: ch = 0x159; break;
-					case 0x73: ch = 0x161; break;
-					case 0x74: ch = 0x165; break;
-					case 0x7A: ch = 0x017E; break;
-					// unknown character --> fallback
-					default: ch = b; break;
-				}
-				break;
-			/* rest is the same */
-			default: ch = b; break;
+
+			ch = 0;
+			if ((base >= 0x20) && (base < 0x80))
+				ch = iso6937_combined_map[b - 0xC1][base - 0x20];
+			if (!ch)
+				ch = base;
 		}
-		if (b != 0)
+		else if (b >= 0xA0)
 		{
-			b = READ_BYTE();
+			ch = iso6937_chars[b - 0xA0];
 		}
-		if (ch != 0)
+		else
 		{
-			/* dest buffer not enough, and this will not happen */
-			if ((dlen+1) >= (src_len*2))
-				goto iso6937_end;
-			ucs2[dlen++] = (ch&0xff00) >> 8;
-			ucs2[dlen++] = ch;
+			ch = b;
 		}
-	}
 
-iso6937_end:
-	if (dlen > 0)
-	{
-		iconv_t handle;
-		char *org_ucs2 = ucs2;
-		char **pin=&ucs2;
-		char **pout=&dest;
-		char *o_dest = dest;
-		size_t l_dest = *dest_len;
-		size_t l_dlen = dlen;
-
-		handle=iconv_open("utf-8","utf-16");
-		if (handle == (iconv_t)-1)
+		nchar++;
+		if (SI_IS_C1_CONTROL(ch))
+			continue;
+
+		n = si_put_utf8(ch, d + dlen, *dest_len - dlen);
+		if (!n)
 		{
-			AM_DEBUG(1, "iconv_open err: %d", errno);
+			*dest_len = dlen;
 			return AM_FAILURE;
 		}
+		dlen += n;
+	}
+
+	*dest_len = dlen;
 
-		if ((int)iconv(handle,pin,&l_dlen,pout, &l_dest) < 0)
+	return nchar ? AM_SUCCESS : AM_FAILURE;
+}
+
+/**\brief 返回ISO-8859编码的部分号，不能查表转换时返回0*/
+static int si_get_iso8859_part(const char *coding)
+{
+	char *end;
+	long part;
+
+	if (strncasecmp(coding, "ISO-8859-", 9))
+		return 0;
+
+	part = strtol(coding + 9, &end, 10);
+	if (*end || (part < 1) || (part >= (long)AM_ARRAY_SIZE(iso8859_tables)))
+		return 0;
+	if ((part != 1) && !iso8859_tables[part])
+		return 0;
+
+	return part;
+}
+
+/**\brief 查表将ISO-8859编码转换为UTF-8编码，遇到0结束，编码中未定义的字符被忽略*/
+static AM_ErrorCode_t si_convert_iso8859_to_utf8(int part, const char *src, int src_len, char *dest, int *dest_len)
+{
+	const uint16_t *table = iso8859_tables[part];
+	const uint8_t *s = (const uint8_t*)src;
+	uint8_t *d = (uint8_t*)dest;
+	int i, dlen = 0, n;
+	uint16_t ch;
+
+	for (i = 0; i < src_len; i++)
+	{
+		ch = s[i];
+		if (!ch)
+			break;
+
+		if (ch < 0x80)
 		{
-		    int i;
-		    AM_DEBUG(1, "iconv err:%d", errno);
-		    iconv_close(handle);
-		    return AM_FAILURE;
+			/*ASCII字符较多，直接写入*/
+			if (dlen >= *dest_len)
+				goto overflow;
+			d[dlen++] = ch;
+			continue;
 		}
 
-		*dest_len = l_dest;
-		AM_Check_UTF8(o_dest, *dest_len, o_dest, dest_len);
-
-		free(org_ucs2);
+		if ((ch >= 0xA0) && table)
+			ch = table[ch - 0xA0];
+		if (!ch || SI_IS_C1_CONTROL(ch))
+			continue;
 
-		return iconv_close(handle);
-    }
+		n = si_put_utf8(ch, d + dlen, *dest_len - dlen);
+		if (!n)
+			goto overflow;
+		dlen += n;
+	}
 
-    free(ucs2);
+	*dest_len = dlen;
+	return AM_SUCCESS;
 
-    return -1;
+overflow:
+	*dest_len = dlen;
+	return AM_FAILURE;
 }
 
 static void si_add_audio(AM_SI_AudioInfo_t *ai, int aud_pid, int aud_fmt, char lang[3],int audio_type,int audio_exten)
@@ -1261,8 +1423,11 @@ AM_ErrorCode_t AM_SI_Create(AM_SI_Handle_t *handle)
 	SET_DECODE_DESCRIPTOR_CALLBACK(atsc_eit, si_decode_descriptor, 0);
 	SET_DECODE_DESCRIPTOR_CALLBACK(atsc_ett, si_decode_descriptor, 0);
 
+	pthread_once(&si_init_once, si_init);
+
 	dec->prv_data = (void*)si_prv_data;
 	dec->allocated = AM_TRUE;
+	dec->lazy_descr = AM_FALSE;
 
 	*handle = dec;
 
@@ -1308,21 +1473,28 @@ AM_ErrorCode_t AM_SI_Destroy(AM_SI_Handle_t handle)
  */
 AM_ErrorCode_t AM_SI_DecodeSection(AM_SI_Handle_t handle, uint16_t pid, uint8_t *buf, uint16_t len, void **sec)
 {
+	dvbpsi_psi_section_t psi_section;
 	dvbpsi_psi_section_t *psi_sec = NULL;
 	AM_ErrorCode_t ret = AM_SUCCESS;
+	AM_Bool_t lazy_descr;
 	uint8_t table_id;
 
 	assert(buf && sec);
 	AM_TRY(si_check_handle(handle));
 
 	table_id = buf[0];
+	lazy_descr = ((SI_Decoder_t*)handle)->lazy_descr;
 
 	if (table_id <= AM_SI_TID_PSIP_CEA)
 	{
 		/*生成dvbpsi section*/
-		AM_TRY(si_gen_dvbpsi_section(buf, len, &psi_sec));
+		AM_TRY(si_gen_dvbpsi_section(buf, len, &psi_section));
+		psi_sec = &psi_section;
 	}
 
+	if (lazy_descr)
+		pthread_setspecific(si_lazy_descr_key, (void*)1);
+
 	*sec = NULL;
 	/*Decode*/
 	switch (table_id)
@@ -1420,13 +1592,95 @@ AM_ErrorCode_t AM_SI_DecodeSection(AM_SI_Handle_t handle, uint16_t pid, uint8_t
 			break;
 	}
 
-	/*release the psi_sec*/
-	if (psi_sec)
-		free(psi_sec);
+	if (lazy_descr)
+		pthread_setspecific(si_lazy_descr_key, NULL);
+
+	return ret;
+}
+
+/**\brief 解析一个section，解析数据全部从内存池中分配
+ * 用于解析后立即处理的section(如EIT)，处理完后调用AM_MEM_PoolClear()一次释放，
+ * 返回的数据不能用AM_SI_ReleaseSection()释放。不支持RRT。
+ * \param handle SI解析句柄
+ * \param pid section pid
+ * \param [in] buf section原始数据
+ * \param len section原始数据长度
+ * \param [in] pool 内存池，同一时间只能在一个线程中使用
+ * \param [out] sec 返回section解析后的数据
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码(见am_si.h)
+ */
+AM_ErrorCode_t AM_SI_DecodeSectionInPool(AM_SI_Handle_t handle, uint16_t pid, uint8_t *buf, uint16_t len, AM_MEM_Pool_t *pool, void **sec)
+{
+	AM_MEM_Pool_t *old;
+	AM_ErrorCode_t ret;
+
+	assert(buf && pool && sec);
+
+	/*RRT由atsc_psip解析，不使用dvbpsi的分配函数*/
+	if (buf[0] == AM_SI_TID_PSIP_RRT)
+	{
+		*sec = NULL;
+		return AM_SI_ERR_NOT_SUPPORTED;
+	}
+
+	old = dvbpsi_SetAllocPool(pool);
+	ret = AM_SI_DecodeSection(handle, pid, buf, len, sec);
+	dvbpsi_SetAllocPool(old);
 
 	return ret;
 }
 
+/**\brief 设置是否延迟解析描述符
+ * 延迟解析时AM_SI_DecodeSection()只保留描述符的原始数据(tag, 长度, 数据)，
+ * 描述符在第一次调用AM_SI_GetDecodedDescriptor()时才解析，之前p_decoded为NULL。
+ * 只有所有使用者都通过AM_SI_GetDecodedDescriptor()访问描述符时才能打开。
+ * \param handle SI解析句柄
+ * \param enable 是否延迟解析
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码(见am_si.h)
+ */
+AM_ErrorCode_t AM_SI_SetLazyDescriptorDecode(AM_SI_Handle_t handle, AM_Bool_t enable)
+{
+	AM_TRY(si_check_handle(handle));
+
+	((SI_Decoder_t*)handle)->lazy_descr = enable;
+
+	return AM_SUCCESS;
+}
+
+/**\brief 返回描述符解析后的数据，没有解析过时先解析，结果保存在p_decoded中
+ * 解析数据和描述符从同一个内存池分配，随section一起释放。
+ * 同一个section的描述符不能在多个线程中同时解析。
+ * \param [in] descr 描述符
+ * \param table_id 描述符所在表的table_id，用于区分同一tag的不同描述符
+ * \return
+ *   - 解析后的数据
+ *   - NULL 不支持的描述符或数据错误
+ */
+void *AM_SI_GetDecodedDescriptor(dvbpsi_descriptor_t *descr, uint8_t table_id)
+{
+	AM_MEM_Pool_t *old;
+	SI_Descriptor_Flag_t flag = 0;
+
+	assert(descr);
+
+	if (descr->p_decoded || !descr->p_data)
+		return descr->p_decoded;
+
+	/*NIT中的0x87为LCN描述符，与AM_SI_Create()中的设置一致*/
+	if (table_id == AM_SI_TID_NIT_ACT || table_id == AM_SI_TID_NIT_OTH)
+		flag = SI_DESCR_87_LCN;
+
+	old = dvbpsi_SetAllocPool((AM_MEM_Pool_t*)descr->p_pool);
+	si_decode_descriptor_ex(descr, flag);
+	dvbpsi_SetAllocPool(old);
+
+	return descr->p_decoded;
+}
+
 /**\brief 释放一个从 AM_SI_DecodeSection()返回的section
  * \param handle SI解析句柄
  * \param table_id 用于标示section类型
@@ -1614,11 +1868,15 @@ AM_ErrorCode_t AM_SI_GetDVBTextCodingAndData(char *in, int in_len, char *coding,
 //Covert @in to UTF8 @out
 AM_ErrorCode_t AM_SI_ConvertToUTF8(char *in, int in_len, char *out, int out_len, char *coding)
 {
+	int part;
+
 	if (!in || !out || in_len <= 0 || out_len <= 0 || !coding) {
 		AM_DEBUG(1,"%s : bad param\n", __FUNCTION__);
 		return AM_FAILURE;
 	}
 
+	pthread_once(&si_init_once, si_init);
+
 	memset(out,0,out_len);
 
 	if (! strcmp(coding, "ISO6937"))
@@ -1638,40 +1896,25 @@ AM_ErrorCode_t AM_SI_ConvertToUTF8(char *in, int in_len, char *out, int out_len,
 		return 0;
 	} else if (!strcmp(coding, "utf-16")) {
 		uint8_t *src, *dst;
-		uint16_t uc;
-		int sleft, dleft;
+		int sleft, dleft, n;
 
 		src = (uint8_t*)in;
 		dst = (uint8_t*)out;
 		sleft = in_len;
 		dleft = out_len;
 
-		while (sleft > 0) {
-			uc = (src[0] << 8) | src[1];
-
-			if (uc <= 0x7f) {
-				if (dleft < 1)
-					break;
-				dleft --;
-				*dst++ = uc;
-			} else if (uc <= 0x7ff) {
-				if (dleft < 2)
-					break;
-				dleft -= 2;
-				*dst++ = (uc >> 6) | 0xb0;
-				*dst++ = (uc & 0x3f) | 0x80;
-			} else {
-				if (dleft < 3)
-					break;
-				dleft -= 3;
-				*dst++ = (uc >> 12) | 0xe0;
-				*dst++ = ((uc >> 6) & 0x3f) | 0x80;
-				*dst++ = (uc & 0x3f) | 0x80;
-			}
+		while (sleft >= 2) {
+			n = si_put_utf8((src[0] << 8) | src[1], dst, dleft);
+			if (!n)
+				break;
 
+			dst += n;
+			dleft -= n;
 			src += 2;
 			sleft -= 2;
 		}
+	} else if ((part = si_get_iso8859_part(coding))) {
+		return si_convert_iso8859_to_utf8(part, in, in_len, out, &out_len);
 	} else {
 		char **pin = &in;
 		char **pout = &out;
@@ -1680,7 +1923,7 @@ AM_ErrorCode_t AM_SI_ConvertToUTF8(char *in, int in_len, char *out, int out_len,
 		size_t outLength = out_len;
 		iconv_t handle;
 
-		handle = iconv_open("utf-8", coding);
+		handle = si_iconv_acquire(coding);
 		if (handle == (iconv_t)-1) {
 			AM_DEBUG(1, "Covert DVB text code failed, iconv_open err: %d", errno);
 			return AM_FAILURE;
@@ -1688,11 +1931,11 @@ AM_ErrorCode_t AM_SI_ConvertToUTF8(char *in, int in_len, char *out, int out_len,
 		if ((int)iconv(handle, pin, &inLength, pout, &outLength) == -1) {
 		    AM_DEBUG(1, "Covert DVB text code failed, iconv err: %d, in_len %d, out_len %d",
 				errno, in_len, out_len);
-		    iconv_close(handle);
+		    si_iconv_release(handle, AM_FALSE);
 		    return AM_FAILURE;
 		}
 		AM_Check_UTF8(o_out, out_len, o_out, &out_len);
-		return iconv_close(handle);
+		si_iconv_release(handle, AM_TRUE);
 	}
 	return AM_SUCCESS;
 }
@@ -1864,7 +2107,7 @@ AM_ErrorCode_t AM_SI_ExtractAVFromES(dvbpsi_pmt_es_t *es, int *vid, int *vfmt, A
 					case AM_SI_DESCR_AC3:
 						AM_DEBUG(1, "!!Found AC3 Descriptor!!!");
 						afmt_tmp = AFORMAT_AC3;
-						if (descr->p_decoded != NULL)
+						if (AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT) != NULL)
 						{
 							AM_SI_GetAudioExten_from_AC3des((dvbpsi_AC3_dr_t*)descr->p_decoded,&audio_exten);
 						}
@@ -1872,7 +2115,7 @@ AM_ErrorCode_t AM_SI_ExtractAVFromES(dvbpsi_pmt_es_t *es, int *vid, int *vfmt, A
 					case AM_SI_DESCR_ENHANCED_AC3:
 						AM_DEBUG(1, "!!Found Enhanced AC3 Descriptor!!!");
 						afmt_tmp = AFORMAT_EAC3;
-						if (descr->p_decoded != NULL)
+						if (AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT) != NULL)
 						{
 							AM_SI_GetAudioExten_from_ENAC3des((dvbpsi_ENAC3_dr_t*)descr->p_decoded,&audio_exten);
 						}
@@ -1880,7 +2123,7 @@ AM_ErrorCode_t AM_SI_ExtractAVFromES(dvbpsi_pmt_es_t *es, int *vid, int *vfmt, A
 					case AM_SI_DESCR_PSIPENHANCED_AC3:
 						AM_DEBUG(1, "!!Found PSIP Enhanced AC3 Descriptor!!!");
 						afmt_tmp = AFORMAT_EAC3;
-						if (descr->p_decoded != NULL)
+						if (AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT) != NULL)
 						{
 							AM_SI_GetAudioExten_from_PSIPENAC3des((dvbpsi_PSIPENAC3_dr_t*)descr->p_decoded,&audio_exten);
 						}
@@ -1888,7 +2131,7 @@ AM_ErrorCode_t AM_SI_ExtractAVFromES(dvbpsi_pmt_es_t *es, int *vid, int *vfmt, A
 					case AM_SI_DESCR_PSIP_AUDIOSTREAM_AC3:
 						AM_DEBUG(1, "!!Found PSIP AC3 audio stream Descriptor!!!");
 						afmt_tmp = AFORMAT_AC3;
-						if (descr->p_decoded != NULL)
+						if (AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT) != NULL)
 						{
 							AM_SI_GetAudioExten_from_PSIPAC3AStreamdes((dvbpsi_atsc_ac3_audio_dr_t*)descr->p_decoded,&audio_exten);
 						}
@@ -1907,7 +2150,7 @@ AM_ErrorCode_t AM_SI_ExtractAVFromES(dvbpsi_pmt_es_t *es, int *vid, int *vfmt, A
 						break;
 					case AM_SI_DESCR_REGISTRATION:
 						AM_DEBUG(1, "!!Found Registeration Descriptor!!!");
-						if (descr->p_decoded != NULL)
+						if (AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT) != NULL)
 						{
 							dvbpsi_registration_dr_t *pregd = (dvbpsi_registration_dr_t*)descr->p_decoded;
 							switch (pregd->i_format_identifier)
@@ -1987,7 +2230,7 @@ AM_ErrorCode_t AM_SI_ExtractAVFromES(dvbpsi_pmt_es_t *es, int *vid, int *vfmt, A
 					case AM_SI_DESCR_AC3:
 						AM_DEBUG(1, "!!Found AC3 Descriptor!!!");
 						afmt_tmp = AFORMAT_AC3;
-						if (descr->p_decoded != NULL)
+						if (AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT) != NULL)
 						{
 							AM_SI_GetAudioExten_from_AC3des((dvbpsi_AC3_dr_t*)descr->p_decoded,&audio_exten);
 						}
@@ -1995,7 +2238,7 @@ AM_ErrorCode_t AM_SI_ExtractAVFromES(dvbpsi_pmt_es_t *es, int *vid, int *vfmt, A
 					case AM_SI_DESCR_ENHANCED_AC3:
 						AM_DEBUG(1, "!!Found Enhanced AC3 Descriptor!!!");
 						afmt_tmp = AFORMAT_EAC3;
-						if (descr->p_decoded != NULL)
+						if (AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT) != NULL)
 						{
 							AM_SI_GetAudioExten_from_ENAC3des((dvbpsi_ENAC3_dr_t*)descr->p_decoded,&audio_exten);
 						}
@@ -2003,7 +2246,7 @@ AM_ErrorCode_t AM_SI_ExtractAVFromES(dvbpsi_pmt_es_t *es, int *vid, int *vfmt, A
 					case AM_SI_DESCR_PSIPENHANCED_AC3:
 						AM_DEBUG(1, "!!Found PSIP Enhanced AC3 Descriptor!!!");
 						afmt_tmp = AFORMAT_EAC3;
-						if (descr->p_decoded != NULL)
+						if (AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT) != NULL)
 						{
 							AM_SI_GetAudioExten_from_PSIPENAC3des((dvbpsi_PSIPENAC3_dr_t*)descr->p_decoded,&audio_exten);
 						}
@@ -2011,7 +2254,7 @@ AM_ErrorCode_t AM_SI_ExtractAVFromES(dvbpsi_pmt_es_t *es, int *vid, int *vfmt, A
 					case AM_SI_DESCR_PSIP_AUDIOSTREAM_AC3:
 						AM_DEBUG(1, "!!Found PSIP AC3 audio stream Descriptor!!!");
 						afmt_tmp = AFORMAT_AC3;
-						if (descr->p_decoded != NULL)
+						if (AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT) != NULL)
 						{
 							AM_SI_GetAudioExten_from_PSIPAC3AStreamdes((dvbpsi_atsc_ac3_audio_dr_t*)descr->p_decoded,&audio_exten);
 						}
@@ -2036,7 +2279,7 @@ AM_ErrorCode_t AM_SI_ExtractAVFromES(dvbpsi_pmt_es_t *es, int *vid, int *vfmt, A
 					case AM_SI_DESCR_AC3:
 						AM_DEBUG(1, "!!Found AC3 Descriptor!!!");
 						afmt_tmp = AFORMAT_AC3;
-						if (descr->p_decoded != NULL)
+						if (AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT) != NULL)
 						{
 							AM_SI_GetAudioExten_from_AC3des((dvbpsi_AC3_dr_t*)descr->p_decoded,&audio_exten);
 						}
@@ -2044,7 +2287,7 @@ AM_ErrorCode_t AM_SI_ExtractAVFromES(dvbpsi_pmt_es_t *es, int *vid, int *vfmt, A
 					case AM_SI_DESCR_ENHANCED_AC3:
 						AM_DEBUG(1, "!!Found Enhanced AC3 Descriptor!!!");
 						afmt_tmp = AFORMAT_EAC3;
-						if (descr->p_decoded != NULL)
+						if (AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT) != NULL)
 						{
 							AM_SI_GetAudioExten_from_ENAC3des((dvbpsi_ENAC3_dr_t*)descr->p_decoded,&audio_exten);
 						}
@@ -2052,7 +2295,7 @@ AM_ErrorCode_t AM_SI_ExtractAVFromES(dvbpsi_pmt_es_t *es, int *vid, int *vfmt, A
 					case AM_SI_DESCR_PSIPENHANCED_AC3:
 						AM_DEBUG(1, "!!Found PSIP Enhanced AC3 Descriptor!!!");
 						afmt_tmp = AFORMAT_EAC3;
-						if (descr->p_decoded != NULL)
+						if (AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT) != NULL)
 						{
 							AM_SI_GetAudioExten_from_PSIPENAC3des((dvbpsi_PSIPENAC3_dr_t*)descr->p_decoded,&audio_exten);
 						}
@@ -2060,7 +2303,7 @@ AM_ErrorCode_t AM_SI_ExtractAVFromES(dvbpsi_pmt_es_t *es, int *vid, int *vfmt, A
 					case AM_SI_DESCR_PSIP_AUDIOSTREAM_AC3:
 						AM_DEBUG(1, "!!Found PSIP AC3 audio stream Descriptor!!!");
 						afmt_tmp = AFORMAT_AC3;
-						if (descr->p_decoded != NULL)
+						if (AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT) != NULL)
 						{
 							AM_SI_GetAudioExten_from_PSIPAC3AStreamdes((dvbpsi_atsc_ac3_audio_dr_t*)descr->p_decoded,&audio_exten);
 						}
@@ -2091,7 +2334,7 @@ AM_ErrorCode_t AM_SI_ExtractAVFromES(dvbpsi_pmt_es_t *es, int *vid, int *vfmt, A
 
 	if (afmt_tmp == -1 && ac4_enable) {
 		AM_SI_LIST_BEGIN(es->p_first_descriptor, descr)
-			if (descr->i_tag == AM_SI_DESCR_EXTENSION && descr->p_decoded != NULL)
+			if (descr->i_tag == AM_SI_DESCR_EXTENSION && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT))
 			{
 				dvbpsi_EXTENTION_dr_t *pisod = (dvbpsi_EXTENTION_dr_t*)descr->p_decoded;
 				if (pisod->i_extern_des_tag == AM_SI_EXTEN_DESCR_AC4)
@@ -2107,7 +2350,7 @@ AM_ErrorCode_t AM_SI_ExtractAVFromES(dvbpsi_pmt_es_t *es, int *vid, int *vfmt, A
 	if (afmt_tmp != -1)
 	{
 		AM_SI_LIST_BEGIN(es->p_first_descriptor, descr)
-			if (descr->i_tag == AM_SI_DESCR_ISO639 && descr->p_decoded != NULL)
+			if (descr->i_tag == AM_SI_DESCR_ISO639 && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT))
 			{
 				dvbpsi_iso639_dr_t *pisod = (dvbpsi_iso639_dr_t*)descr->p_decoded;
 				if (pisod->i_code_count > 0)
@@ -2120,7 +2363,7 @@ AM_ErrorCode_t AM_SI_ExtractAVFromES(dvbpsi_pmt_es_t *es, int *vid, int *vfmt, A
 		AM_SI_LIST_END()
 		/*if exist exten des, used exten des info to check audio main or sub*/
 		AM_SI_LIST_BEGIN(es->p_first_descriptor, descr)
-			if (descr->i_tag == AM_SI_DESCR_EXTENSION && descr->p_decoded != NULL)
+			if (descr->i_tag == AM_SI_DESCR_EXTENSION && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT))
 			{
 				dvbpsi_EXTENTION_dr_t *pisod = (dvbpsi_EXTENTION_dr_t*)descr->p_decoded;
 				if (pisod->i_extern_des_tag == AM_SI_EXTEN_DESCR_SUP_AUDIO)
@@ -2215,7 +2458,7 @@ AM_ErrorCode_t AM_SI_ExtractAVFromVC(dvbpsi_atsc_vct_channel_t *vcinfo, int *vid
 	memset(lang_tmp, 0, sizeof(lang_tmp));
 
 	AM_SI_LIST_BEGIN(vcinfo->p_first_descriptor, descr)
-		if (descr->p_decoded && descr->i_tag == AM_SI_DESCR_SERVICE_LOCATION)
+		if (descr->i_tag == AM_SI_DESCR_SERVICE_LOCATION && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PSIP_TVCT))
 		{
 			dvbpsi_atsc_service_location_dr_t *asld = (dvbpsi_atsc_service_location_dr_t*)descr->p_decoded;
 			for (i=0; i<asld->i_number_elements; i++)
@@ -2293,7 +2536,7 @@ AM_ErrorCode_t AM_SI_ExtractDVBSubtitleFromES(dvbpsi_pmt_es_t *es, AM_SI_Subtitl
 	dvbpsi_descriptor_t *descr;
 
 	AM_SI_LIST_BEGIN(es->p_first_descriptor, descr)
-		if (descr->p_decoded && descr->i_tag == AM_SI_DESCR_SUBTITLING)
+		if (descr->i_tag == AM_SI_DESCR_SUBTITLING && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT))
 		{
 			int isub, i;
 			dvbpsi_subtitle_t *tmp_sub;
@@ -2364,7 +2607,7 @@ AM_ErrorCode_t AM_SI_ExtractDVBTeletextFromES(dvbpsi_pmt_es_t *es, AM_SI_Teletex
 	dvbpsi_descriptor_t *descr;
 
 	AM_SI_LIST_BEGIN(es->p_first_descriptor, descr)
-		if (descr->p_decoded==NULL && descr->i_tag == AM_SI_DESCR_TELETEXT){
+		if (descr->i_tag == AM_SI_DESCR_TELETEXT && !AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT)){
 			if(descr->i_length == 0){
 				if (ttx_info->teletext_count < 0)
 					ttx_info->teletext_count = 0;
@@ -2380,7 +2623,7 @@ AM_ErrorCode_t AM_SI_ExtractDVBTeletextFromES(dvbpsi_pmt_es_t *es, AM_SI_Teletex
 			}
 		}
 
-		if (descr->p_decoded && descr->i_tag == AM_SI_DESCR_TELETEXT)
+		if (descr->i_tag == AM_SI_DESCR_TELETEXT && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT))
 		{
 			int itel, i;
 			dvbpsi_teletextpage_t *tmp_ttx;
@@ -2479,7 +2722,7 @@ AM_ErrorCode_t AM_SI_ExtractATSCCaptionFromES(dvbpsi_pmt_es_t *es, AM_SI_Caption
 	dvbpsi_descriptor_t *descr;
 
 	AM_SI_LIST_BEGIN(es->p_first_descriptor, descr)
-		if (descr->p_decoded && descr->i_tag == AM_SI_DESCR_CAPTION_SERVICE)
+		if (descr->i_tag == AM_SI_DESCR_CAPTION_SERVICE && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PMT))
 		{
 			int icap, i;
 			dvbpsi_caption_service_t *tmp_cap;
@@ -2637,7 +2880,7 @@ AM_ErrorCode_t AM_SI_GetRatingStringFromDescriptors(dvbpsi_descriptor_t *p_descr
 		return AM_SUCCESS;
 
 	AM_SI_LIST_BEGIN(p_descriptor, descr)
-		if (descr->p_decoded && descr->i_tag == AM_SI_DESCR_CONTENT_ADVISORY)
+		if (descr->i_tag == AM_SI_DESCR_CONTENT_ADVISORY && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PSIP_EIT))
 		{
 			dvbpsi_atsc_content_advisory_dr_t *pcad = (dvbpsi_atsc_content_advisory_dr_t*)descr->p_decoded;
 			AM_SI_GetRatingString(pcad, buf, buf_size);
@@ -2655,7 +2898,7 @@ AM_ErrorCode_t AM_SI_GetATSCCaptionStringFromDescriptors(dvbpsi_descriptor_t *p_
 	if (!buf || !buf_size)
 		return AM_SUCCESS;
 	AM_SI_LIST_BEGIN(p_descriptor, descr)
-		if (descr->p_decoded && descr->i_tag == AM_SI_DESCR_CAPTION_SERVICE)
+		if (descr->i_tag == AM_SI_DESCR_CAPTION_SERVICE && AM_SI_GetDecodedDescriptor(descr, AM_SI_TID_PSIP_EIT))
 		{
 			dvbpsi_atsc_caption_service_dr_t *pcsd = (dvbpsi_atsc_caption_service_dr_t*)descr->p_decoded;
 			AM_SI_GetATSCCaptionString(pcsd, buf, buf_size);
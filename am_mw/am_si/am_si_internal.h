@@ -35,6 +35,7 @@ typedef struct
 {
 	void 		*prv_data;	/**< 私有数据,用于句柄检查*/
 	AM_Bool_t   allocated;	/**< 是否已经分配*/
+	AM_Bool_t   lazy_descr;	/**< 描述符是否在使用时才解析*/
 }SI_Decoder_t;
 
 /**\brief SI Decode Descriptor Flag
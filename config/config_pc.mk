@@ -12,6 +12,8 @@ SDL_INPUT=y
 
 EMU_DEMUX=y
 
+EMU_DVR=y
+
 SDL_OSD=y
 
 LINUX_DVB_FEND=n
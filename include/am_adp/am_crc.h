@@ -0,0 +1,95 @@
+/***************************************************************************
+ * Copyright (c) 2019 Amlogic, Inc. All rights reserved.
+ *
+ * This source code is subject to the terms and conditions defined in the
+ * file 'LICENSE' which is part of this source code package.
+ *
+ * Description:
+ */
+/**\file
+ * \brief MPEG-2 CRC32计算(ISO 13818-1 Annex B)
+ *
+ * 多项式0x04C11DB7，高位在前，无最终异或。PSI section包括CRC_32字段计算的结果为0。
+ * 默认使用slice-by-8查表，CPU支持无进位乘法指令(x86 PCLMULQDQ, AArch64 PMULL)时
+ * 较长的数据使用折叠算法。
+ ***************************************************************************/
+
+#ifndef _AM_CRC_H
+#define _AM_CRC_H
+
+#include "am_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * Macro definitions
+ ***************************************************************************/
+
+/**\brief CRC32的初始值*/
+#define AM_CRC32_INIT 0xFFFFFFFF
+
+/****************************************************************************
+ * Type definitions
+ ***************************************************************************/
+
+/**\brief CRC32计算方法*/
+typedef enum
+{
+	AM_CRC32_ENGINE_AUTO,   /**< 自动选择最快的方法*/
+	AM_CRC32_ENGINE_BYTE,   /**< 每次查表处理1个字节*/
+	AM_CRC32_ENGINE_SLICE8, /**< 每次查表处理8个字节*/
+	AM_CRC32_ENGINE_CLMUL   /**< 无进位乘法折叠(PCLMULQDQ/PMULL)*/
+} AM_CRC32_Engine_t;
+
+/****************************************************************************
+ * Function prototypes
+ ***************************************************************************/
+
+/**\brief 计算CRC32
+ * \param crc 初始值，第一块数据为AM_CRC32_INIT，分块计算时为前一块的结果
+ * \param[in] data 数据
+ * \param len 数据长度
+ * \return CRC32值
+ */
+extern uint32_t AM_CRC32_Calc(uint32_t crc, const uint8_t *data, int len);
+
+/**\brief 用指定的方法计算CRC32，用于测试，CPU不支持时使用AM_CRC32_ENGINE_SLICE8
+ * \param engine 计算方法
+ * \param crc 初始值
+ * \param[in] data 数据
+ * \param len 数据长度
+ * \return CRC32值
+ */
+extern uint32_t AM_CRC32_CalcEngine(AM_CRC32_Engine_t engine, uint32_t crc, const uint8_t *data, int len);
+
+/**\brief 检查section的CRC_32字段
+ * \param[in] sec section数据，包括结尾的CRC_32
+ * \param len section长度
+ * \return
+ *   - AM_TRUE CRC正确
+ *   - AM_FALSE CRC错误或长度不足
+ */
+extern AM_Bool_t AM_CRC32_CheckSection(const uint8_t *sec, int len);
+
+/**\brief 检查CPU是否支持指定的计算方法
+ * \param engine 计算方法
+ * \return
+ *   - AM_TRUE 支持
+ *   - AM_FALSE 不支持
+ */
+extern AM_Bool_t AM_CRC32_EngineAvailable(AM_CRC32_Engine_t engine);
+
+/**\brief 返回AM_CRC32_Calc使用的计算方法
+ * \return 计算方法
+ */
+extern AM_CRC32_Engine_t AM_CRC32_GetEngine(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
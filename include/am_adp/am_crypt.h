@@ -17,6 +17,14 @@ extern "C"
  * Macro definitions
  ***************************************************************************/
 
+/**\brief Size of the packets given to the crypt operations*/
+#define CRYPT_PKT_SIZE (188)
+
+/**\brief AES flag, also crypt the last 8 bytes of the packet (ciphertext stealing in ECB mode)*/
+#define AM_CRYPT_AES_FL_WHOLE_PAYLOAD (0x01)
+/**\brief AES flag, use the portable code even if the CPU has AES instructions*/
+#define AM_CRYPT_AES_FL_SOFT          (0x02)
+
 /****************************************************************************
  * Error code definitions
  ****************************************************************************/
@@ -33,10 +41,29 @@ typedef struct
 	void  (*crypt)(void *cryptor,
 		uint8_t *dst, uint8_t *src, int len,
 		int decrypt);
+	/**< Optional, crypt pkt_cnt continuous packets in one call*/
+	void  (*crypt_pkts)(void *cryptor,
+		uint8_t *dst, uint8_t *src, int pkt_cnt,
+		int decrypt);
 } AM_Crypt_Ops_t;
 
 #define CRYPT_SET(_ops_) ((_ops_) && (_ops_)->crypt)
 
+/**\brief Crypt pkt_cnt continuous packets, one crypt call per packet if crypt_pkts is not set*/
+static inline void AM_CRYPT_crypt_pkts(AM_Crypt_Ops_t *ops, void *cryptor,
+		uint8_t *dst, uint8_t *src, int pkt_cnt, int decrypt)
+{
+	int i;
+
+	if (ops->crypt_pkts) {
+		ops->crypt_pkts(cryptor, dst, src, pkt_cnt, decrypt);
+		return;
+	}
+
+	for (i = 0; i < pkt_cnt; i++)
+		ops->crypt(cryptor, dst + i * CRYPT_PKT_SIZE, src + i * CRYPT_PKT_SIZE, CRYPT_PKT_SIZE, decrypt);
+}
+
 /****************************************************************************
  * Function prototypes
  ***************************************************************************/
@@ -47,6 +74,27 @@ int AM_CRYPT_des_close(void *cryptor);
 
 void AM_CRYPT_des_crypt(void* cryptor, uint8_t* dst, const uint8_t *src, int len, uint8_t *iv, int decrypt);
 
+void AM_CRYPT_des_crypt_pkts(void* cryptor, uint8_t* dst, const uint8_t *src, int pkt_cnt, int decrypt);
+
+/**\brief Open an AES cryptor, each 16 byte block of the payload is crypted alone (ECB),
+ * so any packet can be decrypted by itself, the 4 bytes TS header is kept in clear
+ * \param key_bits 128, 192 or 256
+ * \param flags AM_CRYPT_AES_FL_XXX
+ * \return the cryptor, NULL on error
+ */
+void *AM_CRYPT_aes_open(const uint8_t *key, int key_bits, int flags);
+
+int AM_CRYPT_aes_close(void *cryptor);
+
+/**\brief Check if the AES instructions of the CPU are used*/
+int AM_CRYPT_aes_hw_available(void);
+
+/**\brief Crypt a CRYPT_PKT_SIZE bytes packet, iv is not used as for DES*/
+void AM_CRYPT_aes_crypt(void* cryptor, uint8_t* dst, const uint8_t *src, int len, uint8_t *iv, int decrypt);
+
+/**\brief Crypt pkt_cnt continuous packets*/
+void AM_CRYPT_aes_crypt_pkts(void* cryptor, uint8_t* dst, const uint8_t *src, int pkt_cnt, int decrypt);
+
 #ifdef __cplusplus
 }
 #endif
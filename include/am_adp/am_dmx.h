@@ -97,6 +97,25 @@ typedef struct
 	int       dvr_buf_size;            /**< Async fifo buffer size if use software filters.*/
 } AM_DMX_OpenPara_t;
 
+/**\brief Hardware filter reconfiguration statistics of a demux driver*/
+typedef struct
+{
+	int       reconfig_count;          /**< Number of hardware PID set changes*/
+	int       reconfig_ops;            /**< Number of open/close/ioctl calls issued by the changes*/
+	uint64_t  reconfig_time_us;        /**< Total time spent in the changes, in microseconds*/
+} AM_DMX_ReconfigStats_t;
+
+/**\brief Delivery statistics of a filter*/
+typedef struct
+{
+	int       sections;                /**< Sections queued for asynchronous delivery*/
+	int       delivered;               /**< Sections delivered by the worker threads*/
+	int       dropped;                 /**< Sections dropped because the queue was full*/
+	int       overflows;               /**< Times the queue became full*/
+	int       max_bytes;               /**< Peak queue usage in bytes*/
+	int       drv_overflows;           /**< Buffer overflows reported by the demux driver*/
+} AM_DMX_FilterStats_t;
+
 /**\brief Filter received data callback function
  * \a fandle is the filter's handle.
  * \a data is the received data buffer pointer.
@@ -212,6 +231,56 @@ extern AM_ErrorCode_t AM_DMX_SetCallback(int dev_no, int fhandle, AM_DMX_DataCb
  */
 extern AM_ErrorCode_t AM_DMX_SetSource(int dev_no, AM_DMX_Source_t src);
 
+/**\brief Enable or disable asynchronous delivery of a filter
+ * In asynchronous mode, the demux thread copies the received data into a bounded
+ * queue of the filter and the callback is invoked from a worker thread.
+ * Data is dropped when the queue is full, so a slow callback does not block
+ * the other filters.
+ * \param dev_no Demux device number
+ * \param fhandle Filter handle
+ * \param enable AM_TRUE to use asynchronous delivery, AM_FALSE to call the callback in the demux thread
+ * \param queue_size Queue size in bytes, 0 to use the default size, sizes smaller
+ * than one read of the demux (64KB) are raised to it
+ * \retval AM_SUCCESS On success
+ * \return Error code
+ */
+extern AM_ErrorCode_t AM_DMX_SetAsyncMode(int dev_no, int fhandle, AM_Bool_t enable, int queue_size);
+
+/**\brief Set the number of worker threads used for asynchronous delivery
+ * The number can only be changed before asynchronous delivery is first enabled
+ * on the opened device.
+ * \param dev_no Demux device number
+ * \param count Number of worker threads
+ * \retval AM_SUCCESS On success
+ * \return Error code
+ */
+extern AM_ErrorCode_t AM_DMX_SetAsyncWorkers(int dev_no, int count);
+
+/**\brief Get the delivery statistics of a filter
+ * \param dev_no Demux device number
+ * \param fhandle Filter handle
+ * \param[out] stats Return the statistics
+ * \retval AM_SUCCESS On success
+ * \return Error code
+ */
+extern AM_ErrorCode_t AM_DMX_GetFilterStats(int dev_no, int fhandle, AM_DMX_FilterStats_t *stats);
+
+/**\brief Get the hardware filter reconfiguration statistics of the demux driver
+ * \param dev_no Demux device number
+ * \param[out] stats Return the statistics
+ * \retval AM_SUCCESS On success
+ * \return Error code
+ */
+extern AM_ErrorCode_t AM_DMX_GetReconfigStats(int dev_no, AM_DMX_ReconfigStats_t *stats);
+
+/**\brief Get the number of filters supported by the demux device
+ * \param dev_no Demux device number
+ * \param[out] count Return the filter count
+ * \retval AM_SUCCESS On success
+ * \return Error code
+ */
+extern AM_ErrorCode_t AM_DMX_GetFilterCount(int dev_no, int *count);
+
 /**\cond */
 /**\brief Sync the demux data
  * \param dev_no Demux device number
@@ -116,6 +116,16 @@ extern AM_ErrorCode_t AM_DVR_SetBufferSize(int dev_no, int size);
  */
 extern AM_ErrorCode_t AM_DVR_StartRecord(int dev_no, const AM_DVR_StartRecPara_t *para);
 
+/**\brief Change the recorded PIDs, or start recording if it is not started
+ *
+ * The PIDs in both the old and the new parameters keep recording without a gap.
+ * \param dev_no DVR device number
+ * \param [in] para New recording parameters
+ * \retval AM_SUCCESS On succes
+ * \return Error code
+ */
+extern AM_ErrorCode_t AM_DVR_ChangeRecordPids(int dev_no, const AM_DVR_StartRecPara_t *para);
+
 /**\brief Stop recording
  * \param dev_no DVR device number
  * \retval AM_SUCCESS On succes
@@ -153,6 +153,17 @@ iconv(iconv_t cd, char **inbuf, size_t *inbytesleft, char **outbuf, size_t *outb
 	if(!cd)
 		return -1;
 
+	if(!inbuf || !*inbuf)
+	{
+		/*reset the conversion state, as iconv(cd, NULL, NULL, NULL, NULL) does*/
+		char c, *t = &c;
+		const char *s = &c;
+
+		am_ucnv_convertEx(cd->target, cd->source, &t, t, &s, s,
+				NULL, NULL, NULL, NULL, TRUE, TRUE, &err);
+		return 0;
+	}
+
 	sbegin = *inbuf;
 	send   = sbegin + *inbytesleft;
 	tbegin = *outbuf;
@@ -123,6 +123,7 @@ typedef struct
 {
 	int        pool_size;   /**< 每次分配的内存大小*/
 	void      *pools;       /**< 内存块链表*/
+	void      *cur;         /**< 当前分配内存的内存块*/
 } AM_MEM_Pool_t;
 
 /****************************************************************************
@@ -145,6 +146,7 @@ extern void AM_MEM_PoolInit(AM_MEM_Pool_t *pool, int pool_size);
 extern void* AM_MEM_PoolAlloc(AM_MEM_Pool_t *pool, int size);
 
 /**\brief 将缓冲池内全部以分配的内存标记，但不调用系统free()
+ * 内存块都被保留，之后的分配重新从第一个内存块开始
  * \param[in,out] pool 缓冲池指针
  */
 extern void AM_MEM_PoolClear(AM_MEM_Pool_t *pool);
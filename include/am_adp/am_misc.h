@@ -32,6 +32,9 @@ extern "C"
  * Type definitions
  ***************************************************************************/
 
+/**\brief 缓存的文件句柄，文件打开后一直保留，每次读写只需一次pread/pwrite*/
+typedef struct AM_FileHandle_s *AM_FileHandle_t;
+
 /****************************************************************************
  * API function prototypes  
  ***************************************************************************/
@@ -126,6 +129,51 @@ extern AM_ErrorCode_t AM_FileEcho(const char *name, const char *cmd);
  */
 extern AM_ErrorCode_t AM_FileRead(const char *name, char *buf, int len);
 
+/**\brief 读取一个文件中的字符串，可以返回缓存的值，用于变化较慢的节点
+ * \param[in] name 文件名
+ * \param[out] buf 存放字符串的缓冲区
+ * \param len 缓冲区大小
+ * \param max_age 缓存值的最长有效时间(毫秒)，<=0表示总是重新读取
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码
+ */
+extern AM_ErrorCode_t AM_FileReadCached(const char *name, char *buf, int len, int max_age);
+
+/**\brief 取得文件的句柄，同一文件名在进程中共用一个句柄，句柄在进程退出前一直有效
+ * AM_FileRead和AM_FileEcho也使用这些句柄，句柄只省去了文件名的查找
+ * \param[in] name 文件名
+ * \param[out] handle 返回句柄
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码(缓存的句柄已满)
+ */
+extern AM_ErrorCode_t AM_FileOpenHandle(const char *name, AM_FileHandle_t *handle);
+
+/**\brief 通过句柄读取文件中的字符串
+ * \param handle 文件句柄
+ * \param[out] buf 存放字符串的缓冲区
+ * \param len 缓冲区大小
+ * \param max_age 缓存值的最长有效时间(毫秒)，<=0表示总是重新读取
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码
+ */
+extern AM_ErrorCode_t AM_FileHandleRead(AM_FileHandle_t handle, char *buf, int len, int max_age);
+
+/**\brief 通过句柄向文件打印字符串
+ * \param handle 文件句柄
+ * \param[in] cmd 向文件打印的字符串
+ * \return
+ *   - AM_SUCCESS 成功
+ *   - 其他值 错误代码
+ */
+extern AM_ErrorCode_t AM_FileHandleEcho(AM_FileHandle_t handle, const char *cmd);
+
+/**\brief 关闭所有句柄中打开的文件，句柄仍然有效，下次访问时重新打开
+ */
+extern void AM_FileCloseHandles(void);
+
 /**\brief 创建本地socket服务
  * \param[in] name 服务名称
  * \param[out] fd 返回服务器socket
@@ -3,6 +3,9 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 
 enum enqueue_result {
   ENQUEUE_RESULT_SUCCESS,
@@ -66,4 +69,132 @@ bool NAME ##_is_empty(struct NAME * p_queue) {
 }
 
 
+/*
+ * Lock-free single producer, single consumer queue.
+ *
+ * The producer fills a slot and publishes it with a release store of
+ * write_idx, the consumer reads write_idx with an acquire load before it
+ * touches the slot. The slot is given back the same way through read_idx.
+ * Each enqueue also bumps an eventfd, so the consumer can block in
+ * NAME_wait() (or poll NAME_fd() together with other descriptors) instead
+ * of polling the queue. NAME_wakeup() wakes the consumer without an item.
+ *
+ * Only one thread may enqueue at a time, several producers must hold a
+ * common lock. NUM_ITEMS must be a power of 2.
+ */
+#define SPSC_QUEUE_DECLARATION(NAME, ITEM_TYPE, NUM_ITEMS)                              \
+typedef char NAME ## _size_check[((NUM_ITEMS) & ((NUM_ITEMS) - 1)) ? -1 : 1];           \
+struct NAME {                                                                           \
+  uint32_t write_idx;                                                                   \
+  uint32_t read_idx __attribute__((aligned(64)));                                       \
+  int efd;                                                                              \
+  ITEM_TYPE items[NUM_ITEMS];                                                           \
+};                                                                                      \
+int NAME ## _init(struct NAME * p_queue);                                               \
+void NAME ## _destroy(struct NAME * p_queue);                                           \
+enum enqueue_result NAME ##_enqueue(struct NAME * p_queue, ITEM_TYPE * p_new_item);     \
+enum dequeue_result NAME ##_dequeue(struct NAME * p_queue, ITEM_TYPE * p_item_out);     \
+enum dequeue_result NAME ##_peek(struct NAME * p_queue, ITEM_TYPE * p_item_out);        \
+bool NAME ##_is_empty(struct NAME * p_queue);                                           \
+void NAME ##_wakeup(struct NAME * p_queue);                                             \
+int NAME ##_wait(struct NAME * p_queue, int timeout_ms);                                \
+int NAME ##_fd(struct NAME * p_queue);
+
+#define SPSC_QUEUE_DEFINITION(NAME, ITEM_TYPE)                                          \
+int NAME ## _init(struct NAME * p_queue)                                                \
+{                                                                                       \
+  p_queue->write_idx = 0;                                                               \
+  p_queue->read_idx = 0;                                                                \
+  p_queue->efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);                                \
+  return (p_queue->efd == -1) ? -1 : 0;                                                 \
+}                                                                                       \
+                                                                                        \
+void NAME ## _destroy(struct NAME * p_queue)                                            \
+{                                                                                       \
+  if (p_queue->efd != -1) {                                                             \
+    close(p_queue->efd);                                                                \
+    p_queue->efd = -1;                                                                  \
+  }                                                                                     \
+}                                                                                       \
+                                                                                        \
+enum enqueue_result NAME ##_enqueue(struct NAME * p_queue, ITEM_TYPE * p_new_item) {    \
+  uint32_t w = __atomic_load_n(&p_queue->write_idx, __ATOMIC_RELAXED);                  \
+  uint32_t r = __atomic_load_n(&p_queue->read_idx, __ATOMIC_ACQUIRE);                   \
+  size_t const capacity = ARRAY_LENGTH(p_queue->items);                                 \
+                                                                                        \
+  if (w - r == capacity) {                                                              \
+    return ENQUEUE_RESULT_FULL;                                                         \
+  }                                                                                     \
+                                                                                        \
+  p_queue->items[w & (capacity - 1)] = *p_new_item;                                     \
+  __atomic_store_n(&p_queue->write_idx, w + 1, __ATOMIC_RELEASE);                       \
+  NAME ##_wakeup(p_queue);                                                              \
+  return ENQUEUE_RESULT_SUCCESS;                                                        \
+}                                                                                       \
+                                                                                        \
+enum dequeue_result NAME ##_peek(struct NAME * p_queue, ITEM_TYPE * p_item_out) {       \
+  uint32_t r = __atomic_load_n(&p_queue->read_idx, __ATOMIC_RELAXED);                   \
+  uint32_t w = __atomic_load_n(&p_queue->write_idx, __ATOMIC_ACQUIRE);                  \
+  size_t const capacity = ARRAY_LENGTH(p_queue->items);                                 \
+                                                                                        \
+  if (w == r) {                                                                         \
+    return DEQUEUE_RESULT_EMPTY;                                                        \
+  }                                                                                     \
+                                                                                        \
+  *p_item_out = p_queue->items[r & (capacity - 1)];                                     \
+  return DEQUEUE_RESULT_SUCCESS;                                                        \
+}                                                                                       \
+                                                                                        \
+enum dequeue_result NAME ##_dequeue(struct NAME * p_queue, ITEM_TYPE * p_item_out) {    \
+  uint32_t r = __atomic_load_n(&p_queue->read_idx, __ATOMIC_RELAXED);                   \
+                                                                                        \
+  if (NAME ##_peek(p_queue, p_item_out) != DEQUEUE_RESULT_SUCCESS) {                    \
+    return DEQUEUE_RESULT_EMPTY;                                                        \
+  }                                                                                     \
+                                                                                        \
+  __atomic_store_n(&p_queue->read_idx, r + 1, __ATOMIC_RELEASE);                        \
+  return DEQUEUE_RESULT_SUCCESS;                                                        \
+}                                                                                       \
+                                                                                        \
+bool NAME ##_is_empty(struct NAME * p_queue) {                                          \
+  return (__atomic_load_n(&p_queue->write_idx, __ATOMIC_ACQUIRE) ==                     \
+          __atomic_load_n(&p_queue->read_idx, __ATOMIC_RELAXED));                       \
+}                                                                                       \
+                                                                                        \
+void NAME ##_wakeup(struct NAME * p_queue) {                                            \
+  uint64_t one = 1;                                                                     \
+                                                                                        \
+  if (write(p_queue->efd, &one, sizeof(one)) != sizeof(one)) {                          \
+    /* the counter is already non zero, the consumer will wake up */                    \
+  }                                                                                     \
+}                                                                                       \
+                                                                                        \
+/* wait until the queue is not empty, woken up or timeout_ms passed (-1 forever), */    \
+/* return 1 if not timed out. The counter is only reset after poll, so a wakeup */      \
+/* without an item is never lost, at most a later wait returns at once. */              \
+int NAME ##_wait(struct NAME * p_queue, int timeout_ms) {                               \
+  struct pollfd pfd;                                                                    \
+  uint64_t cnt;                                                                         \
+  int ret;                                                                              \
+                                                                                        \
+  if (!NAME ##_is_empty(p_queue)) {                                                     \
+    return 1;                                                                           \
+  }                                                                                     \
+                                                                                        \
+  pfd.fd = p_queue->efd;                                                                \
+  pfd.events = POLLIN;                                                                  \
+  pfd.revents = 0;                                                                      \
+  ret = poll(&pfd, 1, timeout_ms);                                                      \
+  if (ret <= 0) {                                                                       \
+    return 0;                                                                           \
+  }                                                                                     \
+                                                                                        \
+  ret = read(p_queue->efd, &cnt, sizeof(cnt));                                          \
+  return 1;                                                                             \
+}                                                                                       \
+                                                                                        \
+int NAME ##_fd(struct NAME * p_queue) {                                                 \
+  return p_queue->efd;                                                                  \
+}
+
 #endif
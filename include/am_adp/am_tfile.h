@@ -61,13 +61,16 @@ struct AM_TFileData_s
 {
 	int		opened;	/**< open flag*/
 	loff_t	size;	/**< size of the file*/
-	loff_t	avail;	/**< avail data*/
-	loff_t	total;	/**< total written*/
-	loff_t	start;	/**< start offset*/
-	loff_t	read;	/**< read offset*/
-	loff_t	write;	/**< write offset*/
-	pthread_mutex_t lock;	/*r/w lock*/
-	pthread_cond_t		cond;
+	/* Stream positions, they only grow and the file offset is position%size
+	 * in loop mode. The writer owns wpos and spos, the reader owns rpos.
+	 */
+	loff_t	wpos;	/**< bytes written*/
+	loff_t	spos;	/**< position of the earliest data kept, moved before the data is overwritten*/
+	loff_t	rpos;	/**< read position, the reader skips to spos if it is overrun*/
+	uint32_t	wseq;	/**< changed when data is written or rpos is moved, readers wait on it*/
+	int		waiters;	/**< number of readers waiting on wseq*/
+	int		readers;	/**< number of readers in AM_TFile_Read, AM_TFile_Close waits for them*/
+	pthread_mutex_t lock;	/*sub file rotation and timer lock*/
 	AM_Bool_t	loop;	/*loop mode*/
 	AM_Bool_t	is_timeshift;
 	char	*name;	/*name*/
@@ -89,6 +92,8 @@ struct AM_TFileData_s
 	AM_TFile_Sub_t *cur_wsub_file;
 
 	void *timer;
+	int start_time;	/*time of the earliest fragment, read lock-free*/
+	int end_time;	/*time of the latest fragment, read lock-free*/
 
 	int delete_on_close;
 };
@@ -0,0 +1,135 @@
+/***************************************************************************
+ * Copyright (c) 2014 Amlogic, Inc. All rights reserved.
+ *
+ * This source code is subject to the terms and conditions defined in the
+ * file 'LICENSE' which is part of this source code package.
+ *
+ * Description:
+ */
+/**\file
+ * \brief Recording index file
+ *
+ * The index file is stored beside a recording and maps the random access
+ * points of the stream (video key frames, or audio frames when the stream
+ * has no video) to their PTS, playback time and byte offset in the file.
+ * Entries have a fixed size and are sorted by offset and time, so lookups
+ * are binary searches on the file and work while it is still growing.
+ *
+ * \author
+ * \date
+ ***************************************************************************/
+
+#ifndef _AM_TINDEX_H
+#define _AM_TINDEX_H
+
+#include "am_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * Macro definitions
+ ***************************************************************************/
+
+/**\brief Suffix appended to the recording file name to get the index file name*/
+#define AM_TINDEX_SUFFIX	".idx"
+
+/****************************************************************************
+ * Type definitions
+ ***************************************************************************/
+
+/**\brief Index entry flags*/
+enum AM_TIndex_EntryFlag
+{
+	AM_TINDEX_FL_VIDEO_KEY = 0x01,	/**< Video key frame (I/IDR frame or random access point)*/
+	AM_TINDEX_FL_AUDIO     = 0x02,	/**< Audio frame, used when the stream has no video*/
+	AM_TINDEX_FL_DISCONT   = 0x04	/**< PTS discontinuity before this entry, the time is estimated*/
+};
+
+/**\brief Index entry*/
+typedef struct
+{
+	loff_t   offset;	/**< Offset of the first TS packet of the frame in the file*/
+	uint64_t pts;	/**< PTS of the frame (90KHz)*/
+	int      time;	/**< Playback time of the frame in ms, 0 is the first entry*/
+	int      flags;	/**< AM_TINDEX_FL_XXX*/
+} AM_TIndex_Entry_t;
+
+/**\brief Index file handle*/
+typedef void* AM_TIndex_t;
+
+/****************************************************************************
+ * API function prototypes
+ ***************************************************************************/
+
+/**\brief Create an index file and start indexing a TS stream
+ * \param[out] index index handle
+ * \param[in] file_name name of the index file
+ * \param vpid video PID, 0x1fff if the stream has no video
+ * \param vfmt video format (AM_AV_VFormat_t)
+ * \param apid audio PID, used when the stream has no video
+ * \retval AM_SUCCESS On success
+ * \return Error code
+ */
+extern AM_ErrorCode_t AM_TIndex_Create(AM_TIndex_t *index, const char *file_name, int vpid, int vfmt, int apid);
+
+/**\brief Parse the TS data written to the recording and add the entries found
+ * \param[in] index index handle
+ * \param[in] data TS data
+ * \param size length of the data
+ * \param offset offset of the data in the recording file
+ * \retval AM_SUCCESS On success
+ * \return Error code
+ */
+extern AM_ErrorCode_t AM_TIndex_Parse(AM_TIndex_t index, const uint8_t *data, int size, loff_t offset);
+
+/**\brief Open an existing index file for lookup
+ * \param[out] index index handle
+ * \param[in] file_name name of the index file
+ * \retval AM_SUCCESS On success
+ * \return Error code
+ */
+extern AM_ErrorCode_t AM_TIndex_Open(AM_TIndex_t *index, const char *file_name);
+
+/**\brief Close an index file
+ * \param[in] index index handle
+ * \retval AM_SUCCESS On success
+ * \return Error code
+ */
+extern AM_ErrorCode_t AM_TIndex_Close(AM_TIndex_t index);
+
+/**\brief Get the last random access point at or before a playback time
+ * \param[in] index index handle
+ * \param time_ms playback time in ms
+ * \param[out] entry the entry found, the first entry if time_ms is before it
+ * \retval AM_SUCCESS On success
+ * \return Error code, AM_FAILURE if the index is empty
+ */
+extern AM_ErrorCode_t AM_TIndex_TimeSeek(AM_TIndex_t index, int time_ms, AM_TIndex_Entry_t *entry);
+
+/**\brief Get the last random access point at or before a file offset
+ * \param[in] index index handle
+ * \param offset offset in the recording file
+ * \param[out] entry the entry found, the first entry if offset is before it
+ * \retval AM_SUCCESS On success
+ * \return Error code, AM_FAILURE if the index is empty
+ */
+extern AM_ErrorCode_t AM_TIndex_OffsetSeek(AM_TIndex_t index, loff_t offset, AM_TIndex_Entry_t *entry);
+
+/**\brief Get the number of entries and the time of the last entry
+ * \param[in] index index handle
+ * \param[out] count number of entries, can be NULL
+ * \param[out] duration time of the last entry in ms, can be NULL
+ * \retval AM_SUCCESS On success
+ * \return Error code
+ */
+extern AM_ErrorCode_t AM_TIndex_GetInfo(AM_TIndex_t index, int *count, int *duration);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
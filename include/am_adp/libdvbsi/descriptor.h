@@ -70,6 +70,10 @@ typedef struct dvbpsi_descriptor_s
 
   void *                        p_decoded;      /*!< decoded descriptor */
 
+  void *                        p_pool;         /*!< pool the descriptor was
+                                                     allocated from, the decoded
+                                                     descriptor goes there too */
+
 } dvbpsi_descriptor_t;
 
 
@@ -41,6 +41,8 @@ extern "C" {
 #endif
 
 #include <ctype.h>
+#include <stddef.h>
+#include <am_mem.h>
 
 typedef struct dvbpsi_s dvbpsi_t;
 
@@ -69,6 +71,45 @@ typedef struct dvbpsi_decoder_s * dvbpsi_handle;
 void dvbpsi_PushPacket(dvbpsi_handle h_dvbpsi, uint8_t* p_data);
 
 
+/*****************************************************************************
+ * dvbpsi_SetAllocPool
+ *****************************************************************************/
+/*!
+ * \fn AM_MEM_Pool_t *dvbpsi_SetAllocPool(AM_MEM_Pool_t *p_pool)
+ * \brief Take the table and descriptor allocations of the calling thread
+ * from a memory pool.
+ * \param p_pool the pool, NULL to go back to malloc()/free()
+ * \return the pool set before.
+ *
+ * While a pool is set, dvbpsi_malloc() and dvbpsi_calloc() carve the memory
+ * out of it and dvbpsi_free() does nothing. Everything is released at once
+ * with AM_MEM_PoolClear(), tables decoded this way must not be passed to the
+ * dvbpsi_Delete* functions.
+ */
+AM_MEM_Pool_t *dvbpsi_SetAllocPool(AM_MEM_Pool_t *p_pool);
+
+/*****************************************************************************
+ * dvbpsi_GetAllocPool
+ *****************************************************************************/
+/*!
+ * \fn AM_MEM_Pool_t *dvbpsi_GetAllocPool(void)
+ * \brief Get the pool set by dvbpsi_SetAllocPool() in the calling thread.
+ * \return the pool, NULL if malloc() is used.
+ */
+AM_MEM_Pool_t *dvbpsi_GetAllocPool(void);
+
+/*****************************************************************************
+ * dvbpsi_malloc, dvbpsi_calloc, dvbpsi_free
+ *****************************************************************************/
+/*!
+ * \brief Allocators used for the tables and the descriptors, see
+ * dvbpsi_SetAllocPool().
+ */
+void *dvbpsi_malloc(size_t i_size);
+void *dvbpsi_calloc(size_t i_count, size_t i_size);
+void dvbpsi_free(void *p_ptr);
+
+
 /*****************************************************************************
  * The following definitions are just here to allow external decoders but
  * shouldn't be used for any other purpose.
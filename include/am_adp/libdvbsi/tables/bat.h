@@ -173,7 +173,7 @@ void dvbpsi_InitBAT(dvbpsi_bat_t* p_bat, uint16_t i_bouquet_id,
 #define dvbpsi_NewBAT(p_bat, i_bouquet_id,                              \
                       i_version, b_current_next)                        \
 do {                                                                    \
-  p_bat = (dvbpsi_bat_t*)malloc(sizeof(dvbpsi_bat_t));                  \
+  p_bat = (dvbpsi_bat_t*)dvbpsi_malloc(sizeof(dvbpsi_bat_t));           \
   if(p_bat != NULL)                                                     \
     dvbpsi_InitBAT(p_bat, i_bouquet_id, i_version, b_current_next);     \
 } while(0);
@@ -199,7 +199,7 @@ void dvbpsi_EmptyBAT(dvbpsi_bat_t* p_bat);
 #define dvbpsi_DeleteBAT(p_bat)                                         \
 do {                                                                    \
   dvbpsi_EmptyBAT(p_bat);                                               \
-  free(p_bat);                                                          \
+  dvbpsi_free(p_bat);                                                   \
 } while(0);
 
 
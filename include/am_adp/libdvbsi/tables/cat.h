@@ -133,7 +133,7 @@ void dvbpsi_InitCAT(dvbpsi_cat_t* p_cat,
 #define dvbpsi_NewCAT(p_cat,                                            \
                       i_version, b_current_next)                        \
 do {                                                                    \
-  p_cat = (dvbpsi_cat_t*)malloc(sizeof(dvbpsi_cat_t));                  \
+  p_cat = (dvbpsi_cat_t*)dvbpsi_malloc(sizeof(dvbpsi_cat_t));           \
   if(p_cat != NULL)                                                     \
     dvbpsi_InitCAT(p_cat, i_version, b_current_next);                   \
 } while(0);
@@ -159,7 +159,7 @@ void dvbpsi_EmptyCAT(dvbpsi_cat_t* p_cat);
 #define dvbpsi_DeleteCAT(p_cat)                                         \
 do {                                                                    \
   dvbpsi_EmptyCAT(p_cat);                                               \
-  free(p_cat);                                                          \
+  dvbpsi_free(p_cat);                                                   \
 } while(0);
 
 
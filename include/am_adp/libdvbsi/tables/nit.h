@@ -173,7 +173,7 @@ void dvbpsi_InitNIT(dvbpsi_nit_t* p_nit, uint16_t i_network_id,
 #define dvbpsi_NewNIT(p_nit, i_network_id,                              \
                       i_version, b_current_next)                        \
 do {                                                                    \
-  p_nit = (dvbpsi_nit_t*)malloc(sizeof(dvbpsi_nit_t));                  \
+  p_nit = (dvbpsi_nit_t*)dvbpsi_malloc(sizeof(dvbpsi_nit_t));           \
   if(p_nit != NULL)                                                     \
     dvbpsi_InitNIT(p_nit, i_network_id, i_version, b_current_next);     \
 } while(0);
@@ -199,7 +199,7 @@ void dvbpsi_EmptyNIT(dvbpsi_nit_t* p_nit);
 #define dvbpsi_DeleteNIT(p_nit)                                         \
 do {                                                                    \
   dvbpsi_EmptyNIT(p_nit);                                               \
-  free(p_nit);                                                          \
+  dvbpsi_free(p_nit);                                                   \
 } while(0);
 
 
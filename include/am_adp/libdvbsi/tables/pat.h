@@ -157,7 +157,7 @@ void dvbpsi_InitPAT(dvbpsi_pat_t* p_pat, uint16_t i_ts_id, uint8_t i_version,
  */
 #define dvbpsi_NewPAT(p_pat, i_ts_id, i_version, b_current_next)        \
 do {                                                                    \
-  p_pat = (dvbpsi_pat_t*)malloc(sizeof(dvbpsi_pat_t));                  \
+  p_pat = (dvbpsi_pat_t*)dvbpsi_malloc(sizeof(dvbpsi_pat_t));           \
   if(p_pat != NULL)                                                     \
     dvbpsi_InitPAT(p_pat, i_ts_id, i_version, b_current_next);          \
 } while(0);
@@ -183,7 +183,7 @@ void dvbpsi_EmptyPAT(dvbpsi_pat_t* p_pat);
 #define dvbpsi_DeletePAT(p_pat)                                         \
 do {                                                                    \
   dvbpsi_EmptyPAT(p_pat);                                               \
-  free(p_pat);                                                          \
+  dvbpsi_free(p_pat);                                                   \
 } while(0);
 
 
@@ -171,7 +171,7 @@ void dvbpsi_InitPMT(dvbpsi_pmt_t* p_pmt, uint16_t i_program_number,
 #define dvbpsi_NewPMT(p_pmt, i_program_number,                          \
                       i_version, b_current_next, i_pcr_pid)             \
 do {                                                                    \
-  p_pmt = (dvbpsi_pmt_t*)malloc(sizeof(dvbpsi_pmt_t));                  \
+  p_pmt = (dvbpsi_pmt_t*)dvbpsi_malloc(sizeof(dvbpsi_pmt_t));           \
   if(p_pmt != NULL)                                                     \
     dvbpsi_InitPMT(p_pmt, i_program_number, i_version, b_current_next,  \
                    i_pcr_pid);                                          \
@@ -198,7 +198,7 @@ void dvbpsi_EmptyPMT(dvbpsi_pmt_t* p_pmt);
 #define dvbpsi_DeletePMT(p_pmt)                                         \
 do {                                                                    \
   dvbpsi_EmptyPMT(p_pmt);                                               \
-  free(p_pmt);                                                          \
+  dvbpsi_free(p_pmt);                                                   \
 } while(0);
 
 
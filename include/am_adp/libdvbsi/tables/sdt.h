@@ -177,7 +177,7 @@ void dvbpsi_InitSDT(dvbpsi_sdt_t *p_sdt, uint16_t i_ts_id, uint8_t i_version,
  */
 #define dvbpsi_NewSDT(p_sdt, i_ts_id, i_version, b_current_next,i_network_id) \
 do {                                                                    \
-  p_sdt = (dvbpsi_sdt_t*)malloc(sizeof(dvbpsi_sdt_t));                  \
+  p_sdt = (dvbpsi_sdt_t*)dvbpsi_malloc(sizeof(dvbpsi_sdt_t));           \
   if(p_sdt != NULL)                                                     \
     dvbpsi_InitSDT(p_sdt, i_ts_id, i_version, b_current_next, i_network_id); \
 } while(0);
@@ -203,7 +203,7 @@ void dvbpsi_EmptySDT(dvbpsi_sdt_t *p_sdt);
 #define dvbpsi_DeleteSDT(p_sdt)                                         \
 do {                                                                    \
   dvbpsi_EmptySDT(p_sdt);                                               \
-  free(p_sdt);                                                          \
+  dvbpsi_free(p_sdt);                                                   \
 } while(0);
 
 
@@ -133,7 +133,7 @@ void dvbpsi_InitTOT(dvbpsi_tot_t* p_tot, uint64_t i_utc_time);
  */
 #define dvbpsi_NewTOT(p_tot, i_utc_time)                                \
 do {                                                                    \
-  p_tot = (dvbpsi_tot_t*)malloc(sizeof(dvbpsi_tot_t));                  \
+  p_tot = (dvbpsi_tot_t*)dvbpsi_malloc(sizeof(dvbpsi_tot_t));           \
   if(p_tot != NULL)                                                     \
     dvbpsi_InitTOT(p_tot, i_utc_time);                                  \
 } while(0);
@@ -159,7 +159,7 @@ void dvbpsi_EmptyTOT(dvbpsi_tot_t* p_tot);
 #define dvbpsi_DeleteTOT(p_tot)                                         \
 do {                                                                    \
   dvbpsi_EmptyTOT(p_tot);                                               \
-  free(p_tot);                                                          \
+  dvbpsi_free(p_tot);                                                   \
 } while(0);
 
 
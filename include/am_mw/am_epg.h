@@ -332,6 +332,17 @@ extern AM_ErrorCode_t AM_EPG_SetTablesCallback(AM_EPG_Handle_t handle, int table
 
 extern AM_ErrorCode_t AM_EPG_DisableDefProc(AM_EPG_Handle_t handle, AM_Bool_t disable);
 
+/**\brief Decode the descriptors of the received tables on demand
+ * Only the descriptors the EPG scanner uses are decoded. Tables passed to the
+ * table callbacks and the events must then be read through
+ * AM_SI_GetDecodedDescriptor(), p_decoded is NULL until it is called.
+ * \param handle EPG scanner handle
+ * \param enable AM_TRUE to decode the descriptors on demand
+ * \retval AM_SUCCESS On success
+ * \return Error code
+ */
+extern AM_ErrorCode_t AM_EPG_SetLazyDescriptorDecode(AM_EPG_Handle_t handle, AM_Bool_t enable);
+
 
 #ifdef __cplusplus
 }
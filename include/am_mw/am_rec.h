@@ -38,6 +38,9 @@ extern "C"
 
 #define AM_REC_MediaInfo_t AM_AV_TimeshiftMediaInfo_t
 
+/**\brief Suffix appended to the record file name to get the metadata file name*/
+#define AM_REC_META_SUFFIX ".meta"
+
 /****************************************************************************
  * Error code definitions
  ****************************************************************************/
@@ -55,6 +58,7 @@ enum AM_REC_ErrorCode
 	AM_REC_ERR_CANNOT_ACCESS_FILE,		/**< Access deny*/
 	AM_REC_ERR_DVR,                         /**< DVR device error*/
 	AM_REC_ERR_CANNOT_WRITE_FILE_NO_SPACE,		/**< Write file failed, due to no space*/
+	AM_REC_ERR_TOO_MANY_STREAMS,		/**< The recordings on the DVR device need too many PIDs*/
 	AM_REC_ERR_END
 };
 
@@ -124,12 +128,31 @@ typedef struct
 	char suffix_name[AM_REC_SUFFIX_MAX];  /**< Filename suffix*/
 	AM_Crypt_Ops_t *crypt_ops;
 	AM_REC_Pids_t ext_pids;
+	AM_Bool_t share_dvr;            /**< Share the DVR device with the other recordings using share_dvr on it, see AM_REC_StartRecord()*/
 #ifdef SUPPORT_CAS
 	AM_CAS_encrypt enc_cb;
 	uint32_t cb_param;
 #endif
 }AM_REC_RecPara_t;
 
+/**\brief Record file writer parameters
+ *
+ * The recording thread hands the data to a writer thread through
+ * buf_count buffers of buf_size bytes, so slow storage does not stall
+ * the DVR draining.
+ */
+typedef struct
+{
+	int buf_size;          /**< Size of each buffer in bytes, <=0 means default (1MB)*/
+	int buf_count;         /**< Number of buffers (2~8), <=0 means default (2)*/
+	int flush_time;        /**< Max time in ms the data stays in memory, <=0 means default (1000ms)*/
+	int sync_size;         /**< Call fdatasync after this many bytes written, <=0 means never*/
+	AM_Bool_t direct_io;   /**< Bypass the page cache with O_DIRECT when possible*/
+	int meta_time;         /**< Update the metadata file every meta_time ms, <=0 means no metadata file.
+	                            With the metadata file, the duration in the file header is only written
+	                            when the recording ends, so the record file is written sequentially*/
+}AM_REC_WriterPara_t;
+
 /**\brief Recording information*/
 typedef struct
 {
@@ -168,6 +191,13 @@ extern AM_ErrorCode_t AM_REC_Create(AM_REC_CreatePara_t *para, AM_REC_Handle_t *
 extern AM_ErrorCode_t AM_REC_Destroy(AM_REC_Handle_t handle);
 
 /**\brief Start recording
+ *
+ * When start_para->share_dvr is set, the recordings of all the record managers
+ * created on the same DVR device with share_dvr set use one DVR read thread.
+ * It records the PIDs of all of them and splits the packets by PID, so several
+ * services of a multiplex are recorded with one copy of the stream. Each file
+ * still gets its own header and PAT. Starting or stopping one of them adds or
+ * removes its PIDs without interrupting the others.
  * \param handle Record manager handle
  * \param [in] start_para Start parameters
  * \retval AM_SUCCESS On success
@@ -206,6 +236,14 @@ extern AM_ErrorCode_t AM_REC_GetUserData(AM_REC_Handle_t handle, void **user_dat
  */
 extern AM_ErrorCode_t AM_REC_SetRecordPath(AM_REC_Handle_t handle, const char *path);
 
+/**\brief Set the record file writer parameters, used by the next recording
+ * \param handle Record manager handle
+ * \param [in] para Writer parameters
+ * \retval AM_SUCCESS On success
+ * \return Error code
+ */
+extern AM_ErrorCode_t AM_REC_SetWriterPara(AM_REC_Handle_t handle, const AM_REC_WriterPara_t *para);
+
 /**\brief Get the current recording information
  * \param handle Record manager handle
  * \param [out] info Return the current information
@@ -222,6 +260,15 @@ extern AM_ErrorCode_t AM_REC_GetTFile(AM_REC_Handle_t handle, AM_TFile_t *tfile,
 extern AM_ErrorCode_t AM_REC_PauseRecord(AM_REC_Handle_t handle);
 extern AM_ErrorCode_t AM_REC_ResumeRecord(AM_REC_Handle_t handle);
 
+/**\brief Get the media information of a record file
+ *
+ * The metadata file (name + AM_REC_META_SUFFIX) is used if it exists,
+ * otherwise the header of the record file is parsed.
+ * \param [in] name Record file name
+ * \param [out] info Return the media information
+ * \retval AM_SUCCESS On success
+ * \return Error code
+ */
 extern AM_ErrorCode_t AM_REC_GetMediaInfoFromFile(const char *name, AM_REC_MediaInfo_t *info);
 #ifdef __cplusplus
 }
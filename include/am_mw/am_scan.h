@@ -476,6 +476,16 @@ extern AM_ErrorCode_t AM_SCAN_Resume(AM_SCAN_Handle_t handle);
  */
 extern AM_ErrorCode_t AM_SCAN_SetHelper(AM_SCAN_Handle_t handle, AM_SCAN_Helper_t *helper);
 
+/**\brief decode the descriptors of the received tables on demand, call it before AM_SCAN_Start().
+ * The tables in the progress events and the store callback must then be read
+ * through AM_SI_GetDecodedDescriptor(), p_decoded is NULL until it is called.
+ * \param [in] handle scan handle
+ * \param enable AM_TRUE to decode the descriptors on demand
+ * \retval AM_SUCCESS On success
+ * \return Error code
+ */
+extern AM_ErrorCode_t AM_SCAN_SetLazyDescriptorDecode(AM_SCAN_Handle_t handle, AM_Bool_t enable);
+
 #ifdef __cplusplus
 }
 #endif
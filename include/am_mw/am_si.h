@@ -17,6 +17,7 @@
 #define _AM_SI_H
 
 #include "am_types.h"
+#include "am_mem.h"
 
 #include "libdvbsi/descriptor.h"
 #include "libdvbsi/dvbpsi.h"
@@ -354,6 +355,22 @@ extern AM_ErrorCode_t AM_SI_Destroy(AM_SI_Handle_t handle);
  */
 extern AM_ErrorCode_t AM_SI_DecodeSection(AM_SI_Handle_t handle, uint16_t pid, uint8_t *buf, uint16_t len, void **sec);
 
+/**\brief parse a section, all the parsered data is allocated from a memory pool.
+ * Used for sections that are handled and dropped at once (e.g. EIT), the data
+ * is released by AM_MEM_PoolClear(), do not call AM_SI_ReleaseSection() on it.
+ * RRT is not supported.
+ *
+ * \param handle the handle of parser
+ * \param pid section pid
+ * \param [in] buf section original data
+ * \param len section original data length
+ * \param [in] pool memory pool, used by one thread at a time
+ * \param [out] sec parsered section data
+ * \retval AM_SUCCESS On success
+ * \return Error code
+ */
+extern AM_ErrorCode_t AM_SI_DecodeSectionInPool(AM_SI_Handle_t handle, uint16_t pid, uint8_t *buf, uint16_t len, AM_MEM_Pool_t *pool, void **sec);
+
 /**\brief release a section that got from AM_SI_DecodeSection()
  * \param handle the handle of parser
  * \param table_id table id
@@ -363,6 +380,27 @@ extern AM_ErrorCode_t AM_SI_DecodeSection(AM_SI_Handle_t handle, uint16_t pid, u
  */
 extern AM_ErrorCode_t AM_SI_ReleaseSection(AM_SI_Handle_t handle, uint8_t table_id, void *sec);
 
+/**\brief set whether the descriptors are decoded on demand.
+ * When enabled, AM_SI_DecodeSection() keeps only the raw descriptors
+ * (tag, length, data) and p_decoded stays NULL until
+ * AM_SI_GetDecodedDescriptor() is called. Only enable it when every user of
+ * the tables reads the descriptors through AM_SI_GetDecodedDescriptor().
+ * \param handle the handle of parser
+ * \param enable AM_TRUE to decode the descriptors on demand
+ * \retval AM_SUCCESS On success
+ * \return Error code
+ */
+extern AM_ErrorCode_t AM_SI_SetLazyDescriptorDecode(AM_SI_Handle_t handle, AM_Bool_t enable);
+
+/**\brief get the decoded data of a descriptor, decode it first if needed.
+ * The result is cached in p_decoded and released with the section.
+ * Works on descriptors decoded in both modes.
+ * \param [in] descr the descriptor
+ * \param table_id table id of the table holding the descriptor
+ * \return the decoded data, NULL if the descriptor is not supported or invalid
+ */
+extern void *AM_SI_GetDecodedDescriptor(dvbpsi_descriptor_t *descr, uint8_t table_id);
+
 /**\brief get the head info of a section
  * \param handle the handle of parser
  * \param [in] buf section original data
@@ -121,6 +121,10 @@ ifeq ($(EMU_DEMUX), y)
 	CFLAGS+=-DEMU_DEMUX
 endif
 
+ifeq ($(EMU_DVR), y)
+	CFLAGS+=-DEMU_DVR
+endif
+
 ifeq ($(LINUX_DVB_FEND), y)
 	CFLAGS+=-DLINUX_DVB_FEND
 endif
@@ -0,0 +1,12 @@
+LOCAL_PATH := $(call my-dir)
+
+include $(CLEAR_VARS)
+LOCAL_SRC_FILES:= am_crc_test.c
+LOCAL_MODULE:= am_crc_test
+LOCAL_MODULE_TAGS := optional
+LOCAL_VENDOR_MODULE := true
+LOCAL_CFLAGS+=-DANDROID -DAMLINUX
+LOCAL_C_INCLUDES := $(LOCAL_PATH)/../../include/am_adp\
+            $(LOCAL_PATH)/../../android/ndk/include
+LOCAL_SHARED_LIBRARIES := libam_adp libcutils liblog libc
+include $(BUILD_EXECUTABLE)
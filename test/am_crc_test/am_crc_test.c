@@ -0,0 +1,213 @@
+#ifdef _FORTIFY_SOURCE
+#undef _FORTIFY_SOURCE
+#endif
+/***************************************************************************
+ * Copyright (c) 2019 Amlogic, Inc. All rights reserved.
+ *
+ * This source code is subject to the terms and conditions defined in the
+ * file 'LICENSE' which is part of this source code package.
+ *
+ * Description:
+ */
+/**\file
+ * \brief CRC32测试程序
+ *
+ * 用逐位计算的结果检查各计算方法，并测试不同数据长度下各方法的速度(MB/s)。
+ * 用法: am_crc_test [数据量(MB)]
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <am_types.h>
+#include <am_util.h>
+#include <am_crc.h>
+
+/****************************************************************************
+ * Macro definitions
+ ***************************************************************************/
+
+#define TEST_BUF_SIZE   (64*1024)
+#define TEST_CHECK_LEN  (1024)
+
+/****************************************************************************
+ * Static data
+ ***************************************************************************/
+
+static const struct
+{
+	AM_CRC32_Engine_t engine;
+	const char *name;
+} engines[] = {
+	{AM_CRC32_ENGINE_BYTE,   "byte"},
+	{AM_CRC32_ENGINE_SLICE8, "slice8"},
+	{AM_CRC32_ENGINE_CLMUL,  "clmul"},
+	{AM_CRC32_ENGINE_AUTO,   "auto"},
+};
+
+/*TS包, 短section, 典型的EIT section, 最大的私有section*/
+static const int bench_lens[] = {188, 1024, 4096, TEST_BUF_SIZE};
+
+/****************************************************************************
+ * Static functions
+ ***************************************************************************/
+
+static double get_time(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+/**\brief ISO 13818-1 Annex B逐位计算*/
+static uint32_t crc_ref(uint32_t crc, const uint8_t *p, int len)
+{
+	int i;
+
+	while (len-- > 0)
+	{
+		crc ^= (uint32_t)*p++ << 24;
+		for (i = 0; i < 8; i++)
+			crc = (crc << 1) ^ ((crc & 0x80000000) ? 0x04C11DB7 : 0);
+	}
+
+	return crc;
+}
+
+static int check(const uint8_t *buf)
+{
+	uint8_t sec[TEST_CHECK_LEN + 4];
+	uint32_t ref, crc;
+	int e, len, off, split, ret = 0;
+
+	/*CRC-32/MPEG-2的标准校验值*/
+	for (e = 0; e < (int)AM_ARRAY_SIZE(engines); e++)
+	{
+		crc = AM_CRC32_CalcEngine(engines[e].engine, AM_CRC32_INIT, (const uint8_t *)"123456789", 9);
+		if (crc != 0x0376E6E7)
+		{
+			printf("%s: check value 0x%08x, should be 0x0376e6e7\n", engines[e].name, crc);
+			ret = -1;
+		}
+	}
+
+	/*所有长度，不同的对齐*/
+	for (len = 0; len <= TEST_CHECK_LEN; len++)
+	{
+		off = len & 15;
+		ref = crc_ref(AM_CRC32_INIT, buf + off, len);
+
+		for (e = 0; e < (int)AM_ARRAY_SIZE(engines); e++)
+		{
+			crc = AM_CRC32_CalcEngine(engines[e].engine, AM_CRC32_INIT, buf + off, len);
+			if (crc != ref)
+			{
+				printf("%s: len %d crc 0x%08x, should be 0x%08x\n", engines[e].name, len, crc, ref);
+				ret = -1;
+			}
+
+			/*分两块计算*/
+			split = (len * 7) / 11;
+			crc = AM_CRC32_CalcEngine(engines[e].engine, AM_CRC32_INIT, buf + off, split);
+			crc = AM_CRC32_CalcEngine(engines[e].engine, crc, buf + off + split, len - split);
+			if (crc != ref)
+			{
+				printf("%s: len %d split at %d crc 0x%08x, should be 0x%08x\n", engines[e].name, len, split, crc, ref);
+				ret = -1;
+			}
+		}
+
+		if (!len)
+			continue;
+
+		/*加上CRC_32字段后整个section的结果为0*/
+		memcpy(sec, buf + off, len);
+		sec[len]     = ref >> 24;
+		sec[len + 1] = ref >> 16;
+		sec[len + 2] = ref >> 8;
+		sec[len + 3] = ref;
+		if (!AM_CRC32_CheckSection(sec, len + 4))
+		{
+			printf("section len %d: check failed\n", len + 4);
+			ret = -1;
+		}
+		sec[len / 2] ^= 0x10;
+		if (AM_CRC32_CheckSection(sec, len + 4))
+		{
+			printf("section len %d: bad section passed\n", len + 4);
+			ret = -1;
+		}
+	}
+
+	return ret;
+}
+
+static double run(AM_CRC32_Engine_t engine, const uint8_t *buf, int len, int mb)
+{
+	int64_t total = (int64_t)mb * 1024 * 1024;
+	int rounds = AM_MAX(1, (int)(total / len));
+	int cnt = TEST_BUF_SIZE / len;
+	volatile uint32_t sum = 0;
+	double start = get_time();
+	int i;
+
+	for (i = 0; i < rounds; i++)
+		sum += AM_CRC32_CalcEngine(engine, AM_CRC32_INIT, buf + (i % cnt) * len, len);
+
+	return (double)rounds * len / (1024 * 1024) / (get_time() - start);
+}
+
+/****************************************************************************
+ * API functions
+ ***************************************************************************/
+
+int main(int argc, char **argv)
+{
+	int mb = (argc > 1) ? atoi(argv[1]) : 256;
+	int i, e, ret = 0;
+	uint8_t *buf;
+
+	buf = malloc(TEST_BUF_SIZE);
+	if (!buf)
+	{
+		printf("no memory\n");
+		return 1;
+	}
+
+	srand(time(NULL));
+	for (i = 0; i < TEST_BUF_SIZE; i++)
+		buf[i] = rand();
+
+	printf("carry-less multiply: %s\n", AM_CRC32_EngineAvailable(AM_CRC32_ENGINE_CLMUL) ? "yes" : "no");
+	printf("default engine: %s\n", (AM_CRC32_GetEngine() == AM_CRC32_ENGINE_CLMUL) ? "clmul" : "slice8");
+
+	if (check(buf))
+	{
+		printf("check failed\n");
+		ret = 1;
+	}
+
+	printf("%-8s", "MB/s");
+	for (i = 0; i < (int)AM_ARRAY_SIZE(bench_lens); i++)
+		printf(" %10d", bench_lens[i]);
+	printf("\n");
+
+	for (e = 0; e < (int)AM_ARRAY_SIZE(engines); e++)
+	{
+		if (!AM_CRC32_EngineAvailable(engines[e].engine))
+			continue;
+
+		printf("%-8s", engines[e].name);
+		for (i = 0; i < (int)AM_ARRAY_SIZE(bench_lens); i++)
+			printf(" %10.1f", run(engines[e].engine, buf, bench_lens[i], mb));
+		printf("\n");
+	}
+
+	free(buf);
+
+	return ret;
+}
+
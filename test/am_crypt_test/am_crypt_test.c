@@ -0,0 +1,263 @@
+#ifdef _FORTIFY_SOURCE
+#undef _FORTIFY_SOURCE
+#endif
+/***************************************************************************
+ * Copyright (c) 2019 Amlogic, Inc. All rights reserved.
+ *
+ * This source code is subject to the terms and conditions defined in the
+ * file 'LICENSE' which is part of this source code package.
+ *
+ * Description:
+ */
+/**\file
+ * \brief PVR加密算法测试程序
+ *
+ * 检查AES的标准测试向量，批量加解密与逐包加解密的结果是否一致，并测试各算法的速度(MB/s)。
+ * 用法: am_crypt_test [数据量(MB)]
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <am_types.h>
+#include <am_util.h>
+#include <am_crypt.h>
+
+/****************************************************************************
+ * Macro definitions
+ ***************************************************************************/
+
+#define TEST_PKTS     (1024)
+#define TEST_BUF_SIZE (TEST_PKTS*CRYPT_PKT_SIZE)
+
+/****************************************************************************
+ * Type definitions
+ ***************************************************************************/
+
+/**\brief 被测试的算法*/
+typedef struct
+{
+	const char *name;
+	void *(*open)(void);
+	int   (*close)(void *cryptor);
+	void  (*crypt)(void *cryptor, uint8_t *dst, uint8_t *src, int len, int decrypt);
+	void  (*crypt_pkts)(void *cryptor, uint8_t *dst, uint8_t *src, int pkt_cnt, int decrypt);
+} CryptTest_t;
+
+/****************************************************************************
+ * Static data
+ ***************************************************************************/
+
+static uint8_t test_key[24] = {
+	0x13, 0x34, 0x57, 0x79, 0x9b, 0xbc, 0xdf, 0xf1,
+	0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+	0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10
+};
+
+static void *des_open(void)
+{
+	return AM_CRYPT_des_open(test_key, 64);
+}
+
+static void *tdes_open(void)
+{
+	return AM_CRYPT_des_open(test_key, 192);
+}
+
+static void des_crypt(void *cryptor, uint8_t *dst, uint8_t *src, int len, int decrypt)
+{
+	AM_CRYPT_des_crypt(cryptor, dst, src, len, NULL, decrypt);
+}
+
+static void des_crypt_pkts(void *cryptor, uint8_t *dst, uint8_t *src, int pkt_cnt, int decrypt)
+{
+	AM_CRYPT_des_crypt_pkts(cryptor, dst, src, pkt_cnt, decrypt);
+}
+
+static void *aes_ecb_open(void)
+{
+	return AM_CRYPT_aes_open(test_key, 128, 0);
+}
+
+static void *aes_ecb_whole_open(void)
+{
+	return AM_CRYPT_aes_open(test_key, 128, AM_CRYPT_AES_FL_WHOLE_PAYLOAD);
+}
+
+static void *aes_ecb_soft_open(void)
+{
+	return AM_CRYPT_aes_open(test_key, 128, AM_CRYPT_AES_FL_WHOLE_PAYLOAD|AM_CRYPT_AES_FL_SOFT);
+}
+
+static void aes_crypt(void *cryptor, uint8_t *dst, uint8_t *src, int len, int decrypt)
+{
+	AM_CRYPT_aes_crypt(cryptor, dst, src, len, NULL, decrypt);
+}
+
+static void aes_crypt_pkts(void *cryptor, uint8_t *dst, uint8_t *src, int pkt_cnt, int decrypt)
+{
+	AM_CRYPT_aes_crypt_pkts(cryptor, dst, src, pkt_cnt, decrypt);
+}
+
+static CryptTest_t tests[] = {
+	{"DES",         des_open,           AM_CRYPT_des_close, des_crypt, des_crypt_pkts},
+	{"3DES",        tdes_open,          AM_CRYPT_des_close, des_crypt, des_crypt_pkts},
+	{"AES-ECB",     aes_ecb_open,       AM_CRYPT_aes_close, aes_crypt, aes_crypt_pkts},
+	{"AES-ECB-W",   aes_ecb_whole_open, AM_CRYPT_aes_close, aes_crypt, aes_crypt_pkts},
+	{"AES-ECB-W/C", aes_ecb_soft_open,  AM_CRYPT_aes_close, aes_crypt, aes_crypt_pkts},
+};
+
+/*FIPS-197 C.1, AES-128*/
+static const uint8_t kat_ecb_key[16] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static const uint8_t kat_ecb_plain[16] = {
+	0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+static const uint8_t kat_ecb_cipher[16] = {
+	0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+};
+
+/****************************************************************************
+ * Static functions
+ ***************************************************************************/
+
+static double get_time(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+static double run(CryptTest_t *t, void *cryptor, uint8_t *dst, uint8_t *src, int rounds, int batch, int decrypt)
+{
+	double start = get_time();
+	int i, r;
+
+	for (r = 0; r < rounds; r++) {
+		if (batch) {
+			t->crypt_pkts(cryptor, dst, src, TEST_PKTS, decrypt);
+		} else {
+			for (i = 0; i < TEST_PKTS; i++)
+				t->crypt(cryptor, dst + i * CRYPT_PKT_SIZE, src + i * CRYPT_PKT_SIZE, CRYPT_PKT_SIZE, decrypt);
+		}
+	}
+
+	return (double)rounds * TEST_BUF_SIZE / (1024 * 1024) / (get_time() - start);
+}
+
+static int check(CryptTest_t *t, uint8_t *plain, uint8_t *b1, uint8_t *b2)
+{
+	void *cryptor;
+	int i, ret = 0;
+
+	if (!(cryptor = t->open()))
+		return -1;
+	for (i = 0; i < TEST_PKTS; i++)
+		t->crypt(cryptor, b1 + i * CRYPT_PKT_SIZE, plain + i * CRYPT_PKT_SIZE, CRYPT_PKT_SIZE, 0);
+	t->close(cryptor);
+
+	if (!(cryptor = t->open()))
+		return -1;
+	t->crypt_pkts(cryptor, b2, plain, TEST_PKTS, 0);
+	t->close(cryptor);
+	if (memcmp(b1, b2, TEST_BUF_SIZE)) {
+		printf("%s: batch encryption differs from packet encryption\n", t->name);
+		return -1;
+	}
+
+	/*in place*/
+	if (!(cryptor = t->open()))
+		return -1;
+	t->crypt_pkts(cryptor, b2, b2, TEST_PKTS, 1);
+	t->close(cryptor);
+	if (memcmp(plain, b2, TEST_BUF_SIZE)) {
+		printf("%s: batch decryption failed\n", t->name);
+		ret = -1;
+	}
+
+	return ret;
+}
+
+static int check_aes_kat(int flags)
+{
+	uint8_t pkt[CRYPT_PKT_SIZE];
+	void *cryptor;
+	int ret = 0;
+
+	memset(pkt, 0, sizeof(pkt));
+	pkt[0] = 0x47;
+	memcpy(pkt + 4, kat_ecb_plain, 16);
+	cryptor = AM_CRYPT_aes_open(kat_ecb_key, 128, flags);
+	if (!cryptor)
+		return -1;
+	AM_CRYPT_aes_crypt(cryptor, pkt, pkt, CRYPT_PKT_SIZE, NULL, 0);
+	AM_CRYPT_aes_close(cryptor);
+	if ((pkt[0] != 0x47) || memcmp(pkt + 4, kat_ecb_cipher, 16)) {
+		printf("AES-ECB: known answer test failed\n");
+		ret = -1;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * API functions
+ ***************************************************************************/
+
+int main(int argc, char **argv)
+{
+	int mb = (argc > 1) ? atoi(argv[1]) : 64;
+	int rounds, i, ret = 0;
+	uint8_t *plain, *b1, *b2;
+
+	plain = malloc(TEST_BUF_SIZE);
+	b1 = malloc(TEST_BUF_SIZE);
+	b2 = malloc(TEST_BUF_SIZE);
+	if (!plain || !b1 || !b2) {
+		printf("no memory\n");
+		return 1;
+	}
+
+	srand(time(NULL));
+	for (i = 0; i < TEST_BUF_SIZE; i++)
+		plain[i] = rand();
+	for (i = 0; i < TEST_PKTS; i++)
+		plain[i * CRYPT_PKT_SIZE] = 0x47;
+
+	rounds = AM_MAX(1, (int)((int64_t)mb * 1024 * 1024 / TEST_BUF_SIZE));
+
+	printf("AES instructions: %s\n", AM_CRYPT_aes_hw_available() ? "yes" : "no");
+	if (check_aes_kat(0) || check_aes_kat(AM_CRYPT_AES_FL_SOFT))
+		ret = 1;
+
+	printf("%-12s %12s %12s %12s %12s\n", "cipher", "enc MB/s", "dec MB/s", "batch enc", "batch dec");
+
+	for (i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i++) {
+		CryptTest_t *t = &tests[i];
+		void *cryptor;
+
+		if (check(t, plain, b1, b2)) {
+			printf("%s: check failed\n", t->name);
+			ret = 1;
+			continue;
+		}
+
+		cryptor = t->open();
+		printf("%-12s %12.1f %12.1f %12.1f %12.1f\n", t->name,
+			run(t, cryptor, b1, plain, rounds, 0, 0),
+			run(t, cryptor, b2, b1, rounds, 0, 1),
+			run(t, cryptor, b1, plain, rounds, 1, 0),
+			run(t, cryptor, b2, b1, rounds, 1, 1));
+		t->close(cryptor);
+	}
+
+	free(plain);
+	free(b1);
+	free(b2);
+
+	return ret;
+}
@@ -0,0 +1,194 @@
+#ifdef _FORTIFY_SOURCE
+#undef _FORTIFY_SOURCE
+#endif
+/***************************************************************************
+ * Copyright (c) 2019 Amlogic, Inc. All rights reserved.
+ *
+ * This source code is subject to the terms and conditions defined in the
+ * file 'LICENSE' which is part of this source code package.
+ *
+ * Description:
+ */
+/**\file
+ * \brief emu DVR限速测试程序
+ *
+ * 检查emu DVR驱动在没有数据和按AM_DVR_BITRATE限速时，AM_DVR_Read是否阻塞到超时或下一个包的时间，
+ * 而不是立即返回。需要用EMU_DEMUX=y EMU_DVR=y的配置编译。
+ * 用法: am_dvr_emu_test
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <am_types.h>
+#include <am_dmx.h>
+#include <am_dvr.h>
+
+/****************************************************************************
+ * Macro definitions
+ ***************************************************************************/
+
+#define DVR_DEV_NO    (0)
+#define TEST_PID      (0x100)
+#define TEST_PKTS     (64)
+/*限速时每秒输出的包数*/
+#define TEST_PKT_RATE (20)
+/*允许的计时误差(毫秒)*/
+#define TEST_SLACK_MS (30)
+
+/****************************************************************************
+ * Static functions
+ ***************************************************************************/
+
+static int get_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**\brief 生成只包含TEST_PID的TS文件*/
+static int make_ts_file(char *name)
+{
+	uint8_t pkt[188];
+	int fd, i;
+
+	fd = mkstemp(name);
+	if (fd == -1)
+		return -1;
+
+	memset(pkt, 0xff, sizeof(pkt));
+	pkt[0] = 0x47;
+	pkt[1] = TEST_PID >> 8;
+	pkt[2] = TEST_PID & 0xff;
+	pkt[3] = 0x10;
+	for (i = 0; i < TEST_PKTS; i++)
+	{
+		if (write(fd, pkt, sizeof(pkt)) != sizeof(pkt))
+		{
+			close(fd);
+			return -1;
+		}
+	}
+
+	close(fd);
+	return 0;
+}
+
+/**\brief 没有TS文件时，读取应等待到超时*/
+static int check_idle(void)
+{
+	static const int timeouts[] = {20, 50, 100};
+	uint8_t buf[188];
+	int i, start, used, ret = 0;
+
+	for (i = 0; i < (int)(sizeof(timeouts) / sizeof(timeouts[0])); i++)
+	{
+		start = get_ms();
+		AM_DVR_Read(DVR_DEV_NO, buf, sizeof(buf), timeouts[i]);
+		used = get_ms() - start;
+
+		printf("idle read, timeout %d ms: waited %d ms\n", timeouts[i], used);
+		if ((used < timeouts[i] - 2) || (used > timeouts[i] + TEST_SLACK_MS))
+		{
+			printf("idle read did not wait for the timeout\n");
+			ret = -1;
+		}
+	}
+
+	return ret;
+}
+
+/**\brief 限速时，逐包读取的间隔应接近1/TEST_PKT_RATE秒*/
+static int check_rate(void)
+{
+	AM_DVR_StartRecPara_t spara;
+	uint8_t buf[188];
+	int i, cnt, start, used, expect, got = 0, ret = 0;
+
+	memset(&spara, 0, sizeof(spara));
+	spara.pid_count = 1;
+	spara.pids[0] = TEST_PID;
+	if (AM_DVR_StartRecord(DVR_DEV_NO, &spara) != AM_SUCCESS)
+	{
+		printf("cannot start recording\n");
+		return -1;
+	}
+
+	/*第一次读取开始计时*/
+	AM_DVR_Read(DVR_DEV_NO, buf, sizeof(buf), 1000);
+
+	start = get_ms();
+	for (i = 0; i < TEST_PKT_RATE; i++)
+	{
+		cnt = AM_DVR_Read(DVR_DEV_NO, buf, sizeof(buf), 1000);
+		if (cnt > 0)
+			got += cnt / 188;
+	}
+	used = get_ms() - start;
+	expect = got * 1000 / TEST_PKT_RATE;
+
+	printf("paced read, %d packets: %d ms, expected about %d ms\n", got, used, expect);
+	if ((got != TEST_PKT_RATE) || (used < expect - 1000 / TEST_PKT_RATE) || (used > expect + TEST_SLACK_MS * 2))
+	{
+		printf("paced read did not follow the bit rate\n");
+		ret = -1;
+	}
+
+	AM_DVR_StopRecord(DVR_DEV_NO);
+	return ret;
+}
+
+/****************************************************************************
+ * API functions
+ ***************************************************************************/
+
+int main(int argc, char **argv)
+{
+	AM_DMX_OpenPara_t dpara;
+	AM_DVR_OpenPara_t para;
+	char name[] = "/tmp/am_dvr_emu_testXXXXXX";
+	char rate[32];
+	int ret = 0;
+
+	UNUSED(argc);
+	UNUSED(argv);
+
+	if (make_ts_file(name))
+	{
+		printf("cannot create the TS file\n");
+		return 1;
+	}
+
+	unsetenv("AM_TSFILE");
+	unsetenv("AM_TSFILE0");
+	snprintf(rate, sizeof(rate), "%d", 188 * 8 * TEST_PKT_RATE);
+	setenv("AM_DVR_BITRATE", rate, 1);
+
+	memset(&dpara, 0, sizeof(dpara));
+	memset(&para, 0, sizeof(para));
+	if ((AM_DMX_Open(DVR_DEV_NO, &dpara) != AM_SUCCESS) || (AM_DVR_Open(DVR_DEV_NO, &para) != AM_SUCCESS))
+	{
+		printf("cannot open the devices\n");
+		unlink(name);
+		return 1;
+	}
+
+	if (check_idle())
+		ret = 1;
+
+	setenv("AM_TSFILE", name, 1);
+	if (check_rate())
+		ret = 1;
+
+	AM_DVR_Close(DVR_DEV_NO);
+	AM_DMX_Close(DVR_DEV_NO);
+	unlink(name);
+
+	printf("%s\n", ret ? "FAILED" : "PASSED");
+	return ret;
+}
@@ -106,10 +106,48 @@ static void des_crypt(void *cryptor, uint8_t *dst, uint8_t *src, int len, int de
     AM_CRYPT_des_crypt(cryptor, dst, src, len, NULL, decrypt);
 }
 
+static void des_crypt_pkts(void *cryptor, uint8_t *dst, uint8_t *src, int pkt_cnt, int decrypt)
+{
+    AM_CRYPT_des_crypt_pkts(cryptor, dst, src, pkt_cnt, decrypt);
+}
+
 static AM_Crypt_Ops_t des_ops = {
     .open = des_open,
     .close = des_close,
     .crypt = des_crypt,
+    .crypt_pkts = des_crypt_pkts,
+};
+
+static uint8_t aes_key[] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+
+static void *aes_open()
+{
+    return AM_CRYPT_aes_open(aes_key, 128, AM_CRYPT_AES_FL_WHOLE_PAYLOAD);
+}
+
+static int aes_close(void *cryptor)
+{
+    return AM_CRYPT_aes_close(cryptor);
+}
+
+static void aes_crypt(void *cryptor, uint8_t *dst, uint8_t *src, int len, int decrypt)
+{
+    AM_CRYPT_aes_crypt(cryptor, dst, src, len, NULL, decrypt);
+}
+
+static void aes_crypt_pkts(void *cryptor, uint8_t *dst, uint8_t *src, int pkt_cnt, int decrypt)
+{
+    AM_CRYPT_aes_crypt_pkts(cryptor, dst, src, pkt_cnt, decrypt);
+}
+
+static AM_Crypt_Ops_t aes_ops = {
+    .open = aes_open,
+    .close = aes_close,
+    .crypt = aes_crypt,
+    .crypt_pkts = aes_crypt_pkts,
 };
 
 int start_timeshift_test(void)
@@ -288,7 +326,7 @@ int main(int argc, char **argv)
         else if (!strncmp(argv[i], "crypt", 5))
             sscanf(argv[i], "crypt=%s", &crypt[0]);
         else if (!strncmp(argv[i], "help", 4)) {
-            printf("Usage: %s [v=pid:fmt] [a=pid:fmt] [tsin=n] [dur=s] [pause=n]\n", argv[0]);
+            printf("Usage: %s [v=pid:fmt] [a=pid:fmt] [tsin=n] [dur=s] [pause=n] [crypt=des|aes]\n", argv[0]);
             exit(0);
         }
     }
@@ -355,6 +393,8 @@ int main(int argc, char **argv)
 
     if (strncmp(crypt, "des", 3) == 0)
         rsparam.crypt_ops = &des_ops;
+    else if (strncmp(crypt, "aes", 3) == 0)
+        rsparam.crypt_ops = &aes_ops;
 
     ret = AM_REC_StartRecord(rec, &rsparam);
     if (ret != AM_SUCCESS) {
@@ -380,6 +420,8 @@ int main(int argc, char **argv)
 
     if (strncmp(crypt, "des", 3) == 0)
         AM_AV_SetCryptOps(AV_DEV_NO, &des_ops);
+    else if (strncmp(crypt, "aes", 3) == 0)
+        AM_AV_SetCryptOps(AV_DEV_NO, &aes_ops);
 
     AM_AV_TimeshiftPara_t tparam;
     memset(&tparam, 0, sizeof(tparam));